@@ -0,0 +1,22 @@
+#ifndef ALLOC_GUARD_H
+#define ALLOC_GUARD_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+// 实时线程堆操作检测 (仅 Debug 构建生效)
+// - AllocGuardInstall 通过 _CrtSetAllocHook 挂接调试堆, 之后被 Arm 的线程每次 malloc/realloc/free 都计数一次
+// - 定义 ALLOC_GUARD_BREAK 时命中即 __debugbreak, 便于在调试器中定位调用栈
+// - CRT 内部块 (_CRT_BLOCK, 如 stdio 缓冲区) 不计入, 钩子内不调用任何 CRT 函数
+// - Release 构建中全部为空操作, 计数恒为 0
+
+// 函数声明
+void AllocGuardInstall(void);
+void AllocGuardArm(void);
+void AllocGuardDisarm(void);
+LONG AllocGuardGetCount(void);
+int AllocGuardIsActive(void);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef AXIS_CONFIG_H
+#define AXIS_CONFIG_H
+
+#include <stdint.h>
+
+#define MAX_AXIS_COUNT 64       // 编译期轴容量 (所有按轴存储的数组均按此分配)
+#define DEFAULT_AXIS_COUNT 2    // 默认运行轴数
+
+// 运行时轴数 (启动时配置, 控制线程启动后不再修改)
+extern int g_iAxisCount;
+
+// 函数声明
+int AxisConfigSetCount(int iAxisCount);
+uint64_t AxisConfigAllMask(void);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef BIQUAD_BANK_H
+#define BIQUAD_BANK_H
+
+#include "AxisConfig.h"
+
+// 二阶节滤波器组 (结构体数组转为数组结构体, 按轴连续存储)
+// 每个轴一个独立的二阶差分方程:
+//   y[k] = b0*x[k] + b1*x[k-1] + b2*x[k-2] - a1*y[k-1] - a2*y[k-2]
+// 系数在 BiquadBankSetCoeffs 中按 a0 归一化一次, 每周期的计算 (各内核) 不含除法
+// 同一字段的所有轴在内存中连续, 一次遍历所有轴即线性扫描各字段数组
+typedef struct {
+    // 滤波器系数 (已按 a0 归一化)
+    double adB0[MAX_AXIS_COUNT];
+    double adB1[MAX_AXIS_COUNT];
+    double adB2[MAX_AXIS_COUNT];
+    double adA1[MAX_AXIS_COUNT];
+    double adA2[MAX_AXIS_COUNT];
+
+    // 历史值
+    double adIn1[MAX_AXIS_COUNT];   // x[k-1]
+    double adIn2[MAX_AXIS_COUNT];   // x[k-2]
+    double adOut1[MAX_AXIS_COUNT];  // y[k-1]
+    double adOut2[MAX_AXIS_COUNT];  // y[k-2]
+} stBiquadBank;
+
+// 滤波器组计算内核 (运行时按 CPU 特性选择, 各内核运算顺序相同, 结果逐位一致)
+typedef enum {
+    BIQUAD_KERNEL_AUTO = 0,     // 自动选择支持的最宽内核
+    BIQUAD_KERNEL_SCALAR,       // 标量
+    BIQUAD_KERNEL_AVX2,         // AVX2, 每条指令 4 轴
+    BIQUAD_KERNEL_AVX512        // AVX-512F, 每条指令 8 轴
+} eBiquadKernel;
+
+// 函数声明
+int BiquadBankSelectKernel(eBiquadKernel eKernel);
+eBiquadKernel BiquadBankGetKernel(void);
+const char* BiquadBankKernelName(eBiquadKernel eKernel);
+int BiquadBankKernelSupported(eBiquadKernel eKernel);
+int BiquadBankSelfTest(eBiquadKernel eKernel);
+void BiquadBankInit(stBiquadBank* pBank);
+void BiquadBankSetCoeffs(stBiquadBank* pBank, int iAxis,
+                         double b0, double b1, double b2, double a0, double a1, double a2);
+void BiquadBankResetAxis(stBiquadBank* pBank, int iAxis);
+void BiquadBankProcess(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                       const unsigned char* pbEnable, int iAxisCount);
+
+#endif
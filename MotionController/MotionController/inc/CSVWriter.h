@@ -3,28 +3,81 @@
 
 #include <stdio.h>
 #include "ThreadControl.h"
+#include "TelemetryFile.h"
 
-#define DATA_BUFFER_SIZE 1000  // 数据缓冲区大小
-#define AXIS_COUNT 2  // 轴数改为2
+#define CSV_RING_CAPACITY 1024      // 控制线程 -> 写入线程的记录队列容量 (2 的幂, 1ms 周期下约 1s)
+#define CSV_DRAIN_BATCH 64          // 写入线程每次从队列取出的最大记录数
+#define CSV_WRITER_IDLE_MS 5        // 队列为空时写入线程的休眠时间 [ms]
+#define CSV_STOP_TIMEOUT_MS 2000    // 停止时等待写入线程取完队列的最长时间 [ms]
+#define CSV_ROW_MAX_CHARS 160       // 一行 (一条记录的一个轴) 的最大字符数
+#define CSV_BATCH_TEXT_MAX (CSV_DRAIN_BATCH * MAX_AXIS_COUNT * CSV_ROW_MAX_CHARS)   // 一批记录的最大文本长度
+#define CSV_FLUSH_BYTES_MAX (1024 * 1024)           // 写出阈值上限 (文本缓冲区 = 上限 + 一批)
+#define CSV_FLUSH_BYTES_DEFAULT (256 * 1024)        // 默认: 累计 256KB 写出一次
+#define CSV_FLUSH_MS_DEFAULT 100                    // 默认: 或距上次写出 100ms
+#define CSV_CAPTURE_TEXT 0                          // 控制系统的记录格式: CSV 文本 (默认)
+#define CSV_CAPTURE_BINARY 1                        // 二进制 (TelemetryFile)
+#define CSV_CAPTURE_COMPRESSED 2                    // 二进制, 分组压缩 (TelemetryCompress)
+#define CSV_CAPTURE_FILE "control_data.csv"
+#define TELEMETRY_CAPTURE_FILE "control_data.tlm"   // 用 tools/TelemetryConvert 转为 CSV 或输出统计
 
-// CSV数据结构
+// 逐周期数据记录
+// - 控制线程每个控制步骤调用一次 WriteCSVDataToBuffer, 直接在单生产者/单消费者无锁队列 (SpscRing) 的槽内写入,
+//   不加锁、不等待; 队列满时丢弃该记录并计数
+// - 写入线程按批取出记录, 用 DoubleFormat 直接格式化到静态文本缓冲区 (不调用 printf, 不分配内存),
+//   按写出策略一次 fwrite 写出 (文件设为无缓冲, 即一次系统调用):
+//   累计文本 >= 字节阈值 (0: 每批写出) 或距上次写出 >= 时间阈值 (0: 不按时间) 时写出
+// - 数值为最短往返文本 (strtod 可还原为原 double), 行格式: 步号,时间,目标,实际,误差,控制力,模式
+// - 二进制输出 (SetTelemetryFile): 每条记录按 TelemetryFile 标准列整块复制为定长记录, 与文本共用写出策略;
+//   两种输出可同时启用
+// - 压缩 (SetTelemetryFile 的 bCompress): 定长记录先暂存, 满 TELEMETRY_GROUP_RECORDS 条压缩为一组
+//   (TelemetryCompressGroup) 追加到二进制缓冲区; 按时间写出只写出已完成的组 (压缩率不受写出间隔影响,
+//   读取端延迟为一组, 1ms 周期下约 0.5s), 停止时压缩并写出不满一组的剩余记录
+// - 控制系统的记录格式在启动时由 CSVWriterSetCaptureFormat 选择 (命令行第二个参数 csv / tlm / tlmz), 缺省为 CSV
+// - 停止: CSVWriterStop 通知写入线程取完队列、写出剩余文本后退出并等待其确认 (关闭文件前调用)
+
+// CSV数据结构 (各数组只使用前 g_iAxisCount 个)
 typedef struct{
     int step;
     double time;
-    double targetPosition[AXIS_COUNT];
-    double actualPosition[AXIS_COUNT];
-    double error[AXIS_COUNT];
-    double controlForce[AXIS_COUNT];
-    int controlMode[AXIS_COUNT];
+    double targetPosition[MAX_AXIS_COUNT];
+    double actualPosition[MAX_AXIS_COUNT];
+    double error[MAX_AXIS_COUNT];
+    double controlForce[MAX_AXIS_COUNT];
+    int controlMode[MAX_AXIS_COUNT];
 } CSVData;
 
+// 数据记录统计信息
+typedef struct {
+    unsigned long long ullCaptured;     // 已进入队列的记录数
+    unsigned long long ullDropped;      // 队列满被丢弃的记录数
+    unsigned long long ullWritten;      // 已格式化的记录数 (未达写出策略的文本暂存在缓冲区)
+    unsigned long long ullBatches;      // 写入线程取出的批数
+    unsigned long long ullRows;         // 已格式化的行数 (记录数 × 轴数)
+    unsigned long long ullBytes;        // 已写出的字节数 (文本与二进制合计)
+    unsigned long long ullTelemetryRaw; // 二进制输出: 已编码记录的定长字节数 (压缩前)
+    unsigned long long ullTelemetryBytes;   // 二进制输出: 已写出的字节数 (含压缩)
+    unsigned long long ullWrites;       // 写出次数
+    unsigned long long ullWriteFailures;    // 未全部写出的次数 (磁盘满或 I/O 错误, 输出文件已截断)
+    double dBusyUs;                     // [us] 写入线程格式化与写出的累计耗时
+    double dRowsPerSecond;              // 吞吐量: 行数 / 累计耗时
+    LONG lDepth;                        // 当前队列深度 (近似值)
+    LONG lMaxDepth;                     // 写入线程观察到的最大队列深度
+} stCSVWriterStats;
+
 // 函数声明
 void InitCSVBuffer(void);
 void CleanupCSVBuffer(void);
 void SetCSVFile(FILE* pFile);
-int WriteCSVDataToBuffer(int step, double time, 
-                        double targetPosition[], double actualPosition[],
-                        double error[], double controlForce[], int controlMode[]);
+int SetTelemetryFile(FILE* pFile, double dSampleTime, int bCompress);
+int WriteCSVDataToBuffer(int step, double time, const ControlData* pData, const int* piControlMode);
+void CSVWriterStop(void);
+void CSVWriterGetStats(stCSVWriterStats* pStats);
+void CSVWriterSetFlushPolicy(size_t uFlushBytes, unsigned int uFlushMs);
+int CSVWriterSetCaptureFormat(int iFormat);
+int CSVWriterGetCaptureFormat(void);
+size_t CSVWriterFormatBatch(const CSVData* pstData, LONG lCount, char* pcText);
+size_t CSVWriterEncodeBatch(const stTelemetryHeader* pHeader, const CSVData* pstData, LONG lCount,
+                             unsigned char* pucOut);
 void* CSVWriterThreadFunction(void* param);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,42 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include "Socket.h"
+#include "SpscRing.h"
+
+#define COMMAND_QUEUE_CAPACITY 4096     // 指令队列容量 (2 的幂)
+#define COMMAND_DRAIN_MAX_PER_CYCLE 256 // 每个控制周期最多处理的指令数
+#define COMMAND_FEEDBACK_CAPACITY 256   // 异步完成反馈队列容量 (2 的幂)
+
+// 队列元素: 指令数据 + 序列号 + 入队时刻
+typedef struct {
+    struct RxData stRx;         // 指令数据
+    int iSequence;              // Socket 线程分配的指令序列号
+    LONGLONG llEnqueueTicks;    // 入队时刻 (QPC ticks)
+} stCommandEntry;
+
+// 指令队列统计信息
+typedef struct {
+    unsigned long long ullEnqueued;     // 入队成功次数
+    unsigned long long ullDequeued;     // 出队次数
+    unsigned long long ullOverflow;     // 队列满导致的丢弃次数
+    LONG lDepth;                        // 当前队列深度
+    LONG lMaxDepth;                     // 历史最大队列深度
+    double dMaxEnqueueUs;               // 单次入队操作最大耗时 [us]
+    double dMeanEnqueueUs;              // 单次入队操作平均耗时 [us]
+    double dMaxLatencyUs;               // 入队到出队的最大延迟 [us]
+    double dMeanLatencyUs;              // 入队到出队的平均延迟 [us]
+    unsigned long long ullFeedbackDropped;  // 反馈队列满导致丢弃的异步完成反馈数
+} stCommandQueueStats;
+
+// 函数声明
+void CommandQueueInit(void);
+int CommandQueuePush(const struct RxData* pRxData, int iSequence);
+int CommandQueuePop(stCommandEntry* pEntry);
+void CommandQueueGetStats(stCommandQueueStats* pStats);
+int CommandIsAsync(int iCMD);
+int CommandIsStreamed(const struct RxData* pRxData);
+int CommandFeedbackPush(const CommandFeedback* pFeedback);
+int CommandFeedbackPop(CommandFeedback* pFeedback);
+
+#endif
@@ -1,19 +1,57 @@
 #ifndef CONTROLER_H
 #define CONTROLER_H
 
+#include "AxisConfig.h"
 #include "PIDController.h"
 #include "LowPassFilter.h"
 #include "Notch_TF.h"
+#include "LeadLag.h"
+#include "SosCascade.h"
+#include "BiquadBank.h"
 
-// 控制器结构体
+#define CONTROLLER_MAX_NOTCHES 6    // 每轴最多陷波滤波器数
+
+// 控制器结构体: PID 及其后各级滤波器均表示为二阶节级联
+// 第0节固定为PID, 其后依次为低通/陷波/超前滞后等滤波器
+// 在控制器组中只作为配置 (每周期由 ControllerBank 的各级计算); ControllerUpdate 逐节计算单个轴, 仅作参考实现
 typedef struct {
-    PIDController pid;      // PID控制器
-    LowPassFilter lpf;      // 低通滤波器
-    SNotchTF notch;         //陷波滤波器
+    // PID增益参数 (修改后重新生成第0节)
+    double kp;
+    double ki;
+    double kd;
+    double sample_time;
+
+    int iNotchCount;        // 已配置的陷波滤波器数
+    stSosCascade stCascade; // 二阶节级联
 } Controller;
 
+// 多轴控制器组
+// astAxis 只保存各轴的二阶节配置 (冷数据, 每周期不访问); 每周期计算的是 astStage:
+// 第 s 级为所有轴第 s 节组成的二阶节滤波器组 (数组结构体), 按级依次经 BiquadBankProcess (按 CPU 选择的向量内核)
+// 处理所有轴. 每节独立实现 (Direct Form I, 系数已按 a0 归一化), 与逐节级联的传递函数相同, 不展开为高阶多项式,
+// 任意陷波频率/阻尼组合下数值性质与单节相同. 节数少于 iStageCount 的轴, 多出的级为直通
+// 修改 astAxis[i] 的增益或滤波器后需调用 ControllerBankCompileAxis
+typedef struct {
+    Controller astAxis[MAX_AXIS_COUNT];
+    stBiquadBank astStage[SOS_MAX_SECTIONS];   // 各级滤波器组 (状态为各节的输入/输出历史, 与系数无关)
+    int aiSectionCount[MAX_AXIS_COUNT];        // 各轴已编译的节数
+    int iStageCount;                           // 实际计算的级数 (所有轴节数的最大值)
+    double adWork[MAX_AXIS_COUNT];             // 级间信号 (计算用)
+} ControllerBank;
+
 // 函数声明
 void ControllerInit(Controller *controller);
 double ControllerUpdate(Controller * controller, double error);
+void ControllerReset(Controller *controller);
+void ControllerSetGains(Controller *controller, double kp, double ki, double kd);
+void ControllerClearFilters(Controller *controller);
+void ControllerRestoreDefaultFilters(Controller *controller);
+int ControllerAddLowPass(Controller *controller, double cutoff_freq, double damping);
+int ControllerAddNotch(Controller *controller, double freq_zero, double freq_pole, double damp_zero, double damp_pole);
+int ControllerAddLeadLag(Controller *controller, double freq_zero, double freq_pole);
+void ControllerBankInit(ControllerBank *bank, int axisCount);
+int ControllerBankCompileAxis(ControllerBank *bank, int axis);
+void ControllerBankUpdate(ControllerBank *bank, const double *error, double *output,
+                          const unsigned char *enable, int axisCount);
 
-#endif
\ No newline at end of file
+#endif
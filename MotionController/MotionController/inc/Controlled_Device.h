@@ -2,6 +2,7 @@
 #define CONTROLLED_DEVICE_H
 
 #include <stdint.h>
+#include "BiquadBank.h"
 
 // 刚体传递函数结构体
 typedef struct {
@@ -16,5 +17,6 @@ typedef struct {
 // 函数声明
 void RigidBodyTFInit(RigidBodyTF* tf, double mass, double dt);
 double RigidBodyTFUpdate(RigidBodyTF* tf, double force);
+void RigidBodyBankInitAxis(stBiquadBank* pBank, int iAxis, double mass, double dt);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef CYCLE_TIMER_H
+#define CYCLE_TIMER_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+// 周期定时器: 基于 QueryPerformanceCounter 的绝对截止时刻
+// 每个周期的截止时刻 = 上一截止时刻 + 周期, 不受执行时间累积漂移影响
+typedef struct {
+    LONGLONG llFrequency;       // QPC 频率 [ticks/s]
+    LONGLONG llPeriodTicks;     // 周期长度 [ticks]
+    LONGLONG llSpinTicks;       // 截止前改为忙等的余量 [ticks]
+    LONGLONG llNextDeadline;    // 下一周期的绝对截止时刻 [ticks]
+    LONGLONG llWakeTime;        // 本周期实际唤醒时刻 [ticks]
+    HANDLE hTimer;              // 高精度可等待定时器 (不可用时为 NULL, 退化为忙等)
+} stCycleTimer;
+
+// 周期统计信息
+typedef struct {
+    unsigned long long ullCycles;       // 已执行周期数
+    unsigned long long ullOverruns;     // 超限周期数 (执行结束时已错过下一截止时刻)
+    unsigned long long ullOverrunsReported;  // 已报告的超限周期数 (随统计一起清零)
+    unsigned long long ullSkipped;      // 因超限而跳过的周期数
+    double dLastJitterUs;               // 最近一次唤醒抖动 [us]
+    double dMaxJitterUs;                // 最大唤醒抖动 [us]
+    double dSumJitterUs;                // 唤醒抖动累计值, 用于计算平均值 [us]
+    double dLastExecUs;                 // 最近一次周期内执行时间 [us]
+    double dMaxExecUs;                  // 最大周期内执行时间 [us]
+} stCycleStats;
+
+// 函数声明
+int CycleTimerInit(stCycleTimer* pTimer, double dPeriod);
+void CycleTimerStart(stCycleTimer* pTimer);
+void CycleTimerWait(stCycleTimer* pTimer, stCycleStats* pStats);
+void CycleTimerEndCycle(stCycleTimer* pTimer, stCycleStats* pStats);
+void CycleTimerClose(stCycleTimer* pTimer);
+void CycleStatsReset(stCycleStats* pStats);
+double CycleStatsMeanJitterUs(const stCycleStats* pStats);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef DOUBLE_FORMAT_H
+#define DOUBLE_FORMAT_H
+
+#define DOUBLE_FORMAT_MAX_CHARS 32      // 单个数值输出的最大字符数 (含结尾 '\0')
+
+// 浮点数快速转文本 (Grisu2, 不调用 printf, 不分配内存)
+// - 输出可被 strtod 还原为同一个 double (往返精确), 位数在绝大多数情况下为最短
+// - 格式: 10^-5 <= |x| < 10^21 时为定点 ("0.001234", "12.5", "300"), 否则为科学计数 ("1.5e-7", "2e30");
+//   整数值不带小数点, NaN/无穷输出 "nan"/"inf"/"-inf"
+// - 输出以 '\0' 结尾, 返回值为字符数 (不含 '\0'); pcBuffer 至少 DOUBLE_FORMAT_MAX_CHARS 字节
+
+// 函数声明
+int DoubleFormatShortest(double dValue, char* pcBuffer);
+int DoubleFormatInt(int iValue, char* pcBuffer);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef FEED_OVERRIDE_H
+#define FEED_OVERRIDE_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define FEED_OVERRIDE_MAX 2.0               // 最大倍率 (200%)
+#define FEED_OVERRIDE_SHARE 0.5             // 倍率变化引入的附加加速度/Jerk 占轴约束的比例 (规划时预留)
+
+// 进给倍率 (一组同步轴共用一个状态, 纯计算, 不加锁, 不分配内存, 每周期 O(1))
+// - 倍率 r 作为规划轨迹的时间扭曲 (FourthOrderPlannerSetTimeScale), 改变倍率不重新规划, r = 0 即进给保持;
+//   同步规划的各轴 (CMD 12) 须共用一个状态, 否则各轴时间基不同步
+// - r 以加速度受限、速率受限的二阶跟踪器趋近指令倍率, 每周期输出 r, r', r''
+// - 轨迹按链式法则: v = r*x', a = r^2*x'' + r'*x', j = r^3*x''' + 3*r*r'*x'' + r''*x'
+// - 可被倍率扭曲的轨迹按 FeedOverridePlanningLimits 降低后的约束规划 (R = FEED_OVERRIDE_MAX, s = FEED_OVERRIDE_SHARE):
+//   Vp = V/R, Ap = (1-s)*A/R^2, Jp = (1-s)*J/R^3 (V / A / J 为轴约束), 即 |x'| <= Vp, |x''| <= Ap, |x'''| <= Jp;
+//   r' 上限 s/(1-s)*R^2*min(Ap/Vp, Jp/(6*Ap)), r'' 上限 s/(1-s)*R^3*Jp/(2*Vp), 各比值取组内最严的轴,
+//   故任意 r (0 ~ R) 及其变化下 |v| <= V, |a| <= (1-s)*A + s*A, |j| <= (1-s)*J + s*J/2 + s*J/2
+// - 100% 时轨迹按降低后的约束运行 (速度为轴约束的 1/R), 200% 时达到轴约束
+// - 轨迹静止时 (尚未开始或已结束) 时间扭曲不产生速度/加速度, FeedOverrideSettle 直接取指令倍率
+
+// 进给倍率状态
+typedef struct {
+    double dTarget;         // 指令倍率 [0, FEED_OVERRIDE_MAX]
+    double dRatio;          // 当前倍率 r
+    double dRate;           // [1/s]   r'
+    double dAccel;          // [1/s^2] r'' (本周期的速率变化量 / Ts)
+    double dRateMax;        // [1/s]   r' 上限
+    double dAccelMax;       // [1/s^2] r'' 上限
+    double dAOverV;         // [1/s]   组内各轴规划约束 AMax/VMax 的最小值
+    double dJOverA;         // [1/s]   组内各轴规划约束 JMax/AMax 的最小值
+    double dJOverV;         // [1/s^2] 组内各轴规划约束 JMax/VMax 的最小值
+    double dSampleTime;     // [s] 周期
+} stFeedOverride;
+
+// 函数声明
+void FeedOverridePlanningLimits(const stPlannerInput* pstAxis, stPlannerInput* pstPlan);
+void FeedOverrideAxisLimits(const stPlannerInput* pstPlan, stPlannerInput* pstAxis);
+void FeedOverrideInit(stFeedOverride* pFeed, double dSampleTime);
+int FeedOverrideSetLimits(stFeedOverride* pFeed, const stPlannerInput* pstPlan);
+int FeedOverrideAddLimits(stFeedOverride* pFeed, const stPlannerInput* pstPlan);
+int FeedOverrideSet(stFeedOverride* pFeed, double dRatio);
+void FeedOverrideSettle(stFeedOverride* pFeed);
+void FeedOverrideStep(stFeedOverride* pFeed);
+int FeedOverrideIsActive(const stFeedOverride* pFeed);
+
+#endif
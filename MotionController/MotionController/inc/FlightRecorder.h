@@ -0,0 +1,99 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "AxisConfig.h"
+#include "ThreadControl.h"
+
+#define FLIGHT_RECORDER_MAGIC 0x43455246U   // "FREC" (小端)
+#define FLIGHT_RECORDER_VERSION 1
+#define FLIGHT_RECORDER_HEADER_SIZE 4096    // 头部字节数 (槽区从此偏移开始, 按页对齐)
+#define FLIGHT_RECORDER_FILE "flight_recorder.fdr"          // 控制进程的记录文件 (当前工作目录)
+#define FLIGHT_RECORDER_CRASH_FILE "flight_recorder_crash.fdr"  // 上次未正常关闭时保留的记录
+#define FLIGHT_RECORDER_SECONDS 300         // 默认保留时长 [s] (按采样时间换算槽数)
+#define FLIGHT_RECORDER_MAX_BYTES (256ULL * 1024 * 1024)    // 文件大小上限, 轴数多时相应缩短保留时长
+
+#define FLIGHT_RECORDER_STATE_RUNNING 1     // 写入中 (进程崩溃后文件保持此状态)
+#define FLIGHT_RECORDER_STATE_CLOSED 2      // 已正常关闭
+
+#define FLIGHT_RECORDER_FLAG_SYSTEM_FAULT 0x1U  // 槽标志: 系统故障
+
+// 飞行记录仪 (黑匣子): 固定大小的内存映射文件, 槽区为最近 N 个控制周期的环形缓冲
+// - 控制线程直接写映射内存, 无写入线程、无系统调用; 进程崩溃后已写入的页仍在系统文件缓存中, 由系统落盘
+//   (掉电/系统崩溃不在保证范围内)
+// - 打开时按轴数确定槽大小, 创建定长文件并逐页预写, 使控制循环中不再产生缺页
+// - 第 s 个周期 (序号自 1 起) 写入槽 (s - 1) % 槽数: 先写槽首序号, 再写数据, 最后以释放语义写槽尾序号;
+//   首尾序号相同且等于 s 的槽为完整记录, 不同的为写到一半 (崩溃时) 或正在被覆盖的槽
+// - 打开时若已有文件处于写入中状态 (上次未正常关闭), 先改名为 FLIGHT_RECORDER_CRASH_FILE 保留以供事后分析
+// - 读取端 (FlightRecorderDump) 只读映射文件, 可在写入过程中读取: 按序号复制槽后再校验首尾序号
+
+// 文件头部 (FLIGHT_RECORDER_HEADER_SIZE 字节, 其余部分填零)
+typedef struct {
+    uint32_t uMagic;                // FLIGHT_RECORDER_MAGIC
+    uint32_t uVersion;              // FLIGHT_RECORDER_VERSION
+    uint32_t uHeaderSize;           // FLIGHT_RECORDER_HEADER_SIZE
+    uint32_t uAxisCount;            // 每槽的轴数 (1 ~ MAX_AXIS_COUNT)
+    uint32_t uSlotSize;             // 槽字节数 (FLIGHT_RECORDER_SLOT_SIZE)
+    volatile uint32_t uState;       // FLIGHT_RECORDER_STATE_*
+    uint64_t ullSlotCount;          // 槽数
+    double dSampleTime;             // [s] 控制周期
+    uint64_t ullStartTime;          // 打开时刻 (FILETIME, UTC)
+    uint64_t ullCloseTime;          // 关闭时刻 (FILETIME, UTC, 未正常关闭时为 0)
+} stFlightRecorderHeader;
+
+// 单轴记录 (字段取自 ControlData 与 CSVData, 另加故障位)
+typedef struct {
+    double dTarget;                 // 目标位置
+    double dActual;                 // 实际位置
+    double dError;                  // 跟踪误差
+    double dForce;                  // 控制力
+    int32_t iMode;                  // 控制模式 (CONTROL_MODE_*)
+    uint32_t uFaults;               // 故障位 (u32Fault_GetAxisFaultBits)
+} stFlightAxisRecord;
+
+// 槽 (槽尾序号位于 astAxis[uAxisCount] 之后, 见 FLIGHT_RECORDER_SLOT_END)
+typedef struct {
+    volatile int64_t llSequence;    // 槽首序号 (0 为未写入)
+    int32_t iStep;                  // 控制步号
+    uint32_t uFlags;                // FLIGHT_RECORDER_FLAG_*
+    double dTime;                   // [s] 控制时间
+    stFlightAxisRecord astAxis[1];  // 各轴记录 (实际为 uAxisCount 个)
+} stFlightSlot;
+
+// 记录文件 (写入端仅由控制线程使用; 读取端只读映射)
+typedef struct {
+    HANDLE hFile;
+    HANDLE hMapping;
+    unsigned char* pucView;                 // 映射视图
+    stFlightRecorderHeader* pHeader;
+    unsigned char* pucSlots;                // 槽区
+    int iAxisCount;
+    size_t uSlotSize;
+    uint64_t ullSlotCount;
+    uint64_t ullNextSlot;                   // 下一个写入的槽 (写入端)
+    int64_t llSequence;                     // 已写入的最后一个序号 (写入端)
+    int bWritable;                          // 写入端 (关闭时标记为已正常关闭)
+} stFlightRecorder;
+
+// 槽大小: 槽首 24 字节 + 各轴记录 + 槽尾序号 8 字节
+#define FLIGHT_RECORDER_SLOT_SIZE(iAxisCount) \
+    (offsetof(stFlightSlot, astAxis) + (size_t)(iAxisCount) * sizeof(stFlightAxisRecord) + sizeof(int64_t))
+#define FLIGHT_RECORDER_SLOT_END(pSlot, uSlotSize) \
+    ((volatile int64_t*)((unsigned char*)(pSlot) + (uSlotSize) - sizeof(int64_t)))
+
+// 函数声明
+int FlightRecorderOpen(stFlightRecorder* pRecorder, const char* pszPath, const char* pszCrashPath, int iAxisCount,
+                       double dSampleTime, double dSeconds);
+void FlightRecorderClose(stFlightRecorder* pRecorder);
+void FlightRecorderWrite(stFlightRecorder* pRecorder, int iStep, double dTime, const ControlData* pData,
+                         const int* piMode, const uint32_t* puFaults, uint32_t uFlags);
+int FlightRecorderOpenRead(stFlightRecorder* pRecorder, const char* pszPath);
+int FlightRecorderReadSlot(const stFlightRecorder* pRecorder, int64_t llSequence, stFlightSlot* pSlot);
+int64_t FlightRecorderLastSequence(const stFlightRecorder* pRecorder);
+
+#endif
@@ -5,8 +5,8 @@
  * @brief 本文件定义了实现“逐点式”四阶轨迹规划所需的所有数据结构和函数原型。
  * @brief “逐点式”设计旨在适用于内存有限的嵌入式系统，它通过一个上下文(Context)结构体
  * @brief 来管理状态，使得每次调用都能生成轨迹的下一个数据点，而无需一次性生成并储存整个轨迹数组。
- * @version 1.2
- * @date 2025-10-21
+ * @version 1.5
+ * @date 2026-10-16
  */
 
 #ifndef FOURTHORDERTRAJECTORYPLANNING_H
@@ -29,6 +29,18 @@ typedef struct {
     double dTimeLimit;     // [s]      要求完成运动的限制时间。如果 <= 0，则忽略此约束，计算最优时间。
 } stPlannerInput;
 
+/**
+ * @brief stPlannerInputEx: 带起止速度的规划输入 (运动队列中的衔接段)
+ * @brief 起点不必为 0 位置/静止, 终点速度可不为 0; 速度大小沿位移方向计, 位移可为负。
+ */
+typedef struct {
+    stPlannerInput stLimits;    // 约束与采样周期; dDistance 为有符号位移 (终点 - 起点), dTimeLimit 不使用
+    double dStartPos;           // [m]   起点位置
+    double dStartVel;           // [m/s] 起点速度大小 (0 <= v <= VMax)
+    double dEndVel;             // [m/s] 终点速度大小 (0 <= v <= VMax)
+    double dTimeOffset;         // [s]   首个采样点在本段内的时刻 (0 <= offset < Ts), 使多段衔接处保持采样网格
+} stPlannerInputEx;
+
 /**
  * @brief stTrajectoryPoint: 单一轨迹点的状态数据结构
  * @brief 该结构体用于储存轨迹在某一特定时间点的完整运动学状态。
@@ -54,6 +66,23 @@ typedef struct {
     double dJerk;
 } stSegmentBoundaryState;
 
+#define PLANNER_MAX_SEGMENTS 15  // 加速 7 段 + 匀速 1 段 + 减速 7 段
+
+/**
+ * @brief stTrajectorySegment: 预计算的单个子阶段多项式
+ * @brief 段内 Snap 恒定, 以段起点为 tau=0, 各量为 tau 的多项式, 系数按升幂存储,
+ * @brief 取点时用 Horner 法求值 (例: pos = c0 + tau*(c1 + tau*(c2 + tau*(c3 + tau*c4))))。
+ */
+typedef struct {
+    double dStartTime;     // [s] 段起始时间
+    double dEndTime;       // [s] 段结束时间
+    double dSnap;          // 段内恒定 Snap
+    double adPos[5];       // 位置系数 {x0, v0, a0/2, j0/6, s/24}
+    double adVel[4];       // 速度系数 {v0, a0, j0/2, s/6}
+    double adAcc[3];       // 加速度系数 {a0, j0, s/2}
+    double adJerk[2];      // Jerk 系数 {j0, s}
+} stTrajectorySegment;
+
 /**
  * @brief stPlannerContext: 规划器上下文（状态管理器）
  * @brief 这是“逐点式”规划器的核心。它像一个状态机，储存了轨迹规划的
@@ -69,6 +98,14 @@ typedef struct {
     double dTa;             // [s] 加速度以 dAMax 匀速变化的时间
     double dTv;             // [s] 速度以 dVMax 匀速运动的时间
     double dTotalTime;      // [s] 整个轨迹的总时长
+    double dTdDec, dTjDec, dTaDec; // [s] 减速段的时间分段 (Init 时与加速段相同, InitEx 时两段速度变化量可不同)
+
+    // --- 起止边界 (Init: 0 位置起步, 正向, 零速起止) ---
+    double dStartPos;       // [m] 起点位置 (已计入多项式表与终点)
+    double dDirection;      // 运动方向 (+1 / -1, 已计入多项式表与终点); 边界状态按位移大小记录, 恒为正向
+    double dStartVel;       // [m/s] 起点速度大小
+    double dEndVel;         // [m/s] 终点速度大小
+    double dTimeOffset;     // [s] 第 k 个采样点的时刻为 k * Ts + dTimeOffset
 
     // --- 时间缩放相关的状态 ---
     int bIsTimeScaled;          // 标志位：是否因时间限制严苛而执行了时间缩放 (0=否, 1=是)
@@ -85,9 +122,26 @@ typedef struct {
     stSegmentBoundaryState stDecStateAtBorder[8]; // 儲存減速段 0 到 7 結束時的狀態 (相對於減速段起點)
     stSegmentBoundaryState stConstVelEndState;    // 儲存勻速段結束時的狀態
 
+    // --- 预计算的子阶段多项式表 (跳过时长为 0 的段, 按时间顺序排列) ---
+    stTrajectorySegment astSegment[PLANNER_MAX_SEGMENTS];
+    int iSegmentCount;
+
     // --- 轨迹生成器的当前状态 ---
-    double dCurrentTime;       // [s] 内部计时器，记录下一个待计算点的时间
+    double dCurrentTime;       // [s] 下一个待计算点的时间 (= llSampleIndex * dSampleTime + dTimeOffset, 仅供查看)
+    long long llSampleIndex;   // 下一个待计算点的采样序号, 时间由序号乘采样周期得到, 不累加误差
+    int    iSegmentCursor;     // 当前所在子阶段 (GetNextPoint 时间单调递增, 游标只前进)
     int    bIsFinished;        // 标志位，0表示轨迹未完成，1表示已完成
+
+    // --- 进给倍率时间扭曲 (SetTimeScale 启用后, 取点时刻按倍率累加, 不再由采样序号计算) ---
+    int    bTimeWarped;        // 1: 已启用时间扭曲, 下一个点取在 dWarpTime
+    double dWarpTime;          // [s] 下一个待计算点的轨迹时刻 tau
+    double dTimeScale;         // 倍率 r = dtau/dt (Init 时为 1)
+    double dTimeScaleRate;     // [1/s]   dr/dt
+    double dTimeScaleAccel;    // [1/s^2] d2r/dt2
+
+    // --- 规划开销 (诊断用) ---
+    double dInitUs;            // [us] Init 耗时 (从缓存复制的上下文保留原始求解耗时)
+    int    iSolverIterations;  // Init 中 Newton 迭代次数 (仅 "峰值加速度达不到" 的短行程需要迭代, 其余为闭式解); InitEx 中为峰值速度的二分次数
 } stPlannerContext;
 
 /**
@@ -111,8 +165,23 @@ typedef struct {
     double dAPeak;             // [m/s^2] 实际轨迹的峰值加速度
     double dJPeak;             // [m/s^3] 实际轨迹的峰值 jerk
     int iExitFlag;             // 退出标志 (0: OK, <0: error)
+
+    // --- 规划开销 ---
+    double dInitUs;            // [us] Init 耗时
+    int iSolverIterations;     // Init 中 Newton 迭代次数 (v1.11.0 起取代原二分搜索)
 } stPlannerDiagnostics;
 
+/**
+ * @brief stPlannerTimes: 只求时间分段时的规划结果 (FourthOrderPlannerSolveTimes)
+ */
+typedef struct {
+    double dTotalTime;         // [s] 总时长 (有时间限制时为限制时间)
+    double dTd, dTj, dTa, dTv; // [s] 时间分段 (时间缩放后; 加速段与减速段相同)
+    int    bIsTimeScaled;      // 是否执行了时间缩放
+    double dAlphaScaleFactor;  // 时间缩放因子 alpha (未缩放为 1.0)
+    int    iSolverIterations;  // Newton 迭代次数
+} stPlannerTimes;
+
 
 /**
  * @brief      FourthOrderPlannerInit: 初始化轨迹规划器上下文
@@ -124,6 +193,60 @@ typedef struct {
  */
 stPlannerContext* FourthOrderPlannerInit(const stPlannerInput *pstInput);
 
+/**
+ * @brief      FourthOrderPlannerInitInto: 在调用者提供的上下文中初始化轨迹规划器
+ * @details    与 FourthOrderPlannerInit 计算完全相同, 但不分配内存, 可用于静态存储或上下文池 (实时路径)。
+ *             以此初始化的上下文不得传给 FourthOrderPlannerFree。
+ * @param[in]  pstInput 指向包含所有物理约束的输入参数结构体，不可为 NULL。
+ * @param[out] pContext 调用者提供的上下文存储，不可为 NULL。失败时其内容未定义。
+ * @return     0 - 成功; -1 - 输入无效或规划失败。
+ */
+int FourthOrderPlannerInitInto(const stPlannerInput *pstInput, stPlannerContext *pContext);
+
+/**
+ * @brief      FourthOrderPlannerSolveTimes: 只求时间分段与总时长
+ * @details    与 InitInto 的时间求解相同 (最优时间, 有时间限制时 alpha = T_opt / T_limit), 不计算边界状态与多项式表,
+ *             不写上下文, 可在多个线程中同时调用。总时长与同一输入 InitInto 的 dTotalTime 逐位相同。
+ * @param[in]  pstInput 指向输入参数结构体，不可为 NULL。
+ * @param[out] pTimes 输出的时间分段。
+ * @return     0 - 成功; -1 - 输入无效或求解失败。
+ */
+int FourthOrderPlannerSolveTimes(const stPlannerInput *pstInput, stPlannerTimes *pTimes);
+
+/**
+ * @brief      FourthOrderPlannerInitEx: 规划起止速度非零的衔接段 (不分配内存)
+ * @details    加速 (v0 -> vp)、匀速、减速 (vp -> v1) 三段, 约束与 Init 相同; vp >= max(v0, v1) 取满足位移的最大值
+ *             (二分求解, 至多约 50 次)。起点位置与方向计入多项式表, 取点接口直接输出绝对位置与有符号速度;
+ *             终点输出终点速度。不支持时间限制。v0 = v1 = 0 且位移非负时与 InitInto 的最优时间规划相同。
+ *             以此初始化的上下文不进入 PlannerCache。
+ * @param[in]  pstInputEx 指向带起止条件的输入参数，不可为 NULL。
+ * @param[out] pContext 调用者提供的上下文存储，不可为 NULL。失败时其内容未定义。
+ * @return     0 - 成功; -1 - 输入无效, 或位移不足以完成 v0 -> v1 的速度变化。
+ */
+int FourthOrderPlannerInitEx(const stPlannerInputEx *pstInputEx, stPlannerContext *pContext);
+
+/**
+ * @brief      FourthOrderPlannerMaxEndVelocity: 由起点速度在给定位移内可达的最大终点速度
+ * @details    即 InitEx 可行、且不超过 dEndVelCap (及 VMax) 的最大终点速度。速度变化段的位移关于起止速度对称,
+ *             交换两端即得 "能在该位移内变到 dStartVel 的最大起点速度", 用于前瞻的反向速度传播。
+ *             Jerk/Snap 受限时可达终点速度关于起点速度不单调 (起点越快, 同样的速度变化走过的位移越长),
+ *             速度上限低于起点速度时可行终点速度可能不连续, 本函数返回其中不超过上限的最大值。
+ * @param[in]  pstLimits 约束, dDistance 取绝对值作为位移。
+ * @param[in]  dStartVel 起点速度大小。
+ * @param[in]  dEndVelCap 终点速度上限。
+ * @return     终点速度大小; 不存在可行的终点速度或参数无效时返回 -1。
+ */
+double FourthOrderPlannerMaxEndVelocity(const stPlannerInput *pstLimits, double dStartVel, double dEndVelCap);
+
+/**
+ * @brief      FourthOrderPlannerStopDistance: 由起点速度减速到静止所需的最短位移
+ * @details    即 InitEx (dEndVel = 0) 可行的最小位移, 以该位移规划时无匀速段。用于衔接段规划失败时的减速停止。
+ * @param[in]  pstLimits 约束 (dDistance 不使用)。
+ * @param[in]  dStartVel 起点速度大小。
+ * @return     位移 (非负); 参数无效时返回 -1。
+ */
+double FourthOrderPlannerStopDistance(const stPlannerInput *pstLimits, double dStartVel);
+
 /**
  * @brief         FourthOrderPlannerGetNextPoint: 获取轨迹的下一个数据点
  * @details       这是轨迹规划的第二步。在一个循环中重复调用此函数，每次调用都会计算出轨迹上下一个时间点的完整运动学状态。
@@ -134,6 +257,82 @@ stPlannerContext* FourthOrderPlannerInit(const stPlannerInput *pstInput);
  */
 int FourthOrderPlannerGetNextPoint(stPlannerContext *pContext, stTrajectoryPoint *pPointOutput);
 
+/**
+ * @brief         FourthOrderPlannerGenerateBlock: 成批生成后续轨迹点 (数组结构体输出)
+ * @details       从上下文当前进度开始, 按子阶段分块在紧凑循环中求值, 连续写出至多 iMaxPoints 个点;
+ *                与 GetNextPoint 共享游标和采样序号, 两者可交替调用。终点包含在输出中, 写出终点后轨迹完成。
+ *                输出数组可为 NULL 以跳过该量 (如只需位置)。点 i 的时间为 (起始序号 + i) * dSampleTime。
+ *                与逐点输出使用相同的多项式与段判定: 严格浮点模型下逐位一致; 若编译器把乘加收缩为 FMA
+ *                (如 /fp:fast), 与逐点输出的差异不超过各量峰值的 1e-12 (相对)。
+ * @param[in,out] pContext 指向已初始化的上下文结构体。
+ * @param[in]     iMaxPoints 本次最多写出的点数。
+ * @param[out]    pdPos, pdVel, pdAcc, pdJerk 输出数组 (长度至少 iMaxPoints), 可为 NULL。
+ * @return        实际写出的点数; 轨迹已完成或参数无效时返回 0。
+ */
+int FourthOrderPlannerGenerateBlock(stPlannerContext *pContext, int iMaxPoints,
+                                    double *pdPos, double *pdVel, double *pdAcc, double *pdJerk);
+
+/**
+ * @brief         FourthOrderPlannerSetTimeScale: 设置进给倍率 (时间扭曲), 在下一次 GetNextPoint 起生效
+ * @details       首次调用时从当前采样时刻切换为扭曲时间基: 每输出一个点, 轨迹时刻前进 (r + r'*Ts/2) * Ts (r = 0 时停在原处),
+ *                不重新求解。输出按链式法则换算到实际时间: v = r*x', a = r^2*x'' + r'*x',
+ *                j = r^3*x''' + 3*r*r'*x'' + r''*x', Snap 忽略 r''' 项; 位置不变, 轨迹形状不变。
+ *                倍率恒定时各阶导数为原轨迹的 r, r^2, r^3 倍; 倍率变化引入的附加项由调用者限制 r' 与 r''
+ *                (见 FeedOverride.h)。启用后 GenerateBlock 逐点输出, IsAtEnd 按扭曲时刻判定;
+ *                GetEndOffset 仍按采样网格计算, 衔接段改用 InheritTimeWarp。
+ * @param[in,out] pContext 指向已初始化的上下文结构体。
+ * @param[in]     dScale 倍率 r (>= 0)。
+ * @param[in]     dScaleRate 倍率变化率 r' [1/s]。
+ * @param[in]     dScaleAccel 倍率二阶导数 r'' [1/s^2]。
+ * @return        0 - 成功; 1 - 参数为 NULL 或倍率无效。
+ */
+int FourthOrderPlannerSetTimeScale(stPlannerContext *pContext, double dScale, double dScaleRate, double dScaleAccel);
+
+/**
+ * @brief      FourthOrderPlannerInheritTimeWarp: 衔接段继承上一段的时间扭曲
+ * @details    上一段 IsAtEnd 后切换到下一段时调用: 下一段的首个点取在上一段扭曲时刻超出总时长的部分,
+ *             并沿用上一段的倍率, 衔接处不丢失也不重复轨迹时间。上一段未启用时间扭曲时不做任何事。
+ * @param[in,out] pNext 下一段上下文 (尚未取点)。
+ * @param[in]     pPrev 上一段上下文。
+ */
+void FourthOrderPlannerInheritTimeWarp(stPlannerContext *pNext, const stPlannerContext *pPrev);
+
+/**
+ * @brief      FourthOrderPlannerGetPointAt: 随机访问任意时刻的轨迹点
+ * @details    与 GetNextPoint 使用同一张子阶段多项式表, 二分查找所在段, 不修改上下文的游标与计时状态。
+ *             dTime <= 0 返回起点, dTime >= 总时长返回终点。
+ * @param[in]  pContext 指向已初始化的上下文结构体。
+ * @param[in]  dTime 查询时刻 [s]。
+ * @param[out] pPointOutput 输出的轨迹点。
+ * @return     0 - 成功; 1 - 参数为 NULL。
+ */
+int FourthOrderPlannerGetPointAt(const stPlannerContext *pContext, double dTime, stTrajectoryPoint *pPointOutput);
+
+/**
+ * @brief      FourthOrderPlannerIsAtEnd: 下一次 GetNextPoint 是否输出终点 (或轨迹已完成)
+ * @details    与 GetNextPoint 的终点判定相同。衔接段可在此时切换到下一段, 以下一段的首个采样代替本段终点。
+ * @return     1 - 是 (或参数为 NULL); 0 - 否。
+ */
+int FourthOrderPlannerIsAtEnd(const stPlannerContext *pContext);
+
+/**
+ * @brief      FourthOrderPlannerGetEndOffset: 终点采样时刻超出总时长的部分
+ * @details    GetNextPoint 输出终点的采样时刻减去总时长 (落在 [0, Ts) 内); 作为下一段的 dTimeOffset,
+ *             下一段的首个采样即落在本段终点采样的时刻, 衔接处不丢失也不重复采样。
+ * @return     偏移 [s]; 参数为 NULL 时返回 0。
+ */
+double FourthOrderPlannerGetEndOffset(const stPlannerContext *pContext);
+
+/**
+ * @brief      FourthOrderPlannerGetDiagnostics: 获取规划结果的诊断信息
+ * @details    由 Init 预计算的边界状态解析求出有效约束 (alpha 缩放后) 与速度/加速度/Jerk 峰值, 不采样轨迹,
+ *             不修改上下文; 同时返回 Init 耗时与迭代次数, 用于发现规划偏慢的运动。
+ * @param[in]  pContext 指向已初始化的上下文结构体。
+ * @param[out] pDiagnostics 输出的诊断信息。
+ * @return     0 - 成功; 1 - 参数为 NULL。
+ */
+int FourthOrderPlannerGetDiagnostics(const stPlannerContext *pContext, stPlannerDiagnostics *pDiagnostics);
+
 /**
  * @brief      FourthOrderPlannerFree: 释放规划器上下文所占用的内存
  * @details    这是轨迹规划的最后一步。当轨迹生成完毕后，应调用此函数来释放`FourthOrderPlannerInit` 函数所分配的内存。
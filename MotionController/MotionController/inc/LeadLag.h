@@ -0,0 +1,12 @@
+#ifndef LEAD_LAG_H
+#define LEAD_LAG_H
+
+#include "SosCascade.h"
+
+// 超前/滞后环节: C(s) = (s/wz + 1) / (s/wp + 1), 直流增益为1
+// 零点频率低于极点频率时为超前环节, 反之为滞后环节
+
+// 函数声明
+void LeadLagDesignSos(double dZeroFreq, double dPoleFreq, double sample_time, stSosSection* pSection);
+
+#endif
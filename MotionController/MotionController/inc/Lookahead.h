@@ -0,0 +1,46 @@
+#ifndef LOOKAHEAD_H
+#define LOOKAHEAD_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define LOOKAHEAD_WINDOW 16     // 前瞻窗口: 最多缓存的未提交目标点数
+
+// 单轴前瞻规划 (纯计算, 不加锁, 不分配内存; 运动队列与离线工具共用)
+// - 输入为目标位置序列, 每个目标点带本段约束; 相邻目标点之间为一段, 由 FourthOrderPlannerInitEx 规划
+// - 假设在窗口最后一个目标点停止, 追加目标点时反向传播各目标点处的可行速度上限
+//   (仍能在后续已知目标点内减速停止的最大速度, 某点上限不变时更早的点也不变, 传播即停止);
+//   提交窗口首段时取由已提交终点速度可达、且不超过该上限的最大终点速度; 运动方向反向的目标点处速度为 0
+// - Jerk/Snap 受限时可达速度关于起点速度不单调, 故各目标点处传播的是可行速度区间 [0, 上限] 而非单个速度;
+//   之后追加的目标点只会扩大可行区间, 已提交段始终能在已知目标点停止, 后续提交总有可行解
+// - 各段的时间偏移取上一段的终点偏移, 逐段衔接时采样网格连续
+// - 首段规划失败 (数值原因) 时可用 LookaheadCommitStop 从已提交终点沿原方向以最短位移减速停止,
+//   已提交终点速度不超过首个目标点处的可行速度上限, 停止位置不越过首个目标点
+
+// 目标点
+typedef struct {
+    double dTarget;             // [m] 目标位置 (绝对)
+    stPlannerInput stLimits;    // 到达该点的一段所用约束 (dDistance / dTimeLimit 不使用)
+    double dMaxVel;             // [m/s] 该点处的可行速度上限 (追加目标点时反向更新)
+} stLookaheadTarget;
+
+// 前瞻状态
+typedef struct {
+    stLookaheadTarget astTarget[LOOKAHEAD_WINDOW];  // 未提交的目标点 (环形)
+    int iHead;                  // 最早的未提交目标点
+    int iCount;                 // 未提交目标点数
+    double dPos;                // [m] 已提交轨迹的终点位置
+    double dVel;                // [m/s] 已提交轨迹的终点速度 (有符号)
+    double dTimeOffset;         // [s] 下一段的时间偏移
+    double dSampleTime;         // [s] 采样周期 (由 Reset 后的首个目标点确定, 之后的目标点须相同)
+    unsigned long long ullSegments;                 // 已提交段数
+    double dCommittedTime;      // [s] 已提交段的总时长
+} stLookahead;
+
+// 函数声明
+void LookaheadReset(stLookahead* pLookahead, double dStartPos);
+int LookaheadPush(stLookahead* pLookahead, double dTarget, const stPlannerInput* pstLimits);
+int LookaheadCount(const stLookahead* pLookahead);
+int LookaheadCommit(stLookahead* pLookahead, stPlannerContext* pContext);
+int LookaheadCommitStop(stLookahead* pLookahead, stPlannerContext* pContext);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef LOWPASSFILTER_H
 #define LOWPASSFILTER_H
 
+#include "SosCascade.h"
+
 // 二阶低通滤波器结构体
 typedef struct {
     // 滤波器系数
@@ -19,5 +21,6 @@ void LowPassFilterInit(LowPassFilter* lpf, double cutoff_freq, double damping, d
 double LowPassFilterUpdate(LowPassFilter* lpf, double input);
 void LowPassFilterReset(LowPassFilter* lpf);
 double LowPassFilterGetOutput(LowPassFilter* lpf);
+void LowPassFilterDesignSos(double cutoff_freq, double damping, double sample_time, stSosSection* pSection);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef MOTION_QUEUE_H
+#define MOTION_QUEUE_H
+
+#include "AxisConfig.h"
+#include "FourthOrderTrajectoryPlanning.h"
+#include "Lookahead.h"
+#include "SpscRing.h"
+
+#define MOTION_QUEUE_INBOX_CAPACITY 64  // 每轴待规划指令容量 (2 的幂)
+#define MOTION_QUEUE_READY_CAPACITY 16  // 每轴已规划段容量 (2 的幂)
+#define MOTION_QUEUE_MIN_READY 4        // 已规划段少于此数时不等窗口满即提交 (防止欠载)
+
+// 前瞻运动队列 (每轴一个)
+// - 控制线程以 Begin / PushTarget / End 提交一个目标点序列 (运动程序), 立即返回;
+//   规划线程经 Lookahead 逐段规划衔接段 (段间速度不为 0), 上下文取自 PlannerPool
+// - 程序在窗口填满或程序结束后开始执行; 之后已规划段少于 MOTION_QUEUE_MIN_READY 时即使窗口未满也提交,
+//   因 Lookahead 始终保证能在已知目标点停止, 客户端供点不及时只会减速停止而不会越过目标
+// - 控制线程每周期经 MotionQueueSelect 在当前段即将输出终点时切换到下一段, 切换不等待、不分配内存;
+//   已执行完的段归还 PlannerPool
+// - 控制线程 -> 规划线程、规划线程 -> 控制线程各为一个 SpscRing, 两端均无锁;
+//   就绪队列中的 NULL 表示程序结束
+// - Abort 用于其他轨迹 (在线轨迹) 从当前参考接管: 规划线程丢弃未提交的目标点并送出结束标记,
+//   控制线程在 Select 中归还其间收到的已规划段, 不再切换; 当前段由调用者替换后按程序结束后的规则归还
+
+// 运动队列统计信息 (控制线程读取)
+typedef struct {
+    int bActive;                        // 1: 程序执行中 (Begin 之后到最后一段切出之前)
+    LONG lReady;                        // 已规划未执行的段数
+    unsigned long long ullTargets;      // 已接受的目标点数
+    unsigned long long ullSegments;     // 已切换执行的段数
+    unsigned long long ullUnderruns;    // 当前段以非零速度结束时下一段尚未就绪的次数
+    LONG lPlanFailures;                 // 规划失败次数 (失败时减速停止, 丢弃未规划的目标点并结束程序)
+} stMotionQueueStats;
+
+// 函数声明
+void MotionQueueInit(void (*pfnWake)(void));
+int MotionQueueBegin(int iAxis, double dStartPos);
+int MotionQueuePushTarget(int iAxis, double dTarget, const stPlannerInput* pstLimits);
+int MotionQueueEnd(int iAxis);
+int MotionQueueAbort(int iAxis);
+int MotionQueueIsActive(int iAxis);
+stPlannerContext* MotionQueueSelect(int iAxis, stPlannerContext* pCurrent);
+void MotionQueueGetStats(int iAxis, stMotionQueueStats* pStats);
+int MotionQueueService(void);
+
+#endif
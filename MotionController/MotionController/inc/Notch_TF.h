@@ -1,6 +1,8 @@
 #ifndef NOTCH_TF_H
 #define NOTCH_TF_H
 
+#include "SosCascade.h"
+
 typedef struct {
     // 系统状态变量
     double dOutPrev[2];  // 输出历史值
@@ -22,5 +24,6 @@ typedef struct {
 void NotchTFInit(SNotchTF* psFilter,double NotchFreq,double NotchFreqPole,double NotchDampZero,double samNotchDampPole,double sample_time);
 double NotchTFUpdate(SNotchTF* psFilter, double dInput);
 void NotchTFReset(SNotchTF* psFilter);
+void NotchTFDesignSos(double NotchFreq, double NotchFreqPole, double NotchDampZero, double NotchDampPole, double sample_time, stSosSection* pSection);
 
 #endif 
\ No newline at end of file
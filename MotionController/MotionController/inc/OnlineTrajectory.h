@@ -0,0 +1,59 @@
+#ifndef ONLINE_TRAJECTORY_H
+#define ONLINE_TRAJECTORY_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define ONLINE_TRAJ_MAX_WINDOW 1024     // 滑动平均窗口的最大采样数 (Ts = 1ms 时约 1s)
+                                        // 两个窗口固定占 2*1024*8 = 16KB, 每轴一个状态 (64 轴约 1MB)
+
+// 在线轨迹生成 (单轴, 纯计算, 不加锁, 不分配内存, 每周期 O(1))
+// - 目标可在任意周期修改 (点动、摇杆、视觉伺服), 参考轨迹从当前状态连续过渡, 不重新从零状态规划
+// - 结构: 加速度受限的离散跟踪器 (速度 <= VMax, 每步速度变化 <= AMax*Ts, 按离散制动距离精确落点)
+//   + 两级滑动平均 (长度 n1 >= 2*AMax/(JMax*Ts), n2 >= 2*JMax/(DMax*Ts));
+//   滑动平均的各阶差分为输入差分的窗口均值, 不放大速度/加速度上限, 再各增加一阶:
+//   Jerk <= (加速度变化范围 2*AMax) / (n1*Ts), Snap <= (Jerk 变化范围 2*JMax) / (n2*Ts)
+// - 任意时刻改变目标或 VMax, 输出的速度、加速度、Jerk、Snap (采样差分) 均不超过约束;
+//   代价是相比闭式规划多出约 (n1 + n2) 个采样的滞后, 且不追求时间最优
+// - 滞后由约束决定: 缺省约束 AMax = 2, JMax = 10, DMax = 200, Ts = 1ms 时 n1 = 400, n2 = 100,
+//   输出比跟踪器固定滞后约 0.5s (摇杆松开后仍会继续运动约 0.25s 的平均滞后距离);
+//   提高 JMax / DMax 可缩短窗口和滞后, 窗口超过 ONLINE_TRAJ_MAX_WINDOW 时 Init 失败
+// - 可从静止 (Init) 或运动中的状态 (InitFrom, 位置/速度/加速度连续) 开始
+// - 闭式四阶规划只能从零加速度/零 Jerk 出发, 任意状态的时间最优解需要迭代求解, 耗时无界, 故不采用
+// - 跟踪器落点后连续 n1 + n2 个采样静止即判定到位, 输出精确等于目标 (同时清除滑动和的累计舍入)
+
+// 在线轨迹状态
+typedef struct {
+    stPlannerInput stLimits;    // 约束 (AMax / JMax / DMax / Ts 在 Init 时确定窗口长度, dDistance / dTimeLimit 不使用)
+    double dTarget;             // [m] 当前目标位置
+    double dVMax;               // [m/s] 当前速度上限 (不超过 stLimits.dVMax)
+    double dPos0;               // [m] 跟踪器位置
+    double dVel0;               // [m/s] 跟踪器速度
+    double adWindow1[ONLINE_TRAJ_MAX_WINDOW];       // 第一级滑动平均的输入 (环形)
+    double adWindow2[ONLINE_TRAJ_MAX_WINDOW];       // 第二级滑动平均的输入 (环形)
+    int iLen1;                  // 第一级窗口长度 n1
+    int iLen2;                  // 第二级窗口长度 n2
+    int iIndex1;
+    int iIndex2;
+    double dSum1;
+    double dSum2;
+    int iRestSteps;             // 跟踪器静止在目标点的连续采样数
+    long long llSampleIndex;    // 已输出的采样数
+    stTrajectoryPoint stLast;   // 上一输出点 (速度及以上各阶为后向差分)
+
+    // 统计
+    unsigned long long ullRetargets;    // 目标修改次数
+    double dLastStepUs;                 // [us] 最近一次 Step 耗时
+    double dMaxStepUs;                  // [us] Step 最大耗时
+    double dSumStepUs;                  // [us] Step 耗时累计
+} stOnlineTrajectory;
+
+// 函数声明
+int OnlineTrajectoryInit(stOnlineTrajectory* pOnline, double dStartPos, const stPlannerInput* pstLimits);
+int OnlineTrajectoryInitFrom(stOnlineTrajectory* pOnline, const stTrajectoryPoint* pStart,
+                             const stPlannerInput* pstLimits);
+int OnlineTrajectorySetTarget(stOnlineTrajectory* pOnline, double dTarget, double dVMax);
+void OnlineTrajectoryStop(stOnlineTrajectory* pOnline);
+void OnlineTrajectoryStep(stOnlineTrajectory* pOnline, stTrajectoryPoint* pPointOutput);
+int OnlineTrajectoryIsSettled(const stOnlineTrajectory* pOnline);
+
+#endif
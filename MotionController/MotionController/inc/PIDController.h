@@ -1,6 +1,8 @@
 #ifndef PIDCONTROLLER_H
 #define PIDCONTROLLER_H
 
+#include "SosCascade.h"
+
 // PID控制器结构体;
 typedef struct {
     // PID增益参数
@@ -8,6 +10,10 @@ typedef struct {
     double ki;  // 积分增益
     double kd;  // 微分增益
     double sample_time;  // 采样时间
+
+    // 预先计算的积分/微分输入增益 (由 PIDControllerSetGains 更新)
+    double dFiGain;      // kp*ki*2π*Ts/2
+    double dFdGain;      // kp/kd/(2π)*2/Ts
     
     // 积分部分历史值
     double dFiInPrev[2];
@@ -22,5 +28,7 @@ typedef struct {
 void PIDControllerInit(PIDController* pid, double kp, double ki, double kd, double sample_time);
 double PIDControllerUpdate(PIDController* pid, double error);
 void PIDControllerReset(PIDController* pid);
+void PIDControllerSetGains(PIDController* pid, double kp, double ki, double kd);
+void PIDControllerDesignSos(double kp, double ki, double kd, double sample_time, stSosSection* pSection);
 
 #endif
\ No newline at end of file
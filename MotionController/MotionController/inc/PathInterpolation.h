@@ -0,0 +1,52 @@
+#ifndef PATH_INTERPOLATION_H
+#define PATH_INTERPOLATION_H
+
+#include <stdint.h>
+#include "AxisConfig.h"
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define PATH_TYPE_LINE 0            // 多轴直线
+#define PATH_TYPE_ARC 1             // 两轴平面内的圆弧 (含整圆)
+#define PATH_ARC_NORMAL_SHARE 0.5   // 圆弧向心加速度占加速度约束的比例
+#define PATH_ARC_RADIUS_TOL 1e-6    // 终点到圆心距离与半径之差的相对容差
+
+// 多轴路径插补 (控制线程使用, 不加锁, 不分配内存)
+// - 在路径长度 s 上运行四阶规划 (FourthOrderPlannerInitInto), 每周期取一个路径点 (s, s', s'', s''')
+//   并投影到各参与轴; 客户端只发送一条路径指令, 不再逐点流式发送各轴位置
+// - 参与轴按数组结构体存放 (起点、方向连续), 直线投影为对各轴的同一乘加, 便于编译器向量化
+// - 直线: 约束即路径 (合成) 约束, 各轴分量不超过约束
+// - 圆弧: 向心加速度 s'^2/R 占 share*A, 切向规划取 (1-share)*A 与 (1-share)*J, 路径速度再取
+//   min(V, sqrt(share*A*R), share*J*R/(3*(1-share)*A)); 合成加速度 <= A,
+//   法向 Jerk 3*s'*s''/R <= share*J, 切向 Jerk <= (1-share)*J + share^2*J/(3*(1-share)) (share = 0.5 时合成 <= 0.83*J)
+// - 路径规划器的上下文可接受进给倍率 (FourthOrderPlannerSetTimeScale)
+// - 后续可在此基础上增加多段折线 (各段共用同一投影方式)
+
+// 路径插补状态
+typedef struct {
+    int iType;                              // PATH_TYPE_*
+    int iAxisCount;                         // 参与轴数
+    int aiAxis[MAX_AXIS_COUNT];             // 参与轴号 (直线按轴号升序; 圆弧为 X, Y)
+    double adOrigin[MAX_AXIS_COUNT];        // 起点 (按参与顺序)
+    double adDir[MAX_AXIS_COUNT];           // 直线单位方向 (按参与顺序)
+    double adEnd[MAX_AXIS_COUNT];           // 终点 (按参与顺序, 完成时精确输出)
+    double dCenterX, dCenterY;              // 圆心
+    double dRadius;                         // 半径
+    double dStartAngle;                     // 起点相位 [rad]
+    double dSweepSign;                      // +1 逆时针, -1 顺时针
+    double dLength;                         // 路径长度
+    stPlannerInput stPathLimits;            // 路径长度上的规划约束
+    stPlannerContext stContext;             // 路径长度上的四阶规划
+    stTrajectoryPoint stPathPoint;          // 最近一次路径点
+    double adPos[MAX_AXIS_COUNT];           // 最近一次各参与轴位置 (按参与顺序)
+    double adVel[MAX_AXIS_COUNT];           // 最近一次各参与轴速度 (按参与顺序)
+} stPathInterp;
+
+// 函数声明
+int PathInterpInitLine(stPathInterp* pPath, uint64_t ullAxisMask, const double* pdStart, const double* pdEnd,
+                       const stPlannerInput* pstLimits);
+int PathInterpInitArc(stPathInterp* pPath, int iAxisX, int iAxisY, const double* pdStart, double dEndX, double dEndY,
+                      double dCenterX, double dCenterY, int iDirection, const stPlannerInput* pstLimits);
+int PathInterpStep(stPathInterp* pPath);
+int PathInterpIsFinished(const stPathInterp* pPath);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef PLANNER_BATCH_H
+#define PLANNER_BATCH_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define PLANNER_BATCH_CHUNK 1024            // 每个线程池任务处理的运动数
+#define PLANNER_BATCH_CHUNKS_PER_THREAD 2   // 每个参与线程至少分到的任务数
+
+// 批量规划 (节拍估算): 对大量点到点运动只求时间分段与总时长 (FourthOrderPlannerSolveTimes)
+// - 输入为 stPlannerInput 数组, 输出按数组结构体存放 (总时长与各时间分段各一个连续数组), 均由调用者提供,
+//   引擎不分配内存
+// - 运动按 PLANNER_BATCH_CHUNK 分块, 由 ThreadPoolParallelFor 分给全部工作线程及调用线程;
+//   各运动互相独立, 结果与逐个调用 InitInto 的 dTotalTime 逐位相同
+// - 用于离线预处理; 与 PlannerGroup 共用线程池, 不可在规划线程运行期间调用 (线程池不可重入)
+
+// 批量规划的输入输出 (数组长度均为 iCount; 输出数组可为 NULL 以跳过该量)
+typedef struct {
+    int iCount;                     // 运动数
+    const stPlannerInput* pstInput; // 输入
+    double* pdTotalTime;            // [s] 总时长 (失败时为 -1)
+    double* pdTd;                   // [s] 时间分段 (加速段与减速段相同)
+    double* pdTj;
+    double* pdTa;
+    double* pdTv;
+    double* pdAlpha;                // 时间缩放因子
+} stPlannerBatch;
+
+// 批量规划的汇总结果
+typedef struct {
+    double dSumTime;                // [s] 成功运动的总时长之和 (节拍估算)
+    int iFailed;                    // 失败的运动数
+    int iFirstFailed;               // 第一个失败的运动 (-1: 无)
+    double dElapsedUs;              // [us] 总耗时
+    double dMovesPerSecond;         // 吞吐量
+} stPlannerBatchResult;
+
+// 函数声明
+int PlannerBatchPlan(const stPlannerBatch* pBatch, stPlannerBatchResult* pResult);
+
+#endif
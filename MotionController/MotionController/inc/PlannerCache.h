@@ -0,0 +1,37 @@
+#ifndef PLANNER_CACHE_H
+#define PLANNER_CACHE_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define PLANNER_CACHE_CAPACITY 512              // 缓存条目数 (每条约 3KB)
+#define PLANNER_CACHE_BUCKETS 1024              // 哈希桶数 (2 的幂, 不小于容量)
+#define PLANNER_CACHE_VERSION 4                 // 持久化格式版本, 规划算法或上下文布局变化时递增
+#define PLANNER_CACHE_FILE "planner_cache.bin"  // 默认持久化文件
+
+// 规划结果缓存 (LRU)
+// - 以规范化后的 stPlannerInput 为键, 缓存 Init 刚完成 (尚未取点) 的完整上下文
+// - 命中时复制上下文即可, 无需重新求解; 未命中时由调用者 Init 后插入
+// - 键规范化: -0.0 视为 0.0, dTimeLimit <= 0 (不限时) 统一为 0; 其余字段按位比较, 不做容差匹配
+// - 哈希为规范化键的 FNV-1a (64 位), 命中需键完全相等
+// - 仅规划线程 (及其启动前的初始化阶段) 访问, 不加锁; 统计信息可跨线程读取, 为近似值
+// - 可持久化到文件, 重启后加载即可直接命中; 文件头记录格式版本与上下文大小, 不匹配时整体丢弃
+
+// 缓存统计信息
+typedef struct {
+    unsigned long long ullHits;         // 命中次数
+    unsigned long long ullMisses;       // 未命中次数
+    unsigned long long ullInserts;      // 插入次数
+    unsigned long long ullEvictions;    // 淘汰次数 (缓存满时移除最久未使用的条目)
+    int iEntries;                       // 当前条目数
+    int iLoaded;                        // 启动时从文件加载的条目数
+} stPlannerCacheStats;
+
+// 函数声明
+void PlannerCacheInit(void);
+int PlannerCacheLookup(const stPlannerInput* pstInput, stPlannerContext* pContext);
+void PlannerCacheInsert(const stPlannerInput* pstInput, const stPlannerContext* pContext);
+void PlannerCacheGetStats(stPlannerCacheStats* pStats);
+int PlannerCacheSave(const char* pszPath);
+int PlannerCacheLoad(const char* pszPath);
+
+#endif
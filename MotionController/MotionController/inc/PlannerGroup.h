@@ -0,0 +1,32 @@
+#ifndef PLANNER_GROUP_H
+#define PLANNER_GROUP_H
+
+#include <stdint.h>
+#include "AxisConfig.h"
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define PLANNER_GROUP_AXES_PER_THREAD 8     // 每个参与线程至少分到的轴数 (单轴 Init 仅数 us)
+
+// 多轴同步规划 (共同结束时间)
+// 1. 各轴以 dTimeLimit = 0 并行求最优时间 T_i
+// 2. 共同时间 T = max(max T_i, max dTimeLimit_i) (dTimeLimit 可用于整体放慢)
+// 3. T_i 不等于 T 的轴以 dTimeLimit = T 并行重新规划 (alpha = T_i / T 的时间缩放), 零位移轴以零速停留到 T
+// 每轴两次 Init 均为闭式解 (短行程至多 60 次 Newton), 并行部分由 ThreadPoolParallelFor 完成, 耗时有界;
+// 不分配内存, 不访问 PlannerCache (缓存仅限规划线程串行访问)
+// 仅规划线程 (及其启动前的初始化阶段) 调用, 不可重入
+
+// 同步规划结果
+typedef struct {
+    double dCommonTime;     // [s] 共同结束时间
+    int iSlowestAxis;       // 决定共同时间的轴 (-1: 由 dTimeLimit 决定)
+    int iScaledAxes;        // 被时间缩放的轴数
+    int iFailedAxis;        // 规划失败的轴 (-1: 无)
+    int bPoolTimeout;       // 线程池等待超时, 各轴结果作废 (iFailedAxis 为 -1)
+    double dPlanUs;         // [us] 总耗时
+} stPlannerGroupResult;
+
+// 函数声明
+int PlannerGroupPlan(uint64_t ullAxisMask, const stPlannerInput* astInput,
+                     stPlannerContext* const* apContext, stPlannerGroupResult* pResult);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PLANNER_POOL_H
+#define PLANNER_POOL_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include "AxisConfig.h"
+#include "FourthOrderTrajectoryPlanning.h"
+
+#define PLANNER_POOL_QUEUE_RESERVE 512  // 各轴运动队列共享的段上下文 (单轴至多 MOTION_QUEUE_READY_CAPACITY + 2 个, 池空时稍后重试)
+#define PLANNER_POOL_CAPACITY (2 * MAX_AXIS_COUNT + PLANNER_POOL_QUEUE_RESERVE)    // 每轴双缓冲 + 运动队列
+
+// 规划上下文池
+// - 固定容量, 存储为静态区, 启动时一次性建立空闲链表, 之后不调用分配器
+// - 空闲链表为 Windows SList (无锁 LIFO), 任意线程均可获取/归还
+// - 上下文以 FourthOrderPlannerInitInto 初始化, 不得传给 FourthOrderPlannerFree
+
+// 上下文池统计信息 (跨线程读取, 为近似值)
+typedef struct {
+    LONG lCapacity;                     // 容量
+    LONG lInUse;                        // 当前已获取的上下文数
+    LONG lMaxInUse;                     // 已获取上下文数的峰值
+    LONG lExhausted;                    // 池空导致获取失败的次数
+} stPlannerPoolStats;
+
+// 函数声明
+void PlannerPoolInit(void);
+stPlannerContext* PlannerPoolAcquire(void);
+void PlannerPoolRelease(stPlannerContext* pContext);
+void PlannerPoolGetStats(stPlannerPoolStats* pStats);
+
+#endif
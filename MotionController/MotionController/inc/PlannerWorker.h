@@ -0,0 +1,74 @@
+#ifndef PLANNER_WORKER_H
+#define PLANNER_WORKER_H
+
+#include "AxisConfig.h"
+#include "FourthOrderTrajectoryPlanning.h"
+#include "SpscRing.h"
+#include "PlannerGroup.h"
+
+#define PLANNER_REQUEST_CAPACITY 256            // 规划请求队列容量 (2 的幂)
+#define PLANNER_RESULT_CAPACITY MAX_AXIS_COUNT  // 规划结果队列容量 (每轴至多一个未应用结果)
+#define PLANNER_GROUP_REQUEST (-1)              // 请求中的轴号取此值表示多轴同步规划
+
+// 轨迹规划工作线程
+// - 控制线程提交规划请求后立即返回, 规划在工作线程中执行
+// - 每轴两个上下文槽 (双缓冲, 启动时从 PlannerPool 获取): 控制线程读取当前槽, 工作线程以 InitInto 直接写入后备槽,
+//   启动后的规划路径不调用分配器
+// - 工作线程写完后备槽后经结果队列通知控制线程, 控制线程在周期边界一次性切换当前槽,
+//   控制循环不等待规划也不调用分配器
+// - 后备槽在结果被控制线程应用前不会被再次写入 (同一轴的后续请求在工作线程中排队等待)
+// - 多轴同步规划 (PlannerGroup, 共同结束时间) 的输入经单独的缓冲区传递, 请求队列中只放标记请求以保持先后顺序;
+//   结果覆盖全部参与轴, 控制线程在同一周期边界一并切换
+// - 规划前先查 PlannerCache, 命中时直接复制缓存的上下文 (缓存仅由工作线程及启动阶段访问)
+// - 工作线程同时服务各轴的前瞻运动队列 (MotionQueue): 每轮处理一条请求后调用 MotionQueueService;
+//   以及轨迹文件的后台打开/映射/关闭 (TrajectoryFileService), 控制线程不做文件系统调用
+
+// 规划请求 (控制线程 -> 工作线程)
+typedef struct {
+    int iAxis;                  // 目标轴 (PLANNER_GROUP_REQUEST: 多轴同步规划)
+    uint64_t ullAxisMask;       // 涉及的轴
+    int iSequence;              // 指令序列号 (用于完成反馈)
+    stPlannerInput stInput;     // 规划参数
+    LONGLONG llRequestTicks;    // 提交时刻 (QPC ticks)
+} stPlanRequest;
+
+// 规划结果 (工作线程 -> 控制线程)
+typedef struct {
+    int iAxis;                  // 目标轴 (PLANNER_GROUP_REQUEST: 多轴同步规划)
+    uint64_t ullAxisMask;       // 涉及的轴 (应用时一并切换)
+    int iSequence;              // 指令序列号
+    int iStatus;                // 0: 成功, 后备槽已写入新轨迹; -1: 规划失败, 当前轨迹不变
+    int bCacheHit;              // 1: 结果来自规划缓存 (未调用 Init)
+    double dPlanUs;             // 工作线程中规划耗时 (缓存命中时为复制耗时) [us]
+    double dLatencyUs;          // 提交到控制线程应用的总延迟 [us] (应用时填写)
+    LONGLONG llRequestTicks;    // 提交时刻 (QPC ticks)
+    stPlannerGroupResult stGroup; // 多轴同步规划的结果 (共同时间、失败轴等)
+} stPlanResult;
+
+// 规划统计信息 (仅控制线程更新)
+typedef struct {
+    unsigned long long ullRequested;    // 已提交请求数
+    unsigned long long ullRejected;     // 请求队列满被拒绝的请求数
+    unsigned long long ullApplied;      // 已切换到新轨迹的请求数
+    unsigned long long ullFailed;       // 规划失败的请求数
+    unsigned long long ullCacheHits;    // 已应用请求中命中规划缓存的次数
+    double dMaxPlanUs;                  // 最大规划耗时 [us]
+    double dSumPlanUs;                  // 规划耗时累计 [us]
+    double dMaxLatencyUs;               // 最大提交到应用延迟 [us]
+    double dSumLatencyUs;               // 提交到应用延迟累计 [us]
+} stPlannerWorkerStats;
+
+// 函数声明
+int PlannerWorkerInit(void);
+int PlannerWorkerStart(void);
+void PlannerWorkerStop(void);
+int PlannerWorkerPlanGroupSync(uint64_t ullAxisMask, const stPlannerInput* astInput, stPlannerGroupResult* pResult);
+int PlannerWorkerRequest(int iAxis, int iSequence, const stPlannerInput* pstInput);
+int PlannerWorkerRequestGroup(uint64_t ullAxisMask, int iSequence, const stPlannerInput* astInput);
+int PlannerWorkerApply(stPlanResult* pResult);
+int PlannerWorkerIsPending(uint64_t ullAxisMask);
+void PlannerWorkerWake(void);
+stPlannerContext* PlannerWorkerGetContext(int iAxis);
+void PlannerWorkerGetStats(stPlannerWorkerStats* pStats);
+
+#endif
@@ -4,7 +4,6 @@
 
 // 在全局变量区域添加以下定义
 #define ERROR_THRESHOLD 0.0000000007      // 误差阈值 (单位: m)
-#define AXIS_COUNT 2
 // 安全控制模式枚举
 typedef enum {
     CONTROL_MODE_CLOSED_LOOP = 0,  // 闭环控制模式
@@ -18,7 +17,7 @@ typedef struct {
 } SafetyControlData;
 
 // 在全局变量区域添加安全控制数据
-SafetyControlData SafetyData[AXIS_COUNT];
+SafetyControlData SafetyData[MAX_AXIS_COUNT];
 
 // 修改函数声明，使用不同的参数名避免冲突
 double ApplySafetyControl(int axis, double control_force, double error, ControlSystemState* sysCtrlState);
@@ -36,10 +36,6 @@ struct RxData
     double dParamData[5];
 };
 
-// 全局变量声明
-extern struct RxData g_rxData;
-extern int g_bDataReceived;
-
 // 添加发送反馈函数声明
 int SendCommandFeedback(SOCKET clientSocket, CommandFeedback* feedback);
 
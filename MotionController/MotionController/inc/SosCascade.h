@@ -0,0 +1,31 @@
+#ifndef SOS_CASCADE_H
+#define SOS_CASCADE_H
+
+#define SOS_MAX_SECTIONS 12     // 每轴最多二阶节数 (PID + 低通/陷波/超前滞后等)
+
+// 二阶节 (Direct Form II Transposed), 系数已按 a0 归一化, 更新时无除法:
+//   y  = b0*x + z1
+//   z1 = b1*x - a1*y + z2
+//   z2 = b2*x - a2*y
+typedef struct {
+    double dB0, dB1, dB2;   // 分子系数 (已除以 a0)
+    double dA1, dA2;        // 分母系数 (已除以 a0)
+    double dZ1, dZ2;        // 状态
+} stSosSection;
+
+// 二阶节级联: 各节连续存储, 按顺序逐节处理
+typedef struct {
+    int iSectionCount;
+    stSosSection astSection[SOS_MAX_SECTIONS];
+} stSosCascade;
+
+// 函数声明
+void SosSectionSetCoeffs(stSosSection* pSection,
+                         double b0, double b1, double b2, double a0, double a1, double a2);
+void SosCascadeInit(stSosCascade* pCascade);
+int SosCascadeAddSection(stSosCascade* pCascade, const stSosSection* pSection);
+void SosCascadeTruncate(stSosCascade* pCascade, int iSectionCount);
+void SosCascadeReset(stSosCascade* pCascade);
+double SosCascadeUpdate(stSosCascade* pCascade, double dInput);
+
+#endif
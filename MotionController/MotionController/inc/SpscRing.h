@@ -0,0 +1,36 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#define SPSC_CACHE_LINE 64
+
+// 单生产者/单消费者无锁环形队列
+// - 只允许一个线程调用 Push, 一个线程调用 Pop, 两端均无等待 (wait-free)
+// - 元素大小在初始化时指定, 存储区由调用者提供, 容量必须为 2 的幂
+// - 读写索引单调递增, 分别位于独立缓存行, 避免伪共享
+// - 元素较大时生产者可用 Reserve/Commit 直接在槽内写入, 消费者可用 PopBatch 一次取出多个元素并一次释放槽位
+typedef struct {
+    volatile LONG lHead;                            // 写索引 (仅生产者修改)
+    char acPad0[SPSC_CACHE_LINE - sizeof(LONG)];
+    volatile LONG lTail;                            // 读索引 (仅消费者修改)
+    char acPad1[SPSC_CACHE_LINE - sizeof(LONG)];
+    unsigned char* pucStorage;                      // 元素存储区
+    size_t uElemSize;                               // 单个元素字节数
+    LONG lCapacity;                                 // 容量 (2 的幂)
+    LONG lMask;                                     // 索引掩码 = 容量 - 1
+} stSpscRing;
+
+// 函数声明
+int SpscRingInit(stSpscRing* pRing, void* pStorage, LONG lCapacity, size_t uElemSize);
+int SpscRingPush(stSpscRing* pRing, const void* pElem);
+int SpscRingPop(stSpscRing* pRing, void* pElem);
+LONG SpscRingCount(const stSpscRing* pRing);
+void* SpscRingReserve(stSpscRing* pRing);
+void SpscRingCommit(stSpscRing* pRing);
+LONG SpscRingPopBatch(stSpscRing* pRing, void* pElems, LONG lMaxCount);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_COMPRESS_H
+#define TELEMETRY_COMPRESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "TelemetryFile.h"
+
+#define TELEMETRY_GROUP_MAGIC 0x50524754U   // "TGRP" (小端)
+#define TELEMETRY_GROUP_RECORDS 512         // 每组最大记录数 (1ms 周期下约 0.5s)
+#define TELEMETRY_CHANNEL_MAX (TELEMETRY_RECORD_MAX / 4)    // 最大通道数 (记录 <= TELEMETRY_RECORD_MAX)
+#define TELEMETRY_INDEX_MAGIC 0x58444954U   // "TIDX" (小端)
+#define TELEMETRY_INDEX_MAX 4096            // 写入端组索引的最大条目数 (满时隔一删一, 条目间隔加倍)
+
+// 通道块编码 (块首字节)
+#define TELEMETRY_CODEC_XOR 1               // 与前值异或: Gorilla 浮点编码
+#define TELEMETRY_CODEC_DOD 2               // 按位模式线性预测的二阶差分 (delta-of-delta) + zigzag 变长
+
+// 一块的最大字节数: 编码字节 + 首值 8 字节 + 其余每值至多 77 位; 一组的最大字节数: 头部 + 偏移表 + 各块
+#define TELEMETRY_BLOCK_MAX_BYTES(n) (9 + ((size_t)(n) * 77 + 7) / 8)
+#define TELEMETRY_GROUP_MAX_BYTES(channels, n) (24 + (size_t)(channels) * (4 + TELEMETRY_BLOCK_MAX_BYTES(n)))
+
+// 逐周期记录的分组压缩 (头部 uFlags 含 TELEMETRY_FLAG_COMPRESSED 时, 记录区为连续的压缩组)
+// - 通道: 每列的每个元素 (按列顺序, 列内按元素顺序), 一组内每个通道独立编码为一块, 可只解码所需的通道
+// - 组: stTelemetryGroupHeader + 各通道块相对组起点的偏移 (uint32 × 通道数) + 各通道块, 组内记录数
+//   <= TELEMETRY_GROUP_RECORDS; 组按整组追加, 读取端只处理完整的组, 因此写入过程中即可读取
+// - 每块按两种编码分别计算位数, 取较小者:
+//   XOR: 首值原样, 之后每值与前值异或: 相同写 '0'; 有效位落在上次的前导/末尾零窗口内写 '10' + 窗口内的位;
+//        否则写 '11' + 5 位前导零数 + 6 位有效位数 - 1 + 有效位 (平稳段、重复值)
+//   DOD: 首值原样, 之后以位模式 (整数) 2·x[n-1] - x[n-2] 为预测, 残差 zigzag 后: 0 写 '0'; < 2^3 写 '10' + 3 位;
+//        < 2^7 写 '110' + 7 位; < 2^12 写 '1110' + 12 位; 否则 '1111' + 6 位位数 - 1 + 残差 (步号、时间、匀速段;
+//        同一指数内位模式与数值线性相关, 预测只用整数运算, 与浮点环境无关)
+// - 无损: 解码结果与原记录逐位相同; 整数列按符号扩展为 64 位编码
+// - 组索引: 写入结束时在最后一组之后追加 stTelemetryIndexEntry × N 与 stTelemetryIndexTrailer (文件最后 32 字节),
+//   每隔 uStride 组记录一组的 (首记录序号, 偏移); 读取端二分查找后至多再跳过 uStride - 1 个组头部.
+//   仍在写入或异常结束的文件没有索引, 读取端从头按组头部定位 (并记住经过的组起点)
+
+// 组头部 (24 字节)
+typedef struct {
+    uint32_t uMagic;                    // TELEMETRY_GROUP_MAGIC
+    uint32_t uRecordCount;              // 组内记录数 (1 .. TELEMETRY_GROUP_RECORDS)
+    uint64_t ullFirstRecord;            // 组内首条记录的序号 (自 0 起)
+    uint32_t uGroupBytes;               // 整组字节数 (含头部与偏移表)
+    uint32_t uChannelCount;             // 通道数 (与文件头部一致)
+} stTelemetryGroupHeader;
+
+// 组索引尾部 (32 字节, 位于文件末尾)
+typedef struct {
+    uint32_t uMagic;                    // TELEMETRY_INDEX_MAGIC
+    uint32_t uEntryCount;               // 条目数
+    uint32_t uStride;                   // 条目间隔 (组数)
+    uint32_t uReserved;
+    uint64_t ullIndexOffset;            // 第一个条目的文件偏移 (= 记录区末尾)
+    uint64_t ullGroupCount;             // 总组数
+} stTelemetryIndexTrailer;
+
+// 写入端组索引 (固定大小, 写入过程中不分配内存)
+typedef struct {
+    stTelemetryIndexEntry astEntry[TELEMETRY_INDEX_MAX];
+    uint32_t uCount;
+    uint32_t uStride;
+    uint64_t ullGroups;
+} stTelemetryIndexBuilder;
+
+// 函数声明
+int TelemetryChannelCount(const stTelemetryHeader* pHeader);
+int TelemetryChannelIndex(const stTelemetryHeader* pHeader, int iColumn, int iIndex);
+size_t TelemetryGroupMaxBytes(const stTelemetryHeader* pHeader, uint32_t uRecordCount);
+size_t TelemetryCompressGroup(const stTelemetryHeader* pHeader, const unsigned char* pucRecords, uint32_t uRecordCount,
+                              uint64_t ullFirstRecord, unsigned char* pucOut);
+int TelemetryCheckGroup(const stTelemetryHeader* pHeader, const unsigned char* pucGroup, size_t uBytes);
+int TelemetryDecompressGroup(const stTelemetryHeader* pHeader, const unsigned char* pucGroup,
+                             unsigned char* pucRecords);
+int TelemetryDecodeChannel(const stTelemetryHeader* pHeader, const unsigned char* pucGroup, int iChannel,
+                           double* pdOut);
+void TelemetryIndexInit(stTelemetryIndexBuilder* pIndex);
+void TelemetryIndexAdd(stTelemetryIndexBuilder* pIndex, uint64_t ullFirstRecord, uint64_t ullOffset);
+long long TelemetryIndexWrite(const stTelemetryIndexBuilder* pIndex, uint64_t ullIndexOffset, FILE* pFile);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef TELEMETRY_FILE_H
+#define TELEMETRY_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "AxisConfig.h"
+
+#define TELEMETRY_MAGIC 0x4D4C4554U         // "TELM" (小端)
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 512           // 头部字节数 (记录区从此偏移开始)
+#define TELEMETRY_MAX_COLUMNS 16
+#define TELEMETRY_NAME_CHARS 16
+
+// 列数据类型 (均为小端)
+#define TELEMETRY_TYPE_I32 1
+#define TELEMETRY_TYPE_F64 2
+#define TELEMETRY_COLUMN_PER_AXIS 0x1       // 列标记: 每轴一个元素 (否则为每条记录的标量或数组)
+#define TELEMETRY_FLAG_COMPRESSED 0x1U      // 头部标记: 记录区为压缩组 (TelemetryCompress)
+
+// 控制数据记录的标准列 (TelemetryHeaderInit 按此顺序生成; 先放 8 字节列, 记录内各值自然对齐)
+#define TELEMETRY_COL_TIME 0                // [s]   1 个
+#define TELEMETRY_COL_TARGET 1              // [m]   每轴 1 个
+#define TELEMETRY_COL_ACTUAL 2              // [m]   每轴 1 个
+#define TELEMETRY_COL_ERROR 3               // [m]   每轴 1 个
+#define TELEMETRY_COL_FORCE 4               // [N]   每轴 1 个
+#define TELEMETRY_COL_STEP 5                //       1 个
+#define TELEMETRY_COL_MODE 6                //       每轴 1 个 (0: 闭环, 1: 开环)
+#define TELEMETRY_STD_COLUMNS 7
+#define TELEMETRY_RECORD_MAX (8 * (1 + 4 * MAX_AXIS_COUNT) + 4 * (1 + MAX_AXIS_COUNT))    // 标准列的最大记录字节数
+#define TELEMETRY_STD_CHANNELS_MAX (2 + 5 * MAX_AXIS_COUNT)   // 标准列的最大元素数 (压缩通道数)
+
+// 二进制逐周期数据记录文件
+// - 自描述头部: 轴数、采样时间、记录字节数与各列的名称/类型/元素数/记录内偏移, 读取端只依赖头部解析记录
+// - 头部之后为固定大小的记录, 由写入线程整条追加; 文件中不保存记录数 (= (文件大小 - 头部) / 记录字节数),
+//   因此写入过程中即可读取: 读取端只处理完整的记录, 末尾不完整的记录留待下次读取
+// - 数值以本机字节序写入 (x86/x64 即小端), 与 CSV 相比无格式化开销; 对非整齐小数的实测数据体积约为 CSV 的 40%
+// - 头部含 TELEMETRY_FLAG_COMPRESSED 时记录区为按通道分块压缩的记录组 (见 TelemetryCompress.h), 读取器透明解压,
+//   同样只处理完整的组; TelemetryReaderReadChannel 只解码所需通道, 可随机读取单个通道;
+//   写入结束时追加的组索引 (见 TelemetryCompress.h) 使定位不必从头逐组跳过
+
+// 列描述 (24 字节)
+typedef struct {
+    char acName[TELEMETRY_NAME_CHARS];  // 列名 ('\0' 结尾)
+    uint8_t ucType;                     // TELEMETRY_TYPE_*
+    uint8_t ucFlags;                    // TELEMETRY_COLUMN_*
+    uint16_t usCount;                   // 元素数 (标量列为 1, 每轴一个的列为轴数)
+    uint32_t uOffset;                   // 记录内字节偏移
+} stTelemetryColumn;
+
+// 文件头部 (TELEMETRY_HEADER_SIZE 字节)
+typedef struct {
+    uint32_t uMagic;                    // TELEMETRY_MAGIC
+    uint16_t usVersion;                 // TELEMETRY_VERSION
+    uint16_t usHeaderSize;              // TELEMETRY_HEADER_SIZE
+    uint32_t uAxisCount;                // 轴数
+    uint32_t uColumnCount;              // 列数 (<= TELEMETRY_MAX_COLUMNS)
+    uint32_t uRecordSize;               // 每条记录字节数
+    uint32_t uFlags;                    // TELEMETRY_FLAG_*
+    double dSampleTime;                 // [s] 控制周期
+    uint64_t ullStartTime;              // 采集开始时刻 (FILETIME: 1601-01-01 起的 100ns 数, UTC)
+    stTelemetryColumn astColumn[TELEMETRY_MAX_COLUMNS];
+    uint8_t aucReserved[TELEMETRY_HEADER_SIZE - 40 - TELEMETRY_MAX_COLUMNS * sizeof(stTelemetryColumn)];
+} stTelemetryHeader;
+
+// 组索引条目: 一组的首记录序号与组在文件中的偏移 (16 字节)
+typedef struct {
+    uint64_t ullFirstRecord;
+    uint64_t ullOffset;
+} stTelemetryIndexEntry;
+
+// 顺序读取器 (可跟随正在写入的文件)
+typedef struct {
+    FILE* pFile;
+    stTelemetryHeader stHeader;
+    uint64_t ullRecords;                // 已读取的记录数
+    // 压缩文件 (未压缩时不使用)
+    uint64_t ullOffset;                 // 下一组在文件中的偏移
+    uint64_t ullGroups;                 // 已读取的组数
+    uint64_t ullStoredBytes;            // 已读取的组字节数合计
+    size_t uGroupMaxBytes;              // 一组的最大字节数
+    unsigned char* pucGroup;            // 当前组 (压缩)
+    unsigned char* pucRecords;          // 当前组解压后的记录
+    uint32_t uGroupRecords;             // 当前组记录数
+    uint32_t uGroupNext;                // 当前组中下一条未读取的记录
+    stTelemetryIndexEntry* pstIndex;    // 已知的组起点 (按记录序号递增): 文件末尾的索引 + 读取时经过的组
+    uint32_t uIndexCount;
+    uint32_t uIndexCapacity;
+    uint32_t uIndexStride;              // 文件索引的条目间隔 (组数), 无文件索引时为 0
+    uint64_t ullDataEnd;                // 记录区末尾 (文件有索引时为索引起点, 否则为 0: 不限)
+} stTelemetryReader;
+
+// 函数声明
+int TelemetryTypeSize(int iType);
+int TelemetryHeaderInit(stTelemetryHeader* pHeader, int iAxisCount, double dSampleTime);
+int TelemetryHeaderCheck(const stTelemetryHeader* pHeader);
+int TelemetryFindColumn(const stTelemetryHeader* pHeader, const char* pszName);
+double TelemetryGetValue(const stTelemetryHeader* pHeader, const unsigned char* pucRecord, int iColumn, int iIndex);
+int TelemetryReaderOpen(stTelemetryReader* pReader, const char* pszPath);
+int TelemetryReaderNext(stTelemetryReader* pReader, unsigned char* pucRecord);
+int TelemetryReaderReadChannel(stTelemetryReader* pReader, int iColumn, int iIndex, uint64_t ullFirst, uint32_t uCount,
+                               double* pdOut);
+void TelemetryReaderClose(stTelemetryReader* pReader);
+
+#endif
@@ -1,36 +1,47 @@
 #ifndef THREAD_CONTROL_H
 #define THREAD_CONTROL_H
+#include <stdint.h>
+#include "AxisConfig.h"
+#include "BiquadBank.h"
 #include "Controlled_Device.h"
 #include "Controler.h"
 #include "FourthOrderTrajectoryPlanning.h"
+#include "CycleTimer.h"
+#include "TrajectoryFile.h"
 
 #define SAMPLINGTIME 0.001     // 采样时间 1ms
 #define TOTALSTEPS 1001         // 总步数
-#define AXIS_COUNT 2  // 轴数为2
+#define PLANT_MASS 16.0         // 被控对象质量
 
-// 修改 ControlData 结构体为支持多轴
+// 修改 ControlData 结构体为支持多轴 (每个字段按轴连续存储, 实际使用前 g_iAxisCount 个)
 typedef struct {
-    volatile double dTargetPosition[AXIS_COUNT];
-    double dActualPosition[AXIS_COUNT];
-    double dError[AXIS_COUNT];
-    double dControlForce[AXIS_COUNT];
-    double dOutputPosition[AXIS_COUNT];
+    volatile double dTargetPosition[MAX_AXIS_COUNT];
+    double dActualPosition[MAX_AXIS_COUNT];
+    double dError[MAX_AXIS_COUNT];
+    double dControlForce[MAX_AXIS_COUNT];
+    double dOutputPosition[MAX_AXIS_COUNT];
 } ControlData;
 // 控制系统全局状态结构体
 
 typedef struct {
-    RigidBodyTF plant[AXIS_COUNT];
-    Controller controller[AXIS_COUNT];
+    stBiquadBank plant;                   // 被控对象 (刚体传递函数组)
+    ControllerBank controller;            // 控制器组
     ControlData ctrl_data;
-    stTrajectoryPoint currentPoint[AXIS_COUNT];  // 每轴都有自己的轨迹
-    stPlannerContext* pContext[AXIS_COUNT];
+    double adRawControlForce[MAX_AXIS_COUNT];  // 安全控制前的控制器输出
+    stPlannerContext* pContext[MAX_AXIS_COUNT];  // 各轴当前轨迹 (指向规划线程双缓冲中的当前槽, 周期边界切换)
+    stTrajectoryFile stReplay;            // 离线轨迹文件回放 (CMD 18, 占用期间代替 pContext 给出参与轴的参考)
     int iControlStep;
     int bTrajectoryReady;
     int bControlRunning;
     FILE* pFile;
     // 添加以下两个成员用于支持独立轴控制
-    int iControlStepPerAxis[AXIS_COUNT];  // 每个轴的独立步进计数器
-    int bAxisActive[AXIS_COUNT];          // 每个轴的激活状态标记
+    int iControlStepPerAxis[MAX_AXIS_COUNT];  // 每个轴的独立步进计数器
+    int bAxisActive[MAX_AXIS_COUNT];          // 每个轴的激活状态标记
+    unsigned char abStepEnable[MAX_AXIS_COUNT];   // 本步需要更新控制器/被控对象的轴
+    // 周期控制模式: 控制线程按 SAMPLINGTIME 绝对截止时刻自主执行控制步骤
+    int bCyclicMode;                      // 周期模式运行标记
+    uint64_t ullCyclicAxisMask;           // 周期模式下参与控制的轴掩码
+    stCycleStats stCycleStats;            // 周期抖动/超限统计
 } ControlSystemState;
 
 // // 全局控制系统状态变量
@@ -45,9 +56,8 @@ typedef struct {
 // 执行计数器
 static int g_executionCounter = 0;
 
-// 全局控制变量
-extern int g_bDataReceived;
-extern struct RxData g_rxData;
+// Socket 指令结构体 (定义见 Socket.h)
+struct RxData;
 
 // 函数声明
 void* ControlThreadFunction(void* param);
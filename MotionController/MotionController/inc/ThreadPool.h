@@ -0,0 +1,29 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#define THREAD_POOL_MAX_THREADS 16      // 工作线程数上限
+#define THREAD_POOL_WAIT_MS 1000        // 等待已唤醒工作线程的上限 (其至多还在执行一个已领取的任务)
+
+// 固定线程池 (并行 for)
+// - 工作线程在 ThreadPoolInit 中一次性创建, 之后不再创建/销毁线程, 也不分配内存
+// - ThreadPoolParallelFor 阻塞到全部任务完成; 调用线程自身也领取任务, 线程池为空时退化为顺序执行
+// - 任务按原子计数器逐个领取: 即使工作线程唤醒迟缓, 调用线程也会把剩余任务做完;
+//   返回前只需等待已唤醒的工作线程做完各自已领取的任务 (及其被调度的延迟), 不依赖工作线程的吞吐
+// - 等待超时 (工作线程被挂起或长时间得不到调度) 返回 -1, 调用方应放弃本次结果;
+//   滞后的工作线程至多再完成一个任务, 在其退出前的调用均由调用线程顺序执行
+// - 同一时刻只允许一个线程调用 ThreadPoolParallelFor (不可重入)
+
+typedef void (*ThreadPoolTaskFn)(int iIndex, void* pParam);
+
+// 函数声明
+int ThreadPoolInit(int iThreads);
+void ThreadPoolDestroy(void);
+int ThreadPoolParallelFor(int iCount, int iMinTasksPerThread, ThreadPoolTaskFn pfnTask, void* pParam);
+int ThreadPoolGetThreadCount(void);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <stdint.h>
+#include "AxisConfig.h"
+
+#define TRAJ_FILE_MAGIC 0x4A52544DU         // "MTRJ" (小端)
+#define TRAJ_FILE_VERSION 1
+#define TRAJ_FILE_HEADER_SIZE 128           // 头部字节数 (记录区从此偏移开始, 按缓存行对齐)
+#define TRAJ_FILE_FLAG_VALIDATED 0x1U       // 已通过约束检查 (TrajectoryFileValidate)
+#define TRAJ_FILE_NAME_FORMAT "trajectory_%03d.trj"  // 指令中以编号指定文件 (当前工作目录)
+#define TRAJ_FILE_PREFETCH_FRAMES 16        // 回放时软件预取的前方帧数
+#define TRAJ_FILE_START_TOL 1e-6            // 首帧位置与轴当前位置之差的容差 [m]
+#define TRAJ_FILE_CHECK_TOL 1e-9            // 约束检查的相对容差
+#define TRAJ_FILE_REST_TOL 1e-9             // 首帧与末帧须静止: |v| [m/s]、|a| [m/s^2] 不超过此值
+#define TRAJ_FILE_PATH_CHARS 64             // 后台打开的文件路径最大长度
+
+// 后台加载器状态
+#define TRAJ_LOADER_IDLE 0                  // 空闲 (控制线程可提交打开或关闭)
+#define TRAJ_LOADER_OPENING 1               // 已提交打开, 工作线程尚未完成
+#define TRAJ_LOADER_READY 2                 // 已打开并映射, 等待控制线程取走
+#define TRAJ_LOADER_FAILED 3                // 打开失败, 等待控制线程确认
+#define TRAJ_LOADER_CLOSING 4               // 已交还文件, 工作线程尚未关闭
+
+// 离线轨迹文件 (内存映射回放)
+// - 文件为头部 + 固定大小记录, 小端 double; 记录按帧连续存放: 帧 i 为各文件轴的 (pos, vel, acc) 依次排列,
+//   控制循环每周期顺序读取一帧, 不解析文本, 不调用系统函数
+// - 打开时映射整个文件, 只检查头部与文件大小 (O(1)); 逐点的约束检查由生成工具离线完成 (TrajectoryFileValidate),
+//   通过后在头部置 TRAJ_FILE_FLAG_VALIDATED, 控制线程只接受已检查的文件
+// - 打开时以 PrefetchVirtualMemory 提示系统预读整个映射, 回放时以 _mm_prefetch 预取前方
+//   TRAJ_FILE_PREFETCH_FRAMES 帧所在缓存行
+// - 文件轴按序映射到轴掩码中由低到高的各轴
+// - 首帧与末帧须静止 (v = a = 0): 回放从静止的轴接管, 结束后停在末帧位置
+// - 后台加载: 打开、映射、预读与关闭均为可能阻塞的系统调用, 控制线程经 TrajectoryFileRequestOpen /
+//   TrajectoryFilePollOpen / TrajectoryFileRequestClose 交给规划工作线程 (TrajectoryFileService) 完成,
+//   控制线程只复制已映射的文件描述 (句柄与指针); 同一时刻至多一个文件在加载器中
+
+// 文件头部 (TRAJ_FILE_HEADER_SIZE 字节)
+typedef struct {
+    uint32_t uMagic;                // TRAJ_FILE_MAGIC
+    uint32_t uVersion;              // TRAJ_FILE_VERSION
+    uint32_t uAxisCount;            // 文件轴数 (1 ~ MAX_AXIS_COUNT)
+    uint32_t uFlags;                // TRAJ_FILE_FLAG_*
+    uint64_t ullFrameCount;         // 帧数 (每帧 uAxisCount 条记录)
+    double dSampleTime;             // [s] 帧间隔 (须与控制周期一致)
+    double dVMax;                   // 检查所用约束 (各轴相同)
+    double dAMax;
+    double dJMax;
+    double adReserved[9];
+} stTrajFileHeader;
+
+// 单轴单帧记录
+typedef struct {
+    double dPos;                    // [m]
+    double dVel;                    // [m/s]
+    double dAcc;                    // [m/s^2]
+} stTrajRecord;
+
+// 已映射的轨迹文件及回放游标 (回放仅由控制线程使用; 描述可按值复制, 复制后由接收方负责关闭)
+typedef struct {
+    HANDLE hFile;
+    HANDLE hMapping;
+    const unsigned char* pucView;       // 映射视图
+    const stTrajFileHeader* pHeader;
+    const stTrajRecord* pRecords;       // 记录区 (帧 i 起始于 pRecords + i * iAxisCount)
+    int iAxisCount;
+    uint64_t ullFrameCount;
+    uint64_t ullFrame;                  // 下一帧序号
+    uint64_t ullAxisMask;               // 回放目标轴 (文件轴 k 对应掩码中第 k 个轴)
+    int aiAxis[MAX_AXIS_COUNT];         // 文件轴 -> 控制轴
+} stTrajectoryFile;
+
+// 函数声明
+int TrajectoryFileOpen(stTrajectoryFile* pFile, const char* pszPath, int bWritable);
+void TrajectoryFileClose(stTrajectoryFile* pFile);
+int TrajectoryFileBind(stTrajectoryFile* pFile, uint64_t ullAxisMask);
+const stTrajRecord* TrajectoryFileNextFrame(stTrajectoryFile* pFile);
+int TrajectoryFileIsFinished(const stTrajectoryFile* pFile);
+const stTrajRecord* TrajectoryFileGetFrame(const stTrajectoryFile* pFile, uint64_t ullFrame);
+int TrajectoryFileValidate(stTrajectoryFile* pFile, double dVMax, double dAMax, double dJMax, uint64_t* pullBadFrame);
+int TrajectoryFileIsAtRest(const stTrajectoryFile* pFile, uint64_t ullFrame);
+void TrajectoryFileLoaderInit(void (*pfnWake)(void));
+int TrajectoryFileRequestOpen(const char* pszPath);
+int TrajectoryFilePollOpen(stTrajectoryFile* pFile);
+void TrajectoryFileRequestClose(stTrajectoryFile* pFile);
+int TrajectoryFileService(void);
+void TrajectoryFileLoaderCleanup(void);
+
+#endif
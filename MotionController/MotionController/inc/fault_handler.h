@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "AxisConfig.h"
 
 // ================== 枚举定义 ==================
 
@@ -33,6 +34,8 @@ typedef enum {
     FAULT_MAX
 } tFaultType; // 't' prefix for type
 
+#define FAULT_AXIS_FAULT_BIT (1U << 31)   // u32Fault_GetAxisFaultBits 中的轴综合故障位
+
 // ================== 结构体定义 ==================
 
 /**
@@ -68,7 +71,7 @@ typedef struct {
 
 // ================== 全局变量声明 ==================
 // 使用 extern 声明，定义在 .c 文件中
-extern tAxisFaultCtx g_atAxisFaults[8];   // g_: global, a: array
+extern tAxisFaultCtx g_atAxisFaults[MAX_AXIS_COUNT];   // g_: global, a: array
 extern tSystemFaultCtx g_tSystemFault;    // g_: global
 
 // ================== 函数声明 ==================
@@ -80,7 +83,7 @@ void vFault_Init(void);
 
 /**
  * @brief 更新指定轴的故障状态
- * @param u8AxisId 轴ID (0~7)
+ * @param u8AxisId 轴ID (0 ~ MAX_AXIS_COUNT-1)
  */
 void vFault_UpdateAxis(uint8_t u8AxisId);
 
@@ -102,4 +105,11 @@ bool bFault_GetAxisFault(uint8_t u8AxisId);
  */
 bool bFault_GetSystemFault(void);
 
+/**
+ * @brief 获取指定轴的故障位 (记录用)
+ * @param u8AxisId 轴ID
+ * @return 第 k 位为处理后故障信号 m_bFault[k] (k < FAULT_MAX), FAULT_AXIS_FAULT_BIT 为轴综合故障
+ */
+uint32_t u32Fault_GetAxisFaultBits(uint8_t u8AxisId);
+
 #endif // FAULT_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "AllocGuard.h"
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+
+static __declspec(thread) int t_bArmed = 0;    // 当前线程是否受监视
+static volatile LONG g_lTrapped = 0;           // 受监视线程的堆操作次数
+static _CRT_ALLOC_HOOK g_pfnPrevHook = NULL;
+static int g_bInstalled = 0;
+
+static int __cdecl AllocGuardHook(int iAllocType, void* pvData, size_t uSize, int iBlockUse,
+                                  long lRequest, const unsigned char* pszFile, int iLine) {
+    if (t_bArmed && iBlockUse != _CRT_BLOCK) {
+        InterlockedIncrement(&g_lTrapped);
+#ifdef ALLOC_GUARD_BREAK
+        __debugbreak();
+#endif
+    }
+    if (g_pfnPrevHook != NULL) {
+        return g_pfnPrevHook(iAllocType, pvData, uSize, iBlockUse, lRequest, pszFile, iLine);
+    }
+    return TRUE;
+}
+
+// 挂接调试堆钩子 (启动时调用一次)
+void AllocGuardInstall(void) {
+    if (!g_bInstalled) {
+        g_pfnPrevHook = _CrtSetAllocHook(AllocGuardHook);
+        g_bInstalled = 1;
+    }
+}
+
+// 开始监视当前线程
+void AllocGuardArm(void) {
+    t_bArmed = 1;
+}
+
+// 停止监视当前线程
+void AllocGuardDisarm(void) {
+    t_bArmed = 0;
+}
+
+// 受监视线程的堆操作次数
+LONG AllocGuardGetCount(void) {
+    return g_lTrapped;
+}
+
+// 检测是否生效
+int AllocGuardIsActive(void) {
+    return g_bInstalled;
+}
+
+#else
+
+void AllocGuardInstall(void) {}
+void AllocGuardArm(void) {}
+void AllocGuardDisarm(void) {}
+LONG AllocGuardGetCount(void) { return 0; }
+int AllocGuardIsActive(void) { return 0; }
+
+#endif
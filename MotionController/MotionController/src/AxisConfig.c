@@ -0,0 +1,20 @@
+#include "AxisConfig.h"
+
+int g_iAxisCount = DEFAULT_AXIS_COUNT;
+
+// 设置运行时轴数, 超出 [1, MAX_AXIS_COUNT] 时返回 -1 且不修改
+int AxisConfigSetCount(int iAxisCount) {
+    if (iAxisCount < 1 || iAxisCount > MAX_AXIS_COUNT) {
+        return -1;
+    }
+    g_iAxisCount = iAxisCount;
+    return 0;
+}
+
+// 所有运行轴的掩码 (第 i 位对应轴 i)
+uint64_t AxisConfigAllMask(void) {
+    if (g_iAxisCount >= 64) {
+        return ~(uint64_t)0;
+    }
+    return ((uint64_t)1 << g_iAxisCount) - 1;
+}
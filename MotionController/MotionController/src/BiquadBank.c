@@ -0,0 +1,345 @@
+#include "BiquadBank.h"
+#include <string.h>
+#include "log.h"
+
+// x86/x64 下编译 AVX2/AVX-512 内核, 其他平台只有标量内核
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BIQUAD_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BIQUAD_TARGET_AVX2
+#define BIQUAD_TARGET_AVX512
+#else
+#include <cpuid.h>
+// GCC 默认会把乘加合并为 FMA (AVX-512F 隐含 FMA), 需关闭以保持与标量逐位一致
+#define BIQUAD_TARGET_AVX2 __attribute__((target("avx2"), optimize("fp-contract=off")))
+#define BIQUAD_TARGET_AVX512 __attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+#endif
+
+typedef void (*BiquadProcessFn)(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                                const unsigned char* pbEnable, int iAxisCount);
+
+static BiquadProcessFn s_pfnProcess = NULL;
+static eBiquadKernel s_eKernel = BIQUAD_KERNEL_SCALAR;
+
+// 初始化滤波器组: 所有系数和历史值清零, 各轴为直通 (b0 = 1)
+void BiquadBankInit(stBiquadBank* pBank) {
+    memset(pBank, 0, sizeof(stBiquadBank));
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        pBank->adB0[i] = 1.0;
+    }
+}
+
+// 设置指定轴的系数: 按 a0 归一化后保存 (a0 为 1 时原样保存)
+void BiquadBankSetCoeffs(stBiquadBank* pBank, int iAxis,
+                         double b0, double b1, double b2, double a0, double a1, double a2) {
+    if (a0 != 1.0) {
+        double dInvA0 = 1.0 / a0;
+        b0 *= dInvA0;
+        b1 *= dInvA0;
+        b2 *= dInvA0;
+        a1 *= dInvA0;
+        a2 *= dInvA0;
+    }
+    pBank->adB0[iAxis] = b0;
+    pBank->adB1[iAxis] = b1;
+    pBank->adB2[iAxis] = b2;
+    pBank->adA1[iAxis] = a1;
+    pBank->adA2[iAxis] = a2;
+}
+
+// 清除指定轴的历史值
+void BiquadBankResetAxis(stBiquadBank* pBank, int iAxis) {
+    pBank->adIn1[iAxis] = 0.0;
+    pBank->adIn2[iAxis] = 0.0;
+    pBank->adOut1[iAxis] = 0.0;
+    pBank->adOut2[iAxis] = 0.0;
+}
+
+// 标量内核: 处理 [iBegin, iEnd) 范围的轴, 也用于向量内核的尾部
+static void BiquadBankProcessRange(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                                   const unsigned char* pbEnable, int iBegin, int iEnd) {
+    for (int i = iBegin; i < iEnd; i++) {
+        if (pbEnable != NULL && !pbEnable[i]) {
+            continue;
+        }
+
+        double dInput = pdIn[i];
+        double dOutput = pBank->adB0[i] * dInput +
+                         pBank->adB1[i] * pBank->adIn1[i] +
+                         pBank->adB2[i] * pBank->adIn2[i] -
+                         pBank->adA1[i] * pBank->adOut1[i] -
+                         pBank->adA2[i] * pBank->adOut2[i];
+
+        // 更新历史值
+        pBank->adIn2[i] = pBank->adIn1[i];
+        pBank->adIn1[i] = dInput;
+        pBank->adOut2[i] = pBank->adOut1[i];
+        pBank->adOut1[i] = dOutput;
+
+        pdOut[i] = dOutput;
+    }
+}
+
+static void BiquadBankProcessScalar(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                                    const unsigned char* pbEnable, int iAxisCount) {
+    BiquadBankProcessRange(pBank, pdIn, pdOut, pbEnable, 0, iAxisCount);
+}
+
+#ifdef BIQUAD_HAVE_X86_SIMD
+// AVX2 内核: 每次处理 4 轴
+// 乘加按标量内核的顺序逐步计算且不使用 FMA, 保证与标量结果逐位一致
+// 未使能的轴同样参与计算, 但通过 blend 保留其原有历史值和输出
+BIQUAD_TARGET_AVX2
+static void BiquadBankProcessAvx2(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                                  const unsigned char* pbEnable, int iAxisCount) {
+    int i = 0;
+    for (; i + 4 <= iAxisCount; i += 4) {
+        __m256d vMask = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        if (pbEnable != NULL) {
+            int iBytes;
+            memcpy(&iBytes, pbEnable + i, sizeof(iBytes));
+            if (iBytes == 0) {
+                continue;
+            }
+            __m256i vEnable = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(iBytes));
+            vMask = _mm256_castsi256_pd(_mm256_cmpgt_epi64(vEnable, _mm256_setzero_si256()));
+        }
+
+        __m256d vIn = _mm256_loadu_pd(pdIn + i);
+        __m256d vIn1 = _mm256_loadu_pd(pBank->adIn1 + i);
+        __m256d vIn2 = _mm256_loadu_pd(pBank->adIn2 + i);
+        __m256d vOut1 = _mm256_loadu_pd(pBank->adOut1 + i);
+        __m256d vOut2 = _mm256_loadu_pd(pBank->adOut2 + i);
+
+        __m256d vOut = _mm256_mul_pd(_mm256_loadu_pd(pBank->adB0 + i), vIn);
+        vOut = _mm256_add_pd(vOut, _mm256_mul_pd(_mm256_loadu_pd(pBank->adB1 + i), vIn1));
+        vOut = _mm256_add_pd(vOut, _mm256_mul_pd(_mm256_loadu_pd(pBank->adB2 + i), vIn2));
+        vOut = _mm256_sub_pd(vOut, _mm256_mul_pd(_mm256_loadu_pd(pBank->adA1 + i), vOut1));
+        vOut = _mm256_sub_pd(vOut, _mm256_mul_pd(_mm256_loadu_pd(pBank->adA2 + i), vOut2));
+
+        // 更新历史值 (未使能的轴保持原值)
+        _mm256_storeu_pd(pBank->adIn2 + i, _mm256_blendv_pd(vIn2, vIn1, vMask));
+        _mm256_storeu_pd(pBank->adIn1 + i, _mm256_blendv_pd(vIn1, vIn, vMask));
+        _mm256_storeu_pd(pBank->adOut2 + i, _mm256_blendv_pd(vOut2, vOut1, vMask));
+        _mm256_storeu_pd(pBank->adOut1 + i, _mm256_blendv_pd(vOut1, vOut, vMask));
+        _mm256_storeu_pd(pdOut + i, _mm256_blendv_pd(_mm256_loadu_pd(pdOut + i), vOut, vMask));
+    }
+    // 清除 YMM 高位后再进入标量尾部, 避免 AVX/SSE 切换开销
+    _mm256_zeroupper();
+    BiquadBankProcessRange(pBank, pdIn, pdOut, pbEnable, i, iAxisCount);
+}
+
+// AVX-512 内核: 每次处理 8 轴, 未使能的轴通过掩码存储跳过
+BIQUAD_TARGET_AVX512
+static void BiquadBankProcessAvx512(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                                    const unsigned char* pbEnable, int iAxisCount) {
+    int i = 0;
+    for (; i + 8 <= iAxisCount; i += 8) {
+        __mmask8 kMask = 0xFF;
+        if (pbEnable != NULL) {
+            __m512i vEnable = _mm512_cvtepu8_epi64(_mm_loadl_epi64((const __m128i*)(pbEnable + i)));
+            kMask = _mm512_test_epi64_mask(vEnable, vEnable);
+            if (kMask == 0) {
+                continue;
+            }
+        }
+
+        __m512d vIn = _mm512_loadu_pd(pdIn + i);
+        __m512d vIn1 = _mm512_loadu_pd(pBank->adIn1 + i);
+        __m512d vOut1 = _mm512_loadu_pd(pBank->adOut1 + i);
+
+        __m512d vOut = _mm512_mul_pd(_mm512_loadu_pd(pBank->adB0 + i), vIn);
+        vOut = _mm512_add_pd(vOut, _mm512_mul_pd(_mm512_loadu_pd(pBank->adB1 + i), vIn1));
+        vOut = _mm512_add_pd(vOut, _mm512_mul_pd(_mm512_loadu_pd(pBank->adB2 + i), _mm512_loadu_pd(pBank->adIn2 + i)));
+        vOut = _mm512_sub_pd(vOut, _mm512_mul_pd(_mm512_loadu_pd(pBank->adA1 + i), vOut1));
+        vOut = _mm512_sub_pd(vOut, _mm512_mul_pd(_mm512_loadu_pd(pBank->adA2 + i), _mm512_loadu_pd(pBank->adOut2 + i)));
+
+        // 更新历史值 (未使能的轴不写入)
+        _mm512_mask_storeu_pd(pBank->adIn2 + i, kMask, vIn1);
+        _mm512_mask_storeu_pd(pBank->adIn1 + i, kMask, vIn);
+        _mm512_mask_storeu_pd(pBank->adOut2 + i, kMask, vOut1);
+        _mm512_mask_storeu_pd(pBank->adOut1 + i, kMask, vOut);
+        _mm512_mask_storeu_pd(pdOut + i, kMask, vOut);
+    }
+    _mm256_zeroupper();
+    BiquadBankProcessRange(pBank, pdIn, pdOut, pbEnable, i, iAxisCount);
+}
+
+static void BiquadCpuid(int aiRegs[4], int iLeaf, int iSubLeaf) {
+#if defined(_MSC_VER)
+    __cpuidex(aiRegs, iLeaf, iSubLeaf);
+#else
+    unsigned int a, b, c, d;
+    __cpuid_count(iLeaf, iSubLeaf, a, b, c, d);
+    aiRegs[0] = (int)a; aiRegs[1] = (int)b; aiRegs[2] = (int)c; aiRegs[3] = (int)d;
+#endif
+}
+
+// 读取 XCR0: 操作系统是否保存 YMM/ZMM 寄存器状态
+static unsigned long long BiquadXgetbv(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int uLow, uHigh;
+    __asm__ volatile("xgetbv" : "=a"(uLow), "=d"(uHigh) : "c"(0));
+    return ((unsigned long long)uHigh << 32) | uLow;
+#endif
+}
+#endif
+
+// 查询当前 CPU 和操作系统是否支持指定内核
+int BiquadBankKernelSupported(eBiquadKernel eKernel) {
+    if (eKernel == BIQUAD_KERNEL_SCALAR) {
+        return 1;
+    }
+#ifdef BIQUAD_HAVE_X86_SIMD
+    int aiRegs[4];
+    BiquadCpuid(aiRegs, 0, 0);
+    int iMaxLeaf = aiRegs[0];
+    if (iMaxLeaf < 7) {
+        return 0;
+    }
+
+    BiquadCpuid(aiRegs, 1, 0);
+    int bOsxsave = (aiRegs[2] >> 27) & 1;
+    int bAvx = (aiRegs[2] >> 28) & 1;
+    if (!bOsxsave || !bAvx) {
+        return 0;
+    }
+    unsigned long long ullXcr0 = BiquadXgetbv();
+
+    BiquadCpuid(aiRegs, 7, 0);
+    switch (eKernel) {
+        case BIQUAD_KERNEL_AVX2:
+            // XCR0: SSE(bit1) + AVX(bit2); CPUID.7.EBX bit5: AVX2
+            return ((ullXcr0 & 0x6) == 0x6) && ((aiRegs[1] >> 5) & 1);
+        case BIQUAD_KERNEL_AVX512:
+            // XCR0: 另需 opmask/ZMM_Hi256/Hi16_ZMM(bit5~7); CPUID.7.EBX bit16: AVX512F
+            return ((ullXcr0 & 0xE6) == 0xE6) && ((aiRegs[1] >> 16) & 1);
+        default:
+            return 0;
+    }
+#else
+    return 0;
+#endif
+}
+
+static BiquadProcessFn BiquadBankKernelFunction(eBiquadKernel eKernel) {
+    switch (eKernel) {
+#ifdef BIQUAD_HAVE_X86_SIMD
+        case BIQUAD_KERNEL_AVX2:   return BiquadBankProcessAvx2;
+        case BIQUAD_KERNEL_AVX512: return BiquadBankProcessAvx512;
+#endif
+        case BIQUAD_KERNEL_SCALAR: return BiquadBankProcessScalar;
+        default:                   return NULL;
+    }
+}
+
+const char* BiquadBankKernelName(eBiquadKernel eKernel) {
+    switch (eKernel) {
+        case BIQUAD_KERNEL_AUTO:   return "auto";
+        case BIQUAD_KERNEL_SCALAR: return "scalar";
+        case BIQUAD_KERNEL_AVX2:   return "avx2";
+        case BIQUAD_KERNEL_AVX512: return "avx512";
+        default:                   return "unknown";
+    }
+}
+
+// 自检用伪随机数, 范围 [-0.5, 0.5)
+static double BiquadSelfTestRand(unsigned int* puSeed) {
+    *puSeed = *puSeed * 1103515245u + 12345u;
+    return (double)(*puSeed >> 8) / 16777216.0 - 0.5;
+}
+
+// 自检: 用伪随机系数、输入和使能掩码分别运行标量内核和指定内核, 逐位比较历史值和输出
+// 轴数取 MAX_AXIS_COUNT - 3 以覆盖向量尾部; 一致返回 0
+int BiquadBankSelfTest(eBiquadKernel eKernel) {
+    static stBiquadBank stRef, stTest;
+    double adIn[MAX_AXIS_COUNT], adRefOut[MAX_AXIS_COUNT], adTestOut[MAX_AXIS_COUNT];
+    unsigned char abEnable[MAX_AXIS_COUNT];
+    const int iAxisCount = MAX_AXIS_COUNT - 3;
+    unsigned int uSeed = 12345u;
+
+    BiquadProcessFn pfnTest = BiquadBankKernelFunction(eKernel);
+    if (pfnTest == NULL || !BiquadBankKernelSupported(eKernel)) {
+        return -1;
+    }
+
+    BiquadBankInit(&stRef);
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        double b0 = BiquadSelfTestRand(&uSeed);
+        double b1 = BiquadSelfTestRand(&uSeed);
+        double b2 = BiquadSelfTestRand(&uSeed);
+        double a0 = 1.0 + BiquadSelfTestRand(&uSeed);
+        double a1 = 0.5 * BiquadSelfTestRand(&uSeed);
+        double a2 = 0.25 * BiquadSelfTestRand(&uSeed);
+        BiquadBankSetCoeffs(&stRef, i, b0, b1, b2, a0, a1, a2);
+        adRefOut[i] = adTestOut[i] = (double)i;
+    }
+    stTest = stRef;
+
+    for (int iStep = 0; iStep < 16; iStep++) {
+        for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+            adIn[i] = BiquadSelfTestRand(&uSeed);
+            abEnable[i] = (unsigned char)(((i + iStep) % 5) != 0);
+        }
+        BiquadBankProcessScalar(&stRef, adIn, adRefOut, (iStep & 1) ? abEnable : NULL, iAxisCount);
+        pfnTest(&stTest, adIn, adTestOut, (iStep & 1) ? abEnable : NULL, iAxisCount);
+    }
+
+    if (memcmp(&stRef, &stTest, sizeof(stBiquadBank)) != 0 ||
+        memcmp(adRefOut, adTestOut, sizeof(adRefOut)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// 选择计算内核; AUTO 时依次尝试 AVX-512, AVX2, 标量
+// 指定内核不被支持或自检不一致时返回 -1, 保持原内核不变
+int BiquadBankSelectKernel(eBiquadKernel eKernel) {
+    if (eKernel == BIQUAD_KERNEL_AUTO) {
+        const eBiquadKernel aeOrder[] = { BIQUAD_KERNEL_AVX512, BIQUAD_KERNEL_AVX2 };
+        for (int i = 0; i < (int)(sizeof(aeOrder) / sizeof(aeOrder[0])); i++) {
+            if (BiquadBankSelectKernel(aeOrder[i]) == 0) {
+                return 0;
+            }
+        }
+        eKernel = BIQUAD_KERNEL_SCALAR;
+    }
+
+    BiquadProcessFn pfnProcess = BiquadBankKernelFunction(eKernel);
+    if (pfnProcess == NULL || !BiquadBankKernelSupported(eKernel)) {
+        return -1;
+    }
+    if (eKernel != BIQUAD_KERNEL_SCALAR && BiquadBankSelfTest(eKernel) != 0) {
+        log_warn("Biquad kernel %s does not match scalar results, not used", BiquadBankKernelName(eKernel));
+        return -1;
+    }
+
+    s_eKernel = eKernel;
+    s_pfnProcess = pfnProcess;
+    log_debug("Biquad bank kernel: %s", BiquadBankKernelName(eKernel));
+    return 0;
+}
+
+eBiquadKernel BiquadBankGetKernel(void) {
+    if (s_pfnProcess == NULL) {
+        BiquadBankSelectKernel(BIQUAD_KERNEL_AUTO);
+    }
+    return s_eKernel;
+}
+
+// 对前 iAxisCount 个轴执行一步滤波
+// pbEnable 为 NULL 时更新所有轴, 否则只更新 pbEnable[i] 非零的轴 (其余轴的输出和历史值保持不变)
+// pdOut 可与 pdIn 相同 (各内核先读取一组轴的输入再写同一组轴的输出), 用于多级原地级联
+// 首次调用时自动选择内核, 也可在启动时显式调用 BiquadBankSelectKernel
+void BiquadBankProcess(stBiquadBank* pBank, const double* pdIn, double* pdOut,
+                       const unsigned char* pbEnable, int iAxisCount) {
+    if (s_pfnProcess == NULL) {
+        BiquadBankSelectKernel(BIQUAD_KERNEL_AUTO);
+    }
+    s_pfnProcess(pBank, pdIn, pdOut, pbEnable, iAxisCount);
+}
@@ -3,164 +3,375 @@
 #include <windows.h>
 #include <process.h>
 #include <stdlib.h>
+#include <string.h>
 #include "ThreadControl.h"
+#include "SpscRing.h"
+#include "DoubleFormat.h"
+#include "TelemetryCompress.h"
 
-// CSV数据缓冲区和相关变量
-static CSVData g_csvDataBuffer[DATA_BUFFER_SIZE];
-static int g_csvBufferHead = 0;
-static int g_csvBufferTail = 0;
-static int g_csvBufferCount = 0;
-static HANDLE g_csvBufferMutex = NULL;
-static HANDLE g_csvBufferNotEmpty = NULL;
-static HANDLE g_csvBufferNotFull = NULL;
-static int g_csvThreadRunning = 0;
+// 二进制缓冲区每批追加的最大字节数: 一批定长记录, 或压缩时一批至多完成一组 (CSV_DRAIN_BATCH < 组记录数)
+#define CSV_TELEMETRY_APPEND_MAX TELEMETRY_GROUP_MAX_BYTES(TELEMETRY_STD_CHANNELS_MAX, TELEMETRY_GROUP_RECORDS)
+typedef char CSVTelemetryAppendCheck[(CSV_TELEMETRY_APPEND_MAX >= CSV_DRAIN_BATCH * TELEMETRY_RECORD_MAX &&
+                                      CSV_DRAIN_BATCH < TELEMETRY_GROUP_RECORDS) ? 1 : -1];
+
+// 控制线程 -> 写入线程的记录队列
+static CSVData g_csvRingStorage[CSV_RING_CAPACITY];
+static stSpscRing g_csvRing;
+static CSVData g_csvBatch[CSV_DRAIN_BATCH];     // 写入线程取出的一批记录 (仅写入线程使用)
+static volatile LONG g_csvThreadRunning = 0;
+static volatile LONG g_csvThreadExited = 0;
 static FILE* g_pCSVFile = NULL;
 
+// 文本缓冲区 (仅写入线程使用): 未写出的文本 < 写出阈值 <= CSV_FLUSH_BYTES_MAX, 再追加一批也不会越界
+static char g_csvText[CSV_FLUSH_BYTES_MAX + CSV_BATCH_TEXT_MAX];
+static size_t g_uCSVTextLength = 0;
+// 二进制输出 (仅写入线程追加; 头部在写入线程启动前由 SetTelemetryFile 写出)
+static FILE* g_pTelemetryFile = NULL;
+static stTelemetryHeader g_stTelemetryHeader;
+static unsigned char g_telemetryBuffer[CSV_FLUSH_BYTES_MAX + CSV_TELEMETRY_APPEND_MAX];
+static size_t g_uTelemetryLength = 0;
+// 压缩输出: 当前组暂存的定长记录
+static int g_bTelemetryCompress = 0;
+static unsigned char g_telemetryGroup[TELEMETRY_GROUP_RECORDS * TELEMETRY_RECORD_MAX];
+static uint32_t g_uGroupRecords = 0;
+static uint64_t g_ullGroupFirst = 0;    // 当前组首条记录的序号
+static uint64_t g_ullGroupOffset = 0;   // 当前组在文件中的偏移
+static stTelemetryIndexBuilder g_stTelemetryIndex;  // 组索引 (退出时追加到文件末尾)
+static volatile size_t g_uFlushBytes = CSV_FLUSH_BYTES_DEFAULT;
+static volatile unsigned int g_uFlushMs = CSV_FLUSH_MS_DEFAULT;
+static int g_iCaptureFormat = CSV_CAPTURE_TEXT;     // 控制系统的记录格式 (启动时设置)
+
+// 统计: 生产者计数仅控制线程修改, 消费者计数仅写入线程修改, 其他线程读取为近似值
+static volatile unsigned long long g_ullCaptured = 0;
+static volatile unsigned long long g_ullDropped = 0;
+static volatile unsigned long long g_ullWritten = 0;
+static volatile unsigned long long g_ullBatches = 0;
+static volatile unsigned long long g_ullRows = 0;
+static volatile unsigned long long g_ullBytes = 0;      // 两路输出合计
+static volatile unsigned long long g_ullTelemetryRaw = 0;
+static volatile unsigned long long g_ullTelemetryBytes = 0;
+static volatile unsigned long long g_ullWrites = 0;
+static volatile unsigned long long g_ullWriteFailures = 0;
+static volatile LONGLONG g_llBusyTicks = 0;
+static volatile LONG g_lMaxDepth = 0;
+
+static LONGLONG CSVWriterNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
 // 初始化CSV缓冲区
 void InitCSVBuffer(void) {
-    g_csvBufferHead = 0;
-    g_csvBufferTail = 0;
-    g_csvBufferCount = 0;
-    g_csvThreadRunning = 1;
-    
-    // 创建同步对象
-    g_csvBufferMutex = CreateMutex(NULL, FALSE, NULL);
-    g_csvBufferNotEmpty = CreateSemaphore(NULL, 0, DATA_BUFFER_SIZE, NULL);
-    g_csvBufferNotFull = CreateSemaphore(NULL, DATA_BUFFER_SIZE, DATA_BUFFER_SIZE, NULL);
-}
-
-// 清理CSV缓冲区资源
+    SpscRingInit(&g_csvRing, g_csvRingStorage, CSV_RING_CAPACITY, sizeof(CSVData));
+    g_ullCaptured = 0;
+    g_ullDropped = 0;
+    g_ullWritten = 0;
+    g_ullBatches = 0;
+    g_ullRows = 0;
+    g_ullBytes = 0;
+    g_ullTelemetryRaw = 0;
+    g_ullTelemetryBytes = 0;
+    g_ullWrites = 0;
+    g_ullWriteFailures = 0;
+    g_llBusyTicks = 0;
+    g_lMaxDepth = 0;
+    g_uCSVTextLength = 0;
+    g_uTelemetryLength = 0;
+    g_csvThreadExited = 0;
+    WriteRelease(&g_csvThreadRunning, 1);
+}
+
+// 清理CSV缓冲区资源 (队列存储为静态区, 无需释放)
 void CleanupCSVBuffer(void) {
-    g_csvThreadRunning = 0;
-    
-    // 释放同步对象
-    if (g_csvBufferMutex) {
-        CloseHandle(g_csvBufferMutex);
-        g_csvBufferMutex = NULL;
+    WriteRelease(&g_csvThreadRunning, 0);
+}
+
+// 设置CSV文件指针 (须在打开后、首次读写前调用); 文件改为无缓冲, 写入线程每次写出即一次系统调用
+void SetCSVFile(FILE* pFile) {
+    if (pFile != NULL) {
+        setvbuf(pFile, NULL, _IONBF, 0);
     }
-    
-    if (g_csvBufferNotEmpty) {
-        CloseHandle(g_csvBufferNotEmpty);
-        g_csvBufferNotEmpty = NULL;
+    g_pCSVFile = pFile;
+}
+
+// 设置二进制记录文件 (须在打开后、写入线程启动前调用): 按当前轴数生成头部并写出, 之后由写入线程追加记录
+// (bCompress 非 0 时分组压缩); 写头部失败返回 -1 (不启用二进制输出). 文件应以允许其他进程读取的方式打开,
+// 以便采集过程中读取
+int SetTelemetryFile(FILE* pFile, double dSampleTime, int bCompress) {
+    FILETIME stNow;
+    g_pTelemetryFile = NULL;
+    if (pFile == NULL || TelemetryHeaderInit(&g_stTelemetryHeader, g_iAxisCount, dSampleTime) != 0) {
+        return -1;
     }
-    
-    if (g_csvBufferNotFull) {
-        CloseHandle(g_csvBufferNotFull);
-        g_csvBufferNotFull = NULL;
+    g_bTelemetryCompress = bCompress;
+    g_uGroupRecords = 0;
+    g_ullGroupFirst = 0;
+    g_ullGroupOffset = TELEMETRY_HEADER_SIZE;
+    TelemetryIndexInit(&g_stTelemetryIndex);
+    if (bCompress) {
+        g_stTelemetryHeader.uFlags |= TELEMETRY_FLAG_COMPRESSED;
     }
+    GetSystemTimeAsFileTime(&stNow);
+    g_stTelemetryHeader.ullStartTime = ((uint64_t)stNow.dwHighDateTime << 32) | stNow.dwLowDateTime;
+    setvbuf(pFile, NULL, _IONBF, 0);
+    if (fwrite(&g_stTelemetryHeader, 1, sizeof(g_stTelemetryHeader), pFile) != sizeof(g_stTelemetryHeader)) {
+        return -1;
+    }
+    g_pTelemetryFile = pFile;
+    return 0;
 }
 
-// 设置CSV文件指针
-void SetCSVFile(FILE* pFile) {
-    g_pCSVFile = pFile;
+// 设置控制系统的记录格式 (CSV_CAPTURE_*, 须在 InitControlSystem 之前调用), 格式无效返回 -1 (保持不变)
+int CSVWriterSetCaptureFormat(int iFormat) {
+    if (iFormat != CSV_CAPTURE_TEXT && iFormat != CSV_CAPTURE_BINARY && iFormat != CSV_CAPTURE_COMPRESSED) {
+        return -1;
+    }
+    g_iCaptureFormat = iFormat;
+    return 0;
+}
+
+int CSVWriterGetCaptureFormat(void) {
+    return g_iCaptureFormat;
+}
+
+// 设置写出策略: 累计文本达到 uFlushBytes 字节 (0: 每批写出, 超过上限按上限) 或距上次写出 uFlushMs 毫秒 (0: 不按时间)
+void CSVWriterSetFlushPolicy(size_t uFlushBytes, unsigned int uFlushMs) {
+    g_uFlushBytes = (uFlushBytes > CSV_FLUSH_BYTES_MAX) ? CSV_FLUSH_BYTES_MAX : uFlushBytes;
+    g_uFlushMs = uFlushMs;
+}
+
+// 将 lCount 条记录格式化为文本 (每条记录每轴一行, 行首为换行符), 返回字节数;
+// pcText 至少 lCount * g_iAxisCount * CSV_ROW_MAX_CHARS 字节
+size_t CSVWriterFormatBatch(const CSVData* pstData, LONG lCount, char* pcText) {
+    char* p = pcText;
+    for (LONG i = 0; i < lCount; i++) {
+        const CSVData* data = &pstData[i];
+        // 步号与时间每条记录只格式化一次, 各轴行复用
+        char acPrefix[2 * DOUBLE_FORMAT_MAX_CHARS + 2];
+        int iPrefix = 0;
+        acPrefix[iPrefix++] = '\n';
+        iPrefix += DoubleFormatInt(data->step, acPrefix + iPrefix);
+        acPrefix[iPrefix++] = ',';
+        iPrefix += DoubleFormatShortest(data->time, acPrefix + iPrefix);
+
+        for (int axis = 0; axis < g_iAxisCount; axis++) {
+            memcpy(p, acPrefix, (size_t)iPrefix);
+            p += iPrefix;
+            *p++ = ',';
+            p += DoubleFormatShortest(data->targetPosition[axis], p);
+            *p++ = ',';
+            p += DoubleFormatShortest(data->actualPosition[axis], p);
+            *p++ = ',';
+            p += DoubleFormatShortest(data->error[axis], p);
+            *p++ = ',';
+            p += DoubleFormatShortest(data->controlForce[axis], p);
+            *p++ = ',';
+            p += DoubleFormatInt(data->controlMode[axis], p);
+        }
+    }
+    return (size_t)(p - pcText);
+}
+
+// 将 lCount 条记录按头部的标准列编码为定长二进制记录 (各数组整块复制), 返回字节数;
+// pucOut 至少 lCount * pHeader->uRecordSize 字节
+size_t CSVWriterEncodeBatch(const stTelemetryHeader* pHeader, const CSVData* pstData, LONG lCount,
+                             unsigned char* pucOut) {
+    const stTelemetryColumn* pColumn = pHeader->astColumn;
+    size_t uAxisBytes = sizeof(double) * pHeader->uAxisCount;
+    for (LONG i = 0; i < lCount; i++) {
+        const CSVData* data = &pstData[i];
+        unsigned char* p = pucOut + (size_t)i * pHeader->uRecordSize;
+        int32_t iStep = data->step;
+        memcpy(p + pColumn[TELEMETRY_COL_TIME].uOffset, &data->time, sizeof(double));
+        memcpy(p + pColumn[TELEMETRY_COL_TARGET].uOffset, data->targetPosition, uAxisBytes);
+        memcpy(p + pColumn[TELEMETRY_COL_ACTUAL].uOffset, data->actualPosition, uAxisBytes);
+        memcpy(p + pColumn[TELEMETRY_COL_ERROR].uOffset, data->error, uAxisBytes);
+        memcpy(p + pColumn[TELEMETRY_COL_FORCE].uOffset, data->controlForce, uAxisBytes);
+        memcpy(p + pColumn[TELEMETRY_COL_STEP].uOffset, &iStep, sizeof(int32_t));
+        memcpy(p + pColumn[TELEMETRY_COL_MODE].uOffset, data->controlMode, sizeof(int32_t) * pHeader->uAxisCount);
+    }
+    return (size_t)lCount * pHeader->uRecordSize;
+}
+
+// 压缩当前组并追加到二进制缓冲区, 登记到组索引 (仅写入线程调用)
+static void CSVWriterCloseGroup(void) {
+    size_t uBytes = TelemetryCompressGroup(&g_stTelemetryHeader, g_telemetryGroup, g_uGroupRecords,
+                                           g_ullGroupFirst, g_telemetryBuffer + g_uTelemetryLength);
+    TelemetryIndexAdd(&g_stTelemetryIndex, g_ullGroupFirst, g_ullGroupOffset);
+    g_uTelemetryLength += uBytes;
+    g_ullGroupOffset += uBytes;
+    g_ullGroupFirst += g_uGroupRecords;
+    g_uGroupRecords = 0;
+}
+
+// 压缩输出: 将一批记录编码到当前组, 满一组即压缩
+static void CSVWriterStageRecords(const CSVData* pstData, LONG lCount) {
+    while (lCount > 0) {
+        LONG lTake = (LONG)(TELEMETRY_GROUP_RECORDS - g_uGroupRecords);
+        if (lTake > lCount) {
+            lTake = lCount;
+        }
+        CSVWriterEncodeBatch(&g_stTelemetryHeader, pstData, lTake,
+                             g_telemetryGroup + (size_t)g_uGroupRecords * g_stTelemetryHeader.uRecordSize);
+        g_uGroupRecords += (uint32_t)lTake;
+        pstData += lTake;
+        lCount -= lTake;
+        if (g_uGroupRecords == TELEMETRY_GROUP_RECORDS) {
+            CSVWriterCloseGroup();
+        }
+    }
+}
+
+// 一次写出一路输出的缓冲数据 (仅写入线程调用), 返回实际写出的字节数
+// 未全部写出 (磁盘满或 I/O 错误, 文件从此处截断) 时计入写出失败, 未写出的部分丢弃
+static size_t CSVWriterWriteOut(FILE* pFile, const void* pBuffer, size_t* puLength) {
+    size_t uWritten = 0;
+    if (pFile != NULL && *puLength > 0) {
+        uWritten = fwrite(pBuffer, 1, *puLength, pFile);
+        g_ullBytes += uWritten;
+        g_ullWrites++;
+        if (uWritten != *puLength) {
+            g_ullWriteFailures++;
+        }
+    }
+    *puLength = 0;
+    return uWritten;
 }
 
-// 将数据写入CSV缓冲区
-int WriteCSVDataToBuffer(int step, double time, 
-                        double targetPosition[], double actualPosition[],
-                        double error[], double controlForce[], int controlMode[]) {
-    // 等待缓冲区有空间
-    WaitForSingleObject(g_csvBufferNotFull, INFINITE);
-    
-    // 获取互斥锁
-    WaitForSingleObject(g_csvBufferMutex, INFINITE);
-    
-    // 检查缓冲区是否已满
-    if (g_csvBufferCount >= DATA_BUFFER_SIZE) {
-        ReleaseMutex(g_csvBufferMutex);
-        ReleaseSemaphore(g_csvBufferNotFull, 1, NULL);
+// 将本周期数据写入队列 (控制线程调用, 不加锁、不等待); 队列满时丢弃并计数, 返回 -1
+int WriteCSVDataToBuffer(int step, double time, const ControlData* pData, const int* piControlMode) {
+    CSVData* data = (CSVData*)SpscRingReserve(&g_csvRing);
+    if (data == NULL) {
+        g_ullDropped++;
         return -1;
     }
-    
-    // 写入数据到缓冲区
-    CSVData* data = &g_csvDataBuffer[g_csvBufferHead];
+
     data->step = step;
     data->time = time;
-    
-    for (int axis = 0; axis < AXIS_COUNT; axis++) {
-        data->targetPosition[axis] = targetPosition[axis];
-        data->actualPosition[axis] = actualPosition[axis];
-        data->error[axis] = error[axis];
-        data->controlForce[axis] = controlForce[axis];
-        data->controlMode[axis] = controlMode[axis];
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        data->targetPosition[axis] = pData->dTargetPosition[axis];
+        data->actualPosition[axis] = pData->dActualPosition[axis];
+        data->error[axis] = pData->dError[axis];
+        data->controlForce[axis] = pData->dControlForce[axis];
+        data->controlMode[axis] = piControlMode[axis];
     }
-    
-    // 更新缓冲区指针
-    g_csvBufferHead = (g_csvBufferHead + 1) % DATA_BUFFER_SIZE;
-    g_csvBufferCount++;
-    
-    // 释放互斥锁
-    ReleaseMutex(g_csvBufferMutex);
-    
-    // 发信号表示缓冲区不为空
-    ReleaseSemaphore(g_csvBufferNotEmpty, 1, NULL);
-    
+
+    SpscRingCommit(&g_csvRing);
+    g_ullCaptured++;
     return 0;
 }
 
+// 通知写入线程取完队列后退出, 并等待其确认 (至多 CSV_STOP_TIMEOUT_MS); 关闭文件前调用
+void CSVWriterStop(void) {
+    WriteRelease(&g_csvThreadRunning, 0);
+    for (int iWaited = 0; iWaited < CSV_STOP_TIMEOUT_MS && !ReadAcquire(&g_csvThreadExited); iWaited++) {
+        Sleep(1);
+    }
+}
+
+// 读取统计信息
+void CSVWriterGetStats(stCSVWriterStats* pStats) {
+    LARGE_INTEGER liFreq;
+    pStats->ullCaptured = g_ullCaptured;
+    pStats->ullDropped = g_ullDropped;
+    pStats->ullWritten = g_ullWritten;
+    pStats->ullBatches = g_ullBatches;
+    pStats->ullRows = g_ullRows;
+    pStats->ullBytes = g_ullBytes;
+    pStats->ullTelemetryRaw = g_ullTelemetryRaw;
+    pStats->ullTelemetryBytes = g_ullTelemetryBytes;
+    pStats->ullWrites = g_ullWrites;
+    pStats->ullWriteFailures = g_ullWriteFailures;
+    QueryPerformanceFrequency(&liFreq);
+    pStats->dBusyUs = (double)g_llBusyTicks * 1.0e6 / (double)liFreq.QuadPart;
+    pStats->dRowsPerSecond = (pStats->dBusyUs > 0.0) ? (double)pStats->ullRows * 1.0e6 / pStats->dBusyUs : 0.0;
+    pStats->lDepth = SpscRingCount(&g_csvRing);
+    pStats->lMaxDepth = g_lMaxDepth;
+}
+
 // CSV写入线程函数
 void* CSVWriterThreadFunction(void* param) {
+    LARGE_INTEGER liFreq;
+    LONGLONG llLastWrite;
+    (void)param;
     printf("CSV writer thread started\n");
-    
-    while (g_csvThreadRunning || g_csvBufferCount > 0) {
-        // 等待缓冲区有数据
-        if (WaitForSingleObject(g_csvBufferNotEmpty, 100) == WAIT_TIMEOUT) {
-            // 超时继续检查条件
-            continue;
-        }
-        
-        // 获取互斥锁
-        WaitForSingleObject(g_csvBufferMutex, INFINITE);
-        
-        // 检查缓冲区是否为空
-        if (g_csvBufferCount <= 0) {
-            ReleaseMutex(g_csvBufferMutex);
-            ReleaseSemaphore(g_csvBufferNotEmpty, 1, NULL);
-            continue;
+    QueryPerformanceFrequency(&liFreq);
+    llLastWrite = CSVWriterNow();
+
+    for (;;) {
+        // 先读取运行标记再取队列: 标记清除后取到空队列即可退出, 不会漏掉停止前写入的记录
+        LONG lRunning = ReadAcquire(&g_csvThreadRunning);
+        LONG lDepth = SpscRingCount(&g_csvRing);
+        if (lDepth > g_lMaxDepth) {
+            g_lMaxDepth = lDepth;
         }
-        
-        // 从缓冲区读取数据
-        CSVData data = g_csvDataBuffer[g_csvBufferTail];
-        
-        // 更新缓冲区指针
-        g_csvBufferTail = (g_csvBufferTail + 1) % DATA_BUFFER_SIZE;
-        g_csvBufferCount--;
-        
-        // 释放互斥锁
-        ReleaseMutex(g_csvBufferMutex);
-        
-        // 发信号表示缓冲区有空间了
-        ReleaseSemaphore(g_csvBufferNotFull, 1, NULL);
-        
-        // 写入数据到文件
-        if (g_pCSVFile) {
-            //fprintf(g_pCSVFile, "%d,%.3f", data.step, data.time);
-            for(int axis = 0; axis < AXIS_COUNT; axis++) {
-                fprintf(g_pCSVFile, "\n");
-                fprintf(g_pCSVFile, "%d,%.3f", data.step, data.time);
-                fprintf(g_pCSVFile, ",%.12f,%.15f,%.13f,%.9f,%d",
-                        data.targetPosition[axis],
-                        data.actualPosition[axis], 
-                        data.error[axis], 
-                        data.controlForce[axis],
-                        data.controlMode[axis]);
+        LONG lCount = SpscRingPopBatch(&g_csvRing, g_csvBatch, CSV_DRAIN_BATCH);
+        LONGLONG llStart = CSVWriterNow();
+
+        // 格式化到文本缓冲区 / 编码到二进制缓冲区
+        if (lCount > 0) {
+            if (g_pCSVFile) {
+                g_uCSVTextLength += CSVWriterFormatBatch(g_csvBatch, lCount, g_csvText + g_uCSVTextLength);
             }
-            //fprintf(g_pCSVFile, "\n");
-            
-            // 定期刷新文件以确保数据写入磁盘
-            static int flushCounter = 0;
-            if (++flushCounter >= 10) {
-                fflush(g_pCSVFile);
-                flushCounter = 0;
+            if (g_pTelemetryFile) {
+                if (g_bTelemetryCompress) {
+                    CSVWriterStageRecords(g_csvBatch, lCount);
+                } else {
+                    g_uTelemetryLength += CSVWriterEncodeBatch(&g_stTelemetryHeader, g_csvBatch, lCount,
+                                                               g_telemetryBuffer + g_uTelemetryLength);
+                }
+                g_ullTelemetryRaw += (unsigned long long)lCount * g_stTelemetryHeader.uRecordSize;
             }
+            g_ullWritten += (unsigned long long)lCount;
+            g_ullRows += (unsigned long long)lCount * (unsigned long long)g_iAxisCount;
+            g_ullBatches++;
+        }
+
+        // 按写出策略一次写出; 退出前写出全部剩余数据
+        unsigned int uFlushMs = g_uFlushMs;
+        size_t uFlushBytes = g_uFlushBytes;
+        int bForce = (lCount == 0 && !lRunning) ||
+                     (uFlushMs > 0 && (llStart - llLastWrite) * 1000 >= (LONGLONG)uFlushMs * liFreq.QuadPart);
+        int bWrite = 0;
+        if (g_pTelemetryFile && g_uGroupRecords > 0 && lCount == 0 && !lRunning) {
+            CSVWriterCloseGroup();
+        }
+        if (g_uCSVTextLength > 0 && (bForce || g_uCSVTextLength >= uFlushBytes)) {
+            CSVWriterWriteOut(g_pCSVFile, g_csvText, &g_uCSVTextLength);
+            bWrite = 1;
+        }
+        if (g_uTelemetryLength > 0 && (bForce || g_uTelemetryLength >= uFlushBytes)) {
+            g_ullTelemetryBytes += CSVWriterWriteOut(g_pTelemetryFile, g_telemetryBuffer, &g_uTelemetryLength);
+            bWrite = 1;
+        }
+        if (bWrite) {
+            llLastWrite = CSVWriterNow();
         }
+        if (lCount > 0 || bWrite) {
+            g_llBusyTicks += CSVWriterNow() - llStart;
+        }
+        if (lCount > 0) {
+            continue;
+        }
+        if (!lRunning) {
+            break;
+        }
+        Sleep(CSV_WRITER_IDLE_MS);
     }
-    
-    // 最终刷新文件
-    if (g_pCSVFile) {
-        fflush(g_pCSVFile);
+
+    // 压缩输出: 全部组写出后追加组索引, 读取端据此随机定位
+    if (g_pTelemetryFile && g_bTelemetryCompress) {
+        long long llIndexBytes = TelemetryIndexWrite(&g_stTelemetryIndex, g_ullGroupOffset, g_pTelemetryFile);
+        if (llIndexBytes > 0) {
+            g_ullBytes += (unsigned long long)llIndexBytes;
+        } else {
+            g_ullWriteFailures++;
+        }
+        g_ullWrites++;
     }
-    
+
     printf("CSV writer thread exiting\n");
+    WriteRelease(&g_csvThreadExited, 1);
     return NULL;
-}
\ No newline at end of file
+}
@@ -0,0 +1,138 @@
+#include "CommandQueue.h"
+#include <string.h>
+
+// 生产者 (Socket 线程) 独占的统计量
+typedef struct {
+    unsigned long long ullEnqueued;
+    unsigned long long ullOverflow;
+    LONG lMaxDepth;
+    double dMaxEnqueueUs;
+    double dSumEnqueueUs;
+    char acPad[SPSC_CACHE_LINE];
+} stProducerStats;
+
+// 消费者 (控制线程) 独占的统计量
+typedef struct {
+    unsigned long long ullDequeued;
+    double dMaxLatencyUs;
+    double dSumLatencyUs;
+    unsigned long long ullFeedbackDropped;
+    char acPad[SPSC_CACHE_LINE];
+} stConsumerStats;
+
+static stCommandEntry g_astCommandStorage[COMMAND_QUEUE_CAPACITY];
+static stSpscRing g_stCommandRing;
+// 异步完成反馈队列: 控制线程生产, Socket 线程消费 (方向与指令队列相反)
+static CommandFeedback g_astFeedbackStorage[COMMAND_FEEDBACK_CAPACITY];
+static stSpscRing g_stFeedbackRing;
+static stProducerStats g_stProducerStats;
+static stConsumerStats g_stConsumerStats;
+static double g_dTicksToUs = 0.0;
+
+static LONGLONG CommandQueueNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
+// 初始化指令队列 (须在 Socket 线程和控制线程启动前调用)
+void CommandQueueInit(void) {
+    LARGE_INTEGER liFreq;
+    QueryPerformanceFrequency(&liFreq);
+    g_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+
+    memset(&g_stProducerStats, 0, sizeof(g_stProducerStats));
+    memset(&g_stConsumerStats, 0, sizeof(g_stConsumerStats));
+    SpscRingInit(&g_stCommandRing, g_astCommandStorage, COMMAND_QUEUE_CAPACITY, sizeof(stCommandEntry));
+    SpscRingInit(&g_stFeedbackRing, g_astFeedbackStorage, COMMAND_FEEDBACK_CAPACITY, sizeof(CommandFeedback));
+}
+
+// 入队一条指令 (仅 Socket 线程调用), 队列满时丢弃并计数, 返回 -1
+int CommandQueuePush(const struct RxData* pRxData, int iSequence) {
+    stCommandEntry stEntry;
+    LONGLONG llStart = CommandQueueNow();
+
+    stEntry.stRx = *pRxData;
+    stEntry.iSequence = iSequence;
+    stEntry.llEnqueueTicks = llStart;
+
+    if (SpscRingPush(&g_stCommandRing, &stEntry) != 0) {
+        g_stProducerStats.ullOverflow++;
+        return -1;
+    }
+
+    double dCostUs = (double)(CommandQueueNow() - llStart) * g_dTicksToUs;
+    LONG lDepth = SpscRingCount(&g_stCommandRing);
+
+    g_stProducerStats.ullEnqueued++;
+    g_stProducerStats.dSumEnqueueUs += dCostUs;
+    if (dCostUs > g_stProducerStats.dMaxEnqueueUs) {
+        g_stProducerStats.dMaxEnqueueUs = dCostUs;
+    }
+    if (lDepth > g_stProducerStats.lMaxDepth) {
+        g_stProducerStats.lMaxDepth = lDepth;
+    }
+    return 0;
+}
+
+// 出队一条指令 (仅控制线程调用), 队列空时返回 -1
+int CommandQueuePop(stCommandEntry* pEntry) {
+    if (SpscRingPop(&g_stCommandRing, pEntry) != 0) {
+        return -1;
+    }
+
+    double dLatencyUs = (double)(CommandQueueNow() - pEntry->llEnqueueTicks) * g_dTicksToUs;
+
+    g_stConsumerStats.ullDequeued++;
+    g_stConsumerStats.dSumLatencyUs += dLatencyUs;
+    if (dLatencyUs > g_stConsumerStats.dMaxLatencyUs) {
+        g_stConsumerStats.dMaxLatencyUs = dLatencyUs;
+    }
+    return 0;
+}
+
+// 获取统计信息快照 (跨线程读取, 各字段为近似值)
+void CommandQueueGetStats(stCommandQueueStats* pStats) {
+    memset(pStats, 0, sizeof(stCommandQueueStats));
+
+    pStats->ullEnqueued = g_stProducerStats.ullEnqueued;
+    pStats->ullOverflow = g_stProducerStats.ullOverflow;
+    pStats->lMaxDepth = g_stProducerStats.lMaxDepth;
+    pStats->dMaxEnqueueUs = g_stProducerStats.dMaxEnqueueUs;
+    if (pStats->ullEnqueued > 0) {
+        pStats->dMeanEnqueueUs = g_stProducerStats.dSumEnqueueUs / (double)pStats->ullEnqueued;
+    }
+
+    pStats->ullDequeued = g_stConsumerStats.ullDequeued;
+    pStats->dMaxLatencyUs = g_stConsumerStats.dMaxLatencyUs;
+    if (pStats->ullDequeued > 0) {
+        pStats->dMeanLatencyUs = g_stConsumerStats.dSumLatencyUs / (double)pStats->ullDequeued;
+    }
+
+    pStats->ullFeedbackDropped = g_stConsumerStats.ullFeedbackDropped;
+    pStats->lDepth = SpscRingCount(&g_stCommandRing);
+}
+
+// 指令是否异步完成: 出队处理时只提交, 完成后由控制线程经反馈队列发送最终状态
+int CommandIsAsync(int iCMD) {
+    return iCMD == 5 || iCMD == 12 || iCMD == 14 || iCMD == 15 || iCMD == 17 || iCMD == 18;
+}
+
+// 流式指令 (CMD 14 追加目标点): Socket 线程不发送受理反馈, 每条只由控制线程发送一条最终状态
+int CommandIsStreamed(const struct RxData* pRxData) {
+    return pRxData->iCMD == 14 && pRxData->iReserved[1] == 1;
+}
+
+// 写入一条异步完成反馈 (仅控制线程调用), 队列满时丢弃并计数, 返回 -1
+int CommandFeedbackPush(const CommandFeedback* pFeedback) {
+    if (SpscRingPush(&g_stFeedbackRing, pFeedback) != 0) {
+        g_stConsumerStats.ullFeedbackDropped++;
+        return -1;
+    }
+    return 0;
+}
+
+// 取出一条异步完成反馈 (仅 Socket 线程调用), 队列空时返回 -1
+int CommandFeedbackPop(CommandFeedback* pFeedback) {
+    return SpscRingPop(&g_stFeedbackRing, pFeedback);
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 #include "Controler.h"
 #include "Notch_TF.h"
 
@@ -18,24 +19,164 @@
 
 #define SAMPLING_TIME 0.001 //采样时间 1ms
 
-/* 初始化控制器 */
+/* 初始化控制器: 默认链路 PID -> 低通 -> 陷波 */
 void ControllerInit(Controller *ctrl) {
-    // 初始化PID控制器
-    PIDControllerInit(&ctrl->pid, KP, KI, KD, SAMPLING_TIME);
-    // 初始化低通滤波器
-    LowPassFilterInit(&ctrl->lpf, LPF_FREQ, LPF_DAMP, SAMPLING_TIME);
-    //初始化陷波滤波器
-    NotchTFInit(&ctrl->notch, NotchFreq, NotchFreqPole, NotchDampZero, NotchDampPole, SAMPLING_TIME);
+    ctrl->sample_time = SAMPLING_TIME;
+    SosCascadeInit(&ctrl->stCascade);
+    ctrl->stCascade.iSectionCount = 1;  // 第0节: PID
+    ControllerSetGains(ctrl, KP, KI, KD);
+    ControllerRestoreDefaultFilters(ctrl);
+}
+
+/* 恢复默认滤波器 (低通 -> 陷波), 保留当前PID增益 */
+void ControllerRestoreDefaultFilters(Controller *ctrl) {
+    ControllerClearFilters(ctrl);
+    ControllerAddLowPass(ctrl, LPF_FREQ, LPF_DAMP);
+    ControllerAddNotch(ctrl, NotchFreq, NotchFreqPole, NotchDampZero, NotchDampPole);
 }
 
 /* 控制器更新函数 */
 double ControllerUpdate(Controller *ctrl, double error) {
-    // 使用PID控制器计算控制输出
-    double dPidOutput = PIDControllerUpdate(&ctrl->pid, error);
-    // 使用低通滤波器对PID输出进行滤波
-    double dFilteredOutput = LowPassFilterUpdate(&ctrl->lpf, dPidOutput);
-    //使用陷波滤波器对输出进行滤波
-    double dNotchOutput = NotchTFUpdate(&ctrl->notch, dFilteredOutput);
-    
-    return dNotchOutput;
-}
\ No newline at end of file
+    return SosCascadeUpdate(&ctrl->stCascade, error);
+}
+
+/* 清除控制器所有状态 */
+void ControllerReset(Controller *ctrl) {
+    SosCascadeReset(&ctrl->stCascade);
+}
+
+/* 修改PID增益: 只重新生成第0节系数
+   控制器组中各级的历史值为输入/输出信号本身, ControllerBankCompileAxis 后按新系数继续递推
+   (PID 节分母为 1 - z^-2, 即增量形式), 输出无跳变;
+   单独使用 ControllerUpdate 时第0节为 DF2T, 其状态是旧系数与历史信号的组合, 无法换算到新系数, 清零 */
+void ControllerSetGains(Controller *ctrl, double kp, double ki, double kd) {
+    ctrl->kp = kp;
+    ctrl->ki = ki;
+    ctrl->kd = kd;
+    PIDControllerDesignSos(kp, ki, kd, ctrl->sample_time, &ctrl->stCascade.astSection[0]);
+}
+
+/* 移除PID之后的所有滤波器 */
+void ControllerClearFilters(Controller *ctrl) {
+    SosCascadeTruncate(&ctrl->stCascade, 1);
+    ctrl->iNotchCount = 0;
+}
+
+/* 追加一节, 级联已满 (SOS_MAX_SECTIONS) 返回 -1 */
+static int ControllerAddSection(Controller *ctrl, const stSosSection *section) {
+    return SosCascadeAddSection(&ctrl->stCascade, section);
+}
+
+/* 追加二阶低通滤波器, 频率或阻尼 <= 0 或级联已满返回 -1 */
+int ControllerAddLowPass(Controller *ctrl, double cutoff_freq, double damping) {
+    stSosSection stSection;
+    if (!(cutoff_freq > 0.0) || !(damping > 0.0)) {
+        return -1;
+    }
+    LowPassFilterDesignSos(cutoff_freq, damping, ctrl->sample_time, &stSection);
+    return ControllerAddSection(ctrl, &stSection);
+}
+
+/* 追加陷波滤波器, 超过 CONTROLLER_MAX_NOTCHES 或级联已满返回 -1
+   频率须 > 0, 零点阻尼 >= 0 (0 为完全陷波), 极点阻尼 > 0 (为 0 时极点在单位圆上), 否则返回 -1 */
+int ControllerAddNotch(Controller *ctrl, double freq_zero, double freq_pole, double damp_zero, double damp_pole) {
+    stSosSection stSection;
+    if (!(freq_zero > 0.0) || !(freq_pole > 0.0) || !(damp_zero >= 0.0) || !(damp_pole > 0.0)) {
+        return -1;
+    }
+    if (ctrl->iNotchCount >= CONTROLLER_MAX_NOTCHES) {
+        return -1;
+    }
+    NotchTFDesignSos(freq_zero, freq_pole, damp_zero, damp_pole, ctrl->sample_time, &stSection);
+    if (ControllerAddSection(ctrl, &stSection) != 0) {
+        return -1;
+    }
+    ctrl->iNotchCount++;
+    return 0;
+}
+
+/* 追加超前/滞后环节, 频率 <= 0 或级联已满返回 -1 */
+int ControllerAddLeadLag(Controller *ctrl, double freq_zero, double freq_pole) {
+    stSosSection stSection;
+    if (!(freq_zero > 0.0) || !(freq_pole > 0.0)) {
+        return -1;
+    }
+    LeadLagDesignSos(freq_zero, freq_pole, ctrl->sample_time, &stSection);
+    return ControllerAddSection(ctrl, &stSection);
+}
+
+/* 初始化多轴控制器组, 各轴参数与 ControllerInit 相同, 并编译到各级滤波器组 */
+void ControllerBankInit(ControllerBank *bank, int axisCount) {
+    for (int s = 0; s < SOS_MAX_SECTIONS; s++) {
+        BiquadBankInit(&bank->astStage[s]);
+    }
+    memset(bank->aiSectionCount, 0, sizeof(bank->aiSectionCount));
+    memset(bank->adWork, 0, sizeof(bank->adWork));
+    bank->iStageCount = 0;
+    for (int i = 0; i < axisCount; i++) {
+        ControllerInit(&bank->astAxis[i]);
+        ControllerBankCompileAxis(bank, i);
+    }
+}
+
+/* 新启用的第 s 级: 各轴以前一级的输出历史作为本级的输入/输出历史
+   (其余轴在该级为直通, 历史即该处的信号; 新加入的单位直流增益滤波器从稳态开始) */
+static void ControllerBankSeedStage(ControllerBank *bank, int s) {
+    stBiquadBank *pStage = &bank->astStage[s];
+    const stBiquadBank *pPrev = &bank->astStage[s - 1];
+    memcpy(pStage->adIn1, pPrev->adOut1, sizeof(pStage->adIn1));
+    memcpy(pStage->adIn2, pPrev->adOut2, sizeof(pStage->adIn2));
+    memcpy(pStage->adOut1, pPrev->adOut1, sizeof(pStage->adOut1));
+    memcpy(pStage->adOut2, pPrev->adOut2, sizeof(pStage->adOut2));
+}
+
+/* 编译指定轴 (初始化或修改增益/滤波器后调用, 不增加每周期开销): 第 s 节系数写入第 s 级, 其后各级置为直通
+   各节独立实现, 不展开为高阶多项式, 任意节组合均可编译; 节数超过 SOS_MAX_SECTIONS 返回 -1
+   各级历史值为信号本身 (与系数无关), 保留不清零 */
+int ControllerBankCompileAxis(ControllerBank *bank, int axis) {
+    const stSosCascade *pCascade = &bank->astAxis[axis].stCascade;
+    const int n = pCascade->iSectionCount;
+    if (n < 0 || n > SOS_MAX_SECTIONS) {
+        return -1;
+    }
+    for (int s = 0; s < SOS_MAX_SECTIONS; s++) {
+        if (s < n) {
+            const stSosSection *pSec = &pCascade->astSection[s];
+            BiquadBankSetCoeffs(&bank->astStage[s], axis, pSec->dB0, pSec->dB1, pSec->dB2, 1.0, pSec->dA1, pSec->dA2);
+        } else {
+            BiquadBankSetCoeffs(&bank->astStage[s], axis, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+        }
+    }
+    bank->aiSectionCount[axis] = n;
+
+    int iStages = 0;
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        if (bank->aiSectionCount[i] > iStages) {
+            iStages = bank->aiSectionCount[i];
+        }
+    }
+    for (int s = (bank->iStageCount > 1) ? bank->iStageCount : 1; s < iStages; s++) {
+        ControllerBankSeedStage(bank, s);
+    }
+    bank->iStageCount = iStages;
+    return 0;
+}
+
+/* 多轴控制器更新: 按级依次处理所有轴 (级间信号在 adWork 中原地传递), 只更新使能轴 (enable 为 NULL 时更新所有轴) */
+void ControllerBankUpdate(ControllerBank *bank, const double *error, double *output,
+                          const unsigned char *enable, int axisCount) {
+    const double *pdIn = error;
+    for (int s = 0; s < bank->iStageCount; s++) {
+        BiquadBankProcess(&bank->astStage[s], pdIn, bank->adWork, enable, axisCount);
+        pdIn = bank->adWork;
+    }
+    if (enable == NULL) {
+        memcpy(output, pdIn, sizeof(double) * axisCount);
+        return;
+    }
+    for (int a = 0; a < axisCount; a++) {
+        if (enable[a]) {
+            output[a] = pdIn[a];
+        }
+    }
+}
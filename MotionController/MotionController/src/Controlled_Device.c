@@ -49,3 +49,11 @@ double RigidBodyTFUpdate(RigidBodyTF *rb, double input) {
 }
 
  
+
+// 在滤波器组中初始化指定轴的刚体传递函数 (系数与 RigidBodyTFInit 相同)
+void RigidBodyBankInitAxis(stBiquadBank *pBank, int iAxis, double mass, double Ts) {
+    RigidBodyTF rb;
+    RigidBodyTFInit(&rb, mass, Ts);
+    BiquadBankSetCoeffs(pBank, iAxis, rb.b0, rb.b1, rb.b2, rb.a0, rb.a1, rb.a2);
+    BiquadBankResetAxis(pBank, iAxis);
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "CycleTimer.h"
+#include <string.h>
+
+// 高精度可等待定时器标志 (Windows 10 1803 及以上支持)
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+#define CYCLE_SPIN_MARGIN 0.0002    // 截止前 200us 改为忙等, 吸收定时器唤醒误差
+
+static LONGLONG CycleTimerNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
+static double CycleTimerTicksToUs(const stCycleTimer* pTimer, LONGLONG llTicks) {
+    return (double)llTicks * 1.0e6 / (double)pTimer->llFrequency;
+}
+
+// 初始化周期定时器
+int CycleTimerInit(stCycleTimer* pTimer, double dPeriod) {
+    LARGE_INTEGER liFreq;
+
+    if (pTimer == NULL || dPeriod <= 0.0) {
+        return -1;
+    }
+    memset(pTimer, 0, sizeof(stCycleTimer));
+
+    if (!QueryPerformanceFrequency(&liFreq) || liFreq.QuadPart <= 0) {
+        return -1;
+    }
+    pTimer->llFrequency = liFreq.QuadPart;
+    pTimer->llPeriodTicks = (LONGLONG)(dPeriod * (double)liFreq.QuadPart + 0.5);
+    pTimer->llSpinTicks = (LONGLONG)(CYCLE_SPIN_MARGIN * (double)liFreq.QuadPart);
+    if (pTimer->llSpinTicks > pTimer->llPeriodTicks) {
+        pTimer->llSpinTicks = pTimer->llPeriodTicks;
+    }
+
+    // 优先使用高精度定时器, 失败时退化为纯忙等
+    pTimer->hTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+
+    CycleTimerStart(pTimer);
+    return 0;
+}
+
+// 以当前时刻为基准重新对齐截止时刻
+void CycleTimerStart(stCycleTimer* pTimer) {
+    pTimer->llWakeTime = CycleTimerNow();
+    pTimer->llNextDeadline = pTimer->llWakeTime + pTimer->llPeriodTicks;
+}
+
+// 等待到下一周期的绝对截止时刻, 并记录唤醒抖动
+void CycleTimerWait(stCycleTimer* pTimer, stCycleStats* pStats) {
+    LONGLONG llNow = CycleTimerNow();
+    LONGLONG llRemain = pTimer->llNextDeadline - llNow;
+
+    // 粗等待: 睡眠到截止前的忙等余量处
+    if (pTimer->hTimer != NULL && llRemain > pTimer->llSpinTicks) {
+        LARGE_INTEGER liDue;
+        // 相对时间, 单位 100ns, 负值表示相对
+        liDue.QuadPart = -(LONGLONG)((double)(llRemain - pTimer->llSpinTicks) * 1.0e7 / (double)pTimer->llFrequency);
+        if (liDue.QuadPart < 0 && SetWaitableTimer(pTimer->hTimer, &liDue, 0, NULL, NULL, FALSE)) {
+            WaitForSingleObject(pTimer->hTimer, INFINITE);
+        }
+    }
+
+    // 精等待: 忙等到截止时刻
+    do {
+        llNow = CycleTimerNow();
+    } while (llNow < pTimer->llNextDeadline);
+
+    pTimer->llWakeTime = llNow;
+
+    if (pStats != NULL) {
+        double dJitterUs = CycleTimerTicksToUs(pTimer, llNow - pTimer->llNextDeadline);
+        pStats->dLastJitterUs = dJitterUs;
+        pStats->dSumJitterUs += dJitterUs;
+        if (dJitterUs > pStats->dMaxJitterUs) {
+            pStats->dMaxJitterUs = dJitterUs;
+        }
+        pStats->ullCycles++;
+    }
+
+    pTimer->llNextDeadline += pTimer->llPeriodTicks;
+}
+
+// 周期内工作结束: 记录执行时间, 检测超限
+void CycleTimerEndCycle(stCycleTimer* pTimer, stCycleStats* pStats) {
+    LONGLONG llNow = CycleTimerNow();
+
+    if (pStats != NULL) {
+        double dExecUs = CycleTimerTicksToUs(pTimer, llNow - pTimer->llWakeTime);
+        pStats->dLastExecUs = dExecUs;
+        if (dExecUs > pStats->dMaxExecUs) {
+            pStats->dMaxExecUs = dExecUs;
+        }
+    }
+
+    // 已错过下一截止时刻: 计为超限, 并跳过已错过的周期以保持相位
+    if (llNow >= pTimer->llNextDeadline) {
+        LONGLONG llMissed = (llNow - pTimer->llNextDeadline) / pTimer->llPeriodTicks + 1;
+        pTimer->llNextDeadline += llMissed * pTimer->llPeriodTicks;
+        if (pStats != NULL) {
+            pStats->ullOverruns++;
+            pStats->ullSkipped += (unsigned long long)llMissed;
+        }
+    }
+}
+
+// 释放定时器资源
+void CycleTimerClose(stCycleTimer* pTimer) {
+    if (pTimer != NULL && pTimer->hTimer != NULL) {
+        CloseHandle(pTimer->hTimer);
+        pTimer->hTimer = NULL;
+    }
+}
+
+// 清零统计信息
+void CycleStatsReset(stCycleStats* pStats) {
+    memset(pStats, 0, sizeof(stCycleStats));
+}
+
+// 平均唤醒抖动 [us]
+double CycleStatsMeanJitterUs(const stCycleStats* pStats) {
+    if (pStats->ullCycles == 0) {
+        return 0.0;
+    }
+    return pStats->dSumJitterUs / (double)pStats->ullCycles;
+}
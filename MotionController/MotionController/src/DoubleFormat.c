@@ -0,0 +1,315 @@
+#include "DoubleFormat.h"
+#include <stdint.h>
+#include <string.h>
+
+// Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers", 2010):
+// 以 64 位整数 (尾数, 二进制指数) 表示 v 及其舍入边界, 乘以预先算好的 10 的幂使指数落入 [-60, -32],
+// 然后逐位生成落在边界内的十进制数字; 边界内任何数都会被 strtod 还原为 v, 因此输出往返精确
+
+#define DP_SIGNIFICAND_BITS 52
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_BITS)
+#define DP_MIN_EXPONENT (1 - DP_EXPONENT_BIAS)
+#define DP_EXPONENT_MASK 0x7FF0000000000000ULL
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define DP_HIDDEN_BIT 0x0010000000000000ULL
+
+// 64 位尾数 + 二进制指数: 值 = f * 2^e
+typedef struct {
+    uint64_t f;
+    int e;
+} stDiyFp;
+
+// 10^k (k = -348, -340, ..., 340) 的规格化 64 位尾数与二进制指数 (就近舍入)
+static const uint64_t s_aullCachedPowerF[87] = {
+    0xFA8FD5A0081C0288ULL, 0xBAAEE17FA23EBF76ULL, 0x8B16FB203055AC76ULL, 0xCF42894A5DCE35EAULL,
+    0x9A6BB0AA55653B2DULL, 0xE61ACF033D1A45DFULL, 0xAB70FE17C79AC6CAULL, 0xFF77B1FCBEBCDC4FULL,
+    0xBE5691EF416BD60CULL, 0x8DD01FAD907FFC3CULL, 0xD3515C2831559A83ULL, 0x9D71AC8FADA6C9B5ULL,
+    0xEA9C227723EE8BCBULL, 0xAECC49914078536DULL, 0x823C12795DB6CE57ULL, 0xC21094364DFB5637ULL,
+    0x9096EA6F3848984FULL, 0xD77485CB25823AC7ULL, 0xA086CFCD97BF97F4ULL, 0xEF340A98172AACE5ULL,
+    0xB23867FB2A35B28EULL, 0x84C8D4DFD2C63F3BULL, 0xC5DD44271AD3CDBAULL, 0x936B9FCEBB25C996ULL,
+    0xDBAC6C247D62A584ULL, 0xA3AB66580D5FDAF6ULL, 0xF3E2F893DEC3F126ULL, 0xB5B5ADA8AAFF80B8ULL,
+    0x87625F056C7C4A8BULL, 0xC9BCFF6034C13053ULL, 0x964E858C91BA2655ULL, 0xDFF9772470297EBDULL,
+    0xA6DFBD9FB8E5B88FULL, 0xF8A95FCF88747D94ULL, 0xB94470938FA89BCFULL, 0x8A08F0F8BF0F156BULL,
+    0xCDB02555653131B6ULL, 0x993FE2C6D07B7FACULL, 0xE45C10C42A2B3B06ULL, 0xAA242499697392D3ULL,
+    0xFD87B5F28300CA0EULL, 0xBCE5086492111AEBULL, 0x8CBCCC096F5088CCULL, 0xD1B71758E219652CULL,
+    0x9C40000000000000ULL, 0xE8D4A51000000000ULL, 0xAD78EBC5AC620000ULL, 0x813F3978F8940984ULL,
+    0xC097CE7BC90715B3ULL, 0x8F7E32CE7BEA5C70ULL, 0xD5D238A4ABE98068ULL, 0x9F4F2726179A2245ULL,
+    0xED63A231D4C4FB27ULL, 0xB0DE65388CC8ADA8ULL, 0x83C7088E1AAB65DBULL, 0xC45D1DF942711D9AULL,
+    0x924D692CA61BE758ULL, 0xDA01EE641A708DEAULL, 0xA26DA3999AEF774AULL, 0xF209787BB47D6B85ULL,
+    0xB454E4A179DD1877ULL, 0x865B86925B9BC5C2ULL, 0xC83553C5C8965D3DULL, 0x952AB45CFA97A0B3ULL,
+    0xDE469FBD99A05FE3ULL, 0xA59BC234DB398C25ULL, 0xF6C69A72A3989F5CULL, 0xB7DCBF5354E9BECEULL,
+    0x88FCF317F22241E2ULL, 0xCC20CE9BD35C78A5ULL, 0x98165AF37B2153DFULL, 0xE2A0B5DC971F303AULL,
+    0xA8D9D1535CE3B396ULL, 0xFB9B7CD9A4A7443CULL, 0xBB764C4CA7A44410ULL, 0x8BAB8EEFB6409C1AULL,
+    0xD01FEF10A657842CULL, 0x9B10A4E5E9913129ULL, 0xE7109BFBA19C0C9DULL, 0xAC2820D9623BF429ULL,
+    0x80444B5E7AA7CF85ULL, 0xBF21E44003ACDD2DULL, 0x8E679C2F5E44FF8FULL, 0xD433179D9C8CB841ULL,
+    0x9E19DB92B4E31BA9ULL, 0xEB96BF6EBADF77D9ULL, 0xAF87023B9BF0EE6BULL,
+};
+static const short s_asCachedPowerE[87] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066,
+};
+
+static const uint64_t s_aullPow10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+// 两个 64 位尾数相乘取高 64 位 (四舍五入)
+static stDiyFp DiyFpMultiply(stDiyFp x, stDiyFp y) {
+    const uint64_t ullMask32 = 0xFFFFFFFFULL;
+    uint64_t a = x.f >> 32, b = x.f & ullMask32;
+    uint64_t c = y.f >> 32, d = y.f & ullMask32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t ullMid = (bd >> 32) + (ad & ullMask32) + (bc & ullMask32) + (1ULL << 31);
+    stDiyFp r;
+    r.f = ac + (ad >> 32) + (bc >> 32) + (ullMid >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+static stDiyFp DiyFpNormalize(stDiyFp x) {
+    while (!(x.f & 0x8000000000000000ULL)) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+// v 的舍入边界 m- 与 m+ (规格化到相同指数)
+static void DiyFpBoundaries(stDiyFp v, stDiyFp* pMinus, stDiyFp* pPlus) {
+    stDiyFp stPlus, stMinus;
+    stPlus.f = (v.f << 1) + 1;
+    stPlus.e = v.e - 1;
+    stPlus = DiyFpNormalize(stPlus);
+    if (v.f == DP_HIDDEN_BIT) {
+        // 尾数为 2 的幂时下边界更近
+        stMinus.f = (v.f << 2) - 1;
+        stMinus.e = v.e - 2;
+    } else {
+        stMinus.f = (v.f << 1) - 1;
+        stMinus.e = v.e - 1;
+    }
+    stMinus.f <<= stMinus.e - stPlus.e;
+    stMinus.e = stPlus.e;
+    *pMinus = stMinus;
+    *pPlus = stPlus;
+}
+
+// 取 10^-K 使 e + 10^-K 的二进制指数落入 [-60, -32]
+static stDiyFp GetCachedPower(int e, int* piK) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;     // log10(2)
+    int k = (int)dk;
+    if (dk - k > 0.0) {
+        k++;
+    }
+    unsigned int uIndex = (unsigned int)((k >> 3) + 1);
+    stDiyFp r;
+    *piK = -(-348 + (int)(uIndex << 3));
+    r.f = s_aullCachedPowerF[uIndex];
+    r.e = s_asCachedPowerE[uIndex];
+    return r;
+}
+
+// 末位向 w 靠近 (在边界内取最接近 v 的数字串)
+static void GrisuRound(char* pcBuffer, int iLength, uint64_t ullDelta, uint64_t ullRest, uint64_t ullTenKappa,
+                       uint64_t ullWpW) {
+    while (ullRest < ullWpW && ullDelta - ullRest >= ullTenKappa &&
+           (ullRest + ullTenKappa < ullWpW || ullWpW - ullRest > ullRest + ullTenKappa - ullWpW)) {
+        pcBuffer[iLength - 1]--;
+        ullRest += ullTenKappa;
+    }
+}
+
+static int CountDecimalDigit32(uint32_t n) {
+    int iDigits = 1;
+    while (iDigits < 10 && n >= (uint32_t)s_aullPow10[iDigits]) {
+        iDigits++;
+    }
+    return iDigits;
+}
+
+// 逐位生成 Mp 的十进制数字, 直到剩余部分小于边界宽度 delta
+static int DigitGen(stDiyFp W, stDiyFp Mp, uint64_t ullDelta, char* pcBuffer, int* piK) {
+    stDiyFp one;
+    one.f = 1ULL << -Mp.e;
+    one.e = Mp.e;
+    uint64_t ullWpW = Mp.f - W.f;
+    uint32_t p1 = (uint32_t)(Mp.f >> -one.e);       // 整数部分
+    uint64_t p2 = Mp.f & (one.f - 1);               // 小数部分
+    int iKappa = CountDecimalDigit32(p1);
+    int iLength = 0;
+
+    while (iKappa > 0) {
+        uint32_t uPow = (uint32_t)s_aullPow10[iKappa - 1];
+        uint32_t d = p1 / uPow;
+        p1 %= uPow;
+        if (d || iLength) {
+            pcBuffer[iLength++] = (char)('0' + d);
+        }
+        iKappa--;
+        uint64_t ullRest = ((uint64_t)p1 << -one.e) + p2;
+        if (ullRest <= ullDelta) {
+            *piK += iKappa;
+            GrisuRound(pcBuffer, iLength, ullDelta, ullRest, s_aullPow10[iKappa] << -one.e, ullWpW);
+            return iLength;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        ullDelta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if (d || iLength) {
+            pcBuffer[iLength++] = (char)('0' + d);
+        }
+        p2 &= one.f - 1;
+        iKappa--;
+        if (p2 < ullDelta) {
+            int iIndex = -iKappa;
+            *piK += iKappa;
+            GrisuRound(pcBuffer, iLength, ullDelta, p2, one.f, ullWpW * (iIndex < 20 ? s_aullPow10[iIndex] : 0));
+            return iLength;
+        }
+    }
+}
+
+// 正有限数 -> 数字串 pcBuffer[0..len) 与十进制指数 K (值 = 数字串 * 10^K)
+static int Grisu2(uint64_t ullBits, char* pcBuffer, int* piK) {
+    stDiyFp v, stMinus, stPlus;
+    int iBiasedE = (int)((ullBits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_BITS);
+    uint64_t ullSignificand = ullBits & DP_SIGNIFICAND_MASK;
+    if (iBiasedE != 0) {
+        v.f = ullSignificand + DP_HIDDEN_BIT;
+        v.e = iBiasedE - DP_EXPONENT_BIAS;
+    } else {
+        v.f = ullSignificand;
+        v.e = DP_MIN_EXPONENT;
+    }
+
+    DiyFpBoundaries(v, &stMinus, &stPlus);
+    stDiyFp stCached = GetCachedPower(stPlus.e, piK);
+    stDiyFp W = DiyFpMultiply(DiyFpNormalize(v), stCached);
+    stDiyFp Wp = DiyFpMultiply(stPlus, stCached);
+    stDiyFp Wm = DiyFpMultiply(stMinus, stCached);
+    Wm.f++;
+    Wp.f--;
+    return DigitGen(W, Wp, Wp.f - Wm.f, pcBuffer, piK);
+}
+
+static char* WriteExponent(int iExp, char* p) {
+    *p++ = 'e';
+    if (iExp < 0) {
+        *p++ = '-';
+        iExp = -iExp;
+    }
+    if (iExp >= 100) {
+        *p++ = (char)('0' + iExp / 100);
+        iExp %= 100;
+        *p++ = (char)('0' + iExp / 10);
+        *p++ = (char)('0' + iExp % 10);
+    } else if (iExp >= 10) {
+        *p++ = (char)('0' + iExp / 10);
+        *p++ = (char)('0' + iExp % 10);
+    } else {
+        *p++ = (char)('0' + iExp);
+    }
+    return p;
+}
+
+// 数字串 + 指数 -> 定点或科学计数格式, 返回结尾位置
+static char* Prettify(char* pcBuffer, int iLength, int k) {
+    int kk = iLength + k;       // 10^(kk-1) <= v < 10^kk
+
+    if (0 <= k && kk <= 21) {
+        // 1234e3 -> 1234000
+        for (int i = iLength; i < kk; i++) {
+            pcBuffer[i] = '0';
+        }
+        return pcBuffer + kk;
+    }
+    if (0 < kk && kk <= 21) {
+        // 1234e-2 -> 12.34
+        memmove(pcBuffer + kk + 1, pcBuffer + kk, (size_t)(iLength - kk));
+        pcBuffer[kk] = '.';
+        return pcBuffer + iLength + 1;
+    }
+    if (-5 < kk && kk <= 0) {
+        // 1234e-6 -> 0.001234
+        int iOffset = 2 - kk;
+        memmove(pcBuffer + iOffset, pcBuffer, (size_t)iLength);
+        pcBuffer[0] = '0';
+        pcBuffer[1] = '.';
+        for (int i = 2; i < iOffset; i++) {
+            pcBuffer[i] = '0';
+        }
+        return pcBuffer + iLength + iOffset;
+    }
+    if (iLength == 1) {
+        // 1e30
+        return WriteExponent(kk - 1, pcBuffer + 1);
+    }
+    // 1234e30 -> 1.234e33
+    memmove(pcBuffer + 2, pcBuffer + 1, (size_t)(iLength - 1));
+    pcBuffer[1] = '.';
+    return WriteExponent(kk - 1, pcBuffer + iLength + 1);
+}
+
+// 浮点数 -> 最短往返文本, 返回字符数
+int DoubleFormatShortest(double dValue, char* pcBuffer) {
+    uint64_t ullBits;
+    char* p = pcBuffer;
+    memcpy(&ullBits, &dValue, sizeof(ullBits));
+
+    if (ullBits >> 63) {
+        *p++ = '-';
+        ullBits &= ~(1ULL << 63);
+    }
+    if ((ullBits & DP_EXPONENT_MASK) == DP_EXPONENT_MASK) {
+        if (ullBits & DP_SIGNIFICAND_MASK) {
+            p = pcBuffer;       // NaN 不带符号
+            memcpy(p, "nan", 3);
+        } else {
+            memcpy(p, "inf", 3);
+        }
+        p += 3;
+    } else if (ullBits == 0) {
+        *p++ = '0';
+    } else {
+        int k;
+        int iLength = Grisu2(ullBits, p, &k);
+        p = Prettify(p, iLength, k);
+    }
+    *p = '\0';
+    return (int)(p - pcBuffer);
+}
+
+// 整数 -> 十进制文本, 返回字符数
+int DoubleFormatInt(int iValue, char* pcBuffer) {
+    char acDigits[12];
+    char* p = pcBuffer;
+    unsigned int uValue = (unsigned int)iValue;
+    int n = 0;
+
+    if (iValue < 0) {
+        *p++ = '-';
+        uValue = 0u - uValue;
+    }
+    do {
+        acDigits[n++] = (char)('0' + uValue % 10u);
+        uValue /= 10u;
+    } while (uValue != 0u);
+    while (n > 0) {
+        *p++ = acDigits[--n];
+    }
+    *p = '\0';
+    return (int)(p - pcBuffer);
+}
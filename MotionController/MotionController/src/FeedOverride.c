@@ -0,0 +1,128 @@
+#include "FeedOverride.h"
+#include <math.h>
+#include <string.h>
+
+// 倍率为 1 且静止 (未设置过倍率时不启用时间扭曲)
+void FeedOverrideInit(stFeedOverride* pFeed, double dSampleTime) {
+    memset(pFeed, 0, sizeof(*pFeed));
+    pFeed->dTarget = 1.0;
+    pFeed->dRatio = 1.0;
+    pFeed->dSampleTime = dSampleTime;
+}
+
+// 由轴约束计算可被倍率扭曲的轨迹的规划约束 (见头文件); pstPlan 可与 pstAxis 相同
+// Snap 按倍率恒定时的 r^4 倍同样降低 (倍率变化引入的 Snap 不受限)
+void FeedOverridePlanningLimits(const stPlannerInput* pstAxis, stPlannerInput* pstPlan) {
+    const double R = FEED_OVERRIDE_MAX;
+    const double dKeep = 1.0 - FEED_OVERRIDE_SHARE;
+    *pstPlan = *pstAxis;
+    pstPlan->dVMax = pstAxis->dVMax / R;
+    pstPlan->dAMax = dKeep * pstAxis->dAMax / (R * R);
+    pstPlan->dJMax = dKeep * pstAxis->dJMax / (R * R * R);
+    pstPlan->dDMax = dKeep * pstAxis->dDMax / (R * R * R * R);
+}
+
+// FeedOverridePlanningLimits 的逆运算: 由规划约束还原轴约束; pstAxis 可与 pstPlan 相同
+void FeedOverrideAxisLimits(const stPlannerInput* pstPlan, stPlannerInput* pstAxis) {
+    const double R = FEED_OVERRIDE_MAX;
+    const double dKeep = 1.0 - FEED_OVERRIDE_SHARE;
+    *pstAxis = *pstPlan;
+    pstAxis->dVMax = pstPlan->dVMax * R;
+    pstAxis->dAMax = pstPlan->dAMax * (R * R) / dKeep;
+    pstAxis->dJMax = pstPlan->dJMax * (R * R * R) / dKeep;
+    pstAxis->dDMax = pstPlan->dDMax * (R * R * R * R) / dKeep;
+}
+
+// 约束是否有效
+static int FeedOverrideLimitsValid(const stPlannerInput* pstPlan) {
+    return pstPlan->dVMax > 0.0 && pstPlan->dAMax > 0.0 && pstPlan->dJMax > 0.0;
+}
+
+// 由组内最严的规划约束比值更新 r' / r'' 上限 (见头文件)
+static void FeedOverrideUpdateLimits(stFeedOverride* pFeed) {
+    const double R = FEED_OVERRIDE_MAX;
+    const double dGain = FEED_OVERRIDE_SHARE / (1.0 - FEED_OVERRIDE_SHARE);
+    pFeed->dRateMax = dGain * R * R * fmin(pFeed->dAOverV, pFeed->dJOverA / 6.0);
+    pFeed->dAccelMax = dGain * R * R * R * pFeed->dJOverV / 2.0;
+}
+
+// 由轨迹的规划约束 (FeedOverridePlanningLimits 的结果) 确定 r' 与 r'' 上限, 当前倍率与速率不变; 参数无效返回 -1
+// 一组同步轴: 以其中一轴调用本函数, 其余各轴调用 FeedOverrideAddLimits
+int FeedOverrideSetLimits(stFeedOverride* pFeed, const stPlannerInput* pstPlan) {
+    if (!FeedOverrideLimitsValid(pstPlan) || !(pFeed->dSampleTime > 0.0)) {
+        return -1;
+    }
+    pFeed->dAOverV = pstPlan->dAMax / pstPlan->dVMax;
+    pFeed->dJOverA = pstPlan->dJMax / pstPlan->dAMax;
+    pFeed->dJOverV = pstPlan->dJMax / pstPlan->dVMax;
+    FeedOverrideUpdateLimits(pFeed);
+    return 0;
+}
+
+// 组内再加入一轴: 各约束比值取较严者; 未设置上限或参数无效返回 -1
+int FeedOverrideAddLimits(stFeedOverride* pFeed, const stPlannerInput* pstPlan) {
+    if (!(pFeed->dAOverV > 0.0) || !FeedOverrideLimitsValid(pstPlan)) {
+        return -1;
+    }
+    pFeed->dAOverV = fmin(pFeed->dAOverV, pstPlan->dAMax / pstPlan->dVMax);
+    pFeed->dJOverA = fmin(pFeed->dJOverA, pstPlan->dJMax / pstPlan->dAMax);
+    pFeed->dJOverV = fmin(pFeed->dJOverV, pstPlan->dJMax / pstPlan->dVMax);
+    FeedOverrideUpdateLimits(pFeed);
+    return 0;
+}
+
+// 修改指令倍率 (0 ~ FEED_OVERRIDE_MAX), 运动中以 r' / r'' 上限趋近; 未设置上限或参数无效返回 -1
+int FeedOverrideSet(stFeedOverride* pFeed, double dRatio) {
+    if (!(dRatio >= 0.0) || dRatio > FEED_OVERRIDE_MAX || !(pFeed->dAOverV > 0.0)) {
+        return -1;
+    }
+    pFeed->dTarget = dRatio;
+    return 0;
+}
+
+// 组内轨迹静止时调用 (尚未开始或已结束): 倍率直接取指令倍率, 速率清零
+void FeedOverrideSettle(stFeedOverride* pFeed) {
+    pFeed->dRatio = pFeed->dTarget;
+    pFeed->dRate = 0.0;
+    pFeed->dAccel = 0.0;
+}
+
+// 倍率前进一个周期 (每周期调用一次)
+// 朝向目标的速率取 "以 r''max 制动恰好停在目标" 的速率、r'max 与本周期可达速率中的最小者;
+// 已无法不越过目标时以 r''max 制动。落点时残余速率不超过一个周期的速率变化量, 直接停在目标
+void FeedOverrideStep(stFeedOverride* pFeed) {
+    const double dTs = pFeed->dSampleTime;
+    const double dH = pFeed->dAccelMax * dTs;
+    double dErr = pFeed->dTarget - pFeed->dRatio;
+    double dSign = (dErr < 0.0) ? -1.0 : 1.0;
+    double dDist = fabs(dErr);
+    double dSpeed = dSign * pFeed->dRate;
+    double dRateOld = pFeed->dRate;
+
+    if (dDist == 0.0 && dRateOld == 0.0) {
+        pFeed->dAccel = 0.0;
+        return;
+    }
+    if (dDist <= dH * dTs && fabs(dSpeed) <= dH) {
+        pFeed->dRatio = pFeed->dTarget;
+        pFeed->dRate = 0.0;
+        pFeed->dAccel = -dRateOld / dTs;
+        return;
+    }
+
+    double dUpper = fmin(fmin(sqrt(2.0 * pFeed->dAccelMax * dDist), pFeed->dRateMax), dSpeed + dH);
+    double dLower = fmax(dSpeed - dH, fmin(-pFeed->dRateMax, dSpeed + dH));
+    pFeed->dRate = dSign * fmax(dUpper, dLower);
+    pFeed->dAccel = (pFeed->dRate - dRateOld) / dTs;
+    pFeed->dRatio += pFeed->dRate * dTs;
+    if (pFeed->dRatio < 0.0) {
+        pFeed->dRatio = 0.0;
+    } else if (pFeed->dRatio > FEED_OVERRIDE_MAX) {
+        pFeed->dRatio = FEED_OVERRIDE_MAX;
+    }
+}
+
+// 倍率是否偏离 1 (或正在变化); 为 0 时轨迹无需时间扭曲
+int FeedOverrideIsActive(const stFeedOverride* pFeed) {
+    return pFeed->dRatio != 1.0 || pFeed->dTarget != 1.0 || pFeed->dRate != 0.0;
+}
@@ -0,0 +1,225 @@
+#include "FlightRecorder.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FLIGHT_RECORDER_PAGE_SIZE 4096      // 预写步长 (页大小)
+
+static uint64_t CurrentFileTime(void) {
+    FILETIME stNow;
+    GetSystemTimeAsFileTime(&stNow);
+    return ((uint64_t)stNow.dwHighDateTime << 32) | stNow.dwLowDateTime;
+}
+
+// 检查头部与文件大小是否一致; 一致返回 0
+static int HeaderCheck(const stFlightRecorderHeader* pHeader, uint64_t ullFileSize) {
+    if (pHeader->uMagic != FLIGHT_RECORDER_MAGIC || pHeader->uVersion != FLIGHT_RECORDER_VERSION ||
+        pHeader->uHeaderSize != FLIGHT_RECORDER_HEADER_SIZE || pHeader->uAxisCount < 1 ||
+        pHeader->uAxisCount > MAX_AXIS_COUNT || pHeader->uSlotSize != FLIGHT_RECORDER_SLOT_SIZE(pHeader->uAxisCount) ||
+        !(pHeader->dSampleTime > 0.0) || pHeader->ullSlotCount == 0) {
+        return -1;
+    }
+    if ((ullFileSize - FLIGHT_RECORDER_HEADER_SIZE) / pHeader->uSlotSize < pHeader->ullSlotCount) {
+        return -1;
+    }
+    return 0;
+}
+
+// 上次的记录文件若未正常关闭 (进程崩溃), 改名为 pszCrashPath 保留; 保留了返回 1
+static int KeepCrashRecord(const char* pszPath, const char* pszCrashPath) {
+    stFlightRecorderHeader stHeader;
+    FILE* pFile = NULL;
+    int bCrashed = 0;
+
+    if (pszCrashPath == NULL || fopen_s(&pFile, pszPath, "rb") != 0 || pFile == NULL) {
+        return 0;
+    }
+    if (fread(&stHeader, 1, sizeof(stHeader), pFile) == sizeof(stHeader) &&
+        stHeader.uMagic == FLIGHT_RECORDER_MAGIC && stHeader.uState == FLIGHT_RECORDER_STATE_RUNNING) {
+        bCrashed = 1;
+    }
+    fclose(pFile);
+    return bCrashed && MoveFileExA(pszPath, pszCrashPath, MOVEFILE_REPLACE_EXISTING) ? 1 : 0;
+}
+
+// 映射视图 (bWritable 为 1 时以读写方式, 并按 ullFileSize 扩展文件); 失败返回 -1
+static int MapFile(stFlightRecorder* pRecorder, int bWritable, uint64_t ullFileSize) {
+    pRecorder->hMapping = CreateFileMappingA(pRecorder->hFile, NULL, bWritable ? PAGE_READWRITE : PAGE_READONLY,
+                                             (DWORD)(ullFileSize >> 32), (DWORD)(ullFileSize & 0xFFFFFFFFULL), NULL);
+    if (pRecorder->hMapping == NULL) {
+        return -1;
+    }
+    pRecorder->pucView = (unsigned char*)MapViewOfFile(pRecorder->hMapping, bWritable ? FILE_MAP_WRITE : FILE_MAP_READ,
+                                                       0, 0, 0);
+    if (pRecorder->pucView == NULL) {
+        return -1;
+    }
+    pRecorder->pHeader = (stFlightRecorderHeader*)pRecorder->pucView;
+    pRecorder->pucSlots = pRecorder->pucView + FLIGHT_RECORDER_HEADER_SIZE;
+    return 0;
+}
+
+// 创建记录文件: 槽数为 dSeconds / dSampleTime, 超过 FLIGHT_RECORDER_MAX_BYTES 时按上限缩减
+// 已有文件若处于写入中状态, 先改名为 pszCrashPath 保留 (pszCrashPath 为 NULL 时直接覆盖)
+// 返回 -1 失败; 0 成功; 1 成功且保留了上次崩溃时的记录
+int FlightRecorderOpen(stFlightRecorder* pRecorder, const char* pszPath, const char* pszCrashPath, int iAxisCount,
+                       double dSampleTime, double dSeconds) {
+    memset(pRecorder, 0, sizeof(*pRecorder));
+    if (iAxisCount < 1 || iAxisCount > MAX_AXIS_COUNT || !(dSampleTime > 0.0) || !(dSeconds > 0.0)) {
+        return -1;
+    }
+    const int bCrashKept = KeepCrashRecord(pszPath, pszCrashPath);
+
+    const size_t uSlotSize = FLIGHT_RECORDER_SLOT_SIZE(iAxisCount);
+    uint64_t ullSlotCount = (uint64_t)(dSeconds / dSampleTime + 0.5);
+    const uint64_t ullMaxSlots = (FLIGHT_RECORDER_MAX_BYTES - FLIGHT_RECORDER_HEADER_SIZE) / uSlotSize;
+    if (ullSlotCount > ullMaxSlots) {
+        ullSlotCount = ullMaxSlots;
+    }
+    if (ullSlotCount == 0) {
+        ullSlotCount = 1;
+    }
+    const uint64_t ullFileSize = FLIGHT_RECORDER_HEADER_SIZE + ullSlotCount * uSlotSize;
+
+    // 允许其他进程在写入过程中只读打开 (FlightRecorderDump)
+    pRecorder->hFile = CreateFileA(pszPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+                                   FILE_ATTRIBUTE_NORMAL, NULL);
+    if (pRecorder->hFile == INVALID_HANDLE_VALUE) {
+        pRecorder->hFile = NULL;
+        return -1;
+    }
+    if (MapFile(pRecorder, 1, ullFileSize) != 0) {
+        FlightRecorderClose(pRecorder);
+        return -1;
+    }
+
+    // 逐页预写 (新文件内容为零, 写零不改变内容), 控制循环中首次写入各页时不再缺页
+    for (uint64_t ullOffset = 0; ullOffset < ullFileSize; ullOffset += FLIGHT_RECORDER_PAGE_SIZE) {
+        ((volatile unsigned char*)pRecorder->pucView)[ullOffset] = 0;
+    }
+
+    stFlightRecorderHeader* pHeader = pRecorder->pHeader;
+    pHeader->uMagic = FLIGHT_RECORDER_MAGIC;
+    pHeader->uVersion = FLIGHT_RECORDER_VERSION;
+    pHeader->uHeaderSize = FLIGHT_RECORDER_HEADER_SIZE;
+    pHeader->uAxisCount = (uint32_t)iAxisCount;
+    pHeader->uSlotSize = (uint32_t)uSlotSize;
+    pHeader->ullSlotCount = ullSlotCount;
+    pHeader->dSampleTime = dSampleTime;
+    pHeader->ullStartTime = CurrentFileTime();
+    pHeader->ullCloseTime = 0;
+    pHeader->uState = FLIGHT_RECORDER_STATE_RUNNING;
+    FlushViewOfFile(pRecorder->pucView, FLIGHT_RECORDER_HEADER_SIZE);
+
+    pRecorder->iAxisCount = iAxisCount;
+    pRecorder->uSlotSize = uSlotSize;
+    pRecorder->ullSlotCount = ullSlotCount;
+    pRecorder->ullNextSlot = 0;
+    pRecorder->llSequence = 0;
+    pRecorder->bWritable = 1;
+    return bCrashKept;
+}
+
+// 关闭记录文件: 写入端标记为已正常关闭并落盘; 可重复调用
+void FlightRecorderClose(stFlightRecorder* pRecorder) {
+    if (pRecorder->pucView != NULL) {
+        if (pRecorder->bWritable) {
+            pRecorder->pHeader->ullCloseTime = CurrentFileTime();
+            MemoryBarrier();
+            pRecorder->pHeader->uState = FLIGHT_RECORDER_STATE_CLOSED;
+            FlushViewOfFile(pRecorder->pucView, 0);
+        }
+        UnmapViewOfFile(pRecorder->pucView);
+    }
+    if (pRecorder->hMapping != NULL) {
+        CloseHandle(pRecorder->hMapping);
+    }
+    if (pRecorder->hFile != NULL) {
+        CloseHandle(pRecorder->hFile);
+    }
+    memset(pRecorder, 0, sizeof(*pRecorder));
+}
+
+// 写入一个控制周期 (控制线程每周期调用一次; 只写映射内存, 不调用系统函数)
+// piMode / puFaults 为各轴控制模式与故障位 (前 iAxisCount 个)
+void FlightRecorderWrite(stFlightRecorder* pRecorder, int iStep, double dTime, const ControlData* pData,
+                         const int* piMode, const uint32_t* puFaults, uint32_t uFlags) {
+    if (pRecorder->pucView == NULL) {
+        return;
+    }
+    const int64_t llSequence = ++pRecorder->llSequence;
+    stFlightSlot* pSlot = (stFlightSlot*)(pRecorder->pucSlots + (size_t)pRecorder->ullNextSlot * pRecorder->uSlotSize);
+    if (++pRecorder->ullNextSlot == pRecorder->ullSlotCount) {
+        pRecorder->ullNextSlot = 0;
+    }
+
+    // 先写槽首序号 (带屏障, 数据写入不会提前), 槽尾仍为旧序号, 此时槽视为不完整
+    InterlockedExchange64(&pSlot->llSequence, llSequence);
+    pSlot->iStep = iStep;
+    pSlot->uFlags = uFlags;
+    pSlot->dTime = dTime;
+    for (int axis = 0; axis < pRecorder->iAxisCount; axis++) {
+        stFlightAxisRecord* pAxis = &pSlot->astAxis[axis];
+        pAxis->dTarget = pData->dTargetPosition[axis];
+        pAxis->dActual = pData->dActualPosition[axis];
+        pAxis->dError = pData->dError[axis];
+        pAxis->dForce = pData->dControlForce[axis];
+        pAxis->iMode = piMode[axis];
+        pAxis->uFaults = puFaults[axis];
+    }
+    WriteRelease64(FLIGHT_RECORDER_SLOT_END(pSlot, pRecorder->uSlotSize), llSequence);
+}
+
+// 只读打开记录文件 (可在写入过程中打开), 检查头部与文件大小; 失败返回 -1
+int FlightRecorderOpenRead(stFlightRecorder* pRecorder, const char* pszPath) {
+    LARGE_INTEGER liSize;
+
+    memset(pRecorder, 0, sizeof(*pRecorder));
+    pRecorder->hFile = CreateFileA(pszPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL, NULL);
+    if (pRecorder->hFile == INVALID_HANDLE_VALUE) {
+        pRecorder->hFile = NULL;
+        return -1;
+    }
+    if (!GetFileSizeEx(pRecorder->hFile, &liSize) || liSize.QuadPart < FLIGHT_RECORDER_HEADER_SIZE ||
+        MapFile(pRecorder, 0, 0) != 0 || HeaderCheck(pRecorder->pHeader, (uint64_t)liSize.QuadPart) != 0) {
+        FlightRecorderClose(pRecorder);
+        return -1;
+    }
+    pRecorder->iAxisCount = (int)pRecorder->pHeader->uAxisCount;
+    pRecorder->uSlotSize = pRecorder->pHeader->uSlotSize;
+    pRecorder->ullSlotCount = pRecorder->pHeader->ullSlotCount;
+    return 0;
+}
+
+// 复制序号 llSequence 的槽到 pSlot (至少 uSlotSize 字节)
+// 先读槽尾、再复制、最后读槽首, 首尾均等于 llSequence 时复制内容完整 (写入端按相反顺序写)
+// 返回 1 完整; 0 该槽尚未写入或已被覆盖; -1 写到一半 (槽首为 llSequence 而槽尾不是)
+int FlightRecorderReadSlot(const stFlightRecorder* pRecorder, int64_t llSequence, stFlightSlot* pSlot) {
+    if (llSequence < 1) {
+        return 0;
+    }
+    const unsigned char* pucSlot =
+        pRecorder->pucSlots + (size_t)((uint64_t)(llSequence - 1) % pRecorder->ullSlotCount) * pRecorder->uSlotSize;
+    const int64_t llEnd = ReadAcquire64(FLIGHT_RECORDER_SLOT_END(pucSlot, pRecorder->uSlotSize));
+    memcpy(pSlot, pucSlot, pRecorder->uSlotSize);
+    MemoryBarrier();
+    const int64_t llBegin = ReadAcquire64(&((const stFlightSlot*)pucSlot)->llSequence);
+    if (llBegin == llSequence && llEnd == llSequence) {
+        return 1;
+    }
+    return (llBegin == llSequence) ? -1 : 0;
+}
+
+// 扫描全部槽, 返回最大的完整记录序号 (无记录返回 0)
+int64_t FlightRecorderLastSequence(const stFlightRecorder* pRecorder) {
+    int64_t llLast = 0;
+    for (uint64_t i = 0; i < pRecorder->ullSlotCount; i++) {
+        const unsigned char* pucSlot = pRecorder->pucSlots + (size_t)i * pRecorder->uSlotSize;
+        const int64_t llEnd = ReadAcquire64(FLIGHT_RECORDER_SLOT_END(pucSlot, pRecorder->uSlotSize));
+        if (llEnd > llLast && (uint64_t)(llEnd - 1) % pRecorder->ullSlotCount == i &&
+            ReadAcquire64(&((const stFlightSlot*)pucSlot)->llSequence) == llEnd) {
+            llLast = llEnd;
+        }
+    }
+    return llLast;
+}
@@ -1,14 +1,30 @@
 /**
  * @file FourthOrderTrajectoryPlanning.c
- * @brief 四阶(Snap)轨迹规划器API的实现 - 最终稳定版 v1.10.1
+ * @brief 四阶(Snap)轨迹规划器API的实现 - v1.15.0
  * @details
+ * - [v1.15.0] 新增 SolveTimes: 只求时间分段与总时长 (InitInto 的步骤 3~5), 不生成边界状态与多项式表,
+ *             供批量估算节拍 (PlannerBatch); InitInto 改为调用同一求解, 结果逐位不变。
+ * - [v1.14.0] 新增 SetTimeScale / InheritTimeWarp: 进给倍率作为时间扭曲作用于取点时刻, 输出按链式法则换算,
+ *             倍率变化不重新规划; 未调用时取点路径与 v1.13.0 逐位一致。
+ * - [v1.13.0] 新增 InitEx: 起止速度非零、任意起点位置与方向、采样时刻偏移, 供运动队列衔接多段轨迹;
+ *             新增 MaxEndVelocity / IsAtEnd / GetEndOffset。边界状态预计算抽出为 PrecomputeProfile,
+ *             加速段与减速段可使用不同的时间分段。
+ * - [v1.12.0] 新增 GetDiagnostics, 由边界状态解析求出有效约束与峰值; 上下文记录 Init 耗时与 Newton 迭代次数。
+ * - [v1.12.0] 新增 InitInto, 在调用者提供的存储 (静态区/上下文池) 中规划, 不调用分配器;
+ *             Init 改为 malloc + InitInto 的包装。
+ * - [v1.11.0] GetNextPoint 改为子阶段游标 + 预计算多项式系数 (Horner 求值)，时间由整数采样序号计算；
+ *             新增 GetPointAt 随机访问接口。
+ * - [v1.11.0] 新增 GenerateBlock 按段成批生成 (数组结构体输出)。
+ * - [v1.11.0] 最优时间分段改为解析解 (S_ramp = V*Te/2) + 单调 Newton，时间限制下 alpha = T_opt/T_limit 直接求出，
+ *             取代 alpha 与峰值加速度的两层二分搜索；同时覆盖原实现无解的
+ *             "达到 AMax 但达不到 VMax" 与 "VMax 低于 Jerk 段自然达到的速度" 两种情形。
  * - [v1.10.1] 添加 CalculateRampKinematicsInternal 的静态函数原型声明，修复编译错误。
  * - 采用预计算边界点状态的策略，彻底解决数值累计误差。
  * - Init 函数负责一次性精确计算所有时间分段和边界状态。
- * - CalculatePoint 函数基于预计算状态进行分段独立计算。
+ * - 各子阶段基于预计算边界状态独立求值，互不累积误差。
  * - 确保短行程、时间缩放等情况下的稳定性和精度。
- * @version 1.10.1
- * @date 2025-10-24
+ * @version 1.15.0
+ * @date 2026-10-16
  */
 
 #include <stdio.h>
@@ -16,6 +32,14 @@
 #include <math.h>
 #include <string.h>
 #include "FourthOrderTrajectoryPlanning.h" // 假设包含了 isfinite 的定义 (math.h)
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 
 #ifndef isfinite
 #ifdef _MSC_VER // For MSVC
@@ -28,259 +52,491 @@
 #endif
 
 // --- 内部辅助函数原型 ---
-static void CalculatePoint(const stPlannerContext *pContext, double dTime, stTrajectoryPoint *pPointOutput);
-// [*** 修正 ***] 添加 CalculateRampKinematicsInternal 的原型声明
-static void CalculateRampKinematicsInternal(double dTargetV, double dTargetA, double dJMax, double dDMax,
-                                            double *pdTd, double *pdTj, double *pdTa, double *pdFinalV, double *pdFinalS);
-static void CalculateRampKinematicsForSearch(double dTargetA, double dJMax, double dDMax,
-                                             double *pdTd, double *pdTj, double *pdS_ramp, int* pErrorFlag);
-static double CalculateOptimalTimeSegments(const stPlannerInput* pInput, double* pdTd, double* pdTj, double* pdTa, double* pdTv, int* pErrorFlag);
+static int PrecomputeProfile(stPlannerContext *pContext, const double *pdDurAcc, double dTeAcc,
+                             const double *pdDurDec, double dTeDec, double dSnap);
+static void BuildSegmentTable(stPlannerContext *pContext, const double *pdSnapAcc, const double *pdSnapDec);
+static void EvaluateSegment(const stTrajectorySegment *pSeg, double dTime, stTrajectoryPoint *pPointOutput);
+static void CalculateFinalPoint(const stPlannerContext *pContext, stTrajectoryPoint *pPointOutput);
+static int GetNextPointWarped(stPlannerContext *pContext, stTrajectoryPoint *pPointOutput);
+static void ScalePlannerInput(const stPlannerInput *pInput, double dAlpha, stPlannerInput *pScaled);
+static void CalculateJerkPhaseTimes(double dA, double dJMax, double dDMax, double *pdTd, double *pdTj);
+static double PeakAccForVelocity(double dV, double dJMax, double dDMax);
+static double PeakAccForDistance(double dHalfS, double dJMax, double dDMax, double dACap, int *piIterations);
+static double CalculateOptimalTimeSegments(const stPlannerInput* pInput, double* pdTd, double* pdTj, double* pdTa, double* pdTv, int* piIterations, int* pErrorFlag);
+static int SolveTimeSegments(const stPlannerInput *pstInput, stPlannerTimes *pTimes);
+static double RampTimeSegments(double dV0, double dV1, const stPlannerInput *pInput, double *pdTd, double *pdTj, double *pdTa);
+static double RampDistance(double dV0, double dV1, const stPlannerInput *pInput);
+static int SolvePeakVelocity(const stPlannerInput *pInput, double dS, double dV0, double dV1,
+                             double *pdVPeak, double *pdTv, int *piIterations);
+static double SampleTime(const stPlannerContext *pContext, long long llIndex);
+static double PlannerNowUs(void);
 
 
 /**
- * @brief 初始化轨迹规划器 (包含预计算边界状态)
+ * @brief 在调用者提供的上下文中初始化轨迹规划器 (包含预计算边界状态, 不分配内存)
  * @details
  *   本函数完成以下核心工作：
  *   1. 输入参数合法性检查
- *   2. 分配并初始化上下文结构体
+ *   2. 清空并初始化上下文结构体
  *   3. 计算最优时间分段（无时间限制时）
- *   4. 若有限制时间，则通过二分搜索缩放因子 alpha 调整物理约束
+ *   4. 若有限制时间，则由 alpha = T_opt / T_limit 直接求出缩放因子并缩放物理约束
  *   5. 确定最终时间分段、总时长
  *   6. 预计算加速段与减速段的 8 个边界时间点
  *   7. 预计算每个边界点的完整运动学状态（位置、速度、加速度、Jerk）
  *   8. 验证最终位置与速度误差在容许范围内
- *   9. 初始化内部计时器
- *   整个过程一次性完成，后续 GetNextPoint 只做局部积分，极大地提升精度与实时性。
+ *   9. 生成各子阶段的多项式系数表
+ *   10. 初始化内部计时器与段游标
+ *   整个过程一次性完成，后续 GetNextPoint 只做段内多项式求值，极大地提升精度与实时性。
  */
-stPlannerContext* FourthOrderPlannerInit(const stPlannerInput *pstInput) {
+int FourthOrderPlannerInitInto(const stPlannerInput *pstInput, stPlannerContext *pContext) {
     // ===== 步骤 1: 输入验证 =====
     // 检查输入指针是否为空、位移是否为负、所有约束是否为正、采样周期是否有效
-    if (!pstInput || pstInput->dDistance < 0.0 || pstInput->dVMax <= 0.0 || pstInput->dAMax <= 0.0 ||
+    if (!pstInput || !pContext || pstInput->dDistance < 0.0 || pstInput->dVMax <= 0.0 || pstInput->dAMax <= 0.0 ||
         pstInput->dJMax <= 0.0 || pstInput->dDMax <= 0.0 || pstInput->dSampleTime <= 0.0) {
-        fprintf(stderr, "ERROR: Invalid inputs in Init\n"); return NULL;
+        fprintf(stderr, "ERROR: Invalid inputs in Init\n"); return -1;
     }
 
-    // ===== 步骤 2: 分配上下文内存 =====
-    stPlannerContext *pContext = (stPlannerContext*)malloc(sizeof(stPlannerContext));
-    if (!pContext) { fprintf(stderr, "ERROR: Failed to allocate memory\n"); return NULL; }
+    // ===== 步骤 2: 清空调用者提供的上下文 =====
+    double dStartUs = PlannerNowUs();
     memset(pContext, 0, sizeof(stPlannerContext));
     pContext->stInput = *pstInput;
     pContext->dAlphaScaleFactor = 1.0; pContext->bIsTimeScaled = 0;
+    pContext->dTimeScale = 1.0;
+    pContext->dDirection = 1.0;
 
-    double dTd_final, dTj_final, dTa_final, dTv_final; // 最终的时间分段结果
-    double dAlphaFinal = 1.0;
-    double dFinalTime = 0.0;
-    int errorFlag = 0;
-
-    // ===== 步骤 3: 计算最优时间 =====
-    // 调用核心函数计算在无时间限制下的最优时间分段
-    double dOptimalTime = CalculateOptimalTimeSegments(pstInput, &dTd_final, &dTj_final, &dTa_final, &dTv_final, &errorFlag);
-    if (errorFlag) { fprintf(stderr, "ERROR: Failed to calculate optimal time.\n"); free(pContext); return NULL; }
-    double dTimeLimit = pstInput->dTimeLimit;
-
-    // ===== 步骤 4: 处理时间限制 (二分搜索 alpha) =====
-    const int MAX_ITERATIONS = 100;
-    const double TIME_TOLERANCE = 1e-9;
-    const double ALPHA_TOLERANCE = 1e-7;
-
-    if (dTimeLimit > 0 && fabs(dTimeLimit - dOptimalTime) > TIME_TOLERANCE) {
-        // --- 需要进行时间缩放 ---
-        pContext->bIsTimeScaled = 1;
-        double dAlphaLow, dAlphaHigh;
-        double dBestAlpha = 1.0, dMinTimeError = 1e300;
-        // 记录最佳 alpha 对应的最佳分段
-        double dTd_best=dTd_final, dTj_best=dTj_final, dTa_best=dTa_final, dTv_best=dTv_final;
-
-        if (dTimeLimit < dOptimalTime) { // 时间严格, alpha > 1
-            dAlphaLow = 1.0; dAlphaHigh = 50.0;
-        } else { // 时间宽裕, alpha < 1
-            dAlphaLow = 1e-8; dAlphaHigh = 1.0;
-        }
-
-        for (int i = 0; i < MAX_ITERATIONS; i++) {
-            double dAlphaGuess = (dAlphaLow + dAlphaHigh) / 2.0;
-            stPlannerInput stTempInput = *pstInput;
-            // 按 alpha 的幂次缩放物理约束
-            stTempInput.dVMax = pow(dAlphaGuess, 1.0) * pstInput->dVMax;
-            stTempInput.dAMax = pow(dAlphaGuess, 2.0) * pstInput->dAMax;
-            stTempInput.dJMax = pow(dAlphaGuess, 3.0) * pstInput->dJMax;
-            stTempInput.dDMax = pow(dAlphaGuess, 4.0) * pstInput->dDMax;
-
-            int tempError = 0;
-            double dTd_guess, dTj_guess, dTa_guess, dTv_guess;
-            double dTempOptimalTime = CalculateOptimalTimeSegments(&stTempInput, &dTd_guess, &dTj_guess, &dTa_guess, &dTv_guess, &tempError);
-
-            if (tempError || !isfinite(dTempOptimalTime)) { // 计算失败或结果无效
-                if (dTimeLimit < dOptimalTime) dAlphaHigh = dAlphaGuess;
-                else dAlphaLow = dAlphaGuess;
-                continue;
-            }
-
-            double currentTimeError = dTempOptimalTime - dTimeLimit;
-
-            if (fabs(currentTimeError) < dMinTimeError) {
-                dMinTimeError = fabs(currentTimeError);
-                dBestAlpha = dAlphaGuess;
-                dTd_best = dTd_guess; dTj_best = dTj_guess; dTa_best = dTa_guess; dTv_best = dTv_guess;
-            }
-
-            // 根据当前时间误差调整搜索区间
-            if (dTimeLimit < dOptimalTime) {
-                 if (currentTimeError > 0) dAlphaLow = dAlphaGuess; else dAlphaHigh = dAlphaGuess;
-            } else {
-                 if (currentTimeError > 0) dAlphaLow = dAlphaGuess; else dAlphaHigh = dAlphaGuess;
-            }
-
-            // 收敛条件：alpha 精度或时间误差足够小
-            if ((dAlphaHigh - dAlphaLow) < ALPHA_TOLERANCE * fmax(1.0, dAlphaHigh) || fabs(currentTimeError) < TIME_TOLERANCE) {
-                break;
-            }
-        }
-        dAlphaFinal = dBestAlpha;
-        dFinalTime = dTimeLimit;
-        dTd_final = dTd_best; dTj_final = dTj_best; dTa_final = dTa_best; dTv_final = dTv_best;
-
-    } else {
-        // --- 无需缩放或恰好相等 ---
-        dAlphaFinal = 1.0;
-        dFinalTime = dOptimalTime;
-        // 使用最优分段 (已在步骤 3 赋值给 _final 变量)
+    // ===== 步骤 3~4: 最优时间分段, 有时间限制时求缩放因子 (SolveTimeSegments) =====
+    stPlannerTimes stTimes;
+    if (SolveTimeSegments(pstInput, &stTimes) != 0) {
+        return -1;
     }
+    pContext->bIsTimeScaled = stTimes.bIsTimeScaled;
+    pContext->iSolverIterations = stTimes.iSolverIterations;
+    double dTd_final = stTimes.dTd, dTj_final = stTimes.dTj, dTa_final = stTimes.dTa, dTv_final = stTimes.dTv;
+    double dAlphaFinal = stTimes.dAlphaScaleFactor;
+    double dFinalTime = stTimes.dTotalTime;
 
     // ===== 步骤 5: 保存最终确定的 alpha 和时间分段到 Context =====
     pContext->dAlphaScaleFactor = dAlphaFinal;
-    pContext->dTd = dTd_final;
-    pContext->dTj = dTj_final;
-    pContext->dTa = dTa_final;
+    pContext->dTd = pContext->dTdDec = dTd_final;
+    pContext->dTj = pContext->dTjDec = dTj_final;
+    pContext->dTa = pContext->dTaDec = dTa_final;
     pContext->dTv = dTv_final; // 先赋值，下面可能修正
 
-    // ===== 步骤 6: 精确计算最终的 dTe, dTotalTime, dTv =====
+    // ===== 步骤 6~9: 边界时间点、边界状态、终点验证与多项式表 (加速段与减速段分段相同) =====
     double dTe_final = 4.0 * pContext->dTd + 2.0 * pContext->dTj + pContext->dTa;
     pContext->dTotalTime = dFinalTime;
-    pContext->dTv = pContext->dTotalTime - 2.0 * dTe_final;
-    if (pContext->dTv < 0.0) pContext->dTv = 0.0;
-
-    // ===== 步骤 7: 预计算边界时间点 =====
-    pContext->adAccSegBorders[0] = 0.0;
     double adDurVec[7] = { pContext->dTd, pContext->dTj, pContext->dTd, pContext->dTa, pContext->dTd, pContext->dTj, pContext->dTd };
-    for (int i = 0; i < 7; ++i) {
-        pContext->adAccSegBorders[i + 1] = pContext->adAccSegBorders[i] + adDurVec[i];
+    stPlannerInput stEffectiveInput;
+    // 应用缩放因子得到实际生效的约束
+    ScalePlannerInput(pstInput, pContext->dAlphaScaleFactor, &stEffectiveInput);
+    if (PrecomputeProfile(pContext, adDurVec, dTe_final, adDurVec, dTe_final, stEffectiveInput.dDMax) != 0) {
+        return -1;
     }
-    pContext->dConstVelStartTime = dTe_final;
-    pContext->dDecelStartTime = pContext->dTotalTime - dTe_final;
-    if (pContext->dDecelStartTime < pContext->dConstVelStartTime - 1e-9) {
-         pContext->dDecelStartTime = pContext->dConstVelStartTime;
-         pContext->dTv = 0.0;
-    } else {
-         pContext->dTv = fmax(0.0, pContext->dDecelStartTime - pContext->dConstVelStartTime);
+
+    // ===== 步骤 10: 初始化内部状态 =====
+    pContext->dCurrentTime = 0.0;
+    pContext->llSampleIndex = 0;
+    pContext->iSegmentCursor = 0;
+    pContext->bIsFinished = 0;
+    pContext->dInitUs = PlannerNowUs() - dStartUs;
+
+    return 0;
+}
+
+/**
+ * @brief 只求时间分段与总时长 (不写上下文, 不分配内存, 可在多个线程中同时调用)
+ */
+int FourthOrderPlannerSolveTimes(const stPlannerInput *pstInput, stPlannerTimes *pTimes) {
+    if (!pstInput || !pTimes || pstInput->dDistance < 0.0 || pstInput->dVMax <= 0.0 || pstInput->dAMax <= 0.0 ||
+        pstInput->dJMax <= 0.0 || pstInput->dDMax <= 0.0 || pstInput->dSampleTime <= 0.0) {
+        return -1;
     }
-    for (int i = 0; i < 8; ++i) {
-        pContext->adDecSegBorders[i] = pContext->dDecelStartTime + pContext->adAccSegBorders[i];
+    return SolveTimeSegments(pstInput, pTimes);
+}
+
+/**
+ * @brief 规划起止速度非零的衔接段
+ * @details
+ *   1. 输入验证 (起止速度不超过 VMax, 时间偏移在一个采样周期内)
+ *   2. 由起止速度与位移大小求峰值速度 vp 与匀速时间 (SolvePeakVelocity)
+ *   3. 加速段 v0 -> vp、减速段 vp -> v1 各自按最短时间速度变化求时间分段 (RampTimeSegments)
+ *   4. 边界状态与多项式表同 InitInto (PrecomputeProfile), 起点位置与方向在生成多项式表时计入
+ */
+int FourthOrderPlannerInitEx(const stPlannerInputEx *pstInputEx, stPlannerContext *pContext) {
+    const double VEL_TOL = 1e-12;
+    if (!pstInputEx || !pContext) {
+        fprintf(stderr, "ERROR: Invalid inputs in InitEx\n"); return -1;
+    }
+    const stPlannerInput *pLimits = &pstInputEx->stLimits;
+    if (!isfinite(pLimits->dDistance) || !isfinite(pstInputEx->dStartPos) ||
+        pLimits->dVMax <= 0.0 || pLimits->dAMax <= 0.0 || pLimits->dJMax <= 0.0 || pLimits->dDMax <= 0.0 ||
+        pLimits->dSampleTime <= 0.0 || pstInputEx->dStartVel < 0.0 || pstInputEx->dEndVel < 0.0 ||
+        pstInputEx->dStartVel > pLimits->dVMax * (1.0 + VEL_TOL) || pstInputEx->dEndVel > pLimits->dVMax * (1.0 + VEL_TOL) ||
+        pstInputEx->dTimeOffset < 0.0 || pstInputEx->dTimeOffset >= pLimits->dSampleTime) {
+        fprintf(stderr, "ERROR: Invalid inputs in InitEx\n"); return -1;
     }
 
-    // ===== 步骤 8: 预计算所有边界点的状态 =====
-    double dX_acc = 0.0, dV_acc = 0.0, dA_acc = 0.0, dJ_acc = 0.0;
-    stPlannerInput stEffectiveInput = *pstInput;
-    // 应用缩放因子得到实际生效的约束
-    stEffectiveInput.dVMax = pow(pContext->dAlphaScaleFactor, 1.0) * pstInput->dVMax;
-    stEffectiveInput.dAMax = pow(pContext->dAlphaScaleFactor, 2.0) * pstInput->dAMax;
-    stEffectiveInput.dJMax = pow(pContext->dAlphaScaleFactor, 3.0) * pstInput->dJMax;
-    stEffectiveInput.dDMax = pow(pContext->dAlphaScaleFactor, 4.0) * pstInput->dDMax;
-    double dD_eff = stEffectiveInput.dDMax;
-    // 加速段 Snap 序列：正向变化
-    double adSnapAcc[7] = { dD_eff, 0, -dD_eff, 0, -dD_eff, 0, dD_eff };
+    double dStartUs = PlannerNowUs();
+    memset(pContext, 0, sizeof(stPlannerContext));
+    pContext->stInput = *pLimits;
+    pContext->stInput.dTimeLimit = 0.0;
+    pContext->dAlphaScaleFactor = 1.0; pContext->bIsTimeScaled = 0;
+    pContext->dTimeScale = 1.0;
+    pContext->dStartPos = pstInputEx->dStartPos;
+    pContext->dDirection = (pLimits->dDistance < 0.0) ? -1.0 : 1.0;
+    pContext->dStartVel = fmin(pstInputEx->dStartVel, pLimits->dVMax);
+    pContext->dEndVel = fmin(pstInputEx->dEndVel, pLimits->dVMax);
+    pContext->dTimeOffset = pstInputEx->dTimeOffset;
+
+    double dS = fabs(pLimits->dDistance);
+    double dVPeak, dTv;
+    if (SolvePeakVelocity(pLimits, dS, pContext->dStartVel, pContext->dEndVel, &dVPeak, &dTv,
+                          &pContext->iSolverIterations) != 0) {
+        fprintf(stderr, "ERROR: InitEx - distance %.9f too short for velocity change %.6f -> %.6f\n",
+                dS, pContext->dStartVel, pContext->dEndVel);
+        return -1;
+    }
 
-    // 初始化加速段第0个边界点（起始点）
-    pContext->stAccStateAtBorder[0] = (stSegmentBoundaryState){0.0, 0.0, 0.0, 0.0};
-    for (int i = 0; i < 7; ++i) {
-        double dDt = adDurVec[i]; double dSnap = adSnapAcc[i];
-        if (dDt < 1e-12) { pContext->stAccStateAtBorder[i+1] = pContext->stAccStateAtBorder[i]; continue; }
-        double dt2=dDt*dDt, dt3=pow(dDt,3), dt4=pow(dDt,4);
-        // 四阶多项式积分更新位置、速度、加速度、Jerk
-        dX_acc += dV_acc * dDt + 0.5 * dA_acc * dt2 + (1.0/6.0) * dJ_acc * dt3 + (1.0/24.0) * dSnap * dt4;
-        dV_acc += dA_acc * dDt + 0.5 * dJ_acc * dt2 + (1.0/6.0) * dSnap * dt3;
-        dA_acc += dJ_acc * dDt + 0.5 * dSnap * dt2;
-        dJ_acc += dSnap * dDt;
-         if (!isfinite(dX_acc) || !isfinite(dV_acc) || !isfinite(dA_acc) || !isfinite(dJ_acc)) {
-            fprintf(stderr, "ERROR: Invalid state during acceleration precomputation at segment %d\n", i);
-            free(pContext); return NULL;
-        }
-        pContext->stAccStateAtBorder[i+1] = (stSegmentBoundaryState){dX_acc, dV_acc, dA_acc, dJ_acc};
+    double dTeAcc = RampTimeSegments(pContext->dStartVel, dVPeak, pLimits, &pContext->dTd, &pContext->dTj, &pContext->dTa);
+    double dTeDec = RampTimeSegments(dVPeak, pContext->dEndVel, pLimits, &pContext->dTdDec, &pContext->dTjDec, &pContext->dTaDec);
+    pContext->dTv = dTv;
+    pContext->dTotalTime = dTeAcc + dTv + dTeDec;
+
+    double adDurAcc[7] = { pContext->dTd, pContext->dTj, pContext->dTd, pContext->dTa, pContext->dTd, pContext->dTj, pContext->dTd };
+    double adDurDec[7] = { pContext->dTdDec, pContext->dTjDec, pContext->dTdDec, pContext->dTaDec,
+                           pContext->dTdDec, pContext->dTjDec, pContext->dTdDec };
+    if (PrecomputeProfile(pContext, adDurAcc, dTeAcc, adDurDec, dTeDec, pLimits->dDMax) != 0) {
+        return -1;
     }
 
-    // 匀速段结束状态 = 加速段结束状态 + 匀速段位移
-    pContext->stConstVelEndState = pContext->stAccStateAtBorder[7];
-    pContext->stConstVelEndState.dPos += pContext->stAccStateAtBorder[7].dVel * pContext->dTv;
+    pContext->dCurrentTime = pContext->dTimeOffset;
+    pContext->llSampleIndex = 0;
+    pContext->iSegmentCursor = 0;
+    pContext->bIsFinished = 0;
+    pContext->dInitUs = PlannerNowUs() - dStartUs;
+    return 0;
+}
 
-    // 减速段状态计算（从匀速段结束点开始）
-    double dX_dec = pContext->stConstVelEndState.dPos;
-    double dV_dec = pContext->stConstVelEndState.dVel;
-    double dA_dec = 0.0; double dJ_dec = 0.0;
-    // 减速段 Snap 序列：反向变化
-    double adSnapDec[7] = { -dD_eff, 0, dD_eff, 0, dD_eff, 0, -dD_eff };
-    pContext->stDecStateAtBorder[0] = pContext->stConstVelEndState;
-    for (int i = 0; i < 7; ++i) {
-        double dDt = adDurVec[i]; double dSnap = adSnapDec[i];
-         if (dDt < 1e-12) { pContext->stDecStateAtBorder[i+1] = pContext->stDecStateAtBorder[i]; continue; }
-        double dt2=dDt*dDt, dt3=pow(dDt,3), dt4=pow(dDt,4);
-        dX_dec += dV_dec * dDt + 0.5 * dA_dec * dt2 + (1.0/6.0) * dJ_dec * dt3 + (1.0/24.0) * dSnap * dt4;
-        dV_dec += dA_dec * dDt + 0.5 * dJ_dec * dt2 + (1.0/6.0) * dSnap * dt3;
-        dA_dec += dJ_dec * dDt + 0.5 * dSnap * dt2;
-        dJ_dec += dSnap * dDt;
-        if (!isfinite(dX_dec) || !isfinite(dV_dec) || !isfinite(dA_dec) || !isfinite(dJ_dec)) {
-            fprintf(stderr, "ERROR: Invalid state during deceleration precomputation at segment %d\n", i);
-            free(pContext); return NULL;
-        }
-        pContext->stDecStateAtBorder[i+1] = (stSegmentBoundaryState){dX_dec, dV_dec, dA_dec, dJ_dec};
+/**
+ * @brief 由起点速度减速到静止的最短位移 (速度变化段位移 S(v0, 0))
+ */
+double FourthOrderPlannerStopDistance(const stPlannerInput *pstLimits, double dStartVel) {
+    if (!pstLimits || pstLimits->dAMax <= 0.0 || pstLimits->dJMax <= 0.0 || pstLimits->dDMax <= 0.0 ||
+        !(dStartVel >= 0.0)) {
+        return -1.0;
     }
+    return RampDistance(dStartVel, 0.0, pstLimits);
+}
 
-     // 验证最终位置与速度是否满足要求
-     double finalPosError = fabs(pContext->stDecStateAtBorder[7].dPos - pContext->stInput.dDistance);
-     double finalVelError = fabs(pContext->stDecStateAtBorder[7].dVel);
-     if (finalPosError > 1e-6 || finalVelError > 1e-6) {
-         fprintf(stderr, "ERROR: Init - Precalculated final state deviates significantly.\n");
-         fprintf(stderr, "       Final Pos: %.9f (Target: %.9f, Error: %.3e)\n", pContext->stDecStateAtBorder[7].dPos, pContext->stInput.dDistance, finalPosError);
-         fprintf(stderr, "       Final Vel: %.9f (Error: %.3e)\n", pContext->stDecStateAtBorder[7].dVel, finalVelError);
-          free(pContext); return NULL;
-     }
+/**
+ * @brief 由起点速度在给定位移内可达的、不超过上限的最大终点速度
+ * @details
+ *   速度变化段位移 S(v0, v1) 关于速度变化量为凹函数 (Te 关于速度变化量为凹函数):
+ *   - 上限不低于 v0: v1 >= v0 一侧 S 单调递增, 二分求 S(v0, v1) <= dS 的最大 v1 (不超过上限)
+ *   - 上限低于 v0: [0, v0] 上可行集为 [0, a] ∪ [b, v0]; 上限本身可行即取上限,
+ *     否则上限落在 (a, b) 内, 在 [0, 上限] 上二分求 a (S(v0, 0) > dS 时无解)
+ */
+double FourthOrderPlannerMaxEndVelocity(const stPlannerInput *pstLimits, double dStartVel, double dEndVelCap) {
+    if (!pstLimits || pstLimits->dVMax <= 0.0 || pstLimits->dAMax <= 0.0 ||
+        pstLimits->dJMax <= 0.0 || pstLimits->dDMax <= 0.0 || !(dStartVel >= 0.0) || !(dEndVelCap >= 0.0)) {
+        return -1.0;
+    }
+    double dS = fabs(pstLimits->dDistance);
+    double dV0 = fmin(dStartVel, pstLimits->dVMax);
+    double dCap = fmin(dEndVelCap, pstLimits->dVMax);
+    double dLow, dHigh;
 
-    // ===== 步骤 9: 初始化内部状态 =====
-    pContext->dCurrentTime = 0.0;
-    pContext->bIsFinished = 0;
+    if (RampDistance(dV0, dCap, pstLimits) <= dS) {
+        return dCap;
+    }
+    if (dCap >= dV0) {
+        dLow = dV0;                 // S(v0, v0) = 0, 可行
+    } else {
+        if (RampDistance(dV0, 0.0, pstLimits) > dS) {
+            return -1.0;
+        }
+        dLow = 0.0;
+    }
+    dHigh = dCap;                   // 不可行
+    for (int i = 0; i < 100 && dHigh - dLow > 1e-14 * pstLimits->dVMax; ++i) {
+        double dMid = 0.5 * (dLow + dHigh);
+        if (RampDistance(dV0, dMid, pstLimits) <= dS) dLow = dMid;
+        else dHigh = dMid;
+    }
+    return dLow;
+}
 
+/**
+ * @brief 分配上下文并调用 FourthOrderPlannerInitInto (非实时路径使用, 须以 FourthOrderPlannerFree 释放)
+ */
+stPlannerContext* FourthOrderPlannerInit(const stPlannerInput *pstInput) {
+    stPlannerContext *pContext = (stPlannerContext*)malloc(sizeof(stPlannerContext));
+    if (!pContext) { fprintf(stderr, "ERROR: Failed to allocate memory\n"); return NULL; }
+    if (FourthOrderPlannerInitInto(pstInput, pContext) != 0) {
+        free(pContext);
+        return NULL;
+    }
     return pContext;
 }
 
 
 /**
- * @brief 获取轨迹的下一个点 (增加边界检查)
+ * @brief 获取轨迹的下一个点 (子阶段游标 + Horner 求值)
  * @details
- *   每次调用返回当前时间点对应的完整运动学状态。
- *   通过预计算的边界状态 + 局部积分实现高精度输出。
- *   支持实时逐点调用，适用于嵌入式控制循环。
+ *   时间由采样序号 k 计算 (t = k * Ts + 时间偏移)，不做浮点累加，长轨迹也不会漂移。
+ *   GetNextPoint 的时间单调递增，游标只需从当前段向后推进，均摊 O(1)；
+ *   段内直接用预计算的多项式系数求值，不再调用 pow()。
+ *   到达总时长时输出精确终点并置完成标志 (本次返回 0)，此后调用返回 1。
  */
 int FourthOrderPlannerGetNextPoint(stPlannerContext *pContext, stTrajectoryPoint *pPointOutput) {
     if (!pContext || !pPointOutput) { return 1; }
-    if (pContext->bIsFinished && pContext->dCurrentTime > pContext->dTotalTime) return 1;
+    if (pContext->bIsFinished) return 1;
+    if (pContext->bTimeWarped) return GetNextPointWarped(pContext, pPointOutput);
 
-    double dTime = pContext->dCurrentTime;
     const double EPS = 1e-9;
+    double dTime = SampleTime(pContext, pContext->llSampleIndex);
 
-    if (!pContext->bIsFinished && dTime >= pContext->dTotalTime - EPS) {
-        dTime = pContext->dTotalTime;
+    if (dTime >= pContext->dTotalTime - EPS) {
+        CalculateFinalPoint(pContext, pPointOutput);
         pContext->bIsFinished = 1;
-    } else if (dTime < 0.0) {
-        dTime = 0.0;
+        pContext->dCurrentTime = pContext->dTotalTime + pContext->stInput.dSampleTime;
+        return 0;
     }
 
-    CalculatePoint(pContext, dTime, pPointOutput);
+    // 推进游标: 与原实现一致, 距段末 1e-12 以内即视为进入下一段
+    int iCursor = pContext->iSegmentCursor;
+    while (iCursor < pContext->iSegmentCount - 1 && dTime >= pContext->astSegment[iCursor].dEndTime - 1e-12) {
+        iCursor++;
+    }
+    pContext->iSegmentCursor = iCursor;
 
-    if (!pContext->bIsFinished) {
-        pContext->dCurrentTime += pContext->stInput.dSampleTime;
-    } else {
-        pContext->dCurrentTime = pContext->dTotalTime + pContext->stInput.dSampleTime;
+    EvaluateSegment(&pContext->astSegment[iCursor], dTime, pPointOutput);
+
+    pContext->llSampleIndex++;
+    pContext->dCurrentTime = SampleTime(pContext, pContext->llSampleIndex);
+    return 0;
+}
+
+/**
+ * @brief 成批生成后续轨迹点 (按子阶段分块)
+ * @details
+ *   对当前段先求出仍落在本段内的采样序号区间 [k, kEnd)，判定条件与 GetNextPoint 逐点判定完全相同
+ *   (同一浮点表达式 k * Ts + 时间偏移 与段末/总时长比较)，再对各输出量分别做无分支的 Horner 循环，便于编译器向量化。
+ *   跳过 NULL 输出，不写 stTrajectoryPoint。
+ */
+int FourthOrderPlannerGenerateBlock(stPlannerContext *pContext, int iMaxPoints,
+                                    double *pdPos, double *pdVel, double *pdAcc, double *pdJerk) {
+    if (!pContext || iMaxPoints <= 0) { return 0; }
+
+    const double EPS = 1e-9;
+    const double dTs = pContext->stInput.dSampleTime;
+    const double dOffset = pContext->dTimeOffset;
+    const double dEndLimit = pContext->dTotalTime - EPS;
+    int iWritten = 0;
+
+    // 时间扭曲下采样时刻不再是序号的线性函数, 逐点输出
+    while (pContext->bTimeWarped && iWritten < iMaxPoints && !pContext->bIsFinished) {
+        stTrajectoryPoint stPoint;
+        GetNextPointWarped(pContext, &stPoint);
+        if (pdPos)  pdPos[iWritten]  = stPoint.dPos;
+        if (pdVel)  pdVel[iWritten]  = stPoint.dVel;
+        if (pdAcc)  pdAcc[iWritten]  = stPoint.dAcc;
+        if (pdJerk) pdJerk[iWritten] = stPoint.dJerk;
+        iWritten++;
+    }
+
+    while (iWritten < iMaxPoints && !pContext->bIsFinished) {
+        long long k = pContext->llSampleIndex;
+        double dTime = (double)k * dTs + dOffset;
+
+        if (dTime >= dEndLimit) {
+            stTrajectoryPoint stFinal;
+            CalculateFinalPoint(pContext, &stFinal);
+            if (pdPos)  pdPos[iWritten]  = stFinal.dPos;
+            if (pdVel)  pdVel[iWritten]  = stFinal.dVel;
+            if (pdAcc)  pdAcc[iWritten]  = stFinal.dAcc;
+            if (pdJerk) pdJerk[iWritten] = stFinal.dJerk;
+            iWritten++;
+            pContext->bIsFinished = 1;
+            pContext->dCurrentTime = pContext->dTotalTime + dTs;
+            break;
+        }
+
+        int iCursor = pContext->iSegmentCursor;
+        while (iCursor < pContext->iSegmentCount - 1 && dTime >= pContext->astSegment[iCursor].dEndTime - 1e-12) {
+            iCursor++;
+        }
+        pContext->iSegmentCursor = iCursor;
+        const stTrajectorySegment *pSeg = &pContext->astSegment[iCursor];
+
+        // 本段最后一个采样之后的序号: 第一个满足 kEnd*Ts >= 段末 (末段还受总时长限制) 的序号
+        double dLimit = (iCursor < pContext->iSegmentCount - 1) ? pSeg->dEndTime - 1e-12 : dEndLimit;
+        if (dLimit > dEndLimit) dLimit = dEndLimit;
+        long long kEnd = (long long)ceil((dLimit - dOffset) / dTs);
+        while (kEnd > k && (double)(kEnd - 1) * dTs + dOffset >= dLimit) kEnd--;
+        while ((double)kEnd * dTs + dOffset < dLimit) kEnd++;
+
+        int n = iMaxPoints - iWritten;
+        if (kEnd - k < n) n = (int)(kEnd - k);
+
+        const double dStart = pSeg->dStartTime;
+        const double dDur = pSeg->dEndTime - pSeg->dStartTime;
+        if (pdPos) {
+            const double c0 = pSeg->adPos[0], c1 = pSeg->adPos[1], c2 = pSeg->adPos[2], c3 = pSeg->adPos[3], c4 = pSeg->adPos[4];
+            double *pdOut = pdPos + iWritten;
+            for (int i = 0; i < n; i++) {
+                double dTau = (double)(k + i) * dTs + dOffset - dStart;
+                dTau = (dTau < 0.0) ? 0.0 : ((dTau > dDur) ? dDur : dTau);
+                pdOut[i] = c0 + dTau * (c1 + dTau * (c2 + dTau * (c3 + dTau * c4)));
+            }
+        }
+        if (pdVel) {
+            const double c0 = pSeg->adVel[0], c1 = pSeg->adVel[1], c2 = pSeg->adVel[2], c3 = pSeg->adVel[3];
+            double *pdOut = pdVel + iWritten;
+            for (int i = 0; i < n; i++) {
+                double dTau = (double)(k + i) * dTs + dOffset - dStart;
+                dTau = (dTau < 0.0) ? 0.0 : ((dTau > dDur) ? dDur : dTau);
+                pdOut[i] = c0 + dTau * (c1 + dTau * (c2 + dTau * c3));
+            }
+        }
+        if (pdAcc) {
+            const double c0 = pSeg->adAcc[0], c1 = pSeg->adAcc[1], c2 = pSeg->adAcc[2];
+            double *pdOut = pdAcc + iWritten;
+            for (int i = 0; i < n; i++) {
+                double dTau = (double)(k + i) * dTs + dOffset - dStart;
+                dTau = (dTau < 0.0) ? 0.0 : ((dTau > dDur) ? dDur : dTau);
+                pdOut[i] = c0 + dTau * (c1 + dTau * c2);
+            }
+        }
+        if (pdJerk) {
+            const double c0 = pSeg->adJerk[0], c1 = pSeg->adJerk[1];
+            double *pdOut = pdJerk + iWritten;
+            for (int i = 0; i < n; i++) {
+                double dTau = (double)(k + i) * dTs + dOffset - dStart;
+                dTau = (dTau < 0.0) ? 0.0 : ((dTau > dDur) ? dDur : dTau);
+                pdOut[i] = c0 + dTau * c1;
+            }
+        }
+
+        iWritten += n;
+        pContext->llSampleIndex = k + n;
+        pContext->dCurrentTime = (double)pContext->llSampleIndex * dTs + dOffset;
+    }
+    return iWritten;
+}
+
+/**
+ * @brief 随机访问任意时刻的轨迹点 (二分查找子阶段，不修改上下文)
+ */
+int FourthOrderPlannerGetPointAt(const stPlannerContext *pContext, double dTime, stTrajectoryPoint *pPointOutput) {
+    if (!pContext || !pPointOutput) { return 1; }
+
+    if (dTime >= pContext->dTotalTime - 1e-9 || pContext->iSegmentCount == 0) {
+        CalculateFinalPoint(pContext, pPointOutput);
+        return 0;
+    }
+    if (dTime < 0.0) dTime = 0.0;
+
+    // 查找满足 dTime < dEndTime - 1e-12 的第一个段
+    int iLow = 0, iHigh = pContext->iSegmentCount - 1;
+    while (iLow < iHigh) {
+        int iMid = (iLow + iHigh) / 2;
+        if (dTime >= pContext->astSegment[iMid].dEndTime - 1e-12) iLow = iMid + 1;
+        else iHigh = iMid;
+    }
+    EvaluateSegment(&pContext->astSegment[iLow], dTime, pPointOutput);
+    return 0;
+}
+
+/**
+ * @brief 下一次 GetNextPoint 是否输出终点 (与 GetNextPoint 的判定相同)
+ */
+int FourthOrderPlannerIsAtEnd(const stPlannerContext *pContext) {
+    if (!pContext || pContext->bIsFinished) { return 1; }
+    if (pContext->bTimeWarped) { return pContext->dWarpTime >= pContext->dTotalTime - 1e-9; }
+    return SampleTime(pContext, pContext->llSampleIndex) >= pContext->dTotalTime - 1e-9;
+}
+
+/**
+ * @brief 终点采样时刻超出总时长的部分 (终点采样序号为第一个满足 k * Ts + 偏移 >= 总时长 - EPS 的 k)
+ */
+double FourthOrderPlannerGetEndOffset(const stPlannerContext *pContext) {
+    if (!pContext) { return 0.0; }
+    const double dLimit = pContext->dTotalTime - 1e-9;
+    const double dTs = pContext->stInput.dSampleTime;
+    long long k = (long long)ceil((dLimit - pContext->dTimeOffset) / dTs);
+    if (k < 0) k = 0;
+    while (k > 0 && SampleTime(pContext, k - 1) >= dLimit) k--;
+    while (SampleTime(pContext, k) < dLimit) k++;
+    return fmax(0.0, SampleTime(pContext, k) - pContext->dTotalTime);
+}
+
+/**
+ * @brief 设置进给倍率 (时间扭曲); 首次调用时由当前采样时刻切换到扭曲时间基
+ */
+int FourthOrderPlannerSetTimeScale(stPlannerContext *pContext, double dScale, double dScaleRate, double dScaleAccel) {
+    if (!pContext || !(dScale >= 0.0) || !isfinite(dScale) || !isfinite(dScaleRate) || !isfinite(dScaleAccel)) {
+        return 1;
+    }
+    if (!pContext->bTimeWarped) {
+        pContext->dWarpTime = SampleTime(pContext, pContext->llSampleIndex);
+        pContext->bTimeWarped = 1;
+    }
+    pContext->dTimeScale = dScale;
+    pContext->dTimeScaleRate = dScaleRate;
+    pContext->dTimeScaleAccel = dScaleAccel;
+    return 0;
+}
+
+/**
+ * @brief 衔接段继承时间扭曲 (上一段已 IsAtEnd: 扭曲时刻超出总时长的部分即下一段的首个取点时刻)
+ */
+void FourthOrderPlannerInheritTimeWarp(stPlannerContext *pNext, const stPlannerContext *pPrev) {
+    if (!pNext || !pPrev || !pPrev->bTimeWarped) { return; }
+    pNext->bTimeWarped = 1;
+    pNext->dWarpTime = fmax(0.0, pPrev->dWarpTime - pPrev->dTotalTime);
+    pNext->dCurrentTime = pNext->dWarpTime;
+    pNext->dTimeScale = pPrev->dTimeScale;
+    pNext->dTimeScaleRate = pPrev->dTimeScaleRate;
+    pNext->dTimeScaleAccel = pPrev->dTimeScaleAccel;
+}
+
+/**
+ * @brief 由预计算的边界状态解析求出诊断信息 (不采样轨迹)
+ * @details
+ *   各子阶段内 Snap 恒定, Jerk 分段线性且在段内不变号, 因此 Jerk、加速度、速度的极值都落在子阶段边界上
+ *   (速度在加速段单调增、减速段单调减)。取加速段与减速段 16 个边界状态的绝对值最大者即为精确峰值。
+ */
+int FourthOrderPlannerGetDiagnostics(const stPlannerContext *pContext, stPlannerDiagnostics *pDiagnostics) {
+    if (!pContext || !pDiagnostics) { return 1; }
+
+    stPlannerInput stEffectiveInput;
+    memset(pDiagnostics, 0, sizeof(*pDiagnostics));
+    pDiagnostics->dTotalTime = pContext->dTotalTime;
+    pDiagnostics->dTd = pContext->dTd;
+    pDiagnostics->dTj = pContext->dTj;
+    pDiagnostics->dTa = pContext->dTa;
+    pDiagnostics->dTv = pContext->dTv;
+    pDiagnostics->bIsTimeScaled = pContext->bIsTimeScaled;
+    pDiagnostics->dAlphaScaleFactor = pContext->dAlphaScaleFactor;
+
+    ScalePlannerInput(&pContext->stInput, pContext->dAlphaScaleFactor, &stEffectiveInput);
+    pDiagnostics->dVMaxEffective = stEffectiveInput.dVMax;
+    pDiagnostics->dAMaxEffective = stEffectiveInput.dAMax;
+    pDiagnostics->dJMaxEffective = stEffectiveInput.dJMax;
+    pDiagnostics->dDMaxEffective = stEffectiveInput.dDMax;
+
+    for (int i = 0; i < 8; ++i) {
+        const stSegmentBoundaryState *pAcc = &pContext->stAccStateAtBorder[i];
+        const stSegmentBoundaryState *pDec = &pContext->stDecStateAtBorder[i];
+        pDiagnostics->dVPeak = fmax(pDiagnostics->dVPeak, fmax(fabs(pAcc->dVel), fabs(pDec->dVel)));
+        pDiagnostics->dAPeak = fmax(pDiagnostics->dAPeak, fmax(fabs(pAcc->dAcc), fabs(pDec->dAcc)));
+        pDiagnostics->dJPeak = fmax(pDiagnostics->dJPeak, fmax(fabs(pAcc->dJerk), fabs(pDec->dJerk)));
     }
 
+    pDiagnostics->dInitUs = pContext->dInitUs;
+    pDiagnostics->iSolverIterations = pContext->iSolverIterations;
+    pDiagnostics->iExitFlag = (isfinite(pContext->dTotalTime) && isfinite(pDiagnostics->dVPeak)) ? 0 : -1;
     return 0;
 }
 
@@ -292,160 +548,163 @@ void FourthOrderPlannerFree(stPlannerContext *pContext) {
 }
 
 /**
- * @brief 根据当前时间计算轨迹点 (核心计算函数)
+ * @brief 由段起点状态和段内 Snap 生成子阶段多项式系数
+ */
+static void SetSegment(stTrajectorySegment *pSeg, double dStartTime, double dEndTime,
+                       const stSegmentBoundaryState *pBorder, double dSnap, double dOrigin, double dDirection) {
+    // 边界状态按位移大小记录, 在此换算为绝对位置与有符号各阶导数 (Init 时 dOrigin = 0, dDirection = 1, 数值不变)
+    stSegmentBoundaryState stState = { dOrigin + dDirection * pBorder->dPos, dDirection * pBorder->dVel,
+                                       dDirection * pBorder->dAcc, dDirection * pBorder->dJerk };
+    const stSegmentBoundaryState *pState = &stState;
+    dSnap *= dDirection;
+    pSeg->dStartTime = dStartTime;
+    pSeg->dEndTime = dEndTime;
+    pSeg->dSnap = dSnap;
+
+    pSeg->adPos[0] = pState->dPos;  pSeg->adPos[1] = pState->dVel;
+    pSeg->adPos[2] = 0.5 * pState->dAcc;  pSeg->adPos[3] = (1.0/6.0) * pState->dJerk;
+    pSeg->adPos[4] = (1.0/24.0) * dSnap;
+
+    pSeg->adVel[0] = pState->dVel;  pSeg->adVel[1] = pState->dAcc;
+    pSeg->adVel[2] = 0.5 * pState->dJerk;  pSeg->adVel[3] = (1.0/6.0) * dSnap;
+
+    pSeg->adAcc[0] = pState->dAcc;  pSeg->adAcc[1] = pState->dJerk;  pSeg->adAcc[2] = 0.5 * dSnap;
+
+    pSeg->adJerk[0] = pState->dJerk;  pSeg->adJerk[1] = dSnap;
+}
+
+/**
+ * @brief 生成子阶段多项式表
  * @details
- *   1. 判断当前时间属于加速段、匀速段还是减速段
- *   2. 确定所在子阶段（7段法）
- *   3. 使用预计算的边界状态作为初始值
- *   4. 在当前子阶段内进行局部四阶积分
- *   5. 输出位置、速度、加速度、Jerk、Snap
- */
-static void CalculatePoint(const stPlannerContext *pContext, double dTime, stTrajectoryPoint *pPointOutput) {
-    // 获取生效的约束
-    double dAlpha = pContext->dAlphaScaleFactor;
-    double dD = pow(dAlpha, 4.0) * pContext->stInput.dDMax;
-
-    memset(pPointOutput, 0, sizeof(stTrajectoryPoint));
+ *   按 加速 7 段 -> 匀速段 -> 减速 7 段 的时间顺序排列，时长为 0 的段不入表。
+ *   匀速段的加速度与 Jerk 强制为 0 (与原逐点实现一致)。
+ */
+static void BuildSegmentTable(stPlannerContext *pContext, const double *pdSnapAcc, const double *pdSnapDec) {
+    const double EPS = 1e-12;
+    int iCount = 0;
+
+    for (int i = 0; i < 7; ++i) {
+        if (pContext->adAccSegBorders[i + 1] - pContext->adAccSegBorders[i] < EPS) continue;
+        SetSegment(&pContext->astSegment[iCount++], pContext->adAccSegBorders[i], pContext->adAccSegBorders[i + 1],
+                   &pContext->stAccStateAtBorder[i], pdSnapAcc[i], pContext->dStartPos, pContext->dDirection);
+    }
+    if (pContext->dDecelStartTime - pContext->dConstVelStartTime >= EPS) {
+        stSegmentBoundaryState stCruise = pContext->stAccStateAtBorder[7];
+        stCruise.dAcc = 0.0; stCruise.dJerk = 0.0;
+        SetSegment(&pContext->astSegment[iCount++], pContext->dConstVelStartTime, pContext->dDecelStartTime,
+                   &stCruise, 0.0, pContext->dStartPos, pContext->dDirection);
+    }
+    for (int i = 0; i < 7; ++i) {
+        if (pContext->adDecSegBorders[i + 1] - pContext->adDecSegBorders[i] < EPS) continue;
+        SetSegment(&pContext->astSegment[iCount++], pContext->adDecSegBorders[i], pContext->adDecSegBorders[i + 1],
+                   &pContext->stDecStateAtBorder[i], pdSnapDec[i], pContext->dStartPos, pContext->dDirection);
+    }
+    pContext->iSegmentCount = iCount;
+}
+
+/**
+ * @brief 在给定子阶段内用 Horner 法求值
+ */
+static void EvaluateSegment(const stTrajectorySegment *pSeg, double dTime, stTrajectoryPoint *pPointOutput) {
+    double dTau = dTime - pSeg->dStartTime;
+    if (dTau < 0.0) dTau = 0.0;
+    if (dTau > pSeg->dEndTime - pSeg->dStartTime) dTau = pSeg->dEndTime - pSeg->dStartTime;
+
+    const double *c;
     pPointOutput->dTime = dTime;
-    const double EPS = 1e-12; // 內部計算容差
-
-    // 处理 dTime=0
-    if (dTime < EPS) {
-        stSegmentBoundaryState initialState = pContext->stAccStateAtBorder[0];
-        pPointOutput->dPos = initialState.dPos; pPointOutput->dVel = initialState.dVel;
-        pPointOutput->dAcc = initialState.dAcc; pPointOutput->dJerk = initialState.dJerk;
-        pPointOutput->dSnap = (pContext->dTd > EPS) ? dD : 0.0;
-        return;
-    }
-    // 处理 dTime=dTotalTime
-    if (fabs(dTime - pContext->dTotalTime) < EPS) {
-        stSegmentBoundaryState finalState = pContext->stDecStateAtBorder[7];
-        pPointOutput->dPos = finalState.dPos;
-        pPointOutput->dVel = 0.0; pPointOutput->dAcc = 0.0; pPointOutput->dJerk = 0.0; pPointOutput->dSnap = 0.0;
-         // 轻微修正，确保完全到达目标
-         if (fabs(pPointOutput->dPos - pContext->stInput.dDistance) < 1e-6) {
-              pPointOutput->dPos = pContext->stInput.dDistance;
-         }
-        return;
-    }
-
-    // 根据时间判断阶段
-    int iSegment = -1;
-    double dSegmentStartTime = 0.0;
-    stSegmentBoundaryState initialState = {0};
-    double currentSnapValue = 0.0;
-    const double* snapProfile = NULL;
-
-    if (dTime >= pContext->dConstVelStartTime - EPS && dTime < pContext->dDecelStartTime - EPS) {
-         // ========== 阶段 2: 勻速段 ==========
-         initialState = pContext->stAccStateAtBorder[7];
-         double dTau = dTime - pContext->dConstVelStartTime; if(dTau < 0) dTau = 0;
-         pPointOutput->dSnap = 0.0; pPointOutput->dJerk = 0.0; pPointOutput->dAcc  = 0.0;
-         pPointOutput->dVel  = initialState.dVel;
-         pPointOutput->dPos  = initialState.dPos + initialState.dVel * dTau;
-         return;
-    }
-    else if (dTime >= pContext->dDecelStartTime - EPS) {
-        // ========== 阶段 3: 減速段 ==========
-        double adSnapDec[7] = { -dD, 0, dD, 0, dD, 0, -dD };
-        snapProfile = adSnapDec;
-        for (int i = 0; i < 7; ++i) {
-            if (dTime >= pContext->adDecSegBorders[i] - EPS && dTime < pContext->adDecSegBorders[i+1] - EPS) {
-                iSegment = i;
-                initialState = pContext->stDecStateAtBorder[i];
-                dSegmentStartTime = pContext->adDecSegBorders[i];
-                break;
-            }
-        }
-         // 特殊处理恰好在减速阶段结束点的情況（已被 dTime=dTotalTime 處理）
-         if (iSegment == -1 && fabs(dTime - pContext->adDecSegBorders[7]) < EPS) {
-             // 應該被 dTime=dTotalTime 分支捕獲，但作為後備
-             stSegmentBoundaryState finalState = pContext->stDecStateAtBorder[7];
-             pPointOutput->dPos = finalState.dPos; pPointOutput->dVel = 0.0; pPointOutput->dAcc = 0.0;
-             pPointOutput->dJerk = 0.0; pPointOutput->dSnap = 0.0;
-             return;
-         }
-    }
-    else { // dTime < pContext->dConstVelStartTime - EPS
-        // ========== 阶段 1: 加速段 ==========
-        double adSnapAcc[7] = { dD, 0, -dD, 0, -dD, 0, dD };
-        snapProfile = adSnapAcc;
-        for (int i = 0; i < 7; ++i) {
-            if (dTime >= pContext->adAccSegBorders[i] - EPS && dTime < pContext->adAccSegBorders[i+1] - EPS) {
-                iSegment = i;
-                initialState = pContext->stAccStateAtBorder[i];
-                dSegmentStartTime = pContext->adAccSegBorders[i];
-                break;
-            }
-        }
-         // 特殊处理恰好在加速段结束点
-         if (iSegment == -1 && fabs(dTime - pContext->dConstVelStartTime) < EPS) {
-             initialState = pContext->stAccStateAtBorder[7];
-             pPointOutput->dPos = initialState.dPos; pPointOutput->dVel = initialState.dVel;
-             pPointOutput->dAcc = initialState.dAcc; pPointOutput->dJerk = initialState.dJerk;
-             pPointOutput->dSnap = adSnapAcc[6]; // 第七段结束时的 Snap
-             return;
-         }
-    }
-
-    // --- 执行选定段内的积分计算 ---
-    if (iSegment >= 0 && iSegment < 7 && snapProfile != NULL) {
-        double dTau = dTime - dSegmentStartTime; if(dTau < 0) dTau = 0;
-
-        double dSegDuration = 0.0;
-        if (snapProfile[0] == dD) { // 加速段
-             dSegDuration = pContext->adAccSegBorders[iSegment+1] - pContext->adAccSegBorders[iSegment];
-        } else { // 减速段
-             dSegDuration = pContext->adDecSegBorders[iSegment+1] - pContext->adDecSegBorders[iSegment];
-        }
-        if (dTau > dSegDuration + EPS) dTau = fmax(0.0, dSegDuration);
-
-        currentSnapValue = snapProfile[iSegment];
-        double dX0 = initialState.dPos, dV0 = initialState.dVel, dA0 = initialState.dAcc, dJ0 = initialState.dJerk;
-        double dt2=dTau*dTau, dt3=(dTau>0)?pow(dTau,3):0.0, dt4=(dTau>0)?pow(dTau,4):0.0;
-
-        pPointOutput->dSnap = currentSnapValue;
-        pPointOutput->dJerk = dJ0 + currentSnapValue * dTau;
-        pPointOutput->dAcc  = dA0 + dJ0 * dTau + 0.5 * currentSnapValue * dt2;
-        pPointOutput->dVel  = dV0 + dA0 * dTau + 0.5 * dJ0 * dt2 + (1.0/6.0) * currentSnapValue * dt3;
-        pPointOutput->dPos  = dX0 + dV0 * dTau + 0.5 * dA0 * dt2 + (1.0/6.0) * dJ0 * dt3 + (1.0/24.0) * currentSnapValue * dt4;
-
-        if (!isfinite(pPointOutput->dPos)) {
-             fprintf(stderr, "ERROR: Invalid state (Pos=%.3e) calculated at T=%.9f, Seg=%d, Tau=%.9f\n",
-                     pPointOutput->dPos, dTime, iSegment, dTau);
-             // 保持上一个状态或置零
-             pPointOutput->dPos = dX0; // 回滚
-        }
+    c = pSeg->adPos;  pPointOutput->dPos  = c[0] + dTau * (c[1] + dTau * (c[2] + dTau * (c[3] + dTau * c[4])));
+    c = pSeg->adVel;  pPointOutput->dVel  = c[0] + dTau * (c[1] + dTau * (c[2] + dTau * c[3]));
+    c = pSeg->adAcc;  pPointOutput->dAcc  = c[0] + dTau * (c[1] + dTau * c[2]);
+    c = pSeg->adJerk; pPointOutput->dJerk = c[0] + dTau * c[1];
+    pPointOutput->dSnap = pSeg->dSnap;
+}
+
+/**
+ * @brief 输出终点 (速度为终点速度, 加速度及以上各阶为 0, 位置误差在 1e-6 以内时对齐到目标位移)
+ */
+static void CalculateFinalPoint(const stPlannerContext *pContext, stTrajectoryPoint *pPointOutput) {
+    double dS = fabs(pContext->stInput.dDistance);
+    double dPos = pContext->stDecStateAtBorder[7].dPos;
+    if (fabs(dPos - dS) < 1e-6) {
+        dPos = dS;
+    }
+    pPointOutput->dTime = pContext->dTotalTime;
+    pPointOutput->dPos = pContext->dStartPos + pContext->dDirection * dPos;
+    pPointOutput->dVel = (pContext->dEndVel > 0.0) ? pContext->dDirection * pContext->dEndVel : 0.0;
+    pPointOutput->dAcc = 0.0; pPointOutput->dJerk = 0.0; pPointOutput->dSnap = 0.0;
+}
+
 
+/**
+ * @brief 时间扭曲下取下一个点
+ * @details
+ *   在轨迹时刻 tau 处求值 (tau 单调不减, 游标只前进), 再按 dtau/dt = r 换算各阶导数;
+ *   输出后 tau 前进一个周期内 r 的积分。采样序号照常递增, 仅用于计数。
+ */
+static int GetNextPointWarped(stPlannerContext *pContext, stTrajectoryPoint *pPointOutput) {
+    const double r = pContext->dTimeScale;
+    const double r1 = pContext->dTimeScaleRate;
+    const double r2 = pContext->dTimeScaleAccel;
+    const double dTs = pContext->stInput.dSampleTime;
+    double dTau = pContext->dWarpTime;
+    stTrajectoryPoint stRaw;
+
+    if (dTau >= pContext->dTotalTime - 1e-9) {
+        CalculateFinalPoint(pContext, &stRaw);
+        pContext->bIsFinished = 1;
     } else {
-        // 未找到段落，可能因 EPS 容差恰好落在边界外，或 Init 计算有误
-        fprintf(stderr, "Warning: CalculatePoint could not determine segment for time %.9f. ConstT=%.9f, DecelT=%.9f\n",
-                dTime, pContext->dConstVelStartTime, pContext->dDecelStartTime);
-        // 安全赋值：使用最近的边界状态
-        if (dTime > pContext->dDecelStartTime) {
-             initialState = pContext->stDecStateAtBorder[7]; // 终点
-        } else if (dTime > pContext->dConstVelStartTime) {
-             initialState = pContext->stAccStateAtBorder[7]; // 加速结束
-        } else {
-             initialState = pContext->stAccStateAtBorder[0]; // 起点
+        int iCursor = pContext->iSegmentCursor;
+        while (iCursor < pContext->iSegmentCount - 1 && dTau >= pContext->astSegment[iCursor].dEndTime - 1e-12) {
+            iCursor++;
         }
-         pPointOutput->dPos = initialState.dPos; pPointOutput->dVel = initialState.dVel; pPointOutput->dAcc = initialState.dAcc;
-         pPointOutput->dJerk = initialState.dJerk; pPointOutput->dSnap = 0;
+        pContext->iSegmentCursor = iCursor;
+        EvaluateSegment(&pContext->astSegment[iCursor], dTau, &stRaw);
     }
+
+    pPointOutput->dTime = stRaw.dTime;
+    pPointOutput->dPos  = stRaw.dPos;
+    pPointOutput->dVel  = r * stRaw.dVel;
+    pPointOutput->dAcc  = r * r * stRaw.dAcc + r1 * stRaw.dVel;
+    pPointOutput->dJerk = r * r * r * stRaw.dJerk + 3.0 * r * r1 * stRaw.dAcc + r2 * stRaw.dVel;
+    pPointOutput->dSnap = r * r * r * r * stRaw.dSnap + 6.0 * r * r * r1 * stRaw.dJerk
+                        + (3.0 * r1 * r1 + 4.0 * r * r2) * stRaw.dAcc;
+
+    // 本周期内倍率按 r' 线性变化: tau 前进 (r + r'*Ts/2) * Ts (倍率趋于 0 时不后退)
+    double dStep = fmax(0.0, (r + 0.5 * r1 * dTs) * dTs);
+    pContext->llSampleIndex++;
+    pContext->dWarpTime = pContext->bIsFinished ? pContext->dTotalTime + dStep : dTau + dStep;
+    pContext->dCurrentTime = pContext->dWarpTime;
+    return 0;
 }
 
+/**
+ * @brief 按缩放因子 alpha 缩放物理约束 (速度/加速度/Jerk/Snap 分别乘以 alpha 的 1/2/3/4 次幂)
+ */
+static void ScalePlannerInput(const stPlannerInput *pInput, double dAlpha, stPlannerInput *pScaled) {
+    double dAlpha2 = dAlpha * dAlpha;
+    *pScaled = *pInput;
+    pScaled->dVMax = dAlpha * pInput->dVMax;
+    pScaled->dAMax = dAlpha2 * pInput->dAMax;
+    pScaled->dJMax = dAlpha2 * dAlpha * pInput->dJMax;
+    pScaled->dDMax = dAlpha2 * dAlpha2 * pInput->dDMax;
+}
 
 /**
- * @brief 计算给定约束下的最优时间分段 (强化短行程)
+ * @brief 计算给定约束下的最优时间分段 (解析解)
  * @details
- *   1. 若位移极小，直接返回 0
- *   2. 计算加速到最大速度所需的位移 S_ramp
- *   3. 若总位移足够长 → 有匀速段
- *   4. 若位移不足 → 无匀速段，通过二分搜索峰值加速度 a_peak 使 2*S_ramp = dS
+ *   加速段的加速度曲线关于段中点对称，故加速段位移 S_ramp = V * Te / 2，
+ *   其中 V 为段末速度，Te = 4Td + 2Tj + Ta = 2*T1 + Ta，T1 = 2Td + Tj 为加速度升/降所需时间，
+ *   V = A * (T1 + Ta)。据此各情形均可直接求解：
+ *   1. 峰值加速度上限 A_cap = min(AMax, 恰好以 Ta=0 达到 VMax 的加速度)
+ *   2. 以 A_cap 加速到 VMax 的 2*S_ramp 不超过总位移 → 有匀速段
+ *   3. 否则若以 A_cap、Ta=0 的 2*S_ramp 不超过总位移 → 达到 A_cap 但达不到 VMax，Ta 由二次方程求得
+ *   4. 否则 Ta=0，峰值加速度由 S_ramp(A) = S/2 求得 (见 PeakAccForDistance)
  *   5. 返回总时间
+ *   *piIterations 累加情形 4 的 Newton 迭代次数 (其余情形为闭式解, 不迭代)
  */
 static double CalculateOptimalTimeSegments(const stPlannerInput* pInput,
-                                           double* pdTd, double* pdTj, double* pdTa, double* pdTv, int* pErrorFlag) {
+                                           double* pdTd, double* pdTj, double* pdTa, double* pdTv,
+                                           int* piIterations, int* pErrorFlag) {
     *pErrorFlag = 0;
     double dS = pInput->dDistance;
     double dVmax = pInput->dVMax;
@@ -455,190 +714,324 @@ static double CalculateOptimalTimeSegments(const stPlannerInput* pInput,
 
     if (dS < 1e-12) { *pdTd=0; *pdTj=0; *pdTa=0; *pdTv=0; return 0.0; }
 
-    // 1. 尝试以最大加速度加速到最大速度
-    double dSRampVmax = 0.0, dVRampVmax = 0.0;
-    double tempTd, tempTj, tempTa;
-    // [*** 修正 ***] 使用 Internal 版本
-    CalculateRampKinematicsInternal(dVmax, dAmax, dJmax, dDmax, &tempTd, &tempTj, &tempTa, &dVRampVmax, &dSRampVmax);
-    if (*pErrorFlag || !isfinite(dSRampVmax)) { // 增加对 Ramp 计算失败的检查
-         fprintf(stderr, "ERROR: Initial CalculateRampKinematicsInternal failed.\n");
-         *pErrorFlag = 1; return -1.0;
-    }
-
     const double DIST_TOL = 1e-9;
 
+    // 1. 峰值加速度上限及对应的加速度升/降时间
+    double dACap = fmin(dAmax, PeakAccForVelocity(dVmax, dJmax, dDmax));
+    CalculateJerkPhaseTimes(dACap, dJmax, dDmax, pdTd, pdTj);
+    double dT1 = 2.0 * (*pdTd) + (*pdTj);
+    double dTa = fmax(0.0, dVmax / dACap - dT1);
+    double dSRampVmax = 0.5 * dVmax * (2.0 * dT1 + dTa);
+
     if (2.0 * dSRampVmax <= dS + DIST_TOL) {
-        // 2a. 距离足够长，有匀速段
-        *pdTd = tempTd; *pdTj = tempTj; *pdTa = tempTa;
-        *pdTv = (dVmax > 1e-12) ? fmax(0.0, (dS - 2.0 * dSRampVmax) / dVmax) : 0.0;
+        // 2. 距离足够长，有匀速段
+        *pdTa = dTa;
+        *pdTv = fmax(0.0, (dS - 2.0 * dSRampVmax) / dVmax);
+    } else if (2.0 * dACap * dT1 * dT1 <= dS) {
+        // 3. 达到峰值加速度但达不到最大速度: (T1 + Ta)(2*T1 + Ta) = S / A, 取非负根 (有理化避免相消)
+        double dQ = dT1 * dT1 + 4.0 * dS / dACap;
+        *pdTa = fmax(0.0, 2.0 * (dS / dACap - 2.0 * dT1 * dT1) / (sqrt(dQ) + 3.0 * dT1));
+        *pdTv = 0.0;
     } else {
-        // 2b. 距离不够，无匀速段 (三角波)，二分搜索峰值加速度 a_peak
-        *pdTv = 0.0; *pdTa = 0.0;
-
-        double dALow = 0.0, dAHigh = dAmax;
-        double dBestAGuess = 0.0;
-        double dMinSError = 1e300;
-        double dTd_best=0, dTj_best=0;
-        int iter;
-        int foundValidSolution = 0;
-
-        for (iter = 0; iter < 100; ++iter) {
-            double dAGuess = 0.5 * (dALow + dAHigh);
-            // [*** 修正 ***] 避免 A 为 0 或负数
-            if (dAGuess <= 1e-15) {
-                 // 如果下限已为0，且上限也接近0，可能无解或 dS 极小
-                 if (dALow < 1e-14 && dAHigh < 1e-12) break;
-                 dAGuess = 1e-15; // 尝试一个极小正数
-            }
+        // 4. 峰值加速度也达不到 (无 Ta 段)
+        double dAPeak = PeakAccForDistance(0.5 * dS, dJmax, dDmax, dACap, piIterations);
+        CalculateJerkPhaseTimes(dAPeak, dJmax, dDmax, pdTd, pdTj);
+        *pdTa = 0.0;
+        *pdTv = 0.0;
+    }
 
-            double dSGuess = 0.0;
-            double currentTd, currentTj;
-            int rampError = 0;
-            CalculateRampKinematicsForSearch(dAGuess, dJmax, dDmax, &currentTd, &currentTj, &dSGuess, &rampError);
+    if (!isfinite(*pdTd) || !isfinite(*pdTj) || !isfinite(*pdTa) || !isfinite(*pdTv)) {
+        fprintf(stderr, "ERROR: CalculateOptimalTimeSegments produced invalid segments (dS=%.3e).\n", dS);
+        *pErrorFlag = 1; return -1.0;
+    }
 
-            if (rampError || !isfinite(dSGuess)) {
-                 if ((dAHigh - dALow) < 1e-9 * dAmax) break;
-                 // 如果计算失败，通常意味着 A 太小，增大下限
-                 dALow = dAGuess;
-                 continue;
-            }
+    // 5. 返回总时间
+    double finalTotalTime = 2.0 * (4.0 * (*pdTd) + 2.0 * (*pdTj) + (*pdTa)) + (*pdTv);
+    return fmax(0.0, finalTotalTime);
+}
 
-            double currentSError = 2.0 * dSGuess - dS;
 
-            if (fabs(currentSError) < dMinSError) {
-                dMinSError = fabs(currentSError);
-                dBestAGuess = dAGuess;
-                dTd_best = currentTd; dTj_best = currentTj;
-                foundValidSolution = 1;
-            }
+/**
+ * @brief 最优时间分段及时间限制下的缩放 (InitInto 步骤 3~5 的时间部分)
+ * @details
+ *   1. 无时间限制的最优时间分段 (CalculateOptimalTimeSegments)
+ *   2. 有时间限制且与最优时间不同时: 速度/加速度/Jerk/Snap 约束分别按 alpha 的 1/2/3/4 次幂缩放,
+ *      等价于把时间轴压缩 alpha 倍, 最优时间严格满足 T(alpha) = T_opt / alpha, 故 alpha = T_opt / T_limit, 无需迭代;
+ *      零位移时保持原约束, 以零速停留到限制时间
+ *   3. 匀速时间按 总时长 - 2 * 加减速段时长 给出 (与 PrecomputeProfile 的修正一致, InitInto 中会被其覆盖)
+ */
+static int SolveTimeSegments(const stPlannerInput *pstInput, stPlannerTimes *pTimes) {
+    const double TIME_TOLERANCE = 1e-9;
+    int errorFlag = 0;
 
-            if (currentSError > 0) { dAHigh = dAGuess; } else { dALow = dAGuess; }
-            if (fabs(currentSError) < DIST_TOL || (dAHigh - dALow) < 1e-9 * fmax(1.0, dAHigh)) { break; }
-        }
+    memset(pTimes, 0, sizeof(*pTimes));
+    pTimes->dAlphaScaleFactor = 1.0;
+    double dOptimalTime = CalculateOptimalTimeSegments(pstInput, &pTimes->dTd, &pTimes->dTj, &pTimes->dTa, &pTimes->dTv,
+                                                       &pTimes->iSolverIterations, &errorFlag);
+    if (errorFlag) { fprintf(stderr, "ERROR: Failed to calculate optimal time.\n"); return -1; }
+    pTimes->dTotalTime = dOptimalTime;
 
-        if (!foundValidSolution) {
-            fprintf(stderr, "ERROR: Binary search for a_peak failed to find any valid solution (dS=%.3e).\n", dS);
-            *pErrorFlag = 1; return -1.0;
-        }
-        if (dMinSError > 1e-6) {
-             fprintf(stderr, "Warning: Binary search for a_peak finished with MinSError = %.3e > 1e-6.\n", dMinSError);
-             if (iter >= 99) { fprintf(stderr, "         Max iterations reached.\n"); }
+    double dTimeLimit = pstInput->dTimeLimit;
+    if (dTimeLimit > 0 && fabs(dTimeLimit - dOptimalTime) > TIME_TOLERANCE) {
+        pTimes->bIsTimeScaled = 1;
+        pTimes->dTotalTime = dTimeLimit;
+        if (dOptimalTime > 0.0) {
+            stPlannerInput stScaledInput;
+            pTimes->dAlphaScaleFactor = dOptimalTime / dTimeLimit;
+            ScalePlannerInput(pstInput, pTimes->dAlphaScaleFactor, &stScaledInput);
+            CalculateOptimalTimeSegments(&stScaledInput, &pTimes->dTd, &pTimes->dTj, &pTimes->dTa, &pTimes->dTv,
+                                         &pTimes->iSolverIterations, &errorFlag);
+            if (errorFlag) { fprintf(stderr, "ERROR: Failed to calculate scaled time segments.\n"); return -1; }
         }
-
-        *pdTd = dTd_best; *pdTj = dTj_best; *pdTa = 0.0;
-        *pdTv = 0.0;
     }
+    double dTe = 4.0 * pTimes->dTd + 2.0 * pTimes->dTj + pTimes->dTa;
+    pTimes->dTv = (pTimes->dTotalTime - dTe < dTe - 1e-9) ? 0.0 : fmax(0.0, pTimes->dTotalTime - 2.0 * dTe);
+    return 0;
+}
 
-    // 3. 返回总时间
-    double finalTotalTime = 2.0 * (4.0 * (*pdTd) + 2.0 * (*pdTj) + (*pdTa)) + (*pdTv);
-    return fmax(0.0, finalTotalTime);
+/**
+ * @brief 内部辅助函数：给定峰值加速度 A，计算 Td (Snap 作用段) 与 Tj (Jerk 保持 JMax 段)
+ * @details
+ *   加速度升到 A 的过程中 A = DMax * Td * (Td + Tj)。
+ *   A >= JMax^2/DMax 时 Jerk 能达到 JMax：Td = JMax/DMax，Tj = (A - JMax^2/DMax) / JMax；
+ *   否则 Jerk 达不到 JMax：Td = sqrt(A/DMax)，Tj = 0。
+ */
+static void CalculateJerkPhaseTimes(double dA, double dJMax, double dDMax, double *pdTd, double *pdTj) {
+    double dACrit = dJMax * dJMax / dDMax;
+    if (dA >= dACrit) {
+        *pdTd = dJMax / dDMax;
+        *pdTj = (dA - dACrit) / dJMax;
+    } else {
+        *pdTd = sqrt(fmax(0.0, dA / dDMax));
+        *pdTj = 0.0;
+    }
 }
 
+/**
+ * @brief 内部辅助函数：求 Ta=0 时加速段恰好达到速度 V 的峰值加速度
+ * @details
+ *   V = A * T1(A)：
+ *   - Jerk 达不到 JMax：V = 2 * A^1.5 / sqrt(DMax)，A = (V * sqrt(DMax) / 2)^(2/3)
+ *   - Jerk 达到 JMax：V = A^2/JMax + A*JMax/DMax，取正根
+ *   两式在 A = JMax^2/DMax (V = 2*JMax^3/DMax^2) 处衔接。
+ */
+static double PeakAccForVelocity(double dV, double dJMax, double dDMax) {
+    double dC = dJMax / dDMax;
+    if (dV <= 2.0 * dJMax * dC * dC) {
+        double dX = 0.5 * dV * sqrt(dDMax);
+        return cbrt(dX * dX);
+    }
+    return 2.0 * dV / (dC + sqrt(dC * dC + 4.0 * dV / dJMax));
+}
 
 /**
- * @brief 内部辅助函数：计算三角波加速段的 Td, Tj 和位移 S_ramp
+ * @brief 内部辅助函数：求 Ta=0 时加速段位移恰为 dHalfS 的峰值加速度 (dHalfS < S_ramp(dACap))
  * @details
- *   适用于无 Ta 阶段的短行程加速段（峰值加速度 a_peak < AMax）
- *   通过给定 a_peak 计算所需 Td、Tj 和位移
+ *   S_ramp(A) = V * Te / 2 = A * T1(A)^2：
+ *   - Jerk 达不到 JMax：T1 = 2*sqrt(A/DMax)，S_ramp = 4*A^2/DMax，直接开方
+ *   - Jerk 达到 JMax：T1 = JMax/DMax + A/JMax，S_ramp = A*(JMax/DMax + A/JMax)^2 关于 A 单调递增且下凸，
+ *     从右端 dACap 出发的 Newton 迭代单调收敛，不会越过根；迭代值仍夹在 [JMax^2/DMax, dACap] 内作保护。
  */
-static void CalculateRampKinematicsForSearch(double dTargetA, double dJMax, double dDMax,
-                                             double *pdTd, double *pdTj, double *pdS_ramp, int* pErrorFlag) {
-    *pErrorFlag = 0;
-    const double EPS = 1e-12;
-    *pdTd = 0.0; *pdTj = 0.0; *pdS_ramp = 0.0;
+static double PeakAccForDistance(double dHalfS, double dJMax, double dDMax, double dACap, int *piIterations) {
+    double dC = dJMax / dDMax;
+    double dACrit = dC * dJMax;
+    if (dHalfS <= 4.0 * dACrit * dACrit / dDMax || dACap <= dACrit) {
+        return fmin(dACap, 0.5 * sqrt(dDMax * dHalfS));
+    }
 
-    if (dTargetA <= EPS) { return; }
-    dJMax = fmax(EPS, dJMax); dDMax = fmax(EPS, dDMax);
+    double dA = dACap;
+    for (int i = 0; i < 60; ++i) {
+        double dU = dC + dA / dJMax;
+        double dF = dA * dU * dU - dHalfS;
+        double dDF = dU * (dC + 3.0 * dA / dJMax);
+        double dNext = dA - dF / dDF;
+        (*piIterations)++;
+        if (dNext < dACrit) dNext = dACrit;
+        if (dNext > dACap) dNext = dACap;
+        if (fabs(dNext - dA) <= 1e-15 * dA) { dA = dNext; break; }
+        dA = dNext;
+    }
+    return dA;
+}
 
-    // 1. 计算 Td 和 Tj (假定 Ta=0)
-    double TjCrit = dJMax / dDMax; double ACrit = TjCrit * dJMax;
-    if (dTargetA >= ACrit - EPS) {
-        *pdTd = TjCrit; *pdTj = (dJMax > EPS) ? fmax(0.0, (dTargetA - ACrit) / dJMax) : 0.0;
+/**
+ * @brief 内部辅助函数：由边界时长预计算边界时间点、边界状态与多项式表 (InitInto / InitEx 共用)
+ * @details
+ *   调用前须设置 dTotalTime、起止速度与起点/方向。加速段从起点速度开始, 减速段从匀速段末开始,
+ *   两段各自的 7 个子阶段时长分别由 pdDurAcc / pdDurDec 给出 (段长 dTeAcc / dTeDec);
+ *   边界状态按位移大小 (正向) 计算, 终点须在 1e-6 以内到达位移大小与终点速度。
+ */
+static int PrecomputeProfile(stPlannerContext *pContext, const double *pdDurAcc, double dTeAcc,
+                             const double *pdDurDec, double dTeDec, double dSnap) {
+    // ===== 步骤 6~7: 预计算边界时间点 =====
+    pContext->adAccSegBorders[0] = 0.0;
+    for (int i = 0; i < 7; ++i) {
+        pContext->adAccSegBorders[i + 1] = pContext->adAccSegBorders[i] + pdDurAcc[i];
+    }
+    pContext->dConstVelStartTime = dTeAcc;
+    pContext->dDecelStartTime = pContext->dTotalTime - dTeDec;
+    if (pContext->dDecelStartTime < pContext->dConstVelStartTime - 1e-9) {
+         pContext->dDecelStartTime = pContext->dConstVelStartTime;
+         pContext->dTv = 0.0;
     } else {
-        *pdTd = sqrt(fmax(0.0, dTargetA / dDMax)); *pdTj = 0.0;
+         pContext->dTv = fmax(0.0, pContext->dDecelStartTime - pContext->dConstVelStartTime);
+    }
+    double dDecOffset = 0.0;
+    pContext->adDecSegBorders[0] = pContext->dDecelStartTime;
+    for (int i = 0; i < 7; ++i) {
+        dDecOffset += pdDurDec[i];
+        pContext->adDecSegBorders[i + 1] = pContext->dDecelStartTime + dDecOffset;
     }
-    double dTa = 0.0; // 强制 Ta=0
 
-    *pdTd = fmax(0.0, *pdTd); *pdTj = fmax(0.0, *pdTj);
-     if (*pdTd < EPS && *pdTj < EPS) { return; }
+    // ===== 步骤 8: 预计算所有边界点的状态 =====
+    double dX_acc = 0.0, dV_acc = pContext->dStartVel, dA_acc = 0.0, dJ_acc = 0.0;
+    // 加速段 Snap 序列：正向变化
+    double adSnapAcc[7] = { dSnap, 0, -dSnap, 0, -dSnap, 0, dSnap };
+
+    // 初始化加速段第0个边界点（起始点）
+    pContext->stAccStateAtBorder[0] = (stSegmentBoundaryState){0.0, dV_acc, 0.0, 0.0};
+    for (int i = 0; i < 7; ++i) {
+        double dDt = pdDurAcc[i]; double dSn = adSnapAcc[i];
+        if (dDt < 1e-12) { pContext->stAccStateAtBorder[i+1] = pContext->stAccStateAtBorder[i]; continue; }
+        double dt2=dDt*dDt, dt3=dt2*dDt, dt4=dt2*dt2;
+        // 四阶多项式积分更新位置、速度、加速度、Jerk
+        dX_acc += dV_acc * dDt + 0.5 * dA_acc * dt2 + (1.0/6.0) * dJ_acc * dt3 + (1.0/24.0) * dSn * dt4;
+        dV_acc += dA_acc * dDt + 0.5 * dJ_acc * dt2 + (1.0/6.0) * dSn * dt3;
+        dA_acc += dJ_acc * dDt + 0.5 * dSn * dt2;
+        dJ_acc += dSn * dDt;
+         if (!isfinite(dX_acc) || !isfinite(dV_acc) || !isfinite(dA_acc) || !isfinite(dJ_acc)) {
+            fprintf(stderr, "ERROR: Invalid state during acceleration precomputation at segment %d\n", i);
+            return -1;
+        }
+        pContext->stAccStateAtBorder[i+1] = (stSegmentBoundaryState){dX_acc, dV_acc, dA_acc, dJ_acc};
+    }
 
-    // 2. 积分计算加速段的位移 S_ramp
-    double dX0 = 0.0, dV0 = 0.0, dA0 = 0.0, dJ0 = 0.0;
-    double adDur[7] = { *pdTd, *pdTj, *pdTd, dTa, *pdTd, *pdTj, *pdTd }; // dTa = 0
-    double adD[7] = { dDMax, 0.0, -dDMax, 0.0, -dDMax, 0.0, dDMax };
+    // 匀速段结束状态 = 加速段结束状态 + 匀速段位移
+    pContext->stConstVelEndState = pContext->stAccStateAtBorder[7];
+    pContext->stConstVelEndState.dPos += pContext->stAccStateAtBorder[7].dVel * pContext->dTv;
 
+    // 减速段状态计算（从匀速段结束点开始）
+    double dX_dec = pContext->stConstVelEndState.dPos;
+    double dV_dec = pContext->stConstVelEndState.dVel;
+    double dA_dec = 0.0; double dJ_dec = 0.0;
+    // 减速段 Snap 序列：反向变化
+    double adSnapDec[7] = { -dSnap, 0, dSnap, 0, dSnap, 0, -dSnap };
+    pContext->stDecStateAtBorder[0] = pContext->stConstVelEndState;
     for (int i = 0; i < 7; ++i) {
-        double dDt = adDur[i]; if (dDt < EPS) continue;
-        double dSnap = adD[i];
-        double dt2 = dDt*dDt, dt3 = dDt*dt2, dt4 = dt2*dt2;
-        dX0 += dV0 * dDt + 0.5 * dA0 * dt2 + (1.0/6.0) * dJ0 * dt3 + (1.0/24.0) * dSnap * dt4;
-        dV0 += dA0 * dDt + 0.5 * dJ0 * dt2 + (1.0/6.0) * dSnap * dt3;
-        dA0 += dJ0 * dDt + 0.5 * dSnap * dt2;
-        dJ0 += dSnap * dDt;
-
-        if (!isfinite(dX0) || !isfinite(dV0) || !isfinite(dA0) || !isfinite(dJ0)) {
-             fprintf(stderr, "ERROR: Invalid state in CalculateRampKinematicsForSearch at seg %d (A=%.3e)\n", i, dTargetA);
-             *pErrorFlag = 1; *pdS_ramp = NAN; return;
+        double dDt = pdDurDec[i]; double dSn = adSnapDec[i];
+         if (dDt < 1e-12) { pContext->stDecStateAtBorder[i+1] = pContext->stDecStateAtBorder[i]; continue; }
+        double dt2=dDt*dDt, dt3=dt2*dDt, dt4=dt2*dt2;
+        dX_dec += dV_dec * dDt + 0.5 * dA_dec * dt2 + (1.0/6.0) * dJ_dec * dt3 + (1.0/24.0) * dSn * dt4;
+        dV_dec += dA_dec * dDt + 0.5 * dJ_dec * dt2 + (1.0/6.0) * dSn * dt3;
+        dA_dec += dJ_dec * dDt + 0.5 * dSn * dt2;
+        dJ_dec += dSn * dDt;
+        if (!isfinite(dX_dec) || !isfinite(dV_dec) || !isfinite(dA_dec) || !isfinite(dJ_dec)) {
+            fprintf(stderr, "ERROR: Invalid state during deceleration precomputation at segment %d\n", i);
+            return -1;
         }
+        pContext->stDecStateAtBorder[i+1] = (stSegmentBoundaryState){dX_dec, dV_dec, dA_dec, dJ_dec};
     }
-    *pdS_ramp = dX0;
-}
 
+     // 验证最终位置与速度是否满足要求
+     double dTarget = fabs(pContext->stInput.dDistance);
+     double finalPosError = fabs(pContext->stDecStateAtBorder[7].dPos - dTarget);
+     double finalVelError = fabs(pContext->stDecStateAtBorder[7].dVel - pContext->dEndVel);
+     if (finalPosError > 1e-6 || finalVelError > 1e-6) {
+         fprintf(stderr, "ERROR: Init - Precalculated final state deviates significantly.\n");
+         fprintf(stderr, "       Final Pos: %.9f (Target: %.9f, Error: %.3e)\n", pContext->stDecStateAtBorder[7].dPos, dTarget, finalPosError);
+         fprintf(stderr, "       Final Vel: %.9f (Error: %.3e)\n", pContext->stDecStateAtBorder[7].dVel, finalVelError);
+          return -1;
+     }
+
+    // ===== 步骤 9: 生成子阶段多项式表 =====
+    BuildSegmentTable(pContext, adSnapAcc, adSnapDec);
+    return 0;
+}
 
 /**
- * @brief 内部辅助函数：计算给定 TargetV/A 的加速段运动学参数 (增加保护)
+ * @brief 内部辅助函数：速度由 dV0 变为 dV1 的最短时间分段, 返回段长 Te
  * @details
- *   给定目标速度 V 和目标加速度 A，计算：
- *   - Td, Tj, Ta
- *   - 最终速度（应等于 V）
- *   - 加速段总位移 S_ramp
- */
-static void CalculateRampKinematicsInternal(double dTargetV, double dTargetA,
-                                            double dJMax, double dDMax,
-                                            double *pdTd, double *pdTj, double *pdTa,
-                                            double *pdFinalV, double *pdFinalS) {
-    const double EPS = 1e-12;
-    *pdTd = 0.0; *pdTj = 0.0; *pdTa = 0.0; *pdFinalV = 0.0; *pdFinalS = 0.0;
+ *   与 CalculateOptimalTimeSegments 的加速段相同: 峰值加速度取 min(AMax, 恰好以 Ta=0 完成速度变化的加速度),
+ *   |dV1 - dV0| = A * (T1 + Ta)。加速与减速的时间分段相同, 仅 Snap 符号相反。
+ */
+static double RampTimeSegments(double dV0, double dV1, const stPlannerInput *pInput, double *pdTd, double *pdTj, double *pdTa) {
+    double dDeltaV = fabs(dV1 - dV0);
+    if (dDeltaV < 1e-15) { *pdTd = 0.0; *pdTj = 0.0; *pdTa = 0.0; return 0.0; }
+    double dA = fmin(pInput->dAMax, PeakAccForVelocity(dDeltaV, pInput->dJMax, pInput->dDMax));
+    CalculateJerkPhaseTimes(dA, pInput->dJMax, pInput->dDMax, pdTd, pdTj);
+    double dT1 = 2.0 * (*pdTd) + (*pdTj);
+    *pdTa = fmax(0.0, dDeltaV / dA - dT1);
+    return 2.0 * dT1 + (*pdTa);
+}
 
-    if (dTargetA <= EPS || dTargetV < -EPS) { return; }
-    dJMax = fmax(EPS, dJMax); dDMax = fmax(EPS, dDMax);
+/**
+ * @brief 内部辅助函数：速度变化段的位移 (加速度曲线关于段中点对称, S = (v0 + v1) / 2 * Te)
+ * @details 固定一端速度时关于另一端速度单调递增; 关于两端速度对称。
+ */
+static double RampDistance(double dV0, double dV1, const stPlannerInput *pInput) {
+    double dTd, dTj, dTa;
+    return 0.5 * (dV0 + dV1) * RampTimeSegments(dV0, dV1, pInput, &dTd, &dTj, &dTa);
+}
 
-    // 1. 计算Td和Tj
-    double TjCrit = dJMax / dDMax; double ACrit = TjCrit * dJMax;
-    if (dTargetA >= ACrit - EPS) {
-        *pdTd = TjCrit; *pdTj = (dJMax > EPS) ? fmax(0.0, (dTargetA - ACrit) / dJMax) : 0.0;
-    } else {
-        *pdTd = sqrt(fmax(0.0, dTargetA / dDMax)); *pdTj = 0.0;
+/**
+ * @brief 内部辅助函数：求衔接段的峰值速度与匀速时间
+ * @details
+ *   总位移 f(vp) = S_ramp(v0, vp) + S_ramp(vp, v1) 在 [max(v0, v1), VMax] 上单调递增:
+ *   1. f(max(v0, v1)) 即 v0 直接变到 v1 的位移, 超过 dS 时无解 (前瞻应保证不出现)
+ *   2. f(VMax) <= dS 时以 VMax 匀速走完剩余位移
+ *   3. 否则二分求 f(vp) <= dS 的最大 vp (至相对 1e-14), 剩余的极小位移以 vp 匀速补足, 终点位置精确
+ *   *piIterations 累加二分次数
+ */
+static int SolvePeakVelocity(const stPlannerInput *pInput, double dS, double dV0, double dV1,
+                             double *pdVPeak, double *pdTv, int *piIterations) {
+    const double DIST_TOL = 1e-9;
+    double dLow = fmax(dV0, dV1), dHigh = pInput->dVMax;
+    double dSLow = RampDistance(dV0, dV1, pInput);
+    if (dSLow > dS + DIST_TOL) {
+        return -1;
     }
-
-    // 2. 计算Ta
-    double vel_jerk_phases = dTargetA * (2.0 * (*pdTd) + (*pdTj));
-    if (dTargetV >= vel_jerk_phases - EPS) {
-        *pdTa = (dTargetA > EPS) ? fmax(0.0, (dTargetV - vel_jerk_phases) / dTargetA) : 0.0;
+    double dSHigh = RampDistance(dV0, dHigh, pInput) + RampDistance(dHigh, dV1, pInput);
+    if (dSHigh <= dS) {
+        dLow = dHigh;
+        dSLow = dSHigh;
     } else {
-        *pdTa = 0.0;
+        for (int i = 0; i < 100 && dHigh - dLow > 1e-14 * dHigh; ++i) {
+            double dMid = 0.5 * (dLow + dHigh);
+            double dSMid = RampDistance(dV0, dMid, pInput) + RampDistance(dMid, dV1, pInput);
+            (*piIterations)++;
+            if (dSMid <= dS) { dLow = dMid; dSLow = dSMid; }
+            else dHigh = dMid;
+        }
     }
+    *pdVPeak = dLow;
+    *pdTv = (dLow > 0.0) ? fmax(0.0, dS - dSLow) / dLow : 0.0;
+    return 0;
+}
 
-    *pdTd = fmax(0.0, *pdTd); *pdTj = fmax(0.0, *pdTj); *pdTa = fmax(0.0, *pdTa);
-     if (*pdTd < EPS && *pdTj < EPS && *pdTa < EPS) { return; }
-
-    // 3. 积分计算加速段的终点状态
-    double dX0 = 0.0, dV0 = 0.0, dA0 = 0.0, dJ0 = 0.0;
-    double adDur[7] = { *pdTd, *pdTj, *pdTd, *pdTa, *pdTd, *pdTj, *pdTd };
-    double adD[7] = { dDMax, 0.0, -dDMax, 0.0, -dDMax, 0.0, dDMax };
+/**
+ * @brief 内部辅助函数：第 llIndex 个采样点的段内时刻
+ */
+static double SampleTime(const stPlannerContext *pContext, long long llIndex) {
+    return (double)llIndex * pContext->stInput.dSampleTime + pContext->dTimeOffset;
+}
 
-    for (int i = 0; i < 7; ++i) {
-        double dDt = adDur[i]; if (dDt < EPS) continue;
-        double dSnap = adD[i];
-        double dt2 = dDt*dDt, dt3 = dDt*dt2, dt4 = dt2*dt2;
-        dX0 += dV0 * dDt + 0.5 * dA0 * dt2 + (1.0/6.0) * dJ0 * dt3 + (1.0/24.0) * dSnap * dt4;
-        dV0 += dA0 * dDt + 0.5 * dJ0 * dt2 + (1.0/6.0) * dSnap * dt3;
-        dA0 += dJ0 * dDt + 0.5 * dSnap * dt2;
-        dJ0 += dSnap * dDt;
-        if (!isfinite(dX0) || !isfinite(dV0) || !isfinite(dA0) || !isfinite(dJ0)) {
-            *pdFinalV = NAN; *pdFinalS = NAN; return; // 标记为无效
-        }
+/**
+ * @brief 内部辅助函数：单调时钟 [us], 用于记录 Init 耗时
+ */
+static double PlannerNowUs(void) {
+#ifdef _WIN32
+    static double s_dTicksToUs = 0.0;
+    LARGE_INTEGER liNow;
+    if (s_dTicksToUs == 0.0) {
+        LARGE_INTEGER liFreq;
+        QueryPerformanceFrequency(&liFreq);
+        s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
     }
-    *pdFinalV = dV0;
-    *pdFinalS = dX0;
-}
\ No newline at end of file
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+#else
+    struct timespec stNow;
+    timespec_get(&stNow, TIME_UTC);
+    return (double)stNow.tv_sec * 1.0e6 + (double)stNow.tv_nsec * 1.0e-3;
+#endif
+}
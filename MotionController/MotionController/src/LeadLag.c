@@ -0,0 +1,14 @@
+#include "LeadLag.h"
+
+#define CONST_PI 3.14159265358979323846
+
+// 双线性变换离散化超前/滞后环节 (一阶, b2 = a2 = 0)
+void LeadLagDesignSos(double dZeroFreq, double dPoleFreq, double sample_time, stSosSection* pSection)
+{
+    double dKz = 2.0 / (2.0 * CONST_PI * dZeroFreq * sample_time);  // 2/(wz*T)
+    double dKp = 2.0 / (2.0 * CONST_PI * dPoleFreq * sample_time);  // 2/(wp*T)
+
+    SosSectionSetCoeffs(pSection,
+                        1.0 + dKz, 1.0 - dKz, 0.0,
+                        1.0 + dKp, 1.0 - dKp, 0.0);
+}
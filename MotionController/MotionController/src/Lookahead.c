@@ -0,0 +1,145 @@
+#include "Lookahead.h"
+#include <math.h>
+#include <string.h>
+
+// 窗口内第 i 个未提交目标点 (0 为最早)
+static const stLookaheadTarget* LookaheadAt(const stLookahead* pLookahead, int i) {
+    return &pLookahead->astTarget[(pLookahead->iHead + i) % LOOKAHEAD_WINDOW];
+}
+
+static stLookaheadTarget* LookaheadAtMutable(stLookahead* pLookahead, int i) {
+    return &pLookahead->astTarget[(pLookahead->iHead + i) % LOOKAHEAD_WINDOW];
+}
+
+// 第 i 个目标点之前的位置 (第 0 个为已提交轨迹的终点)
+static double LookaheadPrevPos(const stLookahead* pLookahead, int i) {
+    return (i == 0) ? pLookahead->dPos : LookaheadAt(pLookahead, i - 1)->dTarget;
+}
+
+// 由第 i+1 个目标点的可行速度上限求第 i 个目标点的上限:
+// 可行速度集为 [0, 上限]: 不超过下一点上限的速度可匀速通过下一段, 更高的速度须在下一段内减速到
+// [0, 下一点上限] 中的某个速度 (位移关于速度变化量为凹, 最省位移的终点在区间端点)
+static double LookaheadJunctionVel(const stLookahead* pLookahead, int i) {
+    const stLookaheadTarget* pCur = LookaheadAt(pLookahead, i);
+    const stLookaheadTarget* pNext = LookaheadAt(pLookahead, i + 1);
+    double dIn = pCur->dTarget - LookaheadPrevPos(pLookahead, i);
+    double dOut = pNext->dTarget - pCur->dTarget;
+    if ((dIn > 0.0) != (dOut > 0.0)) {
+        return 0.0;     // 反向点停止
+    }
+    stPlannerInput stSegment = pNext->stLimits;
+    stSegment.dDistance = dOut;
+    double dReach = fmax(FourthOrderPlannerMaxEndVelocity(&stSegment, pNext->dMaxVel, stSegment.dVMax),
+                         FourthOrderPlannerMaxEndVelocity(&stSegment, 0.0, stSegment.dVMax));
+    return fmin(fmin(pCur->stLimits.dVMax, pNext->stLimits.dVMax), dReach);
+}
+
+// 从 dStartPos 静止开始新的目标序列, 丢弃未提交的目标点
+void LookaheadReset(stLookahead* pLookahead, double dStartPos) {
+    memset(pLookahead, 0, sizeof(*pLookahead));
+    pLookahead->dPos = dStartPos;
+}
+
+// 追加目标点: 成功返回 0; 与上一目标点重合时忽略并返回 1; 窗口满或参数无效返回 -1
+int LookaheadPush(stLookahead* pLookahead, double dTarget, const stPlannerInput* pstLimits) {
+    if (pLookahead->iCount >= LOOKAHEAD_WINDOW || !isfinite(dTarget) ||
+        pstLimits->dVMax <= 0.0 || pstLimits->dAMax <= 0.0 || pstLimits->dJMax <= 0.0 ||
+        pstLimits->dDMax <= 0.0 || pstLimits->dSampleTime <= 0.0) {
+        return -1;
+    }
+    if (pLookahead->dSampleTime > 0.0 && pstLimits->dSampleTime != pLookahead->dSampleTime) {
+        return -1;
+    }
+    if (dTarget == LookaheadPrevPos(pLookahead, pLookahead->iCount)) {
+        return 1;
+    }
+
+    stLookaheadTarget* pTarget = LookaheadAtMutable(pLookahead, pLookahead->iCount);
+    pTarget->dTarget = dTarget;
+    pTarget->stLimits = *pstLimits;
+    pTarget->stLimits.dDistance = 0.0;
+    pTarget->stLimits.dTimeLimit = 0.0;
+    pTarget->dMaxVel = 0.0;     // 窗口最后一个目标点停止
+    pLookahead->dSampleTime = pstLimits->dSampleTime;
+    pLookahead->iCount++;
+
+    // 反向传播, 某点上限不变时更早的点也不变
+    for (int i = pLookahead->iCount - 2; i >= 0; i--) {
+        stLookaheadTarget* pCur = LookaheadAtMutable(pLookahead, i);
+        double dMaxVel = LookaheadJunctionVel(pLookahead, i);
+        if (dMaxVel == pCur->dMaxVel) {
+            break;
+        }
+        pCur->dMaxVel = dMaxVel;
+    }
+    return 0;
+}
+
+// 未提交目标点数
+int LookaheadCount(const stLookahead* pLookahead) {
+    return pLookahead->iCount;
+}
+
+// 规划并提交窗口首段到 pContext: 成功返回 0; 窗口为空返回 1; 规划失败返回 -1 (状态不变)
+int LookaheadCommit(stLookahead* pLookahead, stPlannerContext* pContext) {
+    if (pLookahead->iCount == 0) {
+        return 1;
+    }
+
+    // 首段: 起点为已提交终点, 终点速度取 [0, 上限] 中由起点速度可达的最大值
+    const stLookaheadTarget* pFirst = LookaheadAt(pLookahead, 0);
+    stPlannerInputEx stInputEx;
+    stInputEx.stLimits = pFirst->stLimits;
+    stInputEx.stLimits.dDistance = pFirst->dTarget - pLookahead->dPos;
+    stInputEx.dStartPos = pLookahead->dPos;
+    stInputEx.dStartVel = fmin(fabs(pLookahead->dVel), pFirst->stLimits.dVMax);
+    stInputEx.dEndVel = fmax(0.0, FourthOrderPlannerMaxEndVelocity(&stInputEx.stLimits, stInputEx.dStartVel, pFirst->dMaxVel));
+    stInputEx.dTimeOffset = pLookahead->dTimeOffset;
+    if (FourthOrderPlannerInitEx(&stInputEx, pContext) != 0) {
+        return -1;
+    }
+
+    // 推进已提交终点
+    pLookahead->dPos = pFirst->dTarget;
+    pLookahead->dVel = (stInputEx.stLimits.dDistance < 0.0) ? -stInputEx.dEndVel : stInputEx.dEndVel;
+    pLookahead->dTimeOffset = FourthOrderPlannerGetEndOffset(pContext);
+    pLookahead->dCommittedTime += pContext->dTotalTime;
+    pLookahead->ullSegments++;
+    pLookahead->iHead = (pLookahead->iHead + 1) % LOOKAHEAD_WINDOW;
+    pLookahead->iCount--;
+    return 0;
+}
+
+// 从已提交终点沿原方向以最短位移减速停止 (约束取窗口首个目标点, VMax 不低于当前速度), 丢弃全部未提交目标点
+// 成功返回 0; 已静止或窗口为空返回 1 (无需停止段); 规划失败返回 -1 (状态不变)
+int LookaheadCommitStop(stLookahead* pLookahead, stPlannerContext* pContext) {
+    if (pLookahead->dVel == 0.0 || pLookahead->iCount == 0) {
+        return 1;
+    }
+
+    const double dSpeed = fabs(pLookahead->dVel);
+    stPlannerInputEx stInputEx;
+    stInputEx.stLimits = LookaheadAt(pLookahead, 0)->stLimits;
+    stInputEx.stLimits.dVMax = fmax(stInputEx.stLimits.dVMax, dSpeed);
+    double dStop = FourthOrderPlannerStopDistance(&stInputEx.stLimits, dSpeed);
+    if (dStop < 0.0) {
+        return -1;
+    }
+    stInputEx.stLimits.dDistance = (pLookahead->dVel < 0.0) ? -dStop : dStop;
+    stInputEx.dStartPos = pLookahead->dPos;
+    stInputEx.dStartVel = dSpeed;
+    stInputEx.dEndVel = 0.0;
+    stInputEx.dTimeOffset = pLookahead->dTimeOffset;
+    if (FourthOrderPlannerInitEx(&stInputEx, pContext) != 0) {
+        return -1;
+    }
+
+    pLookahead->dPos += stInputEx.stLimits.dDistance;
+    pLookahead->dVel = 0.0;
+    pLookahead->dTimeOffset = FourthOrderPlannerGetEndOffset(pContext);
+    pLookahead->dCommittedTime += pContext->dTotalTime;
+    pLookahead->ullSegments++;
+    pLookahead->iHead = 0;
+    pLookahead->iCount = 0;
+    return 0;
+}
@@ -61,4 +61,11 @@ void LowPassFilterReset(LowPassFilter* lpf) {
 // 获取滤波器输出
 double LowPassFilterGetOutput(LowPassFilter* lpf) {
     return lpf->dOutPrev[0];
+}
+
+// 生成与 LowPassFilterInit 相同传递函数的二阶节系数
+void LowPassFilterDesignSos(double cutoff_freq, double damping, double sample_time, stSosSection* pSection) {
+    LowPassFilter lpf;
+    LowPassFilterInit(&lpf, cutoff_freq, damping, sample_time);
+    SosSectionSetCoeffs(pSection, lpf.b0, lpf.b1, lpf.b2, lpf.a0, lpf.a1, lpf.a2);
 }
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "MotionQueue.h"
+#include "PlannerPool.h"
+#include <math.h>
+#include <string.h>
+
+// 待规划指令类型
+#define MOTION_QUEUE_BEGIN 0    // dValue: 起点位置
+#define MOTION_QUEUE_TARGET 1   // dValue: 目标位置, stLimits: 本段约束
+#define MOTION_QUEUE_END 2
+#define MOTION_QUEUE_ABORT 3    // 丢弃未提交的目标点并送出结束标记 (已提交段由控制线程丢弃)
+
+// 待规划指令 (控制线程 -> 规划线程)
+typedef struct {
+    int iType;
+    double dValue;
+    stPlannerInput stLimits;
+} stMotionQueueEntry;
+
+// 每轴的运动队列
+typedef struct {
+    stSpscRing stInbox;                                         // 待规划指令
+    stMotionQueueEntry astInbox[MOTION_QUEUE_INBOX_CAPACITY];
+    stSpscRing stReady;                                         // 已规划段 (NULL: 程序结束)
+    stPlannerContext* apReady[MOTION_QUEUE_READY_CAPACITY];
+
+    // 仅规划线程使用
+    stLookahead stLookahead;
+    int bRunning;                   // 1: 已收到 Begin, 尚未送出结束标记
+    int bEnding;                    // 1: 已收到 End (或规划失败), 提交剩余目标点后结束
+    int bHeld;                      // 1: stHeld 已取出但因就绪队列满或上下文池空暂未处理
+    stMotionQueueEntry stHeld;
+    volatile LONG lPlanFailures;
+
+    // 仅控制线程使用
+    stPlannerContext* pActive;      // 正在执行 (或最后执行) 的队列段
+    int bProgram;                   // 1: 程序执行中
+    int bEndRequested;              // 1: 已提交 End, 不再接受目标点
+    int bAborting;                  // 1: 已提交 Abort, Select 丢弃已规划段直到结束标记
+    int bUnderrun;                  // 1: 本次欠载已计数
+    unsigned long long ullTargets;
+    unsigned long long ullSegments;
+    unsigned long long ullUnderruns;
+} stMotionQueueAxis;
+
+static stMotionQueueAxis g_astAxisQueue[MAX_AXIS_COUNT];
+static void (*g_pfnWake)(void) = NULL;
+
+static void MotionQueueWake(void) {
+    if (g_pfnWake != NULL) {
+        g_pfnWake();
+    }
+}
+
+// 提交一条待规划指令 (仅控制线程调用), 队列满返回 -1
+static int MotionQueuePost(stMotionQueueAxis* pQueue, int iType, double dValue, const stPlannerInput* pstLimits) {
+    stMotionQueueEntry stEntry;
+    memset(&stEntry, 0, sizeof(stEntry));
+    stEntry.iType = iType;
+    stEntry.dValue = dValue;
+    if (pstLimits != NULL) {
+        stEntry.stLimits = *pstLimits;
+    }
+    if (SpscRingPush(&pQueue->stInbox, &stEntry) != 0) {
+        return -1;
+    }
+    MotionQueueWake();
+    return 0;
+}
+
+// 初始化全部轴的队列 (须在规划线程启动前调用), pfnWake 用于唤醒规划线程
+void MotionQueueInit(void (*pfnWake)(void)) {
+    memset(g_astAxisQueue, 0, sizeof(g_astAxisQueue));
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        stMotionQueueAxis* pQueue = &g_astAxisQueue[i];
+        SpscRingInit(&pQueue->stInbox, pQueue->astInbox, MOTION_QUEUE_INBOX_CAPACITY, sizeof(stMotionQueueEntry));
+        SpscRingInit(&pQueue->stReady, pQueue->apReady, MOTION_QUEUE_READY_CAPACITY, sizeof(stPlannerContext*));
+    }
+    g_pfnWake = pfnWake;
+}
+
+// 以 dStartPos 开始新程序 (仅控制线程调用): 程序执行中或队列满时返回 -1
+int MotionQueueBegin(int iAxis, double dStartPos) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT || !isfinite(dStartPos)) {
+        return -1;
+    }
+    stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+    if (pQueue->bProgram || MotionQueuePost(pQueue, MOTION_QUEUE_BEGIN, dStartPos, NULL) != 0) {
+        return -1;
+    }
+    pQueue->bProgram = 1;
+    pQueue->bEndRequested = 0;
+    pQueue->bAborting = 0;
+    pQueue->bUnderrun = 0;
+    return 0;
+}
+
+// 追加目标点 (仅控制线程调用): 无程序、已结束、参数无效或队列满时返回 -1
+// 约束在此检查, 规划线程中的 LookaheadPush 不会因参数失败 (与上一目标点重合的点被忽略)
+int MotionQueuePushTarget(int iAxis, double dTarget, const stPlannerInput* pstLimits) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT || !isfinite(dTarget) ||
+        !(pstLimits->dVMax > 0.0) || !(pstLimits->dAMax > 0.0) || !(pstLimits->dJMax > 0.0) ||
+        !(pstLimits->dDMax > 0.0) || !(pstLimits->dSampleTime > 0.0)) {
+        return -1;
+    }
+    stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+    if (!pQueue->bProgram || pQueue->bEndRequested ||
+        MotionQueuePost(pQueue, MOTION_QUEUE_TARGET, dTarget, pstLimits) != 0) {
+        return -1;
+    }
+    pQueue->ullTargets++;
+    return 0;
+}
+
+// 结束程序 (仅控制线程调用): 剩余目标点全部规划, 最后一段在最后一个目标点停止
+int MotionQueueEnd(int iAxis) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return -1;
+    }
+    stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+    if (!pQueue->bProgram || pQueue->bEndRequested ||
+        MotionQueuePost(pQueue, MOTION_QUEUE_END, 0.0, NULL) != 0) {
+        return -1;
+    }
+    pQueue->bEndRequested = 1;
+    return 0;
+}
+
+// 中止程序 (仅控制线程调用, 用于其他轨迹从当前参考接管): 不再执行任何已规划或未规划的段,
+// 之后 MotionQueueSelect 不再切换段, 丢弃并归还已规划段, 收到结束标记后程序结束 (Begin 前须等 IsActive 为 0);
+// 无程序时直接返回 0, 队列满返回 -1 (程序照常执行)
+int MotionQueueAbort(int iAxis) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return -1;
+    }
+    stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+    if (!pQueue->bProgram || pQueue->bAborting) {
+        return 0;
+    }
+    if (MotionQueuePost(pQueue, MOTION_QUEUE_ABORT, 0.0, NULL) != 0) {
+        return -1;
+    }
+    pQueue->bAborting = 1;
+    pQueue->bEndRequested = 1;
+    return 0;
+}
+
+// 程序是否执行中 (仅控制线程调用)
+int MotionQueueIsActive(int iAxis) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return 0;
+    }
+    return g_astAxisQueue[iAxis].bProgram;
+}
+
+// 选择本周期使用的上下文 (仅控制线程在 GetNextPoint 之前调用)
+// 当前为队列段且即将输出终点, 或当前为其他轨迹且已完成时, 切换到下一个已规划段并归还上一段;
+// 下一段未就绪时继续使用当前段 (以非零速度结束时计为欠载)
+stPlannerContext* MotionQueueSelect(int iAxis, stPlannerContext* pCurrent) {
+    stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+
+    if (!pQueue->bProgram) {
+        // 程序结束后最后一段在被其他轨迹替换时归还
+        if (pQueue->pActive != NULL && pQueue->pActive != pCurrent) {
+            PlannerPoolRelease(pQueue->pActive);
+            pQueue->pActive = NULL;
+        }
+        return pCurrent;
+    }
+
+    if (pQueue->bAborting) {
+        // 已中止: 当前上下文由调用者替换, 已规划段直接归还
+        stPlannerContext* pNext;
+        while (SpscRingPop(&pQueue->stReady, &pNext) == 0) {
+            MotionQueueWake();
+            if (pNext == NULL) {
+                pQueue->bProgram = 0;
+                pQueue->bAborting = 0;
+                break;
+            }
+            PlannerPoolRelease(pNext);
+        }
+        return pCurrent;
+    }
+
+    while (pCurrent == NULL ||
+           (pCurrent == pQueue->pActive ? FourthOrderPlannerIsAtEnd(pCurrent) : pCurrent->bIsFinished)) {
+        stPlannerContext* pNext;
+        if (SpscRingPop(&pQueue->stReady, &pNext) != 0) {
+            if (pCurrent != NULL && pCurrent == pQueue->pActive && pCurrent->dEndVel > 0.0 && !pQueue->bUnderrun) {
+                pQueue->bUnderrun = 1;
+                pQueue->ullUnderruns++;
+            }
+            break;
+        }
+        if (pNext == NULL) {
+            pQueue->bProgram = 0;   // 最后一段保留到被替换
+            break;
+        }
+        if (pCurrent != NULL && pCurrent == pQueue->pActive) {
+            FourthOrderPlannerInheritTimeWarp(pNext, pCurrent);    // 进给倍率下衔接处接续轨迹时刻
+        }
+        if (pQueue->pActive != NULL) {
+            PlannerPoolRelease(pQueue->pActive);
+        }
+        pQueue->pActive = pNext;
+        pQueue->bUnderrun = 0;
+        pQueue->ullSegments++;
+        pCurrent = pNext;
+        MotionQueueWake();          // 就绪队列有空位, 规划线程可继续提交
+    }
+    return pCurrent;
+}
+
+// 获取统计信息 (仅控制线程调用)
+void MotionQueueGetStats(int iAxis, stMotionQueueStats* pStats) {
+    memset(pStats, 0, sizeof(*pStats));
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return;
+    }
+    const stMotionQueueAxis* pQueue = &g_astAxisQueue[iAxis];
+    pStats->bActive = pQueue->bProgram;
+    pStats->lReady = SpscRingCount(&pQueue->stReady);
+    pStats->ullTargets = pQueue->ullTargets;
+    pStats->ullSegments = pQueue->ullSegments;
+    pStats->ullUnderruns = pQueue->ullUnderruns;
+    pStats->lPlanFailures = ReadAcquire(&pQueue->lPlanFailures);
+}
+
+// 规划窗口首段并放入就绪队列: 成功返回 0; 就绪队列满或上下文池空返回 1 (稍后重试);
+// 规划失败时改为提交一段减速停止段 (已提交段以非零速度结束时, 避免速度阶跃), 丢弃剩余目标点并结束程序, 返回 -1
+static int MotionQueueCommit(stMotionQueueAxis* pQueue) {
+    if (SpscRingCount(&pQueue->stReady) >= MOTION_QUEUE_READY_CAPACITY) {
+        return 1;
+    }
+    stPlannerContext* pContext = PlannerPoolAcquire();
+    if (pContext == NULL) {
+        return 1;
+    }
+    if (LookaheadCommit(&pQueue->stLookahead, pContext) != 0) {
+        InterlockedIncrement(&pQueue->lPlanFailures);
+        if (LookaheadCommitStop(&pQueue->stLookahead, pContext) == 0) {
+            SpscRingPush(&pQueue->stReady, &pContext);
+        } else {
+            PlannerPoolRelease(pContext);
+        }
+        LookaheadReset(&pQueue->stLookahead, pQueue->stLookahead.dPos);
+        pQueue->bEnding = 1;
+        return -1;
+    }
+    SpscRingPush(&pQueue->stReady, &pContext);
+    return 0;
+}
+
+// 处理一个轴的待规划指令并按需提交, 有进展时返回 1
+static int MotionQueueServiceAxis(stMotionQueueAxis* pQueue) {
+    int bProgress = 0;
+
+    // 1. 取出待规划指令; 窗口满时先提交首段, 无法提交时保留该指令
+    for (;;) {
+        if (!pQueue->bHeld) {
+            if (SpscRingPop(&pQueue->stInbox, &pQueue->stHeld) != 0) {
+                break;
+            }
+            pQueue->bHeld = 1;
+            bProgress = 1;
+        }
+        const stMotionQueueEntry* pEntry = &pQueue->stHeld;
+        if (pEntry->iType == MOTION_QUEUE_BEGIN) {
+            LookaheadReset(&pQueue->stLookahead, pEntry->dValue);
+            pQueue->bRunning = 1;
+            pQueue->bEnding = 0;
+        } else if (pEntry->iType == MOTION_QUEUE_END) {
+            pQueue->bEnding = 1;
+        } else if (pEntry->iType == MOTION_QUEUE_ABORT) {
+            if (pQueue->bRunning) {
+                LookaheadReset(&pQueue->stLookahead, pQueue->stLookahead.dPos);
+                pQueue->bEnding = 1;
+            }
+        } else if (pQueue->bRunning && !pQueue->bEnding) {
+            if (LookaheadCount(&pQueue->stLookahead) >= LOOKAHEAD_WINDOW && MotionQueueCommit(pQueue) > 0) {
+                break;
+            }
+            if (!pQueue->bEnding) {
+                LookaheadPush(&pQueue->stLookahead, pEntry->dValue, &pEntry->stLimits);
+            }
+        }
+        pQueue->bHeld = 0;
+    }
+
+    // 2. 程序结束时提交全部目标点; 执行开始后就绪段不足时不等窗口满即提交
+    while (pQueue->bRunning && LookaheadCount(&pQueue->stLookahead) > 0 &&
+           (pQueue->bEnding || (pQueue->stLookahead.ullSegments > 0 &&
+                                SpscRingCount(&pQueue->stReady) < MOTION_QUEUE_MIN_READY))) {
+        if (MotionQueueCommit(pQueue) > 0) {
+            break;
+        }
+        bProgress = 1;
+    }
+
+    // 3. 全部提交后送出结束标记
+    if (pQueue->bRunning && pQueue->bEnding && LookaheadCount(&pQueue->stLookahead) == 0) {
+        stPlannerContext* pEnd = NULL;
+        if (SpscRingPush(&pQueue->stReady, &pEnd) == 0) {
+            pQueue->bRunning = 0;
+            bProgress = 1;
+        }
+    }
+    return bProgress;
+}
+
+// 处理全部轴的运动队列 (仅规划线程调用), 有进展时返回 1
+int MotionQueueService(void) {
+    int bProgress = 0;
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        bProgress |= MotionQueueServiceAxis(&g_astAxisQueue[i]);
+    }
+    return bProgress;
+}
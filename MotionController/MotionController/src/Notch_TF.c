@@ -67,4 +67,12 @@ void NotchTFReset(SNotchTF* psFilter)
     psFilter->dOutPrev[1] = 0.0;
     psFilter->dInPrev[0] = 0.0;
     psFilter->dInPrev[1] = 0.0;
+}
+
+// 生成与 NotchTFInit 相同传递函数的二阶节系数
+void NotchTFDesignSos(double NotchFreq, double NotchFreqPole, double NotchDampZero, double NotchDampPole, double sample_time, stSosSection* pSection)
+{
+    SNotchTF sFilter;
+    NotchTFInit(&sFilter, NotchFreq, NotchFreqPole, NotchDampZero, NotchDampPole, sample_time);
+    SosSectionSetCoeffs(pSection, sFilter.dB0, sFilter.dB1, sFilter.dB2, sFilter.dA0, sFilter.dA1, sFilter.dA2);
 }
\ No newline at end of file
@@ -0,0 +1,344 @@
+#include "OnlineTrajectory.h"
+#include <math.h>
+#include <string.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#define ONLINE_TRAJ_WINDOW_TOL 1e-9     // 窗口长度取整容差 (恰为整数的比值不多取一个采样)
+#define ONLINE_TRAJ_SOLVE_STEPS 30      // 接管时历史速度斜坡的二分次数 (相对精度约 1e-9)
+
+static double g_dTicksToUs = 0.0;
+
+static double OnlineTrajectoryNowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * g_dTicksToUs;
+}
+
+// 以最大减速度 (每步速度减小 h) 从速度 w 停止所经过的位移: Ts * sum_{i>=1} max(0, w - i*h)
+static double OnlineTrajectoryBrakeDistance(double dSpeed, double dH, double dTs) {
+    if (dSpeed <= dH) {
+        return 0.0;
+    }
+    double dM = ceil(dSpeed / dH) - 1.0;
+    return dTs * (dM * dSpeed - dH * dM * (dM + 1.0) / 2.0);
+}
+
+// 距目标 dDist 时本步可取的最大速度: 以该速度走一步后仍能以最大减速度恰好停在目标
+// 走一步加制动的位移 f(w) = Ts*(m+1)*(w - h*m/2), w 属于 (m*h, (m+1)*h], 取满足 f((m+1)*h) >= dDist 的最小 m
+static double OnlineTrajectoryLandingSpeed(double dDist, double dH, double dTs) {
+    double dQ = dDist / (dTs * dH);
+    double dM = ceil((-3.0 + sqrt(1.0 + 8.0 * dQ)) / 2.0);
+    if (dM < 0.0) {
+        dM = 0.0;
+    }
+    return dDist / (dTs * (dM + 1.0)) + dH * dM / 2.0;
+}
+
+// 跟踪器前进一步 (半隐式: 先更新速度, 再以新速度更新位置)
+static void OnlineTrajectoryTrack(stOnlineTrajectory* pOnline) {
+    const double dTs = pOnline->stLimits.dSampleTime;
+    const double dH = pOnline->stLimits.dAMax * dTs;
+    double dErr = pOnline->dTarget - pOnline->dPos0;
+    double dSign = (dErr < 0.0) ? -1.0 : 1.0;
+    double dDist = fabs(dErr);
+    double dSpeed = dSign * pOnline->dVel0;     // 朝向目标的速度分量
+
+    // 上限: 能落点的速度、加速度、速度上限 (当前已超过上限时以最大减速度回到上限)
+    // 下限: 加速度、反向速度上限; 下限高于上限说明已无法不越过目标, 以最大减速度制动
+    double dUpper = fmin(fmin(OnlineTrajectoryLandingSpeed(dDist, dH, dTs), dSpeed + dH),
+                         fmax(pOnline->dVMax, dSpeed - dH));
+    double dLower = fmax(dSpeed - dH, fmin(-pOnline->dVMax, dSpeed + dH));
+    double dNext = fmax(dUpper, dLower);
+
+    if (dDist <= dNext * dTs && dDist >= dLower * dTs) {
+        // 本步恰好到达目标
+        pOnline->dVel0 = dSign * dDist / dTs;
+        pOnline->dPos0 = pOnline->dTarget;
+        return;
+    }
+    pOnline->dVel0 = dSign * dNext;
+    pOnline->dPos0 += pOnline->dVel0 * dTs;
+}
+
+// 检查约束并求两级窗口长度, 窗口超过 ONLINE_TRAJ_MAX_WINDOW 或参数无效时返回 -1
+static int OnlineTrajectoryWindows(const stPlannerInput* pstLimits, int* piLen1, int* piLen2) {
+    if (!(pstLimits->dVMax > 0.0) || !(pstLimits->dAMax > 0.0) || !(pstLimits->dJMax > 0.0) ||
+        !(pstLimits->dDMax > 0.0) || !(pstLimits->dSampleTime > 0.0)) {
+        return -1;
+    }
+    const double dTs = pstLimits->dSampleTime;
+    double dLen1 = ceil(2.0 * pstLimits->dAMax / (pstLimits->dJMax * dTs) - ONLINE_TRAJ_WINDOW_TOL);
+    double dLen2 = ceil(2.0 * pstLimits->dJMax / (pstLimits->dDMax * dTs) - ONLINE_TRAJ_WINDOW_TOL);
+    if (dLen1 > ONLINE_TRAJ_MAX_WINDOW || dLen2 > ONLINE_TRAJ_MAX_WINDOW) {
+        return -1;
+    }
+    *piLen1 = (dLen1 < 1.0) ? 1 : (int)dLen1;
+    *piLen2 = (dLen2 < 1.0) ? 1 : (int)dLen2;
+    return 0;
+}
+
+// 清零状态并写入约束与窗口长度
+static void OnlineTrajectoryReset(stOnlineTrajectory* pOnline, const stPlannerInput* pstLimits, int iLen1, int iLen2) {
+    LARGE_INTEGER liFreq;
+    QueryPerformanceFrequency(&liFreq);
+    g_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+
+    memset(pOnline, 0, sizeof(*pOnline));
+    pOnline->stLimits = *pstLimits;
+    pOnline->stLimits.dDistance = 0.0;
+    pOnline->stLimits.dTimeLimit = 0.0;
+    pOnline->dVMax = pstLimits->dVMax;
+    pOnline->iLen1 = iLen1;
+    pOnline->iLen2 = iLen2;
+}
+
+// 从 dStartPos 静止开始 (窗口内均为起点位置), 窗口超过 ONLINE_TRAJ_MAX_WINDOW 或参数无效时返回 -1
+int OnlineTrajectoryInit(stOnlineTrajectory* pOnline, double dStartPos, const stPlannerInput* pstLimits) {
+    int iLen1, iLen2;
+    if (!isfinite(dStartPos) || OnlineTrajectoryWindows(pstLimits, &iLen1, &iLen2) != 0) {
+        return -1;
+    }
+    OnlineTrajectoryReset(pOnline, pstLimits, iLen1, iLen2);
+    pOnline->dTarget = dStartPos;
+    pOnline->dPos0 = dStartPos;
+    for (int i = 0; i < pOnline->iLen1; i++) {
+        pOnline->adWindow1[i] = dStartPos;
+    }
+    for (int i = 0; i < pOnline->iLen2; i++) {
+        pOnline->adWindow2[i] = dStartPos;
+    }
+    pOnline->dSum1 = dStartPos * pOnline->iLen1;
+    pOnline->dSum2 = dStartPos * pOnline->iLen2;
+    pOnline->iRestSteps = pOnline->iLen1 + pOnline->iLen2;
+    pOnline->stLast.dPos = dStartPos;
+    return 0;
+}
+
+// 跟踪器历史速度取斜坡 w(-i) = clamp(w0 - i*dSlope, ±VMax) 时两级滑动平均输出的速度及每步速度增量:
+// 输出速度 = sum K(i)*w(-i), K 为两个矩形窗的卷积 K(i) = min(i+1, n1, n2, n1+n2-1-i) / (n1*n2)
+static void OnlineTrajectoryRampOutput(double dW0, double dSlope, double dVMax, int iLen1, int iLen2,
+                                       double* pdVel, double* pdDelta) {
+    const int iKernel = iLen1 + iLen2 - 1;
+    const double dNorm = 1.0 / ((double)iLen1 * (double)iLen2);
+    double dVel = 0.0, dDelta = 0.0;
+    double dW = fmax(-dVMax, fmin(dVMax, dW0));
+    for (int i = 0; i < iKernel; i++) {
+        double dWOlder = fmax(-dVMax, fmin(dVMax, dW0 - (double)(i + 1) * dSlope));
+        int iWeight = (i + 1 < iLen1) ? i + 1 : iLen1;
+        iWeight = (iWeight < iLen2) ? iWeight : iLen2;
+        iWeight = (iWeight < iKernel - i) ? iWeight : iKernel - i;
+        dVel += iWeight * dW;
+        dDelta += iWeight * (dW - dWOlder);
+        dW = dWOlder;
+    }
+    *pdVel = dVel * dNorm;
+    *pdDelta = dDelta * dNorm;
+}
+
+// 斜坡斜率为 dSlope 时, 求使输出速度为 dVel 的 w0 (输出速度随 w0 单调不减)
+static double OnlineTrajectoryRampStart(double dVel, double dSlope, double dVMax, int iLen1, int iLen2,
+                                        double* pdDelta) {
+    double dLow = -dVMax, dHigh = dVMax + (double)(iLen1 + iLen2) * dSlope;
+    double dOut;
+    for (int i = 0; i < ONLINE_TRAJ_SOLVE_STEPS; i++) {
+        double dMid = 0.5 * (dLow + dHigh);
+        OnlineTrajectoryRampOutput(dMid, dSlope, dVMax, iLen1, iLen2, &dOut, pdDelta);
+        if (dOut < dVel) {
+            dLow = dMid;
+        } else {
+            dHigh = dMid;
+        }
+    }
+    OnlineTrajectoryRampOutput(dHigh, dSlope, dVMax, iLen1, iLen2, &dOut, pdDelta);
+    return dHigh;
+}
+
+// 从运动中的状态接管 (当前参考的位置、速度、加速度, 例如正在执行的规划轨迹的最近输出点):
+// 把跟踪器的历史速度取为以加速度 a 变化的斜坡 w(-i) = w0 - a*i*Ts (w0 = v + a*(n1+n2-2)*Ts/2),
+// 两级滑动平均后输出恰为 (p, v, a), 再按历史填满两级窗口; 跟踪器目标取其制动终点 (未改目标时平稳停止).
+// 斜坡超出 ±VMax 时 (速度接近上限且加速度较大) 历史速度取 ±VMax, 二分求斜坡使输出速度不变、加速度最接近 a
+// (滑动平均的滞后使生成器在上限附近能表示的加速度小于闭式规划, 达不到时取可达的最大值;
+// 二分共约 30*30 次 O(n1+n2) 求和, 缺省窗口下约 0.15ms, 仅在接管命令中执行一次).
+// 位置、速度总是连续; 接管前后 Jerk 不连续 (接管采样处的 Snap 不受约束), 之后各阶均满足约束.
+// |v| > VMax、|a| > AMax、窗口过长或参数无效时返回 -1; v = a = 0 时与 OnlineTrajectoryInit 相同
+int OnlineTrajectoryInitFrom(stOnlineTrajectory* pOnline, const stTrajectoryPoint* pStart,
+                             const stPlannerInput* pstLimits) {
+    static double s_adHistory[2 * ONLINE_TRAJ_MAX_WINDOW];     // 跟踪器历史位置 (仅控制线程调用)
+    const double dTol = 1.0 + ONLINE_TRAJ_WINDOW_TOL;
+    int iLen1, iLen2;
+    if (!isfinite(pStart->dPos) || !isfinite(pStart->dVel) || !isfinite(pStart->dAcc) ||
+        OnlineTrajectoryWindows(pstLimits, &iLen1, &iLen2) != 0 ||
+        fabs(pStart->dVel) > pstLimits->dVMax * dTol || fabs(pStart->dAcc) > pstLimits->dAMax * dTol) {
+        return -1;
+    }
+    if (pStart->dVel == 0.0 && pStart->dAcc == 0.0) {
+        return OnlineTrajectoryInit(pOnline, pStart->dPos, pstLimits);
+    }
+
+    OnlineTrajectoryReset(pOnline, pstLimits, iLen1, iLen2);
+    const double dTs = pstLimits->dSampleTime;
+    const double dVMax = pstLimits->dVMax;
+    const double dMaxSlope = pstLimits->dAMax * dTs;
+    const int iHistory = iLen1 + iLen2 - 1;    // 第二级窗口最早一项需要的跟踪器历史长度
+    // 按加速度方向镜像, 斜率取非负
+    const double dSign = (pStart->dAcc < 0.0) ? -1.0 : 1.0;
+    const double dVel = fmax(-dVMax, fmin(dVMax, dSign * pStart->dVel));
+    const double dDelta = fmin(dMaxSlope, dSign * pStart->dAcc * dTs);
+    double dSlope = dDelta;
+    double dW0 = dVel + dSlope * (double)(iLen1 + iLen2 - 2) / 2.0;
+    double dOutVel = dVel, dOutDelta = dDelta;
+    if (dW0 > dVMax || dW0 - dSlope * iHistory < -dVMax) {
+        // 斜率增大时饱和段变长, 取输出加速度恰为 a 的斜率 (最大斜率仍不足时取最大斜率)
+        dW0 = OnlineTrajectoryRampStart(dVel, dMaxSlope, dVMax, iLen1, iLen2, &dOutDelta);
+        if (dOutDelta > dDelta) {
+            double dLow = dDelta, dHigh = dMaxSlope;
+            for (int i = 0; i < ONLINE_TRAJ_SOLVE_STEPS; i++) {
+                double dMid = 0.5 * (dLow + dHigh);
+                double dW = OnlineTrajectoryRampStart(dVel, dMid, dVMax, iLen1, iLen2, &dOutDelta);
+                if (dOutDelta < dDelta) {
+                    dLow = dMid;
+                } else {
+                    dHigh = dMid;
+                    dW0 = dW;
+                }
+            }
+            dSlope = dHigh;
+        } else {
+            dSlope = dMaxSlope;
+        }
+        OnlineTrajectoryRampOutput(dW0, dSlope, dVMax, iLen1, iLen2, &dOutVel, &dOutDelta);
+    }
+
+    // 跟踪器历史位置 s_adHistory[i] = x(-i) (相对值, 最后整体平移到起点位置)
+    s_adHistory[0] = 0.0;
+    for (int i = 1; i < iHistory; i++) {
+        double dW = fmax(-dVMax, fmin(dVMax, dW0 - dSlope * (double)(i - 1)));
+        s_adHistory[i] = s_adHistory[i - 1] - dSign * dW * dTs;
+    }
+    // 第一级窗口: 最近 n1 个跟踪器位置 (环形, 最早的在下标 0); 第二级窗口: 最近 n2 个第一级输出
+    for (int j = 0; j < iLen1; j++) {
+        pOnline->adWindow1[j] = s_adHistory[iLen1 - 1 - j];
+    }
+    double dSum = 0.0;
+    for (int i = 0; i < iLen1; i++) {
+        dSum += s_adHistory[iLen2 - 1 + i];
+    }
+    for (int j = 0; j < iLen2; j++) {
+        // y1(-(n2-1-j)) = 跟踪器 x(-(n2-1-j)) ~ x(-(n2-1-j+n1-1)) 的均值
+        pOnline->adWindow2[j] = dSum / iLen1;
+        if (j + 1 < iLen2) {
+            dSum += s_adHistory[iLen2 - 2 - j] - s_adHistory[iLen2 - 2 - j + iLen1];
+        }
+    }
+    double dSum2 = 0.0;
+    for (int j = 0; j < iLen2; j++) {
+        dSum2 += pOnline->adWindow2[j];
+    }
+    double dShift = pStart->dPos - dSum2 / iLen2;
+    pOnline->dSum1 = 0.0;
+    pOnline->dSum2 = 0.0;
+    for (int j = 0; j < iLen1; j++) {
+        pOnline->adWindow1[j] += dShift;
+        pOnline->dSum1 += pOnline->adWindow1[j];
+    }
+    for (int j = 0; j < iLen2; j++) {
+        pOnline->adWindow2[j] += dShift;
+        pOnline->dSum2 += pOnline->adWindow2[j];
+    }
+
+    // 跟踪器状态与制动终点
+    double dVel0 = dSign * fmax(-dVMax, fmin(dVMax, dW0));
+    double dBrakeSign = (dVel0 < 0.0) ? -1.0 : 1.0;
+    pOnline->dPos0 = s_adHistory[0] + dShift;
+    pOnline->dVel0 = dVel0;
+    pOnline->dTarget = pOnline->dPos0 +
+                       dBrakeSign * OnlineTrajectoryBrakeDistance(fabs(dVel0), dMaxSlope, dTs);
+    pOnline->iRestSteps = 0;
+    pOnline->stLast.dPos = pOnline->dSum2 / iLen2;
+    pOnline->stLast.dVel = dSign * dOutVel;
+    pOnline->stLast.dAcc = dSign * dOutDelta / dTs;
+    pOnline->stLast.dJerk = pStart->dJerk;
+    return 0;
+}
+
+// 修改目标位置与速度上限 (dVMax <= 0 时保持当前上限, 超过 Init 的上限时取 Init 的上限), 参数无效返回 -1
+int OnlineTrajectorySetTarget(stOnlineTrajectory* pOnline, double dTarget, double dVMax) {
+    if (!isfinite(dTarget)) {
+        return -1;
+    }
+    pOnline->dTarget = dTarget;
+    if (dVMax > 0.0) {
+        pOnline->dVMax = fmin(dVMax, pOnline->stLimits.dVMax);
+    }
+    pOnline->ullRetargets++;
+    return 0;
+}
+
+// 以最大减速度尽快停止: 目标改为跟踪器的制动终点
+void OnlineTrajectoryStop(stOnlineTrajectory* pOnline) {
+    const double dTs = pOnline->stLimits.dSampleTime;
+    double dSign = (pOnline->dVel0 < 0.0) ? -1.0 : 1.0;
+    double dBrake = OnlineTrajectoryBrakeDistance(fabs(pOnline->dVel0), pOnline->stLimits.dAMax * dTs, dTs);
+    pOnline->dTarget = pOnline->dPos0 + dSign * dBrake;
+    pOnline->ullRetargets++;
+}
+
+// 输出下一个采样点 (每周期调用一次); 速度、加速度、Jerk、Snap 为输出位置的后向差分
+void OnlineTrajectoryStep(stOnlineTrajectory* pOnline, stTrajectoryPoint* pPointOutput) {
+    double dStartUs = OnlineTrajectoryNowUs();
+    const double dTs = pOnline->stLimits.dSampleTime;
+    stTrajectoryPoint* pLast = &pOnline->stLast;
+    stTrajectoryPoint stPoint;
+
+    OnlineTrajectoryTrack(pOnline);
+    if (pOnline->dPos0 == pOnline->dTarget && pOnline->dVel0 == 0.0) {
+        pOnline->iRestSteps++;
+    } else {
+        pOnline->iRestSteps = 0;
+    }
+
+    // 第一级: 窗口内全为目标位置后直接取目标 (并重置滑动和)
+    double dOld = pOnline->adWindow1[pOnline->iIndex1];
+    pOnline->adWindow1[pOnline->iIndex1] = pOnline->dPos0;
+    pOnline->iIndex1 = (pOnline->iIndex1 + 1 == pOnline->iLen1) ? 0 : pOnline->iIndex1 + 1;
+    pOnline->dSum1 += pOnline->dPos0 - dOld;
+    double dPos1 = pOnline->dSum1 / pOnline->iLen1;
+    if (pOnline->iRestSteps >= pOnline->iLen1) {
+        dPos1 = pOnline->dTarget;
+        pOnline->dSum1 = pOnline->dTarget * pOnline->iLen1;
+    }
+
+    // 第二级
+    dOld = pOnline->adWindow2[pOnline->iIndex2];
+    pOnline->adWindow2[pOnline->iIndex2] = dPos1;
+    pOnline->iIndex2 = (pOnline->iIndex2 + 1 == pOnline->iLen2) ? 0 : pOnline->iIndex2 + 1;
+    pOnline->dSum2 += dPos1 - dOld;
+    stPoint.dPos = pOnline->dSum2 / pOnline->iLen2;
+    if (pOnline->iRestSteps >= pOnline->iLen1 + pOnline->iLen2) {
+        stPoint.dPos = pOnline->dTarget;
+        pOnline->dSum2 = pOnline->dTarget * pOnline->iLen2;
+    }
+
+    pOnline->llSampleIndex++;
+    stPoint.dTime = (double)pOnline->llSampleIndex * dTs;
+    stPoint.dVel = (stPoint.dPos - pLast->dPos) / dTs;
+    stPoint.dAcc = (stPoint.dVel - pLast->dVel) / dTs;
+    stPoint.dJerk = (stPoint.dAcc - pLast->dAcc) / dTs;
+    stPoint.dSnap = (stPoint.dJerk - pLast->dJerk) / dTs;
+    *pLast = stPoint;
+    *pPointOutput = stPoint;
+
+    pOnline->dLastStepUs = OnlineTrajectoryNowUs() - dStartUs;
+    pOnline->dSumStepUs += pOnline->dLastStepUs;
+    if (pOnline->dLastStepUs > pOnline->dMaxStepUs) {
+        pOnline->dMaxStepUs = pOnline->dLastStepUs;
+    }
+}
+
+// 是否已到位 (输出精确等于目标且静止)
+int OnlineTrajectoryIsSettled(const stOnlineTrajectory* pOnline) {
+    return pOnline->iRestSteps >= pOnline->iLen1 + pOnline->iLen2;
+}
@@ -6,10 +6,8 @@
 
 // PID控制器初始化
 void PIDControllerInit(PIDController* pid, double kp, double ki, double kd, double sample_time) {
-    pid->kp = kp;
-    pid->ki = ki;
-    pid->kd = kd;
     pid->sample_time = sample_time;
+    PIDControllerSetGains(pid, kp, ki, kd);
     
     // 初始化历史值
     pid->dFiInPrev[0] = 0.0;
@@ -23,23 +21,29 @@ void PIDControllerInit(PIDController* pid, double kp, double ki, double kd, doub
     pid->dFdOutPrev[1] = 0.0;
 }
 
+// 修改PID增益, 同时更新预先计算的积分/微分输入增益
+void PIDControllerSetGains(PIDController* pid, double kp, double ki, double kd) {
+    const double PI = 3.1415926;
+
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->dFiGain = kp * ki * (2.0 * PI) * (pid->sample_time / 2.0);
+    pid->dFdGain = kp * (1 / kd) * (1.0 / 2.0 / PI) * (2.0 / pid->sample_time);
+}
+
 // PID控制器更新
 double PIDControllerUpdate(PIDController* pid, double error) {
-    volatile double fi_input, fd_input, fi_output, fd_output, pid_output;
-    const double PI = 3.1415926;
+    double fi_input, fd_input, fi_output, fd_output, pid_output;
     
     // 计算积分部分输入
-    fi_input = error * pid->kp * pid->ki * (2.0 * PI) * (pid->sample_time / 2.0);
+    fi_input = error * pid->dFiGain;
     
     // 计算微分部分输入
-    fd_input = error * pid->kp * (1 / pid->kd) * (1.0 / 2.0 / PI) * (2.0 / pid->sample_time);
+    fd_input = error * pid->dFdGain;
     
-    // 积分部分计算
-    fi_output = (1.0) * fi_input +
-                (1.0) * pid->dFiInPrev[0] +
-                (0.0) * pid->dFiInPrev[1] -
-                (-1.0) * pid->dFiOutPrev[0] -
-                (0.0) * pid->dFiOutPrev[1];
+    // 积分部分计算: y = x + x[k-1] + y[k-1]
+    fi_output = fi_input + pid->dFiInPrev[0] + pid->dFiOutPrev[0];
     
     // 更新积分部分历史值
     pid->dFiInPrev[1] = pid->dFiInPrev[0];
@@ -47,12 +51,8 @@ double PIDControllerUpdate(PIDController* pid, double error) {
     pid->dFiOutPrev[1] = pid->dFiOutPrev[0];
     pid->dFiOutPrev[0] = fi_output;
     
-    // 微分部分计算
-    fd_output = (1.0) * fd_input +
-                (-1.0) * pid->dFdInPrev[0] +
-                (0.0) * pid->dFdInPrev[1] -
-                (1.0) * pid->dFdOutPrev[0] -
-                (0.0) * pid->dFdOutPrev[1];
+    // 微分部分计算: y = x - x[k-1] - y[k-1]
+    fd_output = fd_input - pid->dFdInPrev[0] - pid->dFdOutPrev[0];
     
     // 更新微分部分历史值
     pid->dFdInPrev[1] = pid->dFdInPrev[0];
@@ -77,4 +77,21 @@ void PIDControllerReset(PIDController* pid) {
     pid->dFdInPrev[1] = 0.0;
     pid->dFdOutPrev[0] = 0.0;
     pid->dFdOutPrev[1] = 0.0;
+}
+
+// 将PID控制器表示为一个二阶节 (与 PIDControllerUpdate 的传递函数相同)
+//   积分: gi*(1+z^-1)/(1-z^-1), gi = kp*ki*2π*Ts/2
+//   微分: gd*(1-z^-1)/(1+z^-1), gd = kp/kd/(2π)*2/Ts
+//   C(z) = kp + 积分 + 微分
+//        = [(kp+gi+gd) + 2(gi-gd)z^-1 + (gi+gd-kp)z^-2] / (1 - z^-2)
+void PIDControllerDesignSos(double kp, double ki, double kd, double sample_time, stSosSection* pSection) {
+    PIDController pid;
+    pid.sample_time = sample_time;
+    PIDControllerSetGains(&pid, kp, ki, kd);
+    double gi = pid.dFiGain;
+    double gd = pid.dFdGain;
+
+    SosSectionSetCoeffs(pSection,
+                        kp + gi + gd, 2.0 * gi - 2.0 * gd, gi + gd - kp,
+                        1.0, 0.0, -1.0);
 }
\ No newline at end of file
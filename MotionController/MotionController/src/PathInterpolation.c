@@ -0,0 +1,147 @@
+#include "PathInterpolation.h"
+#include <math.h>
+#include <string.h>
+
+#define PATH_TWO_PI 6.283185307179586476925286766559
+
+// 在路径长度上规划 (零长度路径规划为零位移轨迹, 立即完成)
+static int PathInterpPlan(stPathInterp* pPath, const stPlannerInput* pstLimits) {
+    pPath->stPathLimits.dDistance = pPath->dLength;
+    pPath->stPathLimits.dSampleTime = pstLimits->dSampleTime;
+    pPath->stPathLimits.dTimeLimit = 0.0;
+    if (FourthOrderPlannerInitInto(&pPath->stPathLimits, &pPath->stContext) != 0) {
+        return -1;
+    }
+    memset(&pPath->stPathPoint, 0, sizeof(pPath->stPathPoint));
+    return 0;
+}
+
+// 掩码中各轴从 pdStart 直线运动到 pdEnd (均按轴号索引), 约束为合成约束; 参数无效返回 -1
+int PathInterpInitLine(stPathInterp* pPath, uint64_t ullAxisMask, const double* pdStart, const double* pdEnd,
+                       const stPlannerInput* pstLimits) {
+    double dLength2 = 0.0;
+    int iCount = 0;
+
+    memset(pPath, 0, sizeof(*pPath));
+    for (int axis = 0; axis < MAX_AXIS_COUNT; axis++) {
+        if (!(ullAxisMask & (1ULL << axis))) {
+            continue;
+        }
+        if (!isfinite(pdStart[axis]) || !isfinite(pdEnd[axis])) {
+            return -1;
+        }
+        pPath->aiAxis[iCount] = axis;
+        pPath->adOrigin[iCount] = pdStart[axis];
+        pPath->adEnd[iCount] = pdEnd[axis];
+        pPath->adDir[iCount] = pdEnd[axis] - pdStart[axis];
+        pPath->adPos[iCount] = pdStart[axis];
+        dLength2 += pPath->adDir[iCount] * pPath->adDir[iCount];
+        iCount++;
+    }
+    if (iCount == 0) {
+        return -1;
+    }
+    pPath->iType = PATH_TYPE_LINE;
+    pPath->iAxisCount = iCount;
+    pPath->dLength = sqrt(dLength2);
+    for (int k = 0; k < iCount; k++) {
+        pPath->adDir[k] = (pPath->dLength > 0.0) ? pPath->adDir[k] / pPath->dLength : 0.0;
+    }
+    pPath->stPathLimits = *pstLimits;
+    return PathInterpPlan(pPath, pstLimits);
+}
+
+// iAxisX / iAxisY 平面内以 (dCenterX, dCenterY) 为圆心, 从 pdStart (按轴号索引) 运动到 (dEndX, dEndY) 的圆弧;
+// iDirection >= 0 逆时针, < 0 顺时针; 终点与起点重合时为整圆。终点不在圆上或参数无效返回 -1
+int PathInterpInitArc(stPathInterp* pPath, int iAxisX, int iAxisY, const double* pdStart, double dEndX, double dEndY,
+                      double dCenterX, double dCenterY, int iDirection, const stPlannerInput* pstLimits) {
+    const double dShare = PATH_ARC_NORMAL_SHARE;
+
+    memset(pPath, 0, sizeof(*pPath));
+    if (iAxisX < 0 || iAxisX >= MAX_AXIS_COUNT || iAxisY < 0 || iAxisY >= MAX_AXIS_COUNT || iAxisX == iAxisY ||
+        !isfinite(dEndX) || !isfinite(dEndY) || !isfinite(dCenterX) || !isfinite(dCenterY)) {
+        return -1;
+    }
+    double dX0 = pdStart[iAxisX] - dCenterX, dY0 = pdStart[iAxisY] - dCenterY;
+    double dX1 = dEndX - dCenterX, dY1 = dEndY - dCenterY;
+    double dRadius = hypot(dX0, dY0);
+    if (!(dRadius > 0.0) || fabs(hypot(dX1, dY1) - dRadius) > PATH_ARC_RADIUS_TOL * fmax(1.0, dRadius)) {
+        return -1;
+    }
+
+    pPath->iType = PATH_TYPE_ARC;
+    pPath->iAxisCount = 2;
+    pPath->aiAxis[0] = iAxisX;
+    pPath->aiAxis[1] = iAxisY;
+    pPath->adOrigin[0] = pPath->adPos[0] = pdStart[iAxisX];
+    pPath->adOrigin[1] = pPath->adPos[1] = pdStart[iAxisY];
+    pPath->adEnd[0] = dEndX;
+    pPath->adEnd[1] = dEndY;
+    pPath->dCenterX = dCenterX;
+    pPath->dCenterY = dCenterY;
+    pPath->dRadius = dRadius;
+    pPath->dSweepSign = (iDirection < 0) ? -1.0 : 1.0;
+    pPath->dStartAngle = atan2(dY0, dX0);
+
+    // 扫过角 (0, 2*pi]: 终点与起点重合 (在容差内) 时为整圆
+    double dSweep = pPath->dSweepSign * (atan2(dY1, dX1) - pPath->dStartAngle);
+    dSweep = fmod(dSweep, PATH_TWO_PI);
+    if (dSweep < 0.0) {
+        dSweep += PATH_TWO_PI;
+    }
+    if (dSweep * dRadius <= PATH_ARC_RADIUS_TOL * fmax(1.0, dRadius)) {
+        dSweep = PATH_TWO_PI;
+    }
+    pPath->dLength = dSweep * dRadius;
+
+    // 切向约束 (见头文件): 向心加速度占 share*A, 法向 Jerk 占 share*J
+    pPath->stPathLimits = *pstLimits;
+    pPath->stPathLimits.dAMax = (1.0 - dShare) * pstLimits->dAMax;
+    pPath->stPathLimits.dJMax = (1.0 - dShare) * pstLimits->dJMax;
+    pPath->stPathLimits.dVMax = fmin(pstLimits->dVMax,
+                                     fmin(sqrt(dShare * pstLimits->dAMax * dRadius),
+                                          dShare * pstLimits->dJMax * dRadius / (3.0 * pPath->stPathLimits.dAMax)));
+    return PathInterpPlan(pPath, pstLimits);
+}
+
+// 输出下一个路径点并投影到各参与轴 (每周期调用一次); 返回 1 表示本次输出了终点或路径已完成
+int PathInterpStep(stPathInterp* pPath) {
+    stTrajectoryPoint* pPoint = &pPath->stPathPoint;
+    if (FourthOrderPlannerGetNextPoint(&pPath->stContext, pPoint) != 0) {
+        return 1;
+    }
+    const int n = pPath->iAxisCount;
+    const double s = pPoint->dPos;
+    const double v = pPoint->dVel;
+
+    if (pPath->stContext.bIsFinished) {
+        for (int k = 0; k < n; k++) {
+            pPath->adPos[k] = pPath->adEnd[k];
+            pPath->adVel[k] = 0.0;
+        }
+        return 1;
+    }
+    if (pPath->iType == PATH_TYPE_LINE) {
+        const double* pdOrigin = pPath->adOrigin;
+        const double* pdDir = pPath->adDir;
+        double* pdPos = pPath->adPos;
+        double* pdVel = pPath->adVel;
+        for (int k = 0; k < n; k++) {
+            pdPos[k] = pdOrigin[k] + pdDir[k] * s;
+            pdVel[k] = pdDir[k] * v;
+        }
+    } else {
+        double dAngle = pPath->dStartAngle + pPath->dSweepSign * s / pPath->dRadius;
+        double dCos = cos(dAngle), dSin = sin(dAngle);
+        pPath->adPos[0] = pPath->dCenterX + pPath->dRadius * dCos;
+        pPath->adPos[1] = pPath->dCenterY + pPath->dRadius * dSin;
+        pPath->adVel[0] = -pPath->dSweepSign * v * dSin;
+        pPath->adVel[1] = pPath->dSweepSign * v * dCos;
+    }
+    return 0;
+}
+
+// 路径是否已输出终点
+int PathInterpIsFinished(const stPathInterp* pPath) {
+    return pPath->stContext.bIsFinished;
+}
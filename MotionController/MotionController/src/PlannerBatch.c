@@ -0,0 +1,75 @@
+#include "PlannerBatch.h"
+#include "ThreadPool.h"
+
+static LONGLONG PlannerBatchNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
+// 一个任务: 连续 PLANNER_BATCH_CHUNK 个运动 (各线程写入互不重叠的连续区间)
+static void PlannerBatchTask(int iIndex, void* pParam) {
+    const stPlannerBatch* pBatch = (const stPlannerBatch*)pParam;
+    int iBegin = iIndex * PLANNER_BATCH_CHUNK;
+    int iEnd = iBegin + PLANNER_BATCH_CHUNK;
+    if (iEnd > pBatch->iCount) {
+        iEnd = pBatch->iCount;
+    }
+
+    for (int i = iBegin; i < iEnd; i++) {
+        stPlannerTimes stTimes;
+        if (FourthOrderPlannerSolveTimes(&pBatch->pstInput[i], &stTimes) != 0) {
+            stTimes.dTotalTime = -1.0;
+            stTimes.dTd = stTimes.dTj = stTimes.dTa = stTimes.dTv = 0.0;
+            stTimes.dAlphaScaleFactor = 1.0;
+        }
+        pBatch->pdTotalTime[i] = stTimes.dTotalTime;
+        if (pBatch->pdTd != NULL) pBatch->pdTd[i] = stTimes.dTd;
+        if (pBatch->pdTj != NULL) pBatch->pdTj[i] = stTimes.dTj;
+        if (pBatch->pdTa != NULL) pBatch->pdTa[i] = stTimes.dTa;
+        if (pBatch->pdTv != NULL) pBatch->pdTv[i] = stTimes.dTv;
+        if (pBatch->pdAlpha != NULL) pBatch->pdAlpha[i] = stTimes.dAlphaScaleFactor;
+    }
+}
+
+// 批量求时间分段 (pdTotalTime 不可为 NULL); 全部成功返回 0, 有运动失败返回 -1 (其余运动的结果仍有效)
+int PlannerBatchPlan(const stPlannerBatch* pBatch, stPlannerBatchResult* pResult) {
+    LARGE_INTEGER liFreq;
+    LONGLONG llStart = PlannerBatchNow();
+
+    pResult->dSumTime = 0.0;
+    pResult->iFailed = 0;
+    pResult->iFirstFailed = -1;
+    pResult->dElapsedUs = 0.0;
+    pResult->dMovesPerSecond = 0.0;
+    if (pBatch->iCount <= 0 || pBatch->pstInput == NULL || pBatch->pdTotalTime == NULL) {
+        return -1;
+    }
+
+    int iChunks = (pBatch->iCount + PLANNER_BATCH_CHUNK - 1) / PLANNER_BATCH_CHUNK;
+    if (ThreadPoolParallelFor(iChunks, PLANNER_BATCH_CHUNKS_PER_THREAD, PlannerBatchTask, (void*)pBatch) != 0) {
+        // 线程池超时: 部分结果可能尚未写入, 全部作废
+        pResult->iFailed = pBatch->iCount;
+        pResult->iFirstFailed = 0;
+        return -1;
+    }
+
+    // 汇总 (顺序累加, 与线程数无关)
+    for (int i = 0; i < pBatch->iCount; i++) {
+        double dTime = pBatch->pdTotalTime[i];
+        if (dTime < 0.0) {
+            if (pResult->iFailed++ == 0) {
+                pResult->iFirstFailed = i;
+            }
+            continue;
+        }
+        pResult->dSumTime += dTime;
+    }
+
+    QueryPerformanceFrequency(&liFreq);
+    pResult->dElapsedUs = (double)(PlannerBatchNow() - llStart) * 1.0e6 / (double)liFreq.QuadPart;
+    if (pResult->dElapsedUs > 0.0) {
+        pResult->dMovesPerSecond = (double)pBatch->iCount * 1.0e6 / pResult->dElapsedUs;
+    }
+    return (pResult->iFailed > 0) ? -1 : 0;
+}
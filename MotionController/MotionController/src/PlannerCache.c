@@ -0,0 +1,272 @@
+#include "PlannerCache.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// 缓存条目
+typedef struct {
+    stPlannerInput stKey;           // 规范化后的键
+    unsigned long long ullHash;     // 键的哈希
+    int iPrev;                      // LRU 链表中更近使用的条目 (-1: 表头)
+    int iNext;                      // LRU 链表中更久未使用的条目 (-1: 表尾)
+    int iHashNext;                  // 同一哈希桶中的下一条目 (-1: 结束)
+    stPlannerContext stContext;     // Init 完成时的上下文
+} stPlannerCacheEntry;
+
+// 持久化文件头
+typedef struct {
+    char acMagic[4];                // "PLCH"
+    int iVersion;                   // PLANNER_CACHE_VERSION
+    int iContextSize;               // sizeof(stPlannerContext)
+    int iCount;                     // 条目数
+} stPlannerCacheFileHeader;
+
+static stPlannerCacheEntry g_astEntry[PLANNER_CACHE_CAPACITY];
+static int g_aiBucket[PLANNER_CACHE_BUCKETS];
+static int g_iHead = -1;            // 最近使用
+static int g_iTail = -1;            // 最久未使用
+static int g_iCount = 0;
+static int g_bInitialized = 0;
+static stPlannerCacheStats g_stStats;
+
+static unsigned long long PlannerCacheFnv1a(unsigned long long ullHash, const void* pData, size_t uSize) {
+    const unsigned char* pucData = (const unsigned char*)pData;
+    for (size_t i = 0; i < uSize; i++) {
+        ullHash ^= pucData[i];
+        ullHash *= FNV_PRIME;
+    }
+    return ullHash;
+}
+
+// 规范化键: 数值相同的输入得到逐字节相同的键
+static void PlannerCacheCanonicalize(const stPlannerInput* pstInput, stPlannerInput* pstKey) {
+    memset(pstKey, 0, sizeof(*pstKey));
+    pstKey->dDistance = (pstInput->dDistance == 0.0) ? 0.0 : pstInput->dDistance;
+    pstKey->dVMax = (pstInput->dVMax == 0.0) ? 0.0 : pstInput->dVMax;
+    pstKey->dAMax = (pstInput->dAMax == 0.0) ? 0.0 : pstInput->dAMax;
+    pstKey->dJMax = (pstInput->dJMax == 0.0) ? 0.0 : pstInput->dJMax;
+    pstKey->dDMax = (pstInput->dDMax == 0.0) ? 0.0 : pstInput->dDMax;
+    pstKey->dSampleTime = (pstInput->dSampleTime == 0.0) ? 0.0 : pstInput->dSampleTime;
+    pstKey->dTimeLimit = (pstInput->dTimeLimit > 0.0) ? pstInput->dTimeLimit : 0.0;
+}
+
+static void PlannerCacheUnlinkLru(int iIndex) {
+    stPlannerCacheEntry* pEntry = &g_astEntry[iIndex];
+    if (pEntry->iPrev >= 0) g_astEntry[pEntry->iPrev].iNext = pEntry->iNext; else g_iHead = pEntry->iNext;
+    if (pEntry->iNext >= 0) g_astEntry[pEntry->iNext].iPrev = pEntry->iPrev; else g_iTail = pEntry->iPrev;
+}
+
+static void PlannerCachePushFront(int iIndex) {
+    stPlannerCacheEntry* pEntry = &g_astEntry[iIndex];
+    pEntry->iPrev = -1;
+    pEntry->iNext = g_iHead;
+    if (g_iHead >= 0) g_astEntry[g_iHead].iPrev = iIndex; else g_iTail = iIndex;
+    g_iHead = iIndex;
+}
+
+static void PlannerCacheLinkBucket(int iIndex) {
+    int iBucket = (int)(g_astEntry[iIndex].ullHash & (PLANNER_CACHE_BUCKETS - 1));
+    g_astEntry[iIndex].iHashNext = g_aiBucket[iBucket];
+    g_aiBucket[iBucket] = iIndex;
+}
+
+static void PlannerCacheUnlinkBucket(int iIndex) {
+    int* piLink = &g_aiBucket[g_astEntry[iIndex].ullHash & (PLANNER_CACHE_BUCKETS - 1)];
+    while (*piLink >= 0) {
+        if (*piLink == iIndex) {
+            *piLink = g_astEntry[iIndex].iHashNext;
+            return;
+        }
+        piLink = &g_astEntry[*piLink].iHashNext;
+    }
+}
+
+static int PlannerCacheFind(const stPlannerInput* pstKey, unsigned long long ullHash) {
+    int iIndex = g_aiBucket[ullHash & (PLANNER_CACHE_BUCKETS - 1)];
+    while (iIndex >= 0) {
+        if (g_astEntry[iIndex].ullHash == ullHash &&
+            memcmp(&g_astEntry[iIndex].stKey, pstKey, sizeof(*pstKey)) == 0) {
+            return iIndex;
+        }
+        iIndex = g_astEntry[iIndex].iHashNext;
+    }
+    return -1;
+}
+
+// 清空缓存与统计信息
+void PlannerCacheInit(void) {
+    for (int i = 0; i < PLANNER_CACHE_BUCKETS; i++) {
+        g_aiBucket[i] = -1;
+    }
+    g_iHead = -1;
+    g_iTail = -1;
+    g_iCount = 0;
+    memset(&g_stStats, 0, sizeof(g_stStats));
+    g_bInitialized = 1;
+}
+
+// 查找缓存, 命中时把上下文复制到 pContext 并返回 0, 未命中返回 -1
+int PlannerCacheLookup(const stPlannerInput* pstInput, stPlannerContext* pContext) {
+    stPlannerInput stKey;
+    unsigned long long ullHash;
+    int iIndex;
+
+    PlannerCacheCanonicalize(pstInput, &stKey);
+    ullHash = PlannerCacheFnv1a(FNV_OFFSET_BASIS, &stKey, sizeof(stKey));
+    iIndex = PlannerCacheFind(&stKey, ullHash);
+    if (iIndex < 0) {
+        g_stStats.ullMisses++;
+        return -1;
+    }
+
+    memcpy(pContext, &g_astEntry[iIndex].stContext, sizeof(stPlannerContext));
+    if (iIndex != g_iHead) {
+        PlannerCacheUnlinkLru(iIndex);
+        PlannerCachePushFront(iIndex);
+    }
+    g_stStats.ullHits++;
+    return 0;
+}
+
+// 插入 Init 刚完成的上下文 (键已存在时覆盖), 缓存满时淘汰最久未使用的条目
+void PlannerCacheInsert(const stPlannerInput* pstInput, const stPlannerContext* pContext) {
+    stPlannerInput stKey;
+    unsigned long long ullHash;
+    int iIndex;
+
+    PlannerCacheCanonicalize(pstInput, &stKey);
+    ullHash = PlannerCacheFnv1a(FNV_OFFSET_BASIS, &stKey, sizeof(stKey));
+    iIndex = PlannerCacheFind(&stKey, ullHash);
+    if (iIndex >= 0) {
+        PlannerCacheUnlinkLru(iIndex);
+    } else if (g_iCount < PLANNER_CACHE_CAPACITY) {
+        iIndex = g_iCount++;
+        g_astEntry[iIndex].stKey = stKey;
+        g_astEntry[iIndex].ullHash = ullHash;
+        PlannerCacheLinkBucket(iIndex);
+    } else {
+        iIndex = g_iTail;
+        PlannerCacheUnlinkLru(iIndex);
+        PlannerCacheUnlinkBucket(iIndex);
+        g_astEntry[iIndex].stKey = stKey;
+        g_astEntry[iIndex].ullHash = ullHash;
+        PlannerCacheLinkBucket(iIndex);
+        g_stStats.ullEvictions++;
+    }
+
+    memcpy(&g_astEntry[iIndex].stContext, pContext, sizeof(stPlannerContext));
+    PlannerCachePushFront(iIndex);
+    g_stStats.ullInserts++;
+    g_stStats.iEntries = g_iCount;
+}
+
+// 获取统计信息
+void PlannerCacheGetStats(stPlannerCacheStats* pStats) {
+    *pStats = g_stStats;
+}
+
+// 保存到文件 (由最久未使用到最近使用, 加载后保持相同的淘汰顺序)
+// 文件末尾为全部条目的 FNV-1a 校验和; 返回保存的条目数, 失败返回 -1
+int PlannerCacheSave(const char* pszPath) {
+    stPlannerCacheFileHeader stHeader;
+    unsigned long long ullChecksum = FNV_OFFSET_BASIS;
+    FILE* pFile = NULL;
+    int iWritten = 0;
+
+    if (!g_bInitialized || fopen_s(&pFile, pszPath, "wb") != 0 || pFile == NULL) {
+        return -1;
+    }
+
+    memcpy(stHeader.acMagic, "PLCH", 4);
+    stHeader.iVersion = PLANNER_CACHE_VERSION;
+    stHeader.iContextSize = (int)sizeof(stPlannerContext);
+    stHeader.iCount = g_iCount;
+    if (fwrite(&stHeader, sizeof(stHeader), 1, pFile) != 1) {
+        fclose(pFile);
+        return -1;
+    }
+
+    for (int iIndex = g_iTail; iIndex >= 0; iIndex = g_astEntry[iIndex].iPrev) {
+        stPlannerCacheEntry* pEntry = &g_astEntry[iIndex];
+        if (fwrite(&pEntry->stKey, sizeof(stPlannerInput), 1, pFile) != 1 ||
+            fwrite(&pEntry->stContext, sizeof(stPlannerContext), 1, pFile) != 1) {
+            fclose(pFile);
+            return -1;
+        }
+        ullChecksum = PlannerCacheFnv1a(ullChecksum, &pEntry->stKey, sizeof(stPlannerInput));
+        ullChecksum = PlannerCacheFnv1a(ullChecksum, &pEntry->stContext, sizeof(stPlannerContext));
+        iWritten++;
+    }
+
+    if (fwrite(&ullChecksum, sizeof(ullChecksum), 1, pFile) != 1) {
+        fclose(pFile);
+        return -1;
+    }
+    return (fclose(pFile) == 0) ? iWritten : -1;
+}
+
+// 从文件加载 (覆盖当前内容, 须在规划线程启动前调用)
+// 文件不存在、版本或上下文大小不符、条目键未规范化或校验和错误时缓存保持为空
+// 返回加载的条目数, 失败返回 -1
+int PlannerCacheLoad(const char* pszPath) {
+    stPlannerCacheFileHeader stHeader;
+    unsigned long long ullChecksum = FNV_OFFSET_BASIS;
+    unsigned long long ullStored = 0;
+    FILE* pFile = NULL;
+    int bValid = 1;
+
+    PlannerCacheInit();
+    if (fopen_s(&pFile, pszPath, "rb") != 0 || pFile == NULL) {
+        return -1;
+    }
+
+    if (fread(&stHeader, sizeof(stHeader), 1, pFile) != 1 ||
+        memcmp(stHeader.acMagic, "PLCH", 4) != 0 ||
+        stHeader.iVersion != PLANNER_CACHE_VERSION ||
+        stHeader.iContextSize != (int)sizeof(stPlannerContext) ||
+        stHeader.iCount < 0 || stHeader.iCount > PLANNER_CACHE_CAPACITY) {
+        fclose(pFile);
+        return -1;
+    }
+
+    // 先整体读入并校验, 再建立索引
+    for (int i = 0; i < stHeader.iCount && bValid; i++) {
+        stPlannerCacheEntry* pEntry = &g_astEntry[i];
+        stPlannerInput stCanonical;
+        if (fread(&pEntry->stKey, sizeof(stPlannerInput), 1, pFile) != 1 ||
+            fread(&pEntry->stContext, sizeof(stPlannerContext), 1, pFile) != 1) {
+            bValid = 0;
+            break;
+        }
+        PlannerCacheCanonicalize(&pEntry->stKey, &stCanonical);
+        if (memcmp(&stCanonical, &pEntry->stKey, sizeof(stCanonical)) != 0) {
+            bValid = 0;
+        }
+        ullChecksum = PlannerCacheFnv1a(ullChecksum, &pEntry->stKey, sizeof(stPlannerInput));
+        ullChecksum = PlannerCacheFnv1a(ullChecksum, &pEntry->stContext, sizeof(stPlannerContext));
+    }
+    if (bValid && (fread(&ullStored, sizeof(ullStored), 1, pFile) != 1 || ullStored != ullChecksum)) {
+        bValid = 0;
+    }
+    fclose(pFile);
+    if (!bValid) {
+        return -1;
+    }
+
+    for (int i = 0; i < stHeader.iCount; i++) {
+        g_astEntry[i].ullHash = PlannerCacheFnv1a(FNV_OFFSET_BASIS, &g_astEntry[i].stKey, sizeof(stPlannerInput));
+        if (PlannerCacheFind(&g_astEntry[i].stKey, g_astEntry[i].ullHash) >= 0) {
+            // 重复键: 文件不是由 PlannerCacheSave 生成
+            PlannerCacheInit();
+            return -1;
+        }
+        PlannerCacheLinkBucket(i);
+        PlannerCachePushFront(i);
+    }
+    g_iCount = stHeader.iCount;
+    g_stStats.iEntries = g_iCount;
+    g_stStats.iLoaded = g_iCount;
+    return g_iCount;
+}
@@ -0,0 +1,130 @@
+#include "PlannerGroup.h"
+#include "ThreadPool.h"
+#include <math.h>
+#include <string.h>
+
+#define PLANNER_GROUP_TIME_TOLERANCE 1e-9   // 与共同时间相差不超过此值的轴不再缩放 (与 Init 的时间容差一致)
+
+// 一次同步规划的任务描述 (仅规划线程使用, 静态存储)
+typedef struct {
+    int aiAxis[MAX_AXIS_COUNT];             // 参与的轴 (压缩后的列表)
+    int iAxisCount;
+    const stPlannerInput* astInput;         // 按轴索引的输入
+    stPlannerContext* const* apContext;     // 按轴索引的输出上下文
+    double dCommonTime;                     // 第二遍使用的共同时间 (第一遍为 0, 即求最优时间)
+    volatile LONG alStatus[MAX_AXIS_COUNT]; // 各任务结果 (0: 成功, -1: 失败), 按列表序号
+} stPlannerGroupJob;
+
+static stPlannerGroupJob g_stJob;
+
+static LONGLONG PlannerGroupNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
+// 第一遍: 最优时间
+static void PlannerGroupOptimalTask(int iIndex, void* pParam) {
+    stPlannerGroupJob* pJob = (stPlannerGroupJob*)pParam;
+    int iAxis = pJob->aiAxis[iIndex];
+    stPlannerInput stInput = pJob->astInput[iAxis];
+    stInput.dTimeLimit = 0.0;
+    pJob->alStatus[iIndex] = (FourthOrderPlannerInitInto(&stInput, pJob->apContext[iAxis]) == 0) ? 0 : -1;
+}
+
+// 第二遍: 缩放到共同时间 (已等于共同时间的轴跳过)
+static void PlannerGroupScaleTask(int iIndex, void* pParam) {
+    stPlannerGroupJob* pJob = (stPlannerGroupJob*)pParam;
+    int iAxis = pJob->aiAxis[iIndex];
+    stPlannerContext* pContext = pJob->apContext[iAxis];
+    if (fabs(pContext->dTotalTime - pJob->dCommonTime) <= PLANNER_GROUP_TIME_TOLERANCE) {
+        pJob->alStatus[iIndex] = 0;
+        return;
+    }
+    stPlannerInput stInput = pJob->astInput[iAxis];
+    stInput.dTimeLimit = pJob->dCommonTime;
+    pJob->alStatus[iIndex] = (FourthOrderPlannerInitInto(&stInput, pContext) == 0) ? 0 : -1;
+}
+
+// 返回第一个失败任务对应的轴, 全部成功返回 -1
+static int PlannerGroupFirstFailure(const stPlannerGroupJob* pJob) {
+    for (int i = 0; i < pJob->iAxisCount; i++) {
+        if (pJob->alStatus[i] != 0) {
+            return pJob->aiAxis[i];
+        }
+    }
+    return -1;
+}
+
+// 为掩码中的各轴规划共同结束时间的轨迹
+// astInput / apContext 按轴号索引 (长度 MAX_AXIS_COUNT), 只读写掩码中的轴
+// 成功返回 0; 任一轴失败返回 -1 (pResult->iFailedAxis 为失败轴, 各轴上下文内容未定义);
+// 线程池等待超时同样返回 -1 (pResult->bPoolTimeout 置位)
+int PlannerGroupPlan(uint64_t ullAxisMask, const stPlannerInput* astInput,
+                     stPlannerContext* const* apContext, stPlannerGroupResult* pResult) {
+    stPlannerGroupJob* pJob = &g_stJob;
+    LARGE_INTEGER liFreq;
+    LONGLONG llStart = PlannerGroupNow();
+
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->iSlowestAxis = -1;
+    pResult->iFailedAxis = -1;
+
+    pJob->iAxisCount = 0;
+    pJob->astInput = astInput;
+    pJob->apContext = apContext;
+    pJob->dCommonTime = 0.0;
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullAxisMask & (1ULL << iAxis)) {
+            pJob->aiAxis[pJob->iAxisCount++] = iAxis;
+        }
+    }
+    if (pJob->iAxisCount == 0) {
+        return -1;
+    }
+
+    // 1. 各轴最优时间
+    if (ThreadPoolParallelFor(pJob->iAxisCount, PLANNER_GROUP_AXES_PER_THREAD, PlannerGroupOptimalTask, pJob) != 0) {
+        pResult->bPoolTimeout = 1;
+        return -1;
+    }
+    pResult->iFailedAxis = PlannerGroupFirstFailure(pJob);
+    if (pResult->iFailedAxis >= 0) {
+        return -1;
+    }
+
+    // 2. 共同时间取最慢轴 (或更长的时间限制)
+    for (int i = 0; i < pJob->iAxisCount; i++) {
+        int iAxis = pJob->aiAxis[i];
+        if (apContext[iAxis]->dTotalTime > pJob->dCommonTime) {
+            pJob->dCommonTime = apContext[iAxis]->dTotalTime;
+            pResult->iSlowestAxis = iAxis;
+        }
+    }
+    for (int i = 0; i < pJob->iAxisCount; i++) {
+        double dLimit = astInput[pJob->aiAxis[i]].dTimeLimit;
+        if (dLimit > pJob->dCommonTime + PLANNER_GROUP_TIME_TOLERANCE) {
+            pJob->dCommonTime = dLimit;
+            pResult->iSlowestAxis = -1;
+        }
+    }
+    for (int i = 0; i < pJob->iAxisCount; i++) {
+        if (fabs(apContext[pJob->aiAxis[i]]->dTotalTime - pJob->dCommonTime) > PLANNER_GROUP_TIME_TOLERANCE) {
+            pResult->iScaledAxes++;
+        }
+    }
+
+    // 3. 其余轴缩放到共同时间
+    if (pResult->iScaledAxes > 0) {
+        if (ThreadPoolParallelFor(pJob->iAxisCount, PLANNER_GROUP_AXES_PER_THREAD, PlannerGroupScaleTask, pJob) != 0) {
+            pResult->bPoolTimeout = 1;
+            return -1;
+        }
+        pResult->iFailedAxis = PlannerGroupFirstFailure(pJob);
+    }
+
+    pResult->dCommonTime = pJob->dCommonTime;
+    QueryPerformanceFrequency(&liFreq);
+    pResult->dPlanUs = (double)(PlannerGroupNow() - llStart) * 1.0e6 / (double)liFreq.QuadPart;
+    return (pResult->iFailedAxis >= 0) ? -1 : 0;
+}
@@ -0,0 +1,67 @@
+#include "PlannerPool.h"
+#include <stddef.h>
+
+// 池节点: SList 链接须按 MEMORY_ALLOCATION_ALIGNMENT 对齐, SLIST_ENTRY 类型本身已带对齐声明
+typedef struct {
+    SLIST_ENTRY stLink;
+    stPlannerContext stContext;
+} stPlannerPoolNode;
+
+static SLIST_HEADER g_stFreeList;
+static stPlannerPoolNode g_astNode[PLANNER_POOL_CAPACITY];
+static volatile LONG g_lInUse = 0;
+static volatile LONG g_lMaxInUse = 0;
+static volatile LONG g_lExhausted = 0;
+
+// 建立空闲链表 (须在任何线程获取上下文之前调用, 重复调用会回收全部上下文)
+void PlannerPoolInit(void) {
+    InitializeSListHead(&g_stFreeList);
+    for (int i = PLANNER_POOL_CAPACITY - 1; i >= 0; i--) {
+        InterlockedPushEntrySList(&g_stFreeList, &g_astNode[i].stLink);
+    }
+    g_lInUse = 0;
+    g_lMaxInUse = 0;
+    g_lExhausted = 0;
+}
+
+// 获取一个上下文 (内容未初始化), 池空时返回 NULL
+stPlannerContext* PlannerPoolAcquire(void) {
+    PSLIST_ENTRY pEntry = InterlockedPopEntrySList(&g_stFreeList);
+    if (pEntry == NULL) {
+        InterlockedIncrement(&g_lExhausted);
+        return NULL;
+    }
+
+    LONG lInUse = InterlockedIncrement(&g_lInUse);
+    LONG lMax = g_lMaxInUse;
+    while (lInUse > lMax) {
+        LONG lPrev = InterlockedCompareExchange(&g_lMaxInUse, lInUse, lMax);
+        if (lPrev == lMax) {
+            break;
+        }
+        lMax = lPrev;
+    }
+    return &((stPlannerPoolNode*)pEntry)->stContext;
+}
+
+// 归还上下文; NULL 或不属于本池的指针被忽略
+void PlannerPoolRelease(stPlannerContext* pContext) {
+    if (pContext == NULL) {
+        return;
+    }
+    stPlannerPoolNode* pNode = (stPlannerPoolNode*)((char*)pContext - offsetof(stPlannerPoolNode, stContext));
+    if (pNode < &g_astNode[0] || pNode >= &g_astNode[PLANNER_POOL_CAPACITY] ||
+        ((char*)pNode - (char*)g_astNode) % sizeof(stPlannerPoolNode) != 0) {
+        return;
+    }
+    InterlockedPushEntrySList(&g_stFreeList, &pNode->stLink);
+    InterlockedDecrement(&g_lInUse);
+}
+
+// 获取统计信息
+void PlannerPoolGetStats(stPlannerPoolStats* pStats) {
+    pStats->lCapacity = PLANNER_POOL_CAPACITY;
+    pStats->lInUse = g_lInUse;
+    pStats->lMaxInUse = g_lMaxInUse;
+    pStats->lExhausted = g_lExhausted;
+}
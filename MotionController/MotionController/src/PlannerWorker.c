@@ -0,0 +1,352 @@
+#include "PlannerWorker.h"
+#include "PlannerCache.h"
+#include "PlannerPool.h"
+#include "PlannerGroup.h"
+#include "MotionQueue.h"
+#include "TrajectoryFile.h"
+#include <process.h>
+#include <string.h>
+
+// 每轴的双缓冲上下文
+typedef struct {
+    stPlannerContext* apSlot[2];    // 两个上下文槽 (启动时从上下文池获取)
+    volatile LONG lActive;          // 控制线程正在读取的槽 (仅控制线程修改)
+    volatile LONG lInFlight;        // 1: 后备槽已写入结果, 尚未被控制线程应用 (工作线程置 1, 控制线程清 0)
+} stPlannerAxisBuffer;
+
+static stPlannerAxisBuffer g_astAxisBuffer[MAX_AXIS_COUNT];
+static stPlanRequest g_astRequestStorage[PLANNER_REQUEST_CAPACITY];
+static stPlanResult g_astResultStorage[PLANNER_RESULT_CAPACITY];
+static stSpscRing g_stRequestRing;
+static stSpscRing g_stResultRing;
+static stPlannerWorkerStats g_stStats;
+static int g_aiPending[MAX_AXIS_COUNT];    // 各轴已提交未应用的请求数 (仅控制线程使用)
+static HANDLE g_hWorkerThread = NULL;
+static HANDLE g_hWakeEvent = NULL;
+static volatile LONG g_lStopRequested = 0;
+static double g_dTicksToUs = 0.0;
+
+// 多轴同步规划请求的输入 (控制线程写入后以请求队列中的标记请求通知工作线程, 每次至多一个待处理)
+static stPlannerInput g_astGroupInput[MAX_AXIS_COUNT];
+static volatile LONG g_lGroupPending = 0;  // 1: 输入已写入, 工作线程尚未取走 (控制线程置 1, 工作线程清 0)
+static stPlannerInput g_astGroupWork[MAX_AXIS_COUNT];      // 工作线程取走后的副本
+static stPlannerContext* g_apGroupContext[MAX_AXIS_COUNT]; // 各轴后备槽
+
+static LONGLONG PlannerWorkerNow(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return liNow.QuadPart;
+}
+
+// 规划到指定槽: 先查缓存, 未命中时直接在槽内 InitInto 并把结果加入缓存, 失败返回 -1
+static int PlannerWorkerPlanInto(const stPlannerInput* pstInput, stPlannerContext* pSlot, int* pbCacheHit) {
+    *pbCacheHit = 0;
+    if (PlannerCacheLookup(pstInput, pSlot) == 0) {
+        *pbCacheHit = 1;
+        return 0;
+    }
+    if (FourthOrderPlannerInitInto(pstInput, pSlot) != 0) {
+        return -1;
+    }
+    PlannerCacheInsert(pstInput, pSlot);
+    return 0;
+}
+
+// 等待该轴上一次结果被应用 (控制线程可能即将切换到后备槽), 停止时返回 -1
+static int PlannerWorkerWaitBackSlot(stPlannerAxisBuffer* pBuffer) {
+    while (ReadAcquire(&pBuffer->lInFlight) != 0) {
+        if (ReadAcquire(&g_lStopRequested)) {
+            return -1;
+        }
+        Sleep(1);
+    }
+    return 0;
+}
+
+// 多轴同步规划: 各轴后备槽全部空闲后并行规划, 以一个结果通知控制线程在同一周期边界切换全部轴
+static void PlannerWorkerProcessGroup(const stPlanRequest* pRequest) {
+    stPlanResult stResult;
+    uint64_t ullMask = pRequest->ullAxisMask;
+
+    memcpy(g_astGroupWork, g_astGroupInput, sizeof(g_astGroupWork));
+    WriteRelease(&g_lGroupPending, 0);
+
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullMask & (1ULL << iAxis)) {
+            stPlannerAxisBuffer* pBuffer = &g_astAxisBuffer[iAxis];
+            if (PlannerWorkerWaitBackSlot(pBuffer) != 0) {
+                return;
+            }
+            g_apGroupContext[iAxis] = pBuffer->apSlot[1 - ReadAcquire(&pBuffer->lActive)];
+        }
+    }
+
+    memset(&stResult, 0, sizeof(stResult));
+    stResult.iAxis = -1;
+    stResult.ullAxisMask = ullMask;
+    stResult.iSequence = pRequest->iSequence;
+    stResult.iStatus = PlannerGroupPlan(ullMask, g_astGroupWork, g_apGroupContext, &stResult.stGroup);
+    stResult.dPlanUs = stResult.stGroup.dPlanUs;
+    stResult.llRequestTicks = pRequest->llRequestTicks;
+
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullMask & (1ULL << iAxis)) {
+            WriteRelease(&g_astAxisBuffer[iAxis].lInFlight, 1);
+        }
+    }
+    SpscRingPush(&g_stResultRing, &stResult);
+}
+
+// 在后备槽中规划一条请求, 结果经结果队列交给控制线程
+static void PlannerWorkerProcess(const stPlanRequest* pRequest) {
+    if (pRequest->iAxis == PLANNER_GROUP_REQUEST) {
+        PlannerWorkerProcessGroup(pRequest);
+        return;
+    }
+
+    stPlannerAxisBuffer* pBuffer = &g_astAxisBuffer[pRequest->iAxis];
+    stPlanResult stResult;
+
+    if (PlannerWorkerWaitBackSlot(pBuffer) != 0) {
+        return;
+    }
+
+    LONG lBack = 1 - ReadAcquire(&pBuffer->lActive);
+    LONGLONG llStart = PlannerWorkerNow();
+    int bCacheHit;
+    int iStatus = PlannerWorkerPlanInto(&pRequest->stInput, pBuffer->apSlot[lBack], &bCacheHit);
+
+    memset(&stResult, 0, sizeof(stResult));
+    stResult.iAxis = pRequest->iAxis;
+    stResult.ullAxisMask = 1ULL << pRequest->iAxis;
+    stResult.iSequence = pRequest->iSequence;
+    stResult.iStatus = iStatus;
+    stResult.bCacheHit = bCacheHit;
+    stResult.dPlanUs = (double)(PlannerWorkerNow() - llStart) * g_dTicksToUs;
+    stResult.llRequestTicks = pRequest->llRequestTicks;
+
+    // 每轴至多一个未应用结果 (同步规划结果占用其全部轴), 结果队列容量不小于轴数, 不会满
+    WriteRelease(&pBuffer->lInFlight, 1);
+    SpscRingPush(&g_stResultRing, &stResult);
+}
+
+static unsigned __stdcall PlannerWorkerThread(void* pParam) {
+    stPlanRequest stRequest;
+    (void)pParam;
+
+    // 每轮处理一条规划请求并服务各轴运动队列与轨迹文件加载器, 均无事可做时才等待唤醒
+    while (!ReadAcquire(&g_lStopRequested)) {
+        int bWork = 0;
+        if (SpscRingPop(&g_stRequestRing, &stRequest) == 0) {
+            PlannerWorkerProcess(&stRequest);
+            bWork = 1;
+        }
+        bWork |= MotionQueueService();
+        bWork |= TrajectoryFileService();
+        if (!bWork) {
+            WaitForSingleObject(g_hWakeEvent, 100);
+        }
+    }
+    return 0;
+}
+
+// 初始化队列, 并从上下文池获取各轴上下文槽 (须在 PlannerPoolInit 之后、工作线程启动前调用)
+// 上下文池不足时返回 -1
+int PlannerWorkerInit(void) {
+    LARGE_INTEGER liFreq;
+    QueryPerformanceFrequency(&liFreq);
+    g_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+
+    memset(g_astAxisBuffer, 0, sizeof(g_astAxisBuffer));
+    memset(&g_stStats, 0, sizeof(g_stStats));
+    memset(g_aiPending, 0, sizeof(g_aiPending));
+    PlannerCacheInit();
+    MotionQueueInit(PlannerWorkerWake);
+    TrajectoryFileLoaderInit(PlannerWorkerWake);
+    SpscRingInit(&g_stRequestRing, g_astRequestStorage, PLANNER_REQUEST_CAPACITY, sizeof(stPlanRequest));
+    SpscRingInit(&g_stResultRing, g_astResultStorage, PLANNER_RESULT_CAPACITY, sizeof(stPlanResult));
+    g_lStopRequested = 0;
+    g_lGroupPending = 0;
+
+    for (int i = 0; i < MAX_AXIS_COUNT; i++) {
+        for (int j = 0; j < 2; j++) {
+            g_astAxisBuffer[i].apSlot[j] = PlannerPoolAcquire();
+            if (g_astAxisBuffer[i].apSlot[j] == NULL) {
+                return -1;
+            }
+            memset(g_astAxisBuffer[i].apSlot[j], 0, sizeof(stPlannerContext));
+        }
+    }
+    return 0;
+}
+
+// 启动工作线程, 失败返回 -1
+int PlannerWorkerStart(void) {
+    if (g_hWorkerThread != NULL) {
+        return 0;
+    }
+    g_hWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_hWakeEvent == NULL) {
+        return -1;
+    }
+    g_hWorkerThread = (HANDLE)_beginthreadex(NULL, 0, PlannerWorkerThread, NULL, 0, NULL);
+    if (g_hWorkerThread == NULL) {
+        CloseHandle(g_hWakeEvent);
+        g_hWakeEvent = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+// 停止工作线程 (未处理的请求被丢弃)
+void PlannerWorkerStop(void) {
+    if (g_hWorkerThread == NULL) {
+        return;
+    }
+    InterlockedExchange(&g_lStopRequested, 1);
+    SetEvent(g_hWakeEvent);
+    WaitForSingleObject(g_hWorkerThread, INFINITE);
+    CloseHandle(g_hWorkerThread);
+    CloseHandle(g_hWakeEvent);
+    g_hWorkerThread = NULL;
+    g_hWakeEvent = NULL;
+}
+
+// 多轴同步规划到各轴当前槽 (仅用于启动阶段, 工作线程启动前调用), 失败返回 -1
+int PlannerWorkerPlanGroupSync(uint64_t ullAxisMask, const stPlannerInput* astInput, stPlannerGroupResult* pResult) {
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullAxisMask & (1ULL << iAxis)) {
+            g_apGroupContext[iAxis] = g_astAxisBuffer[iAxis].apSlot[g_astAxisBuffer[iAxis].lActive];
+        }
+    }
+    return PlannerGroupPlan(ullAxisMask, astInput, g_apGroupContext, pResult);
+}
+
+// 提交规划请求 (仅控制线程调用, 不阻塞), 请求队列满时返回 -1
+int PlannerWorkerRequest(int iAxis, int iSequence, const stPlannerInput* pstInput) {
+    stPlanRequest stRequest;
+
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return -1;
+    }
+    stRequest.iAxis = iAxis;
+    stRequest.ullAxisMask = 1ULL << iAxis;
+    stRequest.iSequence = iSequence;
+    stRequest.stInput = *pstInput;
+    stRequest.llRequestTicks = PlannerWorkerNow();
+
+    if (SpscRingPush(&g_stRequestRing, &stRequest) != 0) {
+        g_stStats.ullRejected++;
+        return -1;
+    }
+    g_stStats.ullRequested++;
+    g_aiPending[iAxis]++;
+    SetEvent(g_hWakeEvent);
+    return 0;
+}
+
+// 提交多轴同步规划请求 (仅控制线程调用, 不阻塞), astInput 按轴号索引, 只读取掩码中的轴
+// 上一个同步请求尚未被工作线程取走或请求队列满时返回 -1
+int PlannerWorkerRequestGroup(uint64_t ullAxisMask, int iSequence, const stPlannerInput* astInput) {
+    stPlanRequest stRequest;
+
+    if (ullAxisMask == 0 || ReadAcquire(&g_lGroupPending) != 0) {
+        g_stStats.ullRejected++;
+        return -1;
+    }
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullAxisMask & (1ULL << iAxis)) {
+            g_astGroupInput[iAxis] = astInput[iAxis];
+        }
+    }
+
+    memset(&stRequest, 0, sizeof(stRequest));
+    stRequest.iAxis = PLANNER_GROUP_REQUEST;
+    stRequest.ullAxisMask = ullAxisMask;
+    stRequest.iSequence = iSequence;
+    stRequest.llRequestTicks = PlannerWorkerNow();
+
+    WriteRelease(&g_lGroupPending, 1);
+    if (SpscRingPush(&g_stRequestRing, &stRequest) != 0) {
+        WriteRelease(&g_lGroupPending, 0);
+        g_stStats.ullRejected++;
+        return -1;
+    }
+    g_stStats.ullRequested++;
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (ullAxisMask & (1ULL << iAxis)) {
+            g_aiPending[iAxis]++;
+        }
+    }
+    SetEvent(g_hWakeEvent);
+    return 0;
+}
+
+// 取出一个规划结果并在周期边界应用 (仅控制线程调用)
+// 成功的结果切换该轴当前槽; 无结果时返回 -1
+int PlannerWorkerApply(stPlanResult* pResult) {
+    if (SpscRingPop(&g_stResultRing, pResult) != 0) {
+        return -1;
+    }
+    // 单轴结果的掩码只含该轴; 同步规划结果的全部轴在此一并切换
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if (pResult->ullAxisMask & (1ULL << iAxis)) {
+            stPlannerAxisBuffer* pBuffer = &g_astAxisBuffer[iAxis];
+            if (pResult->iStatus == 0) {
+                WriteRelease(&pBuffer->lActive, 1 - pBuffer->lActive);
+            }
+            // 切换完成后释放后备槽 (原当前槽), 工作线程方可写入
+            WriteRelease(&pBuffer->lInFlight, 0);
+            g_aiPending[iAxis]--;
+        }
+    }
+    if (pResult->iStatus == 0) {
+        g_stStats.ullApplied++;
+        if (pResult->bCacheHit) {
+            g_stStats.ullCacheHits++;
+        }
+    } else {
+        g_stStats.ullFailed++;
+    }
+
+    pResult->dLatencyUs = (double)(PlannerWorkerNow() - pResult->llRequestTicks) * g_dTicksToUs;
+    g_stStats.dSumPlanUs += pResult->dPlanUs;
+    g_stStats.dSumLatencyUs += pResult->dLatencyUs;
+    if (pResult->dPlanUs > g_stStats.dMaxPlanUs) {
+        g_stStats.dMaxPlanUs = pResult->dPlanUs;
+    }
+    if (pResult->dLatencyUs > g_stStats.dMaxLatencyUs) {
+        g_stStats.dMaxLatencyUs = pResult->dLatencyUs;
+    }
+    return 0;
+}
+
+// 掩码中是否有轴存在已提交未应用的请求 (仅控制线程调用)
+int PlannerWorkerIsPending(uint64_t ullAxisMask) {
+    for (int iAxis = 0; iAxis < MAX_AXIS_COUNT; iAxis++) {
+        if ((ullAxisMask & (1ULL << iAxis)) && g_aiPending[iAxis] > 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 唤醒工作线程 (任意线程可调用, 线程未启动时忽略)
+void PlannerWorkerWake(void) {
+    if (g_hWakeEvent != NULL) {
+        SetEvent(g_hWakeEvent);
+    }
+}
+
+// 该轴当前生效的上下文 (仅控制线程使用)
+stPlannerContext* PlannerWorkerGetContext(int iAxis) {
+    if (iAxis < 0 || iAxis >= MAX_AXIS_COUNT) {
+        return NULL;
+    }
+    return g_astAxisBuffer[iAxis].apSlot[g_astAxisBuffer[iAxis].lActive];
+}
+
+// 获取统计信息 (仅控制线程调用)
+void PlannerWorkerGetStats(stPlannerWorkerStats* pStats) {
+    *pStats = g_stStats;
+}
@@ -1,5 +1,6 @@
 // Socket.c
 #include "Socket.h"
+#include "CommandQueue.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,10 +10,9 @@
 
 #define RXDATA_SIZE sizeof(struct RxData)
 #define FEEDBACK_SIZE sizeof(CommandFeedback)
+#define SOCKET_POLL_INTERVAL_US 5000    // 等待指令时检查异步完成反馈的间隔 [us]
 
 // 全局变量声明
-struct RxData g_rxData = {0};
-int g_bDataReceived = 0;
 static int g_sequenceNumber = 0;  // 指令序列号
 
 // 添加保存上一次命令信息的变量
@@ -29,6 +29,14 @@ int SendCommandFeedback(SOCKET clientSocket, CommandFeedback* feedback) {
     return 0;
 }
 
+// 发送控制线程产生的所有异步完成反馈
+static void FlushAsyncFeedback(SOCKET clientSocket) {
+    CommandFeedback feedback;
+    while (CommandFeedbackPop(&feedback) == 0) {
+        SendCommandFeedback(clientSocket, &feedback);
+    }
+}
+
 int RunSocketServer(unsigned short usPort, void (*pDataCallback)(struct RxData* pData))
 {
     WSADATA wsaData;
@@ -99,7 +107,26 @@ int RunSocketServer(unsigned short usPort, void (*pDataCallback)(struct RxData*
     // 数据接收循环
     while(1)
     {
-        recvLen = recv(clientSocket, (char*)&rxData, RXDATA_SIZE, 0);
+        // 等待指令期间定期发送异步完成反馈 (如后台轨迹规划完成)
+        FlushAsyncFeedback(clientSocket);
+
+        fd_set readSet;
+        struct timeval timeout = { 0, SOCKET_POLL_INTERVAL_US };
+        FD_ZERO(&readSet);
+        FD_SET(clientSocket, &readSet);
+        int ready = select(0, &readSet, NULL, NULL, &timeout);
+        if(ready == SOCKET_ERROR)
+        {
+            fprintf(stderr, "Select failed, error code: %zd\n", (size_t)WSAGetLastError());
+            break;
+        }
+        if(ready == 0)
+        {
+            continue;
+        }
+
+        // MSG_WAITALL: 连续指令在 TCP 流中可能被拆分/合并, 必须按完整结构体接收
+        recvLen = recv(clientSocket, (char*)&rxData, RXDATA_SIZE, MSG_WAITALL);
         if(recvLen <= 0)
         {
             if(recvLen == 0)
@@ -129,8 +156,13 @@ int RunSocketServer(unsigned short usPort, void (*pDataCallback)(struct RxData*
             feedback.iCMD = g_lastRxData.iCMD;
             feedback.axis = g_lastRxData.axis;
             feedback.sequenceNumber = g_lastSequenceNumber;
-            feedback.status = CMD_STATUS_COMPLETED;
-            sprintf_s(feedback.message, sizeof(feedback.message), "Command %d completed successfully", g_lastRxData.iCMD);
+            if (CommandIsAsync(g_lastRxData.iCMD)) {
+                feedback.status = CMD_STATUS_EXECUTING;
+                sprintf_s(feedback.message, sizeof(feedback.message), "Command %d completion pending", g_lastRxData.iCMD);
+            } else {
+                feedback.status = CMD_STATUS_COMPLETED;
+                sprintf_s(feedback.message, sizeof(feedback.message), "Command %d completed successfully", g_lastRxData.iCMD);
+            }
         } else {
             // 如果没有上一次的命令（第一次），则反馈当前命令的接收确认
             feedback.iCMD = rxData.iCMD;
@@ -139,15 +171,26 @@ int RunSocketServer(unsigned short usPort, void (*pDataCallback)(struct RxData*
             feedback.status = CMD_STATUS_PENDING;
             sprintf_s(feedback.message, sizeof(feedback.message), "Command %d received", rxData.iCMD);
         }
-        SendCommandFeedback(clientSocket, &feedback);
+        if (g_lastSequenceNumber == 0 || !CommandIsStreamed(&g_lastRxData)) {
+            SendCommandFeedback(clientSocket, &feedback);
+        }
 
         // 保存当前命令为下一次的"上一次命令"
         g_lastRxData = rxData;
         g_lastSequenceNumber = g_sequenceNumber;
 
-        // 将接收到的数据保存到全局变量
-        g_rxData = rxData;
-        g_bDataReceived = 1;
+        // 将接收到的指令放入无锁队列, 由控制线程在周期开始时取出
+        if (CommandQueuePush(&rxData, g_sequenceNumber) != 0)
+        {
+            feedback.iCMD = rxData.iCMD;
+            feedback.axis = rxData.axis;
+            feedback.sequenceNumber = g_sequenceNumber;
+            feedback.status = CMD_STATUS_ERROR;
+            feedback.errorCode = 1;
+            sprintf_s(feedback.message, sizeof(feedback.message), "Command %d dropped: command queue full", rxData.iCMD);
+            SendCommandFeedback(clientSocket, &feedback);
+            continue;
+        }
 
         // 调用回调函数处理接收到的数据
         if(pDataCallback != NULL)
@@ -170,12 +213,20 @@ int RunSocketServer(unsigned short usPort, void (*pDataCallback)(struct RxData*
         }
 
         // 发送执行完成反馈（反馈当前命令）
+        // 异步指令此时仅表示已提交, 最终状态由控制线程经反馈队列发送; 流式指令只有最终状态
         feedback.iCMD = rxData.iCMD;
         feedback.axis = rxData.axis;
         feedback.sequenceNumber = g_sequenceNumber;
-        feedback.status = CMD_STATUS_COMPLETED;
-        sprintf_s(feedback.message, sizeof(feedback.message), "Command %d executed successfully", rxData.iCMD);
-        SendCommandFeedback(clientSocket, &feedback);
+        if (CommandIsAsync(rxData.iCMD)) {
+            feedback.status = CMD_STATUS_EXECUTING;
+            sprintf_s(feedback.message, sizeof(feedback.message), "Command %d accepted, completion pending", rxData.iCMD);
+        } else {
+            feedback.status = CMD_STATUS_COMPLETED;
+            sprintf_s(feedback.message, sizeof(feedback.message), "Command %d executed successfully", rxData.iCMD);
+        }
+        if (!CommandIsStreamed(&rxData)) {
+            SendCommandFeedback(clientSocket, &feedback);
+        }
 
         // 检查是否需要断开连接
         if(rxData.iCMD == 999)
@@ -0,0 +1,57 @@
+#include "SosCascade.h"
+#include <string.h>
+
+// 由 a0*y = b0*x + b1*x[k-1] + b2*x[k-2] - a1*y[k-1] - a2*y[k-2] 形式的系数设置二阶节
+// 系数在此处一次性除以 a0, 状态清零
+void SosSectionSetCoeffs(stSosSection* pSection,
+                         double b0, double b1, double b2, double a0, double a1, double a2) {
+    pSection->dB0 = b0 / a0;
+    pSection->dB1 = b1 / a0;
+    pSection->dB2 = b2 / a0;
+    pSection->dA1 = a1 / a0;
+    pSection->dA2 = a2 / a0;
+    pSection->dZ1 = 0.0;
+    pSection->dZ2 = 0.0;
+}
+
+// 初始化为空级联 (直通)
+void SosCascadeInit(stSosCascade* pCascade) {
+    memset(pCascade, 0, sizeof(stSosCascade));
+}
+
+// 在级联末尾追加一节, 已满时返回 -1
+int SosCascadeAddSection(stSosCascade* pCascade, const stSosSection* pSection) {
+    if (pCascade->iSectionCount >= SOS_MAX_SECTIONS) {
+        return -1;
+    }
+    pCascade->astSection[pCascade->iSectionCount++] = *pSection;
+    return 0;
+}
+
+// 只保留前 iSectionCount 节
+void SosCascadeTruncate(stSosCascade* pCascade, int iSectionCount) {
+    if (iSectionCount >= 0 && iSectionCount < pCascade->iSectionCount) {
+        pCascade->iSectionCount = iSectionCount;
+    }
+}
+
+// 清除所有节的状态
+void SosCascadeReset(stSosCascade* pCascade) {
+    for (int i = 0; i < pCascade->iSectionCount; i++) {
+        pCascade->astSection[i].dZ1 = 0.0;
+        pCascade->astSection[i].dZ2 = 0.0;
+    }
+}
+
+// 级联更新一步
+double SosCascadeUpdate(stSosCascade* pCascade, double dInput) {
+    double x = dInput;
+    for (int i = 0; i < pCascade->iSectionCount; i++) {
+        stSosSection* s = &pCascade->astSection[i];
+        double y = s->dB0 * x + s->dZ1;
+        s->dZ1 = s->dB1 * x - s->dA1 * y + s->dZ2;
+        s->dZ2 = s->dB2 * x - s->dA2 * y;
+        x = y;
+    }
+    return x;
+}
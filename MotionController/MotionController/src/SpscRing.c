@@ -0,0 +1,98 @@
+#include "SpscRing.h"
+#include <string.h>
+
+// 初始化环形队列, 容量必须为 2 的幂
+int SpscRingInit(stSpscRing* pRing, void* pStorage, LONG lCapacity, size_t uElemSize) {
+    if (pRing == NULL || pStorage == NULL || uElemSize == 0 ||
+        lCapacity <= 0 || (lCapacity & (lCapacity - 1)) != 0) {
+        return -1;
+    }
+    memset(pRing, 0, sizeof(stSpscRing));
+    pRing->pucStorage = (unsigned char*)pStorage;
+    pRing->uElemSize = uElemSize;
+    pRing->lCapacity = lCapacity;
+    pRing->lMask = lCapacity - 1;
+    return 0;
+}
+
+// 生产者写入一个元素, 队列满时返回 -1 (不阻塞)
+int SpscRingPush(stSpscRing* pRing, const void* pElem) {
+    LONG lHead = pRing->lHead;                  // 自己的索引, 无需同步
+    LONG lTail = ReadAcquire(&pRing->lTail);    // 获取消费者已释放的槽位
+
+    if ((ULONG)lHead - (ULONG)lTail >= (ULONG)pRing->lCapacity) {
+        return -1;
+    }
+
+    memcpy(pRing->pucStorage + (size_t)(lHead & pRing->lMask) * pRing->uElemSize, pElem, pRing->uElemSize);
+
+    // 元素写入完成后再发布写索引
+    WriteRelease(&pRing->lHead, (LONG)((ULONG)lHead + 1));
+    return 0;
+}
+
+// 消费者读取一个元素, 队列空时返回 -1 (不阻塞)
+int SpscRingPop(stSpscRing* pRing, void* pElem) {
+    LONG lTail = pRing->lTail;                  // 自己的索引, 无需同步
+    LONG lHead = ReadAcquire(&pRing->lHead);    // 获取生产者已发布的元素
+
+    if (lHead == lTail) {
+        return -1;
+    }
+
+    memcpy(pElem, pRing->pucStorage + (size_t)(lTail & pRing->lMask) * pRing->uElemSize, pRing->uElemSize);
+
+    // 元素读取完成后再释放槽位
+    WriteRelease(&pRing->lTail, (LONG)((ULONG)lTail + 1));
+    return 0;
+}
+
+// 当前队列中的元素个数 (任意线程调用均为近似值)
+LONG SpscRingCount(const stSpscRing* pRing) {
+    return (LONG)((ULONG)ReadAcquire(&pRing->lHead) - (ULONG)ReadAcquire(&pRing->lTail));
+}
+
+// 生产者取得下一个空槽直接写入 (不复制), 队列满时返回 NULL (不阻塞); 写完后调用 SpscRingCommit 发布
+void* SpscRingReserve(stSpscRing* pRing) {
+    LONG lHead = pRing->lHead;
+    LONG lTail = ReadAcquire(&pRing->lTail);
+
+    if ((ULONG)lHead - (ULONG)lTail >= (ULONG)pRing->lCapacity) {
+        return NULL;
+    }
+    return pRing->pucStorage + (size_t)(lHead & pRing->lMask) * pRing->uElemSize;
+}
+
+// 发布 SpscRingReserve 取得的槽
+void SpscRingCommit(stSpscRing* pRing) {
+    WriteRelease(&pRing->lHead, (LONG)((ULONG)pRing->lHead + 1));
+}
+
+// 消费者一次读取至多 lMaxCount 个元素 (按顺序连续写入 pElems), 读完后一次释放槽位; 返回读取的个数
+LONG SpscRingPopBatch(stSpscRing* pRing, void* pElems, LONG lMaxCount) {
+    LONG lTail = pRing->lTail;
+    LONG lHead = ReadAcquire(&pRing->lHead);
+    LONG lCount = (LONG)((ULONG)lHead - (ULONG)lTail);
+
+    if (lCount > lMaxCount) {
+        lCount = lMaxCount;
+    }
+    if (lCount <= 0) {
+        return 0;
+    }
+
+    // 存储区末尾回绕时分两段复制
+    LONG lStart = lTail & pRing->lMask;
+    LONG lFirst = pRing->lCapacity - lStart;
+    if (lFirst > lCount) {
+        lFirst = lCount;
+    }
+    memcpy(pElems, pRing->pucStorage + (size_t)lStart * pRing->uElemSize, (size_t)lFirst * pRing->uElemSize);
+    if (lCount > lFirst) {
+        memcpy((unsigned char*)pElems + (size_t)lFirst * pRing->uElemSize, pRing->pucStorage,
+               (size_t)(lCount - lFirst) * pRing->uElemSize);
+    }
+
+    WriteRelease(&pRing->lTail, (LONG)((ULONG)lTail + (ULONG)lCount));
+    return lCount;
+}
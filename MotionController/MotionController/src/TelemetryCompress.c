@@ -0,0 +1,502 @@
+#include "TelemetryCompress.h"
+#include <string.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+typedef char TelemetryGroupHeaderSizeCheck[(sizeof(stTelemetryGroupHeader) == 24) ? 1 : -1];
+
+// 通道在记录内的位置
+typedef struct {
+    uint32_t uOffset;
+    int iType;
+} stTelemetryChannel;
+
+// 位写入器 (高位在前); pucOut 为 NULL 时只统计位数
+typedef struct {
+    unsigned char* pucOut;
+    uint64_t ullAcc;
+    int iBits;                  // 累加器中尚未写出的位数 (< 8)
+    size_t uBits;               // 已写入的总位数
+} stBitWriter;
+
+// 位读取器 (读过块末尾时置 bOverrun, 按 0 补齐)
+typedef struct {
+    const unsigned char* pucIn;
+    const unsigned char* pucEnd;
+    uint64_t ullAcc;
+    int iBits;
+    int bOverrun;
+} stBitReader;
+
+// 前导零/末尾零个数 (ullValue != 0)
+static int TelemetryClz64(uint64_t ullValue) {
+#if defined(_MSC_VER)
+    unsigned long ulIndex;
+    if (ullValue >> 32) {
+        _BitScanReverse(&ulIndex, (unsigned long)(ullValue >> 32));
+        return 31 - (int)ulIndex;
+    }
+    _BitScanReverse(&ulIndex, (unsigned long)ullValue);
+    return 63 - (int)ulIndex;
+#else
+    return __builtin_clzll(ullValue);
+#endif
+}
+
+static int TelemetryCtz64(uint64_t ullValue) {
+#if defined(_MSC_VER)
+    unsigned long ulIndex;
+    if ((uint32_t)ullValue) {
+        _BitScanForward(&ulIndex, (unsigned long)ullValue);
+        return (int)ulIndex;
+    }
+    _BitScanForward(&ulIndex, (unsigned long)(ullValue >> 32));
+    return 32 + (int)ulIndex;
+#else
+    return __builtin_ctzll(ullValue);
+#endif
+}
+
+static void BitPut32(stBitWriter* pWriter, uint32_t uValue, int iBits) {
+    pWriter->ullAcc = (pWriter->ullAcc << iBits) | uValue;
+    pWriter->iBits += iBits;
+    while (pWriter->iBits >= 8) {
+        pWriter->iBits -= 8;
+        *pWriter->pucOut++ = (unsigned char)(pWriter->ullAcc >> pWriter->iBits);
+    }
+}
+
+// 写入 ullValue 的低 iBits 位 (0..64, 其余位须为 0)
+static void BitPut(stBitWriter* pWriter, uint64_t ullValue, int iBits) {
+    pWriter->uBits += (size_t)iBits;
+    if (pWriter->pucOut == NULL) {
+        return;
+    }
+    if (iBits > 32) {
+        BitPut32(pWriter, (uint32_t)(ullValue >> 32), iBits - 32);
+        iBits = 32;
+    }
+    BitPut32(pWriter, (uint32_t)ullValue, iBits);
+}
+
+// 写出最后不足一字节的位 (低位补 0)
+static void BitFlush(stBitWriter* pWriter) {
+    if (pWriter->pucOut != NULL && pWriter->iBits > 0) {
+        *pWriter->pucOut++ = (unsigned char)(pWriter->ullAcc << (8 - pWriter->iBits));
+        pWriter->iBits = 0;
+    }
+}
+
+static uint32_t BitGet32(stBitReader* pReader, int iBits) {
+    while (pReader->iBits < iBits) {
+        uint32_t uByte = 0;
+        if (pReader->pucIn < pReader->pucEnd) {
+            uByte = *pReader->pucIn++;
+        } else {
+            pReader->bOverrun = 1;
+        }
+        pReader->ullAcc = (pReader->ullAcc << 8) | uByte;
+        pReader->iBits += 8;
+    }
+    pReader->iBits -= iBits;
+    return (uint32_t)((pReader->ullAcc >> pReader->iBits) & (((uint64_t)1 << iBits) - 1));
+}
+
+// 读取 iBits 位 (0..64)
+static uint64_t BitGet(stBitReader* pReader, int iBits) {
+    if (iBits > 32) {
+        uint64_t ullHigh = BitGet32(pReader, iBits - 32);
+        return (ullHigh << 32) | BitGet32(pReader, 32);
+    }
+    return BitGet32(pReader, iBits);
+}
+
+// 列出各通道 (列顺序, 列内元素顺序), 返回通道数; 超过 TELEMETRY_CHANNEL_MAX 返回 -1
+static int TelemetryListChannels(const stTelemetryHeader* pHeader, stTelemetryChannel* pChannels) {
+    int iCount = 0;
+    for (uint32_t i = 0; i < pHeader->uColumnCount; i++) {
+        const stTelemetryColumn* pColumn = &pHeader->astColumn[i];
+        uint32_t uElemSize = (uint32_t)TelemetryTypeSize(pColumn->ucType);
+        if (iCount + pColumn->usCount > TELEMETRY_CHANNEL_MAX) {
+            return -1;
+        }
+        for (uint32_t k = 0; k < pColumn->usCount; k++) {
+            pChannels[iCount].uOffset = pColumn->uOffset + uElemSize * k;
+            pChannels[iCount].iType = pColumn->ucType;
+            iCount++;
+        }
+    }
+    return iCount;
+}
+
+// 通道总数 (各列元素数之和), 超过 TELEMETRY_CHANNEL_MAX 返回 -1
+int TelemetryChannelCount(const stTelemetryHeader* pHeader) {
+    int iCount = 0;
+    for (uint32_t i = 0; i < pHeader->uColumnCount; i++) {
+        iCount += pHeader->astColumn[i].usCount;
+    }
+    return (iCount <= TELEMETRY_CHANNEL_MAX) ? iCount : -1;
+}
+
+// 第 iColumn 列第 iIndex 个元素的通道号, 超出范围返回 -1
+int TelemetryChannelIndex(const stTelemetryHeader* pHeader, int iColumn, int iIndex) {
+    int iChannel = 0;
+    if (iColumn < 0 || (uint32_t)iColumn >= pHeader->uColumnCount || iIndex < 0 ||
+        iIndex >= pHeader->astColumn[iColumn].usCount) {
+        return -1;
+    }
+    for (int i = 0; i < iColumn; i++) {
+        iChannel += pHeader->astColumn[i].usCount;
+    }
+    return iChannel + iIndex;
+}
+
+// uRecordCount 条记录压缩后一组的最大字节数 (输出缓冲区大小)
+size_t TelemetryGroupMaxBytes(const stTelemetryHeader* pHeader, uint32_t uRecordCount) {
+    int iChannels = TelemetryChannelCount(pHeader);
+    if (iChannels < 0) {
+        return 0;
+    }
+    return TELEMETRY_GROUP_MAX_BYTES(iChannels, uRecordCount);
+}
+
+// 取出一个通道的值 (整数符号扩展为 64 位)
+static void TelemetryLoadChannel(const stTelemetryHeader* pHeader, const unsigned char* pucRecords, uint32_t uCount,
+                                 const stTelemetryChannel* pChannel, uint64_t* pullValues) {
+    const unsigned char* p = pucRecords + pChannel->uOffset;
+    for (uint32_t i = 0; i < uCount; i++, p += pHeader->uRecordSize) {
+        if (pChannel->iType == TELEMETRY_TYPE_F64) {
+            memcpy(&pullValues[i], p, sizeof(uint64_t));
+        } else {
+            int32_t iValue;
+            memcpy(&iValue, p, sizeof(iValue));
+            pullValues[i] = (uint64_t)(int64_t)iValue;
+        }
+    }
+}
+
+static void TelemetryStoreChannel(const stTelemetryHeader* pHeader, unsigned char* pucRecords, uint32_t uCount,
+                                  const stTelemetryChannel* pChannel, const uint64_t* pullValues) {
+    unsigned char* p = pucRecords + pChannel->uOffset;
+    for (uint32_t i = 0; i < uCount; i++, p += pHeader->uRecordSize) {
+        if (pChannel->iType == TELEMETRY_TYPE_F64) {
+            memcpy(p, &pullValues[i], sizeof(uint64_t));
+        } else {
+            int32_t iValue = (int32_t)(uint32_t)pullValues[i];
+            memcpy(p, &iValue, sizeof(iValue));
+        }
+    }
+}
+
+static int TelemetryFirstBits(int iType) {
+    return (iType == TELEMETRY_TYPE_F64) ? 64 : 32;
+}
+
+static uint64_t TelemetryFirstMask(int iType) {
+    return (iType == TELEMETRY_TYPE_F64) ? ~(uint64_t)0 : 0xFFFFFFFFULL;
+}
+
+// XOR 编码 (Gorilla)
+static void TelemetryEncodeXor(stBitWriter* pWriter, const uint64_t* pullValues, uint32_t uCount, int iType) {
+    int iLead = -1, iTrail = 0;
+    BitPut(pWriter, pullValues[0] & TelemetryFirstMask(iType), TelemetryFirstBits(iType));
+    for (uint32_t i = 1; i < uCount; i++) {
+        uint64_t ullXor = pullValues[i] ^ pullValues[i - 1];
+        if (ullXor == 0) {
+            BitPut(pWriter, 0, 1);
+            continue;
+        }
+        int iNewLead = TelemetryClz64(ullXor);
+        int iNewTrail = TelemetryCtz64(ullXor);
+        if (iNewLead > 31) {
+            iNewLead = 31;
+        }
+        if (iLead >= 0 && iNewLead >= iLead && iNewTrail >= iTrail) {
+            BitPut(pWriter, 2, 2);
+            BitPut(pWriter, ullXor >> iTrail, 64 - iLead - iTrail);
+        } else {
+            int iSignificant = 64 - iNewLead - iNewTrail;
+            iLead = iNewLead;
+            iTrail = iNewTrail;
+            BitPut(pWriter, 3, 2);
+            BitPut(pWriter, (uint64_t)iLead, 5);
+            BitPut(pWriter, (uint64_t)(iSignificant - 1), 6);
+            BitPut(pWriter, ullXor >> iTrail, iSignificant);
+        }
+    }
+}
+
+// DOD 编码: 预测 2·x[n-1] - x[n-2] (第二个值预测为首值), 残差 zigzag 后变长写入
+static void TelemetryEncodeDod(stBitWriter* pWriter, const uint64_t* pullValues, uint32_t uCount, int iType) {
+    BitPut(pWriter, pullValues[0] & TelemetryFirstMask(iType), TelemetryFirstBits(iType));
+    for (uint32_t i = 1; i < uCount; i++) {
+        uint64_t ullPredict = pullValues[i - 1];
+        if (i >= 2) {
+            ullPredict += pullValues[i - 1] - pullValues[i - 2];
+        }
+        uint64_t ullDelta = pullValues[i] - ullPredict;
+        uint64_t ullZigzag = (ullDelta << 1) ^ (0 - (ullDelta >> 63));
+        if (ullZigzag == 0) {
+            BitPut(pWriter, 0, 1);
+        } else if (ullZigzag < (1U << 3)) {
+            BitPut(pWriter, 2, 2);
+            BitPut(pWriter, ullZigzag, 3);
+        } else if (ullZigzag < (1U << 7)) {
+            BitPut(pWriter, 6, 3);
+            BitPut(pWriter, ullZigzag, 7);
+        } else if (ullZigzag < (1U << 12)) {
+            BitPut(pWriter, 14, 4);
+            BitPut(pWriter, ullZigzag, 12);
+        } else {
+            int iBits = 64 - TelemetryClz64(ullZigzag);
+            BitPut(pWriter, 15, 4);
+            BitPut(pWriter, (uint64_t)(iBits - 1), 6);
+            BitPut(pWriter, ullZigzag, iBits);
+        }
+    }
+}
+
+// 解码一块 (块首字节为编码), 数据不符或越过块末尾返回 -1
+static int TelemetryDecodeBlock(const unsigned char* pucBlock, const unsigned char* pucEnd, int iType, uint32_t uCount,
+                                uint64_t* pullValues) {
+    stBitReader stReader;
+    if (pucBlock >= pucEnd) {
+        return -1;
+    }
+    int iCodec = *pucBlock++;
+    memset(&stReader, 0, sizeof(stReader));
+    stReader.pucIn = pucBlock;
+    stReader.pucEnd = pucEnd;
+
+    pullValues[0] = BitGet(&stReader, TelemetryFirstBits(iType));
+    if (iType != TELEMETRY_TYPE_F64) {
+        pullValues[0] = (uint64_t)(int64_t)(int32_t)(uint32_t)pullValues[0];
+    }
+    if (iCodec == TELEMETRY_CODEC_XOR) {
+        int iLead = 0, iTrail = 0;
+        for (uint32_t i = 1; i < uCount; i++) {
+            uint64_t ullXor = 0;
+            if (BitGet32(&stReader, 1)) {
+                if (BitGet32(&stReader, 1)) {
+                    iLead = (int)BitGet32(&stReader, 5);
+                    int iSignificant = (int)BitGet32(&stReader, 6) + 1;
+                    if (iLead + iSignificant > 64) {
+                        return -1;
+                    }
+                    iTrail = 64 - iLead - iSignificant;
+                }
+                ullXor = BitGet(&stReader, 64 - iLead - iTrail) << iTrail;
+            }
+            pullValues[i] = pullValues[i - 1] ^ ullXor;
+        }
+    } else if (iCodec == TELEMETRY_CODEC_DOD) {
+        for (uint32_t i = 1; i < uCount; i++) {
+            uint64_t ullZigzag = 0;
+            if (BitGet32(&stReader, 1)) {
+                if (!BitGet32(&stReader, 1)) {
+                    ullZigzag = BitGet32(&stReader, 3);
+                } else if (!BitGet32(&stReader, 1)) {
+                    ullZigzag = BitGet32(&stReader, 7);
+                } else if (!BitGet32(&stReader, 1)) {
+                    ullZigzag = BitGet32(&stReader, 12);
+                } else {
+                    ullZigzag = BitGet(&stReader, (int)BitGet32(&stReader, 6) + 1);
+                }
+            }
+            uint64_t ullPredict = pullValues[i - 1];
+            if (i >= 2) {
+                ullPredict += pullValues[i - 1] - pullValues[i - 2];
+            }
+            pullValues[i] = ullPredict + ((ullZigzag >> 1) ^ (0 - (ullZigzag & 1)));
+        }
+    } else {
+        return -1;
+    }
+    return stReader.bOverrun ? -1 : 0;
+}
+
+// 将 uRecordCount (1 .. TELEMETRY_GROUP_RECORDS) 条定长记录压缩为一组, 返回组字节数 (参数无效返回 0);
+// pucOut 至少 TelemetryGroupMaxBytes(pHeader, uRecordCount) 字节
+size_t TelemetryCompressGroup(const stTelemetryHeader* pHeader, const unsigned char* pucRecords, uint32_t uRecordCount,
+                              uint64_t ullFirstRecord, unsigned char* pucOut) {
+    stTelemetryChannel astChannel[TELEMETRY_CHANNEL_MAX];
+    uint64_t aullValues[TELEMETRY_GROUP_RECORDS];
+    stTelemetryGroupHeader stGroup;
+    int iChannels = TelemetryListChannels(pHeader, astChannel);
+    if (iChannels <= 0 || uRecordCount == 0 || uRecordCount > TELEMETRY_GROUP_RECORDS) {
+        return 0;
+    }
+
+    size_t uPos = sizeof(stGroup) + sizeof(uint32_t) * (size_t)iChannels;
+    for (int c = 0; c < iChannels; c++) {
+        stBitWriter stCount, stWriter;
+        uint32_t uOffset = (uint32_t)uPos;
+        TelemetryLoadChannel(pHeader, pucRecords, uRecordCount, &astChannel[c], aullValues);
+
+        // 两种编码先只计算位数, 再按较小者写出
+        memset(&stCount, 0, sizeof(stCount));
+        TelemetryEncodeXor(&stCount, aullValues, uRecordCount, astChannel[c].iType);
+        size_t uXorBits = stCount.uBits;
+        memset(&stCount, 0, sizeof(stCount));
+        TelemetryEncodeDod(&stCount, aullValues, uRecordCount, astChannel[c].iType);
+        int iCodec = (stCount.uBits <= uXorBits) ? TELEMETRY_CODEC_DOD : TELEMETRY_CODEC_XOR;
+
+        memcpy(pucOut + sizeof(stGroup) + sizeof(uint32_t) * (size_t)c, &uOffset, sizeof(uOffset));
+        pucOut[uPos++] = (unsigned char)iCodec;
+        memset(&stWriter, 0, sizeof(stWriter));
+        stWriter.pucOut = pucOut + uPos;
+        if (iCodec == TELEMETRY_CODEC_DOD) {
+            TelemetryEncodeDod(&stWriter, aullValues, uRecordCount, astChannel[c].iType);
+        } else {
+            TelemetryEncodeXor(&stWriter, aullValues, uRecordCount, astChannel[c].iType);
+        }
+        BitFlush(&stWriter);
+        uPos = (size_t)(stWriter.pucOut - pucOut);
+    }
+
+    stGroup.uMagic = TELEMETRY_GROUP_MAGIC;
+    stGroup.uRecordCount = uRecordCount;
+    stGroup.ullFirstRecord = ullFirstRecord;
+    stGroup.uGroupBytes = (uint32_t)uPos;
+    stGroup.uChannelCount = (uint32_t)iChannels;
+    memcpy(pucOut, &stGroup, sizeof(stGroup));
+    return uPos;
+}
+
+// 检查 uBytes 字节的一组: 标识、记录数、通道数与通道块偏移, 不符返回 -1
+int TelemetryCheckGroup(const stTelemetryHeader* pHeader, const unsigned char* pucGroup, size_t uBytes) {
+    stTelemetryGroupHeader stGroup;
+    if (uBytes < sizeof(stGroup)) {
+        return -1;
+    }
+    memcpy(&stGroup, pucGroup, sizeof(stGroup));
+    size_t uDirectoryEnd = sizeof(stGroup) + sizeof(uint32_t) * (size_t)stGroup.uChannelCount;
+    if (stGroup.uMagic != TELEMETRY_GROUP_MAGIC || stGroup.uRecordCount == 0 ||
+        stGroup.uRecordCount > TELEMETRY_GROUP_RECORDS || stGroup.uGroupBytes != uBytes ||
+        (int)stGroup.uChannelCount != TelemetryChannelCount(pHeader) || uDirectoryEnd > uBytes) {
+        return -1;
+    }
+    size_t uPrevious = uDirectoryEnd;
+    for (uint32_t c = 0; c < stGroup.uChannelCount; c++) {
+        uint32_t uOffset;
+        memcpy(&uOffset, pucGroup + sizeof(stGroup) + sizeof(uint32_t) * c, sizeof(uOffset));
+        if (uOffset < uPrevious || uOffset >= uBytes) {
+            return -1;
+        }
+        uPrevious = uOffset;
+    }
+    return 0;
+}
+
+// 第 iChannel 块的起止位置
+static void TelemetryBlockRange(const unsigned char* pucGroup, int iChannel, const unsigned char** ppucBlock,
+                                const unsigned char** ppucEnd) {
+    stTelemetryGroupHeader stGroup;
+    uint32_t uOffset, uEnd;
+    memcpy(&stGroup, pucGroup, sizeof(stGroup));
+    memcpy(&uOffset, pucGroup + sizeof(stGroup) + sizeof(uint32_t) * (size_t)iChannel, sizeof(uOffset));
+    uEnd = stGroup.uGroupBytes;
+    if ((uint32_t)iChannel + 1 < stGroup.uChannelCount) {
+        memcpy(&uEnd, pucGroup + sizeof(stGroup) + sizeof(uint32_t) * (size_t)(iChannel + 1), sizeof(uEnd));
+    }
+    *ppucBlock = pucGroup + uOffset;
+    *ppucEnd = pucGroup + uEnd;
+}
+
+// 解压一组 (已经 TelemetryCheckGroup 检查) 到定长记录, 返回记录数; 数据不符返回 -1
+// pucRecords 至少 组内记录数 × uRecordSize 字节
+int TelemetryDecompressGroup(const stTelemetryHeader* pHeader, const unsigned char* pucGroup,
+                             unsigned char* pucRecords) {
+    stTelemetryChannel astChannel[TELEMETRY_CHANNEL_MAX];
+    uint64_t aullValues[TELEMETRY_GROUP_RECORDS];
+    stTelemetryGroupHeader stGroup;
+    int iChannels = TelemetryListChannels(pHeader, astChannel);
+    memcpy(&stGroup, pucGroup, sizeof(stGroup));
+    if (iChannels < 0) {
+        return -1;
+    }
+    for (int c = 0; c < iChannels; c++) {
+        const unsigned char *pucBlock, *pucEnd;
+        TelemetryBlockRange(pucGroup, c, &pucBlock, &pucEnd);
+        if (TelemetryDecodeBlock(pucBlock, pucEnd, astChannel[c].iType, stGroup.uRecordCount, aullValues) != 0) {
+            return -1;
+        }
+        TelemetryStoreChannel(pHeader, pucRecords, stGroup.uRecordCount, &astChannel[c], aullValues);
+    }
+    return (int)stGroup.uRecordCount;
+}
+
+// 只解码一组 (已检查) 中的一个通道 (整数转为 double), 返回记录数; 数据不符返回 -1
+// pdOut 至少 组内记录数 个元素
+int TelemetryDecodeChannel(const stTelemetryHeader* pHeader, const unsigned char* pucGroup, int iChannel,
+                           double* pdOut) {
+    stTelemetryChannel astChannel[TELEMETRY_CHANNEL_MAX];
+    uint64_t aullValues[TELEMETRY_GROUP_RECORDS];
+    stTelemetryGroupHeader stGroup;
+    const unsigned char *pucBlock, *pucEnd;
+    int iChannels = TelemetryListChannels(pHeader, astChannel);
+    memcpy(&stGroup, pucGroup, sizeof(stGroup));
+    if (iChannel < 0 || iChannel >= iChannels) {
+        return -1;
+    }
+    TelemetryBlockRange(pucGroup, iChannel, &pucBlock, &pucEnd);
+    if (TelemetryDecodeBlock(pucBlock, pucEnd, astChannel[iChannel].iType, stGroup.uRecordCount, aullValues) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < stGroup.uRecordCount; i++) {
+        if (astChannel[iChannel].iType == TELEMETRY_TYPE_F64) {
+            memcpy(&pdOut[i], &aullValues[i], sizeof(double));
+        } else {
+            pdOut[i] = (double)(int32_t)(uint32_t)aullValues[i];
+        }
+    }
+    return (int)stGroup.uRecordCount;
+}
+
+typedef char TelemetryIndexTrailerSizeCheck[(sizeof(stTelemetryIndexTrailer) == 32) ? 1 : -1];
+
+// 清空写入端组索引
+void TelemetryIndexInit(stTelemetryIndexBuilder* pIndex) {
+    pIndex->uCount = 0;
+    pIndex->uStride = 1;
+    pIndex->ullGroups = 0;
+}
+
+// 登记一组 (按写入顺序调用): 组号为 uStride 的倍数时记录; 条目满时隔一删一并加倍间隔, 索引大小不随文件增长
+void TelemetryIndexAdd(stTelemetryIndexBuilder* pIndex, uint64_t ullFirstRecord, uint64_t ullOffset) {
+    uint64_t ullGroup = pIndex->ullGroups++;
+    if (ullGroup % pIndex->uStride != 0) {
+        return;
+    }
+    if (pIndex->uCount == TELEMETRY_INDEX_MAX) {
+        for (uint32_t i = 0; i < TELEMETRY_INDEX_MAX / 2; i++) {
+            pIndex->astEntry[i] = pIndex->astEntry[2 * i];
+        }
+        pIndex->uCount = TELEMETRY_INDEX_MAX / 2;
+        pIndex->uStride *= 2;
+        if (ullGroup % pIndex->uStride != 0) {
+            return;
+        }
+    }
+    pIndex->astEntry[pIndex->uCount].ullFirstRecord = ullFirstRecord;
+    pIndex->astEntry[pIndex->uCount].ullOffset = ullOffset;
+    pIndex->uCount++;
+}
+
+// 在 ullIndexOffset (最后一组之后, 即当前文件末尾) 写出索引条目与尾部, 返回写入的字节数, 写入失败返回 -1
+long long TelemetryIndexWrite(const stTelemetryIndexBuilder* pIndex, uint64_t ullIndexOffset, FILE* pFile) {
+    stTelemetryIndexTrailer stTrailer;
+    size_t uBytes = sizeof(stTelemetryIndexEntry) * pIndex->uCount;
+    memset(&stTrailer, 0, sizeof(stTrailer));
+    stTrailer.uMagic = TELEMETRY_INDEX_MAGIC;
+    stTrailer.uEntryCount = pIndex->uCount;
+    stTrailer.uStride = pIndex->uStride;
+    stTrailer.ullIndexOffset = ullIndexOffset;
+    stTrailer.ullGroupCount = pIndex->ullGroups;
+    if (fwrite(pIndex->astEntry, 1, uBytes, pFile) != uBytes ||
+        fwrite(&stTrailer, 1, sizeof(stTrailer), pFile) != sizeof(stTrailer)) {
+        return -1;
+    }
+    return (long long)(uBytes + sizeof(stTrailer));
+}
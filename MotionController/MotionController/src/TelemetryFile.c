@@ -0,0 +1,351 @@
+#include "TelemetryFile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <share.h>
+#include "TelemetryCompress.h"
+
+typedef char TelemetryHeaderSizeCheck[(sizeof(stTelemetryHeader) == TELEMETRY_HEADER_SIZE) ? 1 : -1];
+
+// 列数据类型的元素字节数, 未知类型返回 0
+int TelemetryTypeSize(int iType) {
+    switch (iType) {
+        case TELEMETRY_TYPE_I32: return 4;
+        case TELEMETRY_TYPE_F64: return 8;
+        default: return 0;
+    }
+}
+
+static void TelemetryAddColumn(stTelemetryHeader* pHeader, const char* pszName, uint8_t ucType, int bPerAxis) {
+    stTelemetryColumn* pColumn = &pHeader->astColumn[pHeader->uColumnCount++];
+    strncpy_s(pColumn->acName, TELEMETRY_NAME_CHARS, pszName, _TRUNCATE);
+    pColumn->ucType = ucType;
+    pColumn->ucFlags = bPerAxis ? TELEMETRY_COLUMN_PER_AXIS : 0;
+    pColumn->usCount = bPerAxis ? (uint16_t)pHeader->uAxisCount : 1;
+    pColumn->uOffset = pHeader->uRecordSize;
+    pHeader->uRecordSize += (uint32_t)TelemetryTypeSize(ucType) * pColumn->usCount;
+}
+
+// 生成控制数据记录的头部 (标准列见 TELEMETRY_COL_*), 轴数超出范围返回 -1; 采集开始时刻由调用者填写
+int TelemetryHeaderInit(stTelemetryHeader* pHeader, int iAxisCount, double dSampleTime) {
+    if (iAxisCount < 1 || iAxisCount > MAX_AXIS_COUNT) {
+        return -1;
+    }
+    memset(pHeader, 0, sizeof(*pHeader));
+    pHeader->uMagic = TELEMETRY_MAGIC;
+    pHeader->usVersion = TELEMETRY_VERSION;
+    pHeader->usHeaderSize = TELEMETRY_HEADER_SIZE;
+    pHeader->uAxisCount = (uint32_t)iAxisCount;
+    pHeader->dSampleTime = dSampleTime;
+
+    TelemetryAddColumn(pHeader, "time", TELEMETRY_TYPE_F64, 0);
+    TelemetryAddColumn(pHeader, "target", TELEMETRY_TYPE_F64, 1);
+    TelemetryAddColumn(pHeader, "actual", TELEMETRY_TYPE_F64, 1);
+    TelemetryAddColumn(pHeader, "error", TELEMETRY_TYPE_F64, 1);
+    TelemetryAddColumn(pHeader, "force", TELEMETRY_TYPE_F64, 1);
+    TelemetryAddColumn(pHeader, "step", TELEMETRY_TYPE_I32, 0);
+    TelemetryAddColumn(pHeader, "mode", TELEMETRY_TYPE_I32, 1);
+    return 0;
+}
+
+// 检查头部: 标识、版本、标记、各列类型与是否落在记录内, 不符返回 -1
+int TelemetryHeaderCheck(const stTelemetryHeader* pHeader) {
+    if (pHeader->uMagic != TELEMETRY_MAGIC || pHeader->usVersion != TELEMETRY_VERSION ||
+        (pHeader->uFlags & ~TELEMETRY_FLAG_COMPRESSED) != 0 ||
+        pHeader->usHeaderSize != TELEMETRY_HEADER_SIZE || pHeader->uAxisCount < 1 ||
+        pHeader->uAxisCount > MAX_AXIS_COUNT || pHeader->uColumnCount < 1 ||
+        pHeader->uColumnCount > TELEMETRY_MAX_COLUMNS || pHeader->uRecordSize == 0 || !(pHeader->dSampleTime > 0.0)) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < pHeader->uColumnCount; i++) {
+        const stTelemetryColumn* pColumn = &pHeader->astColumn[i];
+        uint32_t uElemSize = (uint32_t)TelemetryTypeSize(pColumn->ucType);
+        if (uElemSize == 0 || pColumn->usCount == 0 || pColumn->acName[TELEMETRY_NAME_CHARS - 1] != '\0' ||
+            ((pColumn->ucFlags & TELEMETRY_COLUMN_PER_AXIS) && pColumn->usCount != pHeader->uAxisCount) ||
+            (uint64_t)pColumn->uOffset + (uint64_t)uElemSize * pColumn->usCount > pHeader->uRecordSize) {
+            return -1;
+        }
+    }
+    if ((pHeader->uFlags & TELEMETRY_FLAG_COMPRESSED) && TelemetryChannelCount(pHeader) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// 按名称查找列, 未找到返回 -1
+int TelemetryFindColumn(const stTelemetryHeader* pHeader, const char* pszName) {
+    for (uint32_t i = 0; i < pHeader->uColumnCount; i++) {
+        if (strcmp(pHeader->astColumn[i].acName, pszName) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// 读取一条记录中某列的第 iIndex 个元素 (整数列转为 double)
+double TelemetryGetValue(const stTelemetryHeader* pHeader, const unsigned char* pucRecord, int iColumn, int iIndex) {
+    const stTelemetryColumn* pColumn = &pHeader->astColumn[iColumn];
+    const unsigned char* p = pucRecord + pColumn->uOffset + (size_t)TelemetryTypeSize(pColumn->ucType) * (size_t)iIndex;
+    if (pColumn->ucType == TELEMETRY_TYPE_F64) {
+        double dValue;
+        memcpy(&dValue, p, sizeof(dValue));
+        return dValue;
+    }
+    int32_t iValue;
+    memcpy(&iValue, p, sizeof(iValue));
+    return (double)iValue;
+}
+
+// 记住一个组起点 (只追加在已知组起点之后的组); 内存不足时不记, 只影响定位速度
+static void TelemetryReaderRemember(stTelemetryReader* pReader, uint64_t ullFirstRecord, uint64_t ullOffset) {
+    if (pReader->uIndexCount > 0 && pReader->pstIndex[pReader->uIndexCount - 1].ullOffset >= ullOffset) {
+        return;
+    }
+    if (pReader->uIndexCount == pReader->uIndexCapacity) {
+        uint32_t uCapacity = pReader->uIndexCapacity ? pReader->uIndexCapacity * 2 : 256;
+        stTelemetryIndexEntry* pstIndex =
+            (stTelemetryIndexEntry*)realloc(pReader->pstIndex, sizeof(stTelemetryIndexEntry) * uCapacity);
+        if (pstIndex == NULL) {
+            return;
+        }
+        pReader->pstIndex = pstIndex;
+        pReader->uIndexCapacity = uCapacity;
+    }
+    pReader->pstIndex[pReader->uIndexCount].ullFirstRecord = ullFirstRecord;
+    pReader->pstIndex[pReader->uIndexCount].ullOffset = ullOffset;
+    pReader->uIndexCount++;
+}
+
+// 读取文件末尾的组索引; 没有索引 (仍在写入或异常结束) 或索引不符时不使用, 按组头部顺序定位
+static void TelemetryReaderLoadIndex(stTelemetryReader* pReader) {
+    stTelemetryIndexTrailer stTrailer;
+    if (_fseeki64(pReader->pFile, 0, SEEK_END) != 0) {
+        return;
+    }
+    long long llSize = _ftelli64(pReader->pFile);
+    if (llSize < (long long)(TELEMETRY_HEADER_SIZE + sizeof(stTrailer)) ||
+        _fseeki64(pReader->pFile, llSize - (long long)sizeof(stTrailer), SEEK_SET) != 0 ||
+        fread(&stTrailer, 1, sizeof(stTrailer), pReader->pFile) != sizeof(stTrailer) ||
+        stTrailer.uMagic != TELEMETRY_INDEX_MAGIC || stTrailer.uEntryCount == 0 || stTrailer.uStride == 0 ||
+        stTrailer.ullIndexOffset < TELEMETRY_HEADER_SIZE ||
+        stTrailer.ullIndexOffset + (uint64_t)stTrailer.uEntryCount * sizeof(stTelemetryIndexEntry) +
+            sizeof(stTrailer) != (uint64_t)llSize) {
+        return;
+    }
+    stTelemetryIndexEntry* pstIndex =
+        (stTelemetryIndexEntry*)malloc(sizeof(stTelemetryIndexEntry) * stTrailer.uEntryCount);
+    if (pstIndex == NULL) {
+        return;
+    }
+    int bValid = _fseeki64(pReader->pFile, (long long)stTrailer.ullIndexOffset, SEEK_SET) == 0 &&
+                 fread(pstIndex, sizeof(stTelemetryIndexEntry), stTrailer.uEntryCount, pReader->pFile) ==
+                     stTrailer.uEntryCount &&
+                 pstIndex[0].ullOffset == TELEMETRY_HEADER_SIZE;
+    for (uint32_t i = 1; bValid && i < stTrailer.uEntryCount; i++) {
+        bValid = pstIndex[i].ullFirstRecord > pstIndex[i - 1].ullFirstRecord &&
+                 pstIndex[i].ullOffset > pstIndex[i - 1].ullOffset &&
+                 pstIndex[i].ullOffset < stTrailer.ullIndexOffset;
+    }
+    if (!bValid) {
+        free(pstIndex);
+        clearerr(pReader->pFile);
+        return;
+    }
+    pReader->pstIndex = pstIndex;
+    pReader->uIndexCount = stTrailer.uEntryCount;
+    pReader->uIndexCapacity = stTrailer.uEntryCount;
+    pReader->uIndexStride = stTrailer.uStride;
+    pReader->ullDataEnd = stTrailer.ullIndexOffset;
+}
+
+// 首记录序号 <= ullRecord 的最后一个已知组起点的偏移 (二分查找), 无已知组起点时为第一组
+static uint64_t TelemetryReaderFindGroup(const stTelemetryReader* pReader, uint64_t ullRecord) {
+    uint32_t uLow = 0, uHigh = pReader->uIndexCount;
+    while (uLow < uHigh) {
+        uint32_t uMid = (uLow + uHigh) / 2;
+        if (pReader->pstIndex[uMid].ullFirstRecord <= ullRecord) {
+            uLow = uMid + 1;
+        } else {
+            uHigh = uMid;
+        }
+    }
+    return uLow > 0 ? pReader->pstIndex[uLow - 1].ullOffset : TELEMETRY_HEADER_SIZE;
+}
+
+// 打开文件并读取头部; 文件不存在、头部尚未写完或格式不符返回 -1
+// (以共享读写方式打开, 写入端以 _SH_DENYWR 打开时仍可读取)
+int TelemetryReaderOpen(stTelemetryReader* pReader, const char* pszPath) {
+    memset(pReader, 0, sizeof(*pReader));
+    pReader->pFile = _fsopen(pszPath, "rb", _SH_DENYNO);
+    if (pReader->pFile == NULL) {
+        return -1;
+    }
+    if (fread(&pReader->stHeader, 1, sizeof(pReader->stHeader), pReader->pFile) != sizeof(pReader->stHeader) ||
+        TelemetryHeaderCheck(&pReader->stHeader) != 0) {
+        TelemetryReaderClose(pReader);
+        return -1;
+    }
+    if (pReader->stHeader.uFlags & TELEMETRY_FLAG_COMPRESSED) {
+        pReader->ullOffset = TELEMETRY_HEADER_SIZE;
+        pReader->uGroupMaxBytes = TelemetryGroupMaxBytes(&pReader->stHeader, TELEMETRY_GROUP_RECORDS);
+        pReader->pucGroup = (unsigned char*)malloc(pReader->uGroupMaxBytes);
+        pReader->pucRecords = (unsigned char*)malloc((size_t)TELEMETRY_GROUP_RECORDS * pReader->stHeader.uRecordSize);
+        if (pReader->pucGroup == NULL || pReader->pucRecords == NULL) {
+            TelemetryReaderClose(pReader);
+            return -1;
+        }
+        TelemetryReaderLoadIndex(pReader);
+        _fseeki64(pReader->pFile, TELEMETRY_HEADER_SIZE, SEEK_SET);
+    }
+    return 0;
+}
+
+// 从 ullOffset 读取一整组到 pucGroup 并检查, 返回组字节数; 组尚未写完或数据不符返回 0
+static size_t TelemetryReadGroup(stTelemetryReader* pReader, uint64_t ullOffset) {
+    stTelemetryGroupHeader stGroup;
+    _fseeki64(pReader->pFile, (long long)ullOffset, SEEK_SET);
+    if (fread(&stGroup, 1, sizeof(stGroup), pReader->pFile) != sizeof(stGroup) ||
+        stGroup.uGroupBytes < sizeof(stGroup) || stGroup.uGroupBytes > pReader->uGroupMaxBytes) {
+        return 0;
+    }
+    memcpy(pReader->pucGroup, &stGroup, sizeof(stGroup));
+    size_t uRest = stGroup.uGroupBytes - sizeof(stGroup);
+    if (fread(pReader->pucGroup + sizeof(stGroup), 1, uRest, pReader->pFile) != uRest ||
+        TelemetryCheckGroup(&pReader->stHeader, pReader->pucGroup, stGroup.uGroupBytes) != 0) {
+        return 0;
+    }
+    return stGroup.uGroupBytes;
+}
+
+// 压缩文件: 当前组读完后读取并解压下一组
+static int TelemetryReaderNextCompressed(stTelemetryReader* pReader, unsigned char* pucRecord) {
+    uint32_t uSize = pReader->stHeader.uRecordSize;
+    if (pReader->uGroupNext >= pReader->uGroupRecords) {
+        if (pReader->ullDataEnd != 0 && pReader->ullOffset >= pReader->ullDataEnd) {
+            return 0;
+        }
+        size_t uBytes = TelemetryReadGroup(pReader, pReader->ullOffset);
+        stTelemetryGroupHeader stGroup;
+        if (uBytes > 0) {
+            memcpy(&stGroup, pReader->pucGroup, sizeof(stGroup));
+        }
+        if (uBytes == 0 || stGroup.ullFirstRecord != pReader->ullRecords ||
+            TelemetryDecompressGroup(&pReader->stHeader, pReader->pucGroup, pReader->pucRecords) < 0) {
+            // 不完整 (或损坏): 清除文件结束标记, 下次从组起点重读
+            clearerr(pReader->pFile);
+            return 0;
+        }
+        TelemetryReaderRemember(pReader, stGroup.ullFirstRecord, pReader->ullOffset);
+        pReader->ullOffset += uBytes;
+        pReader->ullGroups++;
+        pReader->ullStoredBytes += uBytes;
+        pReader->uGroupRecords = stGroup.uRecordCount;
+        pReader->uGroupNext = 0;
+    }
+    memcpy(pucRecord, pReader->pucRecords + (size_t)pReader->uGroupNext * uSize, uSize);
+    pReader->uGroupNext++;
+    pReader->ullRecords++;
+    return 1;
+}
+
+// 读取下一条完整记录到 pucRecord (uRecordSize 字节): 成功返回 1, 暂无完整记录返回 0 (文件仍在写入时可稍后重试)
+int TelemetryReaderNext(stTelemetryReader* pReader, unsigned char* pucRecord) {
+    uint32_t uSize = pReader->stHeader.uRecordSize;
+    if (pReader->stHeader.uFlags & TELEMETRY_FLAG_COMPRESSED) {
+        return TelemetryReaderNextCompressed(pReader, pucRecord);
+    }
+    size_t uRead = fread(pucRecord, 1, uSize, pReader->pFile);
+    if (uRead == uSize) {
+        pReader->ullRecords++;
+        return 1;
+    }
+    // 不完整: 回到记录起点, 清除文件结束标记以便继续读取新追加的数据
+    clearerr(pReader->pFile);
+    _fseeki64(pReader->pFile, (long long)TELEMETRY_HEADER_SIZE + (long long)(pReader->ullRecords * uSize), SEEK_SET);
+    return 0;
+}
+
+// 随机读取一个通道: 第 iColumn 列第 iIndex 个元素自第 ullFirst 条记录起的至多 uCount 个值 (整数转为 double),
+// 返回读取的个数 (到达已写入的末尾时较少), 列或元素不存在返回 -1; 不影响 TelemetryReaderNext 的读取位置.
+// 压缩文件经组索引 (文件末尾的索引与读取时经过的组) 二分定位到目标之前最近的已知组, 再按组头部跳过其余不相关的组,
+// 相关的组只解码该通道的块
+int TelemetryReaderReadChannel(stTelemetryReader* pReader, int iColumn, int iIndex, uint64_t ullFirst, uint32_t uCount,
+                               double* pdOut) {
+    const stTelemetryHeader* pHeader = &pReader->stHeader;
+    int iChannel = TelemetryChannelIndex(pHeader, iColumn, iIndex);
+    uint32_t uDone = 0;
+    if (iChannel < 0) {
+        return -1;
+    }
+    long long llPosition = _ftelli64(pReader->pFile);
+
+    if (!(pHeader->uFlags & TELEMETRY_FLAG_COMPRESSED)) {
+        const stTelemetryColumn* pColumn = &pHeader->astColumn[iColumn];
+        size_t uElemSize = (size_t)TelemetryTypeSize(pColumn->ucType);
+        unsigned char aucValue[8];
+        for (; uDone < uCount; uDone++) {
+            long long llOffset = (long long)TELEMETRY_HEADER_SIZE +
+                                 (long long)((ullFirst + uDone) * pHeader->uRecordSize) +
+                                 (long long)(pColumn->uOffset + uElemSize * (size_t)iIndex);
+            if (_fseeki64(pReader->pFile, llOffset, SEEK_SET) != 0 ||
+                fread(aucValue, 1, uElemSize, pReader->pFile) != uElemSize) {
+                break;
+            }
+            if (pColumn->ucType == TELEMETRY_TYPE_F64) {
+                memcpy(&pdOut[uDone], aucValue, sizeof(double));
+            } else {
+                int32_t iValue;
+                memcpy(&iValue, aucValue, sizeof(iValue));
+                pdOut[uDone] = (double)iValue;
+            }
+        }
+    } else {
+        double adValues[TELEMETRY_GROUP_RECORDS];
+        uint64_t ullOffset = TelemetryReaderFindGroup(pReader, ullFirst);
+        while (uDone < uCount) {
+            stTelemetryGroupHeader stGroup;
+            if (pReader->ullDataEnd != 0 && ullOffset >= pReader->ullDataEnd) {
+                break;
+            }
+            _fseeki64(pReader->pFile, (long long)ullOffset, SEEK_SET);
+            if (fread(&stGroup, 1, sizeof(stGroup), pReader->pFile) != sizeof(stGroup) ||
+                stGroup.uMagic != TELEMETRY_GROUP_MAGIC || stGroup.uGroupBytes < sizeof(stGroup)) {
+                break;
+            }
+            TelemetryReaderRemember(pReader, stGroup.ullFirstRecord, ullOffset);
+            uint64_t ullNeed = ullFirst + uDone;
+            uint64_t ullEnd = stGroup.ullFirstRecord + stGroup.uRecordCount;
+            if (ullEnd > ullNeed) {
+                if (stGroup.ullFirstRecord > ullNeed || TelemetryReadGroup(pReader, ullOffset) == 0 ||
+                    TelemetryDecodeChannel(pHeader, pReader->pucGroup, iChannel, adValues) < 0) {
+                    break;
+                }
+                uint32_t uFrom = (uint32_t)(ullNeed - stGroup.ullFirstRecord);
+                uint32_t uTake = stGroup.uRecordCount - uFrom;
+                if (uTake > uCount - uDone) {
+                    uTake = uCount - uDone;
+                }
+                memcpy(pdOut + uDone, adValues + uFrom, sizeof(double) * uTake);
+                uDone += uTake;
+            }
+            ullOffset += stGroup.uGroupBytes;
+        }
+    }
+
+    clearerr(pReader->pFile);
+    _fseeki64(pReader->pFile, llPosition, SEEK_SET);
+    return (int)uDone;
+}
+
+// 关闭文件并释放解压缓冲区 (可重复调用)
+void TelemetryReaderClose(stTelemetryReader* pReader) {
+    if (pReader->pFile != NULL) {
+        fclose(pReader->pFile);
+        pReader->pFile = NULL;
+    }
+    free(pReader->pucGroup);
+    free(pReader->pucRecords);
+    free(pReader->pstIndex);
+    pReader->pstIndex = NULL;
+    pReader->pucGroup = NULL;
+    pReader->pucRecords = NULL;
+}
@@ -8,7 +8,21 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <share.h>
 #include "Socket.h"
+#include "CommandQueue.h"
+#include "PlannerWorker.h"
+#include "PlannerCache.h"
+#include "PlannerPool.h"
+#include "MotionQueue.h"
+#include "OnlineTrajectory.h"
+#include "FeedOverride.h"
+#include "PathInterpolation.h"
+#include "AllocGuard.h"
+#include "ThreadPool.h"
+#include "CSVWriter.h"
+#include "FlightRecorder.h"
 #include "Safety_Faults.h"
 #include "fault_handler.h"     // 故障处理头文件
 #include "log.h"               // 添加日志头文件
@@ -16,11 +30,189 @@
 #include "Controler.h"          // 控制器
 #include "Controlled_Device.h"  // 被控对象
 
+#define ONLINE_STATE_OFF 0      // 参考由规划轨迹给出
+#define ONLINE_STATE_RUNNING 1  // 参考由在线轨迹生成器逐周期给出 (开始时从当前参考立即接管)
+
+#define PATH_STATE_OFF 0        // 无路径插补
+#define PATH_STATE_ARMED 1      // 已开始, 等待参与轴的当前轨迹全部执行完
+#define PATH_STATE_RUNNING 2    // 参与轴的参考由路径插补逐周期给出
+
+#define REPLAY_STATE_OFF 0      // 无文件回放
+#define REPLAY_STATE_LOADING 1  // 规划线程正在打开并映射文件, 完成后检查
+#define REPLAY_STATE_ARMED 2    // 文件已映射并通过检查, 等待参与轴的当前轨迹全部执行完
+#define REPLAY_STATE_RUNNING 3  // 参与轴的参考由轨迹文件逐帧给出
+
 static ControlSystemState g_controlState;
+static int g_iCommandSequence = 0;     // 当前正在处理的指令序列号 (用于异步完成反馈)
+static stPlannerInput g_astStagedInput[MAX_AXIS_COUNT];    // CMD 12 暂存的各轴运动参数 (同步规划输入)
+static uint64_t g_ullStagedMask = 0;                       // 已暂存参数的轴
+static stOnlineTrajectory g_astOnline[MAX_AXIS_COUNT];     // CMD 15 在线轨迹生成 (仅控制线程使用)
+static int g_aiOnlineState[MAX_AXIS_COUNT];                // ONLINE_STATE_*
+static stTrajectoryPoint g_astReference[MAX_AXIS_COUNT];   // 规划轨迹最近一次输出的参考点 (在线轨迹接管用)
+static const stPlannerContext* g_apReferenceContext[MAX_AXIS_COUNT];  // 该参考点所属的上下文
+static stPlannerContext g_astHoldContext[MAX_AXIS_COUNT];  // 退出在线轨迹后停在到位点的零位移轨迹
+static stFeedOverride g_astFeed[MAX_AXIS_COUNT];           // CMD 16 进给倍率 (仅控制线程使用, 作用于规划轨迹)
+static int g_aiFeedGroup[MAX_AXIS_COUNT];                  // 轴所属的倍率组 (组内最低轴号, 状态为 g_astFeed[组号])
+static uint64_t g_aullFeedMask[MAX_AXIS_COUNT];            // 以该轴为组号的组内各轴 (不是组号的轴为 0)
+static stPathInterp g_stPath;                              // CMD 17 多轴路径插补 (仅控制线程使用)
+static int g_iPathState = PATH_STATE_OFF;                  // PATH_STATE_*
+static uint64_t g_ullPathMask = 0;                         // 路径参与轴
+static int g_aiPathSlot[MAX_AXIS_COUNT];                   // 轴在路径参与轴数组中的位置
+static int g_iPathSequence = 0;                            // 启动路径的指令序列号 (完成反馈用)
+static stPlannerInput g_stPathLimits;                      // 路径合成约束
+static double g_adPathTarget[MAX_AXIS_COUNT];              // 直线路径暂存的各轴终点
+static uint64_t g_ullPathStagedMask = 0;                   // 已暂存终点的轴
+
+static int g_iReplayState = REPLAY_STATE_OFF;              // CMD 18 文件回放 REPLAY_STATE_*
+static int g_iReplaySequence = 0;                          // 开始回放的指令序列号 (完成反馈用)
+static int g_bReplayCancelled = 0;                         // 加载中已取消: 打开完成后直接交还关闭
+static char g_szReplayPath[TRAJ_FILE_PATH_CHARS];          // 回放文件 (反馈与日志用)
+static int g_aiReplaySlot[MAX_AXIS_COUNT];                 // 轴在文件帧中的位置
+static const stTrajRecord* g_pReplayFrame = NULL;          // 本周期的回放帧
+
+static stFlightRecorder g_stRecorder;                      // 黑匣子 (最近若干分钟的逐周期轴状态, 仅控制线程写入)
+
+// 轴是否由路径插补占用 (已开始或执行中)
+static int PathOwnsAxis(int iAxis) {
+    return g_iPathState != PATH_STATE_OFF && ((g_ullPathMask >> iAxis) & 1ULL);
+}
+
+// 轴是否由文件回放占用 (已开始或执行中)
+static int ReplayOwnsAxis(int iAxis) {
+    return g_iReplayState != REPLAY_STATE_OFF && ((g_controlState.stReplay.ullAxisMask >> iAxis) & 1ULL);
+}
+
+// 多轴指令完成反馈的轴号: 掩码中最低的轴 (反馈的 axis 为 int, 完整的 64 位掩码写入消息), 空掩码返回 -1
+static int GetMaskFeedbackAxis(uint64_t ullMask) {
+    for (int axis = 0; axis < MAX_AXIS_COUNT; axis++) {
+        if ((ullMask >> axis) & 1ULL) {
+            return axis;
+        }
+    }
+    return -1;
+}
+
+// 轴的当前参考 (位置、速度、加速度): 当前上下文已输出过点时取最近输出点, 尚未输出时取其起点
+static void GetLiveReference(int iAxis, stTrajectoryPoint* pPoint) {
+    const stPlannerContext* pContext = g_controlState.pContext[iAxis];
+    if (g_apReferenceContext[iAxis] == pContext && (pContext->llSampleIndex > 0 || pContext->bIsFinished)) {
+        *pPoint = g_astReference[iAxis];
+    } else {
+        FourthOrderPlannerGetPointAt(pContext, 0.0, pPoint);
+    }
+}
+
+// 轴所属倍率组的状态 (同一组的轴共用一个倍率, 时间基保持同步)
+static stFeedOverride* GetAxisFeed(int iAxis) {
+    return &g_astFeed[g_aiFeedGroup[iAxis]];
+}
+
+// 轴的倍率作用对象 (路径插补执行中为路径, 否则为该轴的当前轨迹)
+static const stPlannerContext* GetFeedContext(int iAxis) {
+    if (g_iPathState == PATH_STATE_RUNNING && PathOwnsAxis(iAxis)) {
+        return &g_stPath.stContext;
+    }
+    return g_controlState.pContext[iAxis];
+}
+
+// 轴当前是否执行规划轨迹 (受倍率影响); 在线轨迹、文件回放执行中的轴不受倍率影响
+static int FeedAxisWarped(int iAxis) {
+    return g_aiOnlineState[iAxis] == ONLINE_STATE_OFF &&
+           !(g_iReplayState == REPLAY_STATE_RUNNING && ReplayOwnsAxis(iAxis));
+}
+
+// 组内轨迹是否都静止 (尚未开始且起点静止, 或已结束); 不受倍率影响的轴不计
+static int FeedGroupAtRest(uint64_t ullMask) {
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        if (!((ullMask >> axis) & 1ULL) || !FeedAxisWarped(axis)) {
+            continue;
+        }
+        const stPlannerContext* pContext = GetFeedContext(axis);
+        if (!pContext->bIsFinished && !(pContext->llSampleIndex == 0 && pContext->dStartVel == 0.0)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 倍率组的约束比值取组内各轴当前轨迹 (规划约束) 中最严的轴
+static void UpdateFeedGroupLimits(int iGroup) {
+    stFeedOverride* pFeed = &g_astFeed[iGroup];
+    FeedOverrideSetLimits(pFeed, &GetFeedContext(iGroup)->stInput);
+    for (int axis = iGroup + 1; axis < g_iAxisCount; axis++) {
+        if ((g_aullFeedMask[iGroup] >> axis) & 1ULL) {
+            FeedOverrideAddLimits(pFeed, &GetFeedContext(axis)->stInput);
+        }
+    }
+}
+
+// 每周期推进各倍率组一次: 约束随组内轴的当前轨迹更新, 组内轨迹静止时直接取指令倍率
+static void UpdateFeedOverride(void) {
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        if (g_aullFeedMask[axis] == 0) {
+            continue;
+        }
+        UpdateFeedGroupLimits(axis);
+        if (FeedGroupAtRest(g_aullFeedMask[axis])) {
+            FeedOverrideSettle(&g_astFeed[axis]);
+        }
+        FeedOverrideStep(&g_astFeed[axis]);
+    }
+}
+
+// 以 ullMask 组成一个倍率组 (组号为最低轴): 各轴先退出原组 (原组号退出时由剩余的最低轴接替),
+// 新组沿用组号轴原来的倍率状态。
+// 各轴原倍率状态不同且组内轨迹未静止时不能合并 (倍率跳变), 返回 -1
+static int SetFeedGroup(uint64_t ullMask) {
+    int iGroup = GetMaskFeedbackAxis(ullMask);
+    const stFeedOverride* pOld = GetAxisFeed(iGroup);
+    for (int axis = iGroup + 1; axis < g_iAxisCount; axis++) {
+        const stFeedOverride* pOther = GetAxisFeed(axis);
+        if (((ullMask >> axis) & 1ULL) && pOther != pOld &&
+            (pOther->dRatio != pOld->dRatio || pOther->dRate != pOld->dRate || pOther->dTarget != pOld->dTarget) &&
+            !FeedGroupAtRest(ullMask)) {
+            return -1;
+        }
+    }
+
+    stFeedOverride stNew = *pOld;
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        uint64_t ullRest = g_aullFeedMask[axis] & ~ullMask;
+        if (g_aullFeedMask[axis] == 0 || ullRest == g_aullFeedMask[axis]) {
+            continue;
+        }
+        g_aullFeedMask[axis] = ullRest;
+        if (ullRest != 0 && ((ullMask >> axis) & 1ULL)) {
+            // 原组号退出: 剩余各轴由其中最低的轴接替组号
+            int iNext = GetMaskFeedbackAxis(ullRest);
+            g_astFeed[iNext] = g_astFeed[axis];
+            g_aullFeedMask[iNext] = ullRest;
+            g_aullFeedMask[axis] = 0;
+            for (int other = iNext; other < g_iAxisCount; other++) {
+                if ((ullRest >> other) & 1ULL) {
+                    g_aiFeedGroup[other] = iNext;
+                }
+            }
+        }
+    }
+    g_astFeed[iGroup] = stNew;
+    g_aullFeedMask[iGroup] = ullMask;
+    for (int axis = iGroup; axis < g_iAxisCount; axis++) {
+        if ((ullMask >> axis) & 1ULL) {
+            g_aiFeedGroup[axis] = iGroup;
+        }
+    }
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        if (g_aullFeedMask[axis] != 0) {
+            UpdateFeedGroupLimits(axis);
+        }
+    }
+    return 0;
+}
 
 // 修改 InitControlData 函数
 void InitControlData(ControlData* data) {
-    for(int i = 0; i < AXIS_COUNT; i++) {
+    for(int i = 0; i < MAX_AXIS_COUNT; i++) {
         data->dTargetPosition[i] = 0.0;
         data->dActualPosition[i] = 0.0;
         data->dError[i] = 0.0;
@@ -36,39 +228,70 @@ void InitControlData(ControlData* data) {
 // 修改 InitControlSystem 函数中的初始化部分
 int InitControlSystem(void)
 {
-    log_info("Initializing control system for %d axes", AXIS_COUNT);
+    log_info("Initializing control system for %d axes", g_iAxisCount);
     
     // 初始化整个结构体为0
     memset(&g_controlState, 0, sizeof(g_controlState));
     // 初始化特定成员
     g_controlState.bControlRunning = 1;
-    for(int i = 0; i < AXIS_COUNT; i++) {
+    for(int i = 0; i < MAX_AXIS_COUNT; i++) {
         g_controlState.pContext[i] = NULL;
+        g_apReferenceContext[i] = NULL;
     }
     
     // 初始化故障处理系统
     vFault_Init();
     log_debug("Fault handling system initialized");
     
-    errno_t err = fopen_s(&g_controlState.pFile, "control_data.csv", "w");
-    if(err != 0)
-    {
-        log_error("Cannot create CSV file!");
-        return -1;
+    if (CSVWriterGetCaptureFormat() != CSV_CAPTURE_TEXT) {
+        // 二进制记录: 允许其他进程在采集过程中读取 (TelemetryConvert)
+        int bCompress = (CSVWriterGetCaptureFormat() == CSV_CAPTURE_COMPRESSED);
+        g_controlState.pFile = _fsopen(TELEMETRY_CAPTURE_FILE, "wb", _SH_DENYWR);
+        if(g_controlState.pFile == NULL || SetTelemetryFile(g_controlState.pFile, SAMPLINGTIME, bCompress) != 0)
+        {
+            log_error("Cannot create telemetry file!");
+            return -1;
+        }
+        log_info("Telemetry file %s created (%d axes%s)", TELEMETRY_CAPTURE_FILE, g_iAxisCount,
+                 bCompress ? ", compressed" : "");
+    } else {
+        errno_t err = fopen_s(&g_controlState.pFile, CSV_CAPTURE_FILE, "w");
+        if(err != 0)
+        {
+            log_error("Cannot create CSV file!");
+            return -1;
+        }
+
+        log_info("CSV file created successfully");
+
+        //设置CSV文件句柄
+        SetCSVFile(g_controlState.pFile);
+        // 修改CSV文件头以适应多轴数据
+        fprintf(g_controlState.pFile, "Step,Time(s),");
+        fprintf(g_controlState.pFile, "TargetPosition_Axis,ActualPosition_Axis,Error_Axis,ControlForce_Axis,ControlMode_Axis");
     }
-    
-    log_info("CSV file created successfully");
-    
-    //设置CSV文件句柄
-    SetCSVFile(g_controlState.pFile);
-    // 修改CSV文件头以适应多轴数据
-    fprintf(g_controlState.pFile, "Step,Time(s)");
-    fprintf(g_controlState.pFile, "TargetPosition_Axis,ActualPosition_Axis,Error_Axis,ControlForce_Axis,ControlMode_Axis");
-    // 初始化每个轴的结构体,包括控制器，被控对象
-    for(int i = 0; i < AXIS_COUNT; i++) {
-        RigidBodyTFInit(&g_controlState.plant[i], 16.0, SAMPLINGTIME);
-        ControllerInit(&g_controlState.controller[i]);
+    // 黑匣子: 内存映射环形文件, 控制线程逐周期直接写入, 进程崩溃后保留; 创建失败时只告警, 不影响控制
+    int iRecorder = FlightRecorderOpen(&g_stRecorder, FLIGHT_RECORDER_FILE, FLIGHT_RECORDER_CRASH_FILE, g_iAxisCount,
+                                       SAMPLINGTIME, FLIGHT_RECORDER_SECONDS);
+    if (iRecorder < 0) {
+        log_warn("Cannot create flight recorder %s, black box disabled", FLIGHT_RECORDER_FILE);
+    } else {
+        if (iRecorder == 1) {
+            log_warn("Previous run did not exit cleanly, flight record kept as %s", FLIGHT_RECORDER_CRASH_FILE);
+        }
+        log_info("Flight recorder %s: %llu cycles (%.0fs), %llu bytes", FLIGHT_RECORDER_FILE,
+                 g_stRecorder.ullSlotCount, g_stRecorder.ullSlotCount * SAMPLINGTIME,
+                 FLIGHT_RECORDER_HEADER_SIZE + g_stRecorder.ullSlotCount * g_stRecorder.uSlotSize);
+    }
+    // 选择滤波器组计算内核 (按 CPU 特性, 在进入实时循环前完成自检)
+    BiquadBankSelectKernel(BIQUAD_KERNEL_AUTO);
+    log_info("Biquad bank kernel: %s", BiquadBankKernelName(BiquadBankGetKernel()));
+    // 初始化控制器组和被控对象组
+    BiquadBankInit(&g_controlState.plant);
+    for(int i = 0; i < g_iAxisCount; i++) {
+        RigidBodyBankInitAxis(&g_controlState.plant, i, PLANT_MASS, SAMPLINGTIME);
     }
+    ControllerBankInit(&g_controlState.controller, g_iAxisCount);
     InitControlData(&g_controlState.ctrl_data);
     
     // 为每个轴规划轨迹
@@ -79,37 +302,264 @@ int InitControlSystem(void)
     stInput.dJMax = 10.0;
     stInput.dDMax = 200.0;
     stInput.dSampleTime = 0.001;
+    stInput.dTimeLimit = 0.0;
+    FeedOverridePlanningLimits(&stInput, &stInput);
     
-    // 为每个轴进行轨迹规划
-    for (int axis = 0; axis < AXIS_COUNT; axis++)
+    // 为每个轴进行轨迹规划 (启动阶段以多轴同步规划写入各轴当前槽, 之后的重新规划由规划线程完成)
+    // 上下文全部来自启动时建立的上下文池, 控制循环中不再调用分配器
+    AllocGuardInstall();
+    if (ThreadPoolInit(0) != 0) {
+        log_error("Failed to create planner thread pool");
+        return -1;
+    }
+    PlannerPoolInit();
+    if (PlannerWorkerInit() != 0) {
+        log_error("Planner context pool exhausted (capacity %d)", PLANNER_POOL_CAPACITY);
+        return -1;
+    }
+    int iCached = PlannerCacheLoad(PLANNER_CACHE_FILE);
+    if (iCached >= 0) {
+        log_info("Planner cache loaded: %d entries from %s", iCached, PLANNER_CACHE_FILE);
+    } else {
+        log_debug("Planner cache starts cold (%s missing or incompatible)", PLANNER_CACHE_FILE);
+    }
+    for (int axis = 0; axis < g_iAxisCount; axis++)
     {
-        g_controlState.pContext[axis] = FourthOrderPlannerInit(&stInput);
-        if (g_controlState.pContext[axis] == NULL) {
-            //初始化失败，打印错误并退出
-            log_error("Trajectory planner initialization failed!");
-            return -1;
+        g_astStagedInput[axis] = stInput;
+        g_stPathLimits = stInput;
+        FeedOverrideInit(&g_astFeed[axis], SAMPLINGTIME);
+        FeedOverrideSetLimits(&g_astFeed[axis], &stInput);
+        g_aiFeedGroup[axis] = axis;
+        g_aullFeedMask[axis] = 1ULL << axis;
+    }
+    stPlannerGroupResult stGroup;
+    if (PlannerWorkerPlanGroupSync(AxisConfigAllMask(), g_astStagedInput, &stGroup) != 0) {
+        //初始化失败，打印错误并退出
+        if (stGroup.bPoolTimeout) {
+            log_error("Trajectory planner initialization failed: thread pool timed out!");
+        } else {
+            log_error("Trajectory planner initialization failed at axis %d!", stGroup.iFailedAxis);
         }
+        return -1;
+    }
+    for (int axis = 0; axis < g_iAxisCount; axis++)
+    {
+        g_controlState.pContext[axis] = PlannerWorkerGetContext(axis);
+    }
+    log_info("Trajectories planned for %d axes: T=%.4fs, %.1fus on %d pool threads",
+             g_iAxisCount, stGroup.dCommonTime, stGroup.dPlanUs, ThreadPoolGetThreadCount());
+    if (PlannerWorkerStart() != 0) {
+        log_error("Failed to start trajectory planner thread");
+        return -1;
     }
     
     log_debug("Trajectory planners initialized");
     
     // 初始化每轴的独立状态
-    for(int i = 0; i < AXIS_COUNT; i++) {
+    for(int i = 0; i < MAX_AXIS_COUNT; i++) {
         g_controlState.iControlStepPerAxis[i] = 0;
         g_controlState.bAxisActive[i] = 0;  // 初始时不激活任何轴
+        g_controlState.abStepEnable[i] = 0;
     }
 
     g_controlState.bTrajectoryReady = 1;
     g_controlState.iControlStep = 0;
     g_controlState.bControlRunning = 1;
-    log_info("Control system initialized successfully for %d axes", AXIS_COUNT);
+    log_info("Control system initialized successfully for %d axes", g_iAxisCount);
     return 0;
 }
 
 
+// 路径插补的周期处理 (仅 ExecuteControlStep 调用)
+// 已开始: 参与轴的当前轨迹全部完成后切换为执行中; 执行中: 上一周期已输出终点时各轴改为停在终点的零位移轨迹并报告完成,
+// 否则推进一个路径点
+static void UpdatePathInterp(void)
+{
+    if (g_iPathState == PATH_STATE_ARMED) {
+        for (int k = 0; k < g_stPath.iAxisCount; k++) {
+            if (!g_controlState.pContext[g_stPath.aiAxis[k]]->bIsFinished) {
+                return;
+            }
+        }
+        g_iPathState = PATH_STATE_RUNNING;
+    }
+
+    if (PathInterpIsFinished(&g_stPath)) {
+        CommandFeedback stFeedback = {0};
+        for (int k = 0; k < g_stPath.iAxisCount; k++) {
+            int axis = g_stPath.aiAxis[k];
+            stPlannerInputEx stHold;
+            memset(&stHold, 0, sizeof(stHold));
+            stHold.stLimits = g_stPathLimits;
+            stHold.stLimits.dDistance = 0.0;
+            stHold.dStartPos = g_stPath.adEnd[k];
+            FourthOrderPlannerInitEx(&stHold, &g_astHoldContext[axis]);
+            g_controlState.pContext[axis] = &g_astHoldContext[axis];
+        }
+        g_iPathState = PATH_STATE_OFF;
+        stFeedback.iCMD = 17;
+        stFeedback.axis = GetMaskFeedbackAxis(g_ullPathMask);
+        stFeedback.sequenceNumber = g_iPathSequence;
+        stFeedback.status = CMD_STATUS_COMPLETED;
+        sprintf_s(stFeedback.message, sizeof(stFeedback.message), "%s path finished (mask 0x%llX): L=%.6f, %lld cycles",
+                  (g_stPath.iType == PATH_TYPE_LINE) ? "Line" : "Arc", (unsigned long long)g_ullPathMask,
+                  g_stPath.dLength, g_stPath.stContext.llSampleIndex);
+        CommandFeedbackPush(&stFeedback);
+        return;
+    }
+
+    const stFeedOverride* pFeed = GetAxisFeed(g_stPath.aiAxis[0]);
+    if (FeedOverrideIsActive(pFeed) || g_stPath.stContext.bTimeWarped) {
+        FourthOrderPlannerSetTimeScale(&g_stPath.stContext, pFeed->dRatio, pFeed->dRate, pFeed->dAccel);
+    }
+    PathInterpStep(&g_stPath);
+}
+
+// 文件回放反馈 (异步, 序列号为开始回放的指令; 反馈 axis 为最低的参与轴号, 消息中含完整掩码)
+static void SendReplayFeedback(CommandStatus eStatus, int iErrorCode, const char* pszFormat, ...)
+{
+    CommandFeedback stFeedback = {0};
+    va_list args;
+
+    stFeedback.iCMD = 18;
+    stFeedback.axis = GetMaskFeedbackAxis(g_controlState.stReplay.ullAxisMask);
+    stFeedback.sequenceNumber = g_iReplaySequence;
+    stFeedback.status = eStatus;
+    stFeedback.errorCode = iErrorCode;
+    va_start(args, pszFormat);
+    vsprintf_s(stFeedback.message, sizeof(stFeedback.message), pszFormat, args);
+    va_end(args);
+    CommandFeedbackPush(&stFeedback);
+}
+
+// 文件回放加载完成后的检查 (仅 UpdateReplay 调用): 文件须已通过约束检查, 帧间隔等于控制周期,
+// 文件约束 (头部 V/A/J) 不超过各参与轴当前轨迹的约束, 首帧与末帧静止, 首帧位置等于各轴当前轨迹终点;
+// 通过后进入已开始, 否则交还文件由规划线程关闭并报告原因
+static void ArmReplay(void)
+{
+    stTrajectoryFile* pReplay = &g_controlState.stReplay;
+    uint64_t ullMask = pReplay->ullAxisMask;
+    int iResult = TrajectoryFilePollOpen(pReplay);
+
+    if (iResult == 0) {
+        return;
+    }
+    if (iResult < 0 || g_bReplayCancelled) {
+        if (iResult < 0 && !g_bReplayCancelled) {
+            log_error("Cannot map trajectory file %s", g_szReplayPath);
+            SendReplayFeedback(CMD_STATUS_ERROR, 2, "Cannot map %s", g_szReplayPath);
+        }
+        TrajectoryFileRequestClose(pReplay);
+        memset(pReplay, 0, sizeof(*pReplay));
+        g_iReplayState = REPLAY_STATE_OFF;
+        return;
+    }
+
+    const stTrajFileHeader* pHeader = pReplay->pHeader;
+    char szReason[64] = "";
+    if (!(pHeader->uFlags & TRAJ_FILE_FLAG_VALIDATED)) {
+        strcpy_s(szReason, sizeof(szReason), "not validated");
+    } else if (fabs(pHeader->dSampleTime - SAMPLINGTIME) > 1e-12) {
+        strcpy_s(szReason, sizeof(szReason), "sample time mismatch");
+    } else if (TrajectoryFileBind(pReplay, ullMask) != 0) {
+        strcpy_s(szReason, sizeof(szReason), "axis count mismatch");
+    } else if (!TrajectoryFileIsAtRest(pReplay, 0) || !TrajectoryFileIsAtRest(pReplay, pReplay->ullFrameCount - 1)) {
+        strcpy_s(szReason, sizeof(szReason), "first or last frame not at rest");
+    } else {
+        const stTrajRecord* pFirst = TrajectoryFileGetFrame(pReplay, 0);
+        const double dTol = 1.0 + TRAJ_FILE_CHECK_TOL;
+        for (int k = 0; k < pReplay->iAxisCount && szReason[0] == '\0'; k++) {
+            int axis = pReplay->aiAxis[k];
+            const stPlannerContext* pContext = g_controlState.pContext[axis];
+            // 规划轨迹按倍率预留后的约束规划, 回放 (不受倍率影响) 按还原的轴约束检查
+            stPlannerInput stAxisLimits;
+            const stPlannerInput* pLimits = &stAxisLimits;
+            FeedOverrideAxisLimits(&pContext->stInput, &stAxisLimits);
+            stTrajectoryPoint stEnd;
+            FourthOrderPlannerGetPointAt(pContext, pContext->dTotalTime, &stEnd);
+            if (pHeader->dVMax > pLimits->dVMax * dTol || pHeader->dAMax > pLimits->dAMax * dTol ||
+                pHeader->dJMax > pLimits->dJMax * dTol) {
+                sprintf_s(szReason, sizeof(szReason), "limits exceed axis %d (V%.3g A%.3g J%.3g)", axis,
+                          pLimits->dVMax, pLimits->dAMax, pLimits->dJMax);
+            } else if (fabs(pFirst[k].dPos - stEnd.dPos) > TRAJ_FILE_START_TOL) {
+                sprintf_s(szReason, sizeof(szReason), "first frame does not start at axis %d position", axis);
+            }
+            g_aiReplaySlot[axis] = k;
+        }
+    }
+    pReplay->ullAxisMask = ullMask;
+    if (szReason[0] != '\0') {
+        log_error("Trajectory file %s rejected: %s", g_szReplayPath, szReason);
+        SendReplayFeedback(CMD_STATUS_ERROR, 3, "%s rejected: %s", g_szReplayPath, szReason);
+        TrajectoryFileRequestClose(pReplay);
+        memset(pReplay, 0, sizeof(*pReplay));
+        g_iReplayState = REPLAY_STATE_OFF;
+        return;
+    }
+
+    g_iReplayState = REPLAY_STATE_ARMED;
+    log_info("Trajectory file %s armed for mask 0x%llX: %llu frames (%.3fs), V<=%.6f A<=%.6f J<=%.6f", g_szReplayPath,
+             (unsigned long long)ullMask, (unsigned long long)pReplay->ullFrameCount,
+             (double)pReplay->ullFrameCount * SAMPLINGTIME, pHeader->dVMax, pHeader->dAMax, pHeader->dJMax);
+    SendReplayFeedback(CMD_STATUS_EXECUTING, 0, "%s armed: %llu frames", g_szReplayPath,
+                       (unsigned long long)pReplay->ullFrameCount);
+}
+
+// 文件回放的周期处理 (仅 ExecuteControlStep 调用)
+// 加载中: 查询规划线程的打开结果并检查; 已开始: 参与轴的当前轨迹全部完成后切换为执行中;
+// 执行中: 每周期取一帧 (映射内存的顺序读取并预取前方帧), 上一周期已取最后一帧时各轴改为停在末帧位置的零位移轨迹,
+// 文件交还规划线程解除映射并关闭, 报告完成
+static void UpdateReplay(void)
+{
+    stTrajectoryFile* pReplay = &g_controlState.stReplay;
+
+    if (g_iReplayState == REPLAY_STATE_LOADING) {
+        ArmReplay();
+        if (g_iReplayState != REPLAY_STATE_ARMED) {
+            return;
+        }
+    }
+
+    if (g_iReplayState == REPLAY_STATE_ARMED) {
+        for (int k = 0; k < pReplay->iAxisCount; k++) {
+            if (!g_controlState.pContext[pReplay->aiAxis[k]]->bIsFinished) {
+                return;
+            }
+        }
+        g_iReplayState = REPLAY_STATE_RUNNING;
+    }
+
+    if (TrajectoryFileIsFinished(pReplay)) {
+        const stTrajRecord* pLast = TrajectoryFileGetFrame(pReplay, pReplay->ullFrameCount - 1);
+        for (int k = 0; k < pReplay->iAxisCount; k++) {
+            int axis = pReplay->aiAxis[k];
+            stPlannerInputEx stHold;
+            memset(&stHold, 0, sizeof(stHold));
+            stHold.stLimits = g_astStagedInput[axis];
+            stHold.stLimits.dDistance = 0.0;
+            stHold.dStartPos = pLast[k].dPos;
+            FourthOrderPlannerInitEx(&stHold, &g_astHoldContext[axis]);
+            g_controlState.pContext[axis] = &g_astHoldContext[axis];
+        }
+        SendReplayFeedback(CMD_STATUS_COMPLETED, 0, "Trajectory file replay finished (mask 0x%llX): %llu frames",
+                           (unsigned long long)pReplay->ullAxisMask, (unsigned long long)pReplay->ullFrameCount);
+        TrajectoryFileRequestClose(pReplay);
+        g_pReplayFrame = NULL;
+        g_iReplayState = REPLAY_STATE_OFF;
+        return;
+    }
+
+    g_pReplayFrame = TrajectoryFileNextFrame(pReplay);
+}
+
 // 修改ExecuteControlStep函数以支持单轴和多轴控制
-int ExecuteControlStep(int axisMask)
+// 每个阶段对所有轴顺序处理, 控制器和被控对象按数组结构体整体更新
+int ExecuteControlStep(uint64_t ullAxisMask)
 {
+    const int iAxisCount = g_iAxisCount;
+    ControlData* pData = &g_controlState.ctrl_data;
+    unsigned char* pbEnable = g_controlState.abStepEnable;
+
     if(!g_controlState.bTrajectoryReady || !g_controlState.bControlRunning) {
         log_warn("Control system not ready or not running");
         return -1;
@@ -122,18 +572,34 @@ int ExecuteControlStep(int axisMask)
         return -1;
     }    
     
-    // 为指定轴执行控制步骤
-    for(int axis = 0; axis < AXIS_COUNT; axis++) {
-        // 检查是否需要控制此轴 (axisMask的第axis位为1表示需要控制)
-        if (!(axisMask & (1 << axis))) {
+    // 进给倍率: 每组每周期推进一次
+    UpdateFeedOverride();
+    // 路径插补: 参与轴的当前轨迹全部执行完后接管; 每周期推进一次路径 (进给倍率取首个参与轴所在的组)
+    if (g_iPathState != PATH_STATE_OFF && (ullAxisMask & g_ullPathMask)) {
+        UpdatePathInterp();
+    }
+    // 文件回放: 同上, 每周期取一帧
+    if (g_iReplayState != REPLAY_STATE_OFF && (ullAxisMask & g_controlState.stReplay.ullAxisMask)) {
+        UpdateReplay();
+    }
+
+    // 阶段1: 确定本步需要更新的轴, 获取目标位置和实际位置, 计算误差
+    for(int axis = 0; axis < iAxisCount; axis++) {
+        pbEnable[axis] = 0;
+
+        // 检查是否需要控制此轴 (ullAxisMask的第axis位为1表示需要控制)
+        if (!(ullAxisMask & ((uint64_t)1 << axis))) {
             continue; // 不需要控制的轴跳过
         }
 
         // 将轴设置为激活状态
         g_controlState.bAxisActive[axis] = 1;
         
-        // 检查是否超过总步数
-        if (g_controlState.iControlStepPerAxis[axis] >= TOTALSTEPS) {
+        // 检查是否超过总步数 (运动队列程序执行中、在线轨迹生成中、进给倍率下轨迹未完成时不受限制)
+        if (g_controlState.iControlStepPerAxis[axis] >= TOTALSTEPS &&
+            !MotionQueueIsActive(axis) && g_aiOnlineState[axis] == ONLINE_STATE_OFF && !PathOwnsAxis(axis) &&
+            !ReplayOwnsAxis(axis) &&
+            !(g_controlState.pContext[axis]->bTimeWarped && !g_controlState.pContext[axis]->bIsFinished)) {
             continue;
         }
 
@@ -141,79 +607,175 @@ int ExecuteControlStep(int axisMask)
         if (bFault_GetAxisFault(axis)) {
             log_warn("AXIS %d FAULT DETECTED! Switching to safe mode.", axis);
             SafetyData[axis].mode = CONTROL_MODE_OPEN_LOOP;
-            g_controlState.ctrl_data.dControlForce[axis] = 0.0;
+            pData->dControlForce[axis] = 0.0;
             continue;
         }
 
-        // 计算该轴的时间
-        double time = g_controlState.iControlStepPerAxis[axis] * SAMPLINGTIME;
-
-        // 获取目标位置(使用预计算的轨迹)
-        if (FourthOrderPlannerGetNextPoint(g_controlState.pContext[axis], &g_controlState.currentPoint[axis]) == 0)
+        // 获取目标位置(使用预计算的轨迹, 运动队列执行中按段切换; 在线轨迹生成时每周期由生成器输出;
+        // 路径插补时取路径在该轴上的投影; 文件回放时取本周期帧中该轴的记录)
+        stTrajectoryPoint stPoint;
+        if (g_aiOnlineState[axis] == ONLINE_STATE_RUNNING)
+        {
+            // 接管时中止的运动队列程序在此丢弃其余已规划段
+            MotionQueueSelect(axis, g_controlState.pContext[axis]);
+            OnlineTrajectoryStep(&g_astOnline[axis], &stPoint);
+            pData->dTargetPosition[axis] = stPoint.dPos;
+        }
+        else if (g_iPathState == PATH_STATE_RUNNING && PathOwnsAxis(axis))
         {
-            g_controlState.ctrl_data.dTargetPosition[axis] = g_controlState.currentPoint[axis].dPos;
+            pData->dTargetPosition[axis] = g_stPath.adPos[g_aiPathSlot[axis]];
+        }
+        else if (g_iReplayState == REPLAY_STATE_RUNNING && ReplayOwnsAxis(axis))
+        {
+            pData->dTargetPosition[axis] = g_pReplayFrame[g_aiReplaySlot[axis]].dPos;
         }
         else
         {
-            log_debug("四阶轨迹调用结束");
+            stPlannerContext* pContext = MotionQueueSelect(axis, g_controlState.pContext[axis]);
+            g_controlState.pContext[axis] = pContext;
+            // 进给倍率: 倍率偏离 1 或当前轨迹已在扭曲时间基上时, 以本周期的倍率 (所在组共用) 推进轨迹时刻
+            const stFeedOverride* pFeed = GetAxisFeed(axis);
+            if (FeedOverrideIsActive(pFeed) || pContext->bTimeWarped)
+            {
+                FourthOrderPlannerSetTimeScale(pContext, pFeed->dRatio, pFeed->dRate, pFeed->dAccel);
+            }
+            if (FourthOrderPlannerGetNextPoint(g_controlState.pContext[axis], &stPoint) == 0)
+            {
+                pData->dTargetPosition[axis] = stPoint.dPos;
+                g_astReference[axis] = stPoint;
+                g_apReferenceContext[axis] = pContext;
+            }
+            else if (!g_controlState.bCyclicMode)
+            {
+                log_debug("四阶轨迹调用结束");
+            }
         }
         // 获取实际位置
-        g_controlState.ctrl_data.dActualPosition[axis] = g_controlState.plant[axis].out_prev[0];
+        pData->dActualPosition[axis] = g_controlState.plant.adOut1[axis];
 
         // 计算误差
-        g_controlState.ctrl_data.dError[axis] = g_controlState.ctrl_data.dTargetPosition[axis] - g_controlState.ctrl_data.dActualPosition[axis];
-        
-        // 更新控制器
-        double raw_control_force = ControllerUpdate(&g_controlState.controller[axis], g_controlState.ctrl_data.dError[axis]);
-        
-        // 应用安全控制
-        g_controlState.ctrl_data.dControlForce[axis] = ApplySafetyControl(axis, raw_control_force, g_controlState.ctrl_data.dError[axis], &g_controlState);
-        
-        // 更新故障检测系统状态
-        vFault_UpdateAxis(axis);
+        pData->dError[axis] = pData->dTargetPosition[axis] - pData->dActualPosition[axis];
 
-        // 更新被控设备系统
-        g_controlState.ctrl_data.dOutputPosition[axis] = RigidBodyTFUpdate(&g_controlState.plant[axis], g_controlState.ctrl_data.dControlForce[axis]);
-        
-        // 增加该轴的步进计数器
-        g_controlState.iControlStepPerAxis[axis]++;
+        pbEnable[axis] = 1;
+    }
+
+    // 阶段2: 更新控制器 (所有使能轴)
+    ControllerBankUpdate(&g_controlState.controller, pData->dError, g_controlState.adRawControlForce, pbEnable, iAxisCount);
+
+    // 阶段3: 应用安全控制, 更新故障检测系统状态
+    for(int axis = 0; axis < iAxisCount; axis++) {
+        if (!pbEnable[axis]) {
+            continue;
+        }
+        pData->dControlForce[axis] = ApplySafetyControl(axis, g_controlState.adRawControlForce[axis], pData->dError[axis], &g_controlState);
+        vFault_UpdateAxis((uint8_t)axis);
+    }
+
+    // 阶段4: 更新被控设备系统 (所有使能轴)
+    BiquadBankProcess(&g_controlState.plant, pData->dControlForce, pData->dOutputPosition, pbEnable, iAxisCount);
+
+    // 增加各轴的步进计数器
+    for(int axis = 0; axis < iAxisCount; axis++) {
+        g_controlState.iControlStepPerAxis[axis] += pbEnable[axis];
     }
     
     // 更新故障检测系统整体状态
     vFault_UpdateSystem();
     
-    // 打印控制结果 - 只打印被控制的轴
-    log_trace("Step: %d", g_controlState.iControlStep);
-    for(int axis = 0; axis < AXIS_COUNT; axis++) {
-        if (axisMask & (1 << axis)) {
+    // 打印控制结果 - 只打印被控制的轴 (周期模式下不逐步打印, 避免日志占用控制周期)
+    if (!g_controlState.bCyclicMode) {
+        log_trace("Step: %d", g_controlState.iControlStep);
+    }
+    for(int axis = 0; axis < iAxisCount && !g_controlState.bCyclicMode; axis++) {
+        if (ullAxisMask & ((uint64_t)1 << axis)) {
             double time = (g_controlState.iControlStepPerAxis[axis] - 1) * SAMPLINGTIME; // 减1是因为上面已递增
             char mode_str = (SafetyData[axis].mode == CONTROL_MODE_CLOSED_LOOP) ? 'C' : 'O';
             log_trace("Axis%d: Time=%.3fs, Target=%.12f, Actual=%.15f, Error=%.13f, Force=%.9f (%c)", 
                    axis,
                    time,
-                   g_controlState.ctrl_data.dTargetPosition[axis], 
-                   g_controlState.ctrl_data.dActualPosition[axis], 
-                   g_controlState.ctrl_data.dError[axis], 
-                   g_controlState.ctrl_data.dControlForce[axis],
+                   pData->dTargetPosition[axis], 
+                   pData->dActualPosition[axis], 
+                   pData->dError[axis], 
+                   pData->dControlForce[axis],
                    mode_str);
         }
     }
 
+    // 黑匣子记录本周期 (在有效性检查之前, 出现数值异常的周期同样留下记录)
+    int aiControlMode[MAX_AXIS_COUNT];
+    uint32_t auFaultBits[MAX_AXIS_COUNT];
+    for(int axis = 0; axis < iAxisCount; axis++) {
+        aiControlMode[axis] = SafetyData[axis].mode;
+        auFaultBits[axis] = u32Fault_GetAxisFaultBits((uint8_t)axis);
+    }
+    FlightRecorderWrite(&g_stRecorder, g_controlState.iControlStep, g_controlState.iControlStep * SAMPLINGTIME, pData,
+                        aiControlMode, auFaultBits, bFault_GetSystemFault() ? FLIGHT_RECORDER_FLAG_SYSTEM_FAULT : 0);
+
     // 数据有效性检查
-    for(int axis = 0; axis < AXIS_COUNT; axis++) {
+    for(int axis = 0; axis < iAxisCount; axis++) {
         // 只检查被控制的轴
-        if (axisMask & (1 << axis)) {
-            if (isnan(g_controlState.ctrl_data.dError[axis]) || isinf(g_controlState.ctrl_data.dError[axis]) ||
-                isnan(g_controlState.ctrl_data.dControlForce[axis]) || isinf(g_controlState.ctrl_data.dControlForce[axis])) {
+        if (ullAxisMask & ((uint64_t)1 << axis)) {
+            if (isnan(pData->dError[axis]) || isinf(pData->dError[axis]) ||
+                isnan(pData->dControlForce[axis]) || isinf(pData->dControlForce[axis])) {
                 log_error("Invalid numerical value detected for axis %d!", axis);
                 return -1;
             }
         }
     }
     
+    // 记录本周期数据 (写入无锁队列, 由CSV写入线程落盘; 队列满时丢弃并计数, 不阻塞控制周期)
+    WriteCSVDataToBuffer(g_controlState.iControlStep, g_controlState.iControlStep * SAMPLINGTIME, pData, aiControlMode);
+
     g_controlState.iControlStep++;
     return 0;
 }
+
+// 解析指令中的轴掩码: axis 为低32位 (1: 轴0, 2: 轴1, 3: 轴0和轴1 ...), iReserved[0] 为高32位
+// 超出当前轴数的位被忽略, 结果为 0 时返回 -1
+static int GetCommandAxisMask(const struct RxData* pRxData, uint64_t* pullAxisMask)
+{
+    uint64_t ullMask = (uint64_t)(uint32_t)pRxData->axis | ((uint64_t)(uint32_t)pRxData->iReserved[0] << 32);
+    ullMask &= AxisConfigAllMask();
+    *pullAxisMask = ullMask;
+    return (ullMask != 0) ? 0 : -1;
+}
+
+// 由指令参数构造规划输入 (位移, VMax, AMax, JMax, DMax; 为 0 的参数取默认值)
+static void GetCommandPlannerInput(const struct RxData* pRxData, stPlannerInput* pstInput)
+{
+    pstInput->dDistance = (pRxData->dParamData[0] != 0.0) ? pRxData->dParamData[0] : 1.0;
+    pstInput->dVMax = (pRxData->dParamData[1] != 0.0) ? pRxData->dParamData[1] : 0.8;
+    pstInput->dAMax = (pRxData->dParamData[2] != 0.0) ? pRxData->dParamData[2] : 2.0;
+    pstInput->dJMax = (pRxData->dParamData[3] != 0.0) ? pRxData->dParamData[3] : 10.0;
+    pstInput->dDMax = (pRxData->dParamData[4] != 0.0) ? pRxData->dParamData[4] : 200.0;
+    pstInput->dSampleTime = SAMPLINGTIME;
+    pstInput->dTimeLimit = 0.0;
+}
+
+// 可被进给倍率扭曲的轨迹 (CMD 5/12/14/17) 的规划输入: 指令约束为轴约束, 按倍率上限预留后规划
+static void GetWarpPlannerInput(const struct RxData* pRxData, stPlannerInput* pstInput)
+{
+    GetCommandPlannerInput(pRxData, pstInput);
+    FeedOverridePlanningLimits(pstInput, pstInput);
+}
+
+// 经反馈队列向客户端发送当前指令的异步状态 (由 Socket 线程发送)
+static void SendAsyncFeedback(int iCMD, int iAxis, CommandStatus eStatus, int iErrorCode, const char* pszFormat, ...)
+{
+    CommandFeedback stFeedback = {0};
+    va_list args;
+
+    stFeedback.iCMD = iCMD;
+    stFeedback.axis = iAxis;
+    stFeedback.sequenceNumber = g_iCommandSequence;
+    stFeedback.status = eStatus;
+    stFeedback.errorCode = iErrorCode;
+    va_start(args, pszFormat);
+    vsprintf_s(stFeedback.message, sizeof(stFeedback.message), pszFormat, args);
+    va_end(args);
+    CommandFeedbackPush(&stFeedback);
+}
+
 // 修改ProcessCommand函数以支持单轴和多轴控制
 void ProcessCommand(struct RxData* pRxData) {
     if (pRxData == NULL) {
@@ -223,27 +785,26 @@ void ProcessCommand(struct RxData* pRxData) {
 
     log_debug("Processing command: CMD=%d, Axis=%d", pRxData->iCMD, pRxData->axis);
 
+    // 周期模式下由控制线程自主步进, 拒绝手动步进指令
+    if (g_controlState.bCyclicMode &&
+        (pRxData->iCMD == 1 || pRxData->iCMD == 3 || pRxData->iCMD == 8 || pRxData->iCMD == 9)) {
+        log_warn("CMD %d ignored: cyclic mode is running (send CMD 11 to stop)", pRxData->iCMD);
+        return;
+    }
+
     switch (pRxData->iCMD) {
         case 1: // 控制轴运动
             {
-                int axisMask = 0;
-                // 根据axis值确定控制哪些轴
+                uint64_t axisMask = 0;
+                // 根据axis值确定控制哪些轴 (按位, iReserved[0] 为高32位)
                 // axis=1 控制轴0
                 // axis=2 控制轴1
                 // axis=3 控制轴0和轴1
-                if (pRxData->axis == 1) {
-                    axisMask = 1;  // 控制轴0
-                    log_info("Controlling axis 0");
-                } else if (pRxData->axis == 2) {
-                    axisMask = 2;  // 控制轴1
-                    log_info("Controlling axis 1");
-                } else if (pRxData->axis == 3) {
-                    axisMask = 3;  // 控制轴0和轴1
-                    log_info("Controlling axis 0 and 1");
-                } else {
+                if (GetCommandAxisMask(pRxData, &axisMask) != 0) {
                     log_error("Invalid axis value %d for CMD 1", pRxData->axis);
                     return;
                 }
+                log_info("Controlling axis mask 0x%llX", (unsigned long long)axisMask);
                 
                 // 执行控制步骤
                 if(ExecuteControlStep(axisMask) != 0) {
@@ -256,7 +817,7 @@ void ProcessCommand(struct RxData* pRxData) {
             log_info("Resetting control step counter");
             g_controlState.iControlStep = 0;
             // 同时重置各轴的步进计数器
-            for(int i = 0; i < AXIS_COUNT; i++) {
+            for(int i = 0; i < g_iAxisCount; i++) {
                 g_controlState.iControlStepPerAxis[i] = 0;
                 g_controlState.bAxisActive[i] = 0;
             }
@@ -264,29 +825,21 @@ void ProcessCommand(struct RxData* pRxData) {
             
         case 3: // 执行多步控制
             {
-                int axisMask = 0;
+                uint64_t axisMask = 0;
                 // 根据axis值确定控制哪些轴
-                if (pRxData->axis == 1) {
-                    axisMask = 1;  // 控制轴0
-                    log_info("Controlling axis 0");
-                } else if (pRxData->axis == 2) {
-                    axisMask = 2;  // 控制轴1
-                    log_info("Controlling axis 1");
-                } else if (pRxData->axis == 3) {
-                    axisMask = 3;  // 控制轴0和轴1
-                    log_info("Controlling axis 0 and 1");
-                } else {
+                if (GetCommandAxisMask(pRxData, &axisMask) != 0) {
                     log_error("Invalid axis value %d for CMD 3", pRxData->axis);
                     return;
                 }
+                log_info("Controlling axis mask 0x%llX", (unsigned long long)axisMask);
                 
                 int stepsToExecute = (int)pRxData->dParamData[0];
                 log_info("Executing %d control steps", stepsToExecute);
                 for(int i = 0; i < stepsToExecute; i++) {
                     // 检查所有涉及轴是否都未超过总步数
                     int canContinue = 1;
-                    for(int axis = 0; axis < AXIS_COUNT; axis++) {
-                        if ((axisMask & (1 << axis)) && g_controlState.iControlStepPerAxis[axis] >= TOTALSTEPS) {
+                    for(int axis = 0; axis < g_iAxisCount; axis++) {
+                        if ((axisMask & ((uint64_t)1 << axis)) && g_controlState.iControlStepPerAxis[axis] >= TOTALSTEPS) {
                             canContinue = 0;
                             break;
                         }
@@ -309,13 +862,13 @@ void ProcessCommand(struct RxData* pRxData) {
             log_warn("Emergency stop triggered");
             g_controlState.bControlRunning = 0;
             // 触发硬件紧急停止故障
-            for(int axis = 0; axis < AXIS_COUNT && axis < 8; axis++) {
+            for(int axis = 0; axis < g_iAxisCount; axis++) {
                 g_atAxisFaults[axis].m_bRawFault[FAULT_HARDWARE_EMERGENCY_STOP] = true;
-                vFault_UpdateAxis(axis);
+                vFault_UpdateAxis((uint8_t)axis);
             }
             vFault_UpdateSystem();
             // 切换到开环模式作为安全措施
-            for(int axis = 0; axis < AXIS_COUNT; axis++) {
+            for(int axis = 0; axis < g_iAxisCount; axis++) {
                 SafetyData[axis].mode = CONTROL_MODE_OPEN_LOOP;
                 g_controlState.ctrl_data.dControlForce[axis] = 0.0; // 清除控制力
                 log_info("Axis %d switched to safe open-loop mode", axis);
@@ -325,34 +878,30 @@ void ProcessCommand(struct RxData* pRxData) {
         case 5: // 设置新的轨迹参数
             {
                 int targetAxis = pRxData->axis;
-                if (targetAxis < 0 || targetAxis >= AXIS_COUNT) {
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
                     log_error("Invalid axis number %d", targetAxis);
                     return;
                 }
                 
+                if (MotionQueueIsActive(targetAxis) || g_aiOnlineState[targetAxis] != ONLINE_STATE_OFF ||
+                    PathOwnsAxis(targetAxis) || ReplayOwnsAxis(targetAxis)) {
+                    log_error("Trajectory replan rejected for axis %d: motion queue, online trajectory, path or replay active", targetAxis);
+                    SendAsyncFeedback(5, targetAxis, CMD_STATUS_ERROR, 1,
+                                      "Axis %d replan rejected: motion queue, online trajectory, path or replay active", targetAxis);
+                    return;
+                }
+
                 log_info("Setting new trajectory parameters for axis %d", targetAxis);
                 
-                // 重新初始化轨迹规划器
+                // 提交到规划线程, 新轨迹在规划完成后的周期边界生效, 完成状态经反馈队列返回
                 stPlannerInput stInput;
-                stInput.dDistance = (pRxData->dParamData[0] != 0.0) ? pRxData->dParamData[0] : 1.0;
-                stInput.dVMax = (pRxData->dParamData[1] != 0.0) ? pRxData->dParamData[1] : 0.8;
-                stInput.dAMax = (pRxData->dParamData[2] != 0.0) ? pRxData->dParamData[2] : 2.0;
-                stInput.dJMax = (pRxData->dParamData[3] != 0.0) ? pRxData->dParamData[3] : 10.0;
-                stInput.dDMax = (pRxData->dParamData[4] != 0.0) ? pRxData->dParamData[4] : 200.0;
-                stInput.dSampleTime = SAMPLINGTIME;
-                
-                // 释放旧的轨迹规划器
-                if (g_controlState.pContext[targetAxis] != NULL) {
-                    free(g_controlState.pContext[targetAxis]);
-                    g_controlState.pContext[targetAxis] = NULL;
-                }
+                GetWarpPlannerInput(pRxData, &stInput);
                 
-                // 创建新的轨迹规划器
-                g_controlState.pContext[targetAxis] = FourthOrderPlannerInit(&stInput);
-                if (g_controlState.pContext[targetAxis] == NULL) {
-                    log_error("Trajectory planner initialization failed for axis %d!", targetAxis);
+                if (PlannerWorkerRequest(targetAxis, g_iCommandSequence, &stInput) != 0) {
+                    log_error("Trajectory planning request rejected for axis %d: planner queue full", targetAxis);
+                    SendAsyncFeedback(5, targetAxis, CMD_STATUS_ERROR, 1,
+                                      "Axis %d replan rejected: planner queue full", targetAxis);
                 } else {
-                    log_info("Trajectory planner reinitialized for axis %d", targetAxis);
                     log_debug("Distance: %.6f, VMax: %.6f, AMax: %.6f, JMax: %.6f, DMax: %.6f",
                              stInput.dDistance, stInput.dVMax, stInput.dAMax, stInput.dJMax, stInput.dDMax);
                 }
@@ -362,7 +911,7 @@ void ProcessCommand(struct RxData* pRxData) {
         case 6: // 修改控制器参数
             {
                 int targetAxis = pRxData->axis;
-                if (targetAxis < 0 || targetAxis >= AXIS_COUNT) {
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
                     log_error("Invalid axis number %d", targetAxis);
                     return;
                 }
@@ -370,33 +919,156 @@ void ProcessCommand(struct RxData* pRxData) {
                 log_info("Modifying controller parameters for axis %d", targetAxis);
                 
                 // 修改PID控制器参数
+                Controller* pCtrl = &g_controlState.controller.astAxis[targetAxis];
+                Controller stBackup = *pCtrl;
+                double kp = pCtrl->kp, ki = pCtrl->ki, kd = pCtrl->kd;
                 if (pRxData->dParamData[0] != 0.0) {
-                    g_controlState.controller[targetAxis].pid.kp = pRxData->dParamData[0];
+                    kp = pRxData->dParamData[0];
                     log_info("Set Kp to %.6f", pRxData->dParamData[0]);
                 }
                 
                 if (pRxData->dParamData[1] != 0.0) {
-                    g_controlState.controller[targetAxis].pid.ki = pRxData->dParamData[1];
+                    ki = pRxData->dParamData[1];
                     log_info("Set Ki to %.6f", pRxData->dParamData[1]);
                 }
                 
                 if (pRxData->dParamData[2] != 0.0) {
-                    g_controlState.controller[targetAxis].pid.kd = pRxData->dParamData[2];
+                    kd = pRxData->dParamData[2];
                     log_info("Set Kd to %.6f", pRxData->dParamData[2]);
                 }
+                // 重新生成PID二阶节系数并重新编译该轴控制器
+                ControllerSetGains(pCtrl, kp, ki, kd);
+                if (ControllerBankCompileAxis(&g_controlState.controller, targetAxis) != 0) {
+                    log_error("Controller compile failed for axis %d, gains not changed", targetAxis);
+                    *pCtrl = stBackup;
+                }
             }
             break;
             
         case 7: // 查询系统状态
             {
                 int targetAxis = pRxData->axis;
-                if (targetAxis < 0 || targetAxis >= AXIS_COUNT) {
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
                     log_error("Invalid axis number %d", targetAxis);
                     return;
                 }
                 
                 log_info("System status for axis %d:", targetAxis);
                 log_info("Control step: %d", g_controlState.iControlStep);
+                log_info("Cyclic mode: %s, mask=0x%llX, cycles=%llu, overruns=%llu, skipped=%llu",
+                         g_controlState.bCyclicMode ? "ON" : "OFF",
+                         (unsigned long long)g_controlState.ullCyclicAxisMask,
+                         g_controlState.stCycleStats.ullCycles,
+                         g_controlState.stCycleStats.ullOverruns,
+                         g_controlState.stCycleStats.ullSkipped);
+                log_info("Cycle jitter: last=%.1fus, mean=%.1fus, max=%.1fus; exec: last=%.1fus, max=%.1fus",
+                         g_controlState.stCycleStats.dLastJitterUs,
+                         CycleStatsMeanJitterUs(&g_controlState.stCycleStats),
+                         g_controlState.stCycleStats.dMaxJitterUs,
+                         g_controlState.stCycleStats.dLastExecUs,
+                         g_controlState.stCycleStats.dMaxExecUs);
+
+                stCommandQueueStats stQueueStats;
+                CommandQueueGetStats(&stQueueStats);
+                log_info("Command queue: enqueued=%llu, dequeued=%llu, overflow=%llu, depth=%ld (max %ld)",
+                         stQueueStats.ullEnqueued, stQueueStats.ullDequeued, stQueueStats.ullOverflow,
+                         stQueueStats.lDepth, stQueueStats.lMaxDepth);
+                log_info("Command queue timing: enqueue mean=%.2fus max=%.2fus, latency mean=%.1fus max=%.1fus",
+                         stQueueStats.dMeanEnqueueUs, stQueueStats.dMaxEnqueueUs,
+                         stQueueStats.dMeanLatencyUs, stQueueStats.dMaxLatencyUs);
+
+                stCSVWriterStats stCSVStats;
+                CSVWriterGetStats(&stCSVStats);
+                log_info("CSV capture: captured=%llu, dropped=%llu, written=%llu in %llu batches, depth=%ld (max %ld/%d)",
+                         stCSVStats.ullCaptured, stCSVStats.ullDropped, stCSVStats.ullWritten, stCSVStats.ullBatches,
+                         stCSVStats.lDepth, stCSVStats.lMaxDepth, CSV_RING_CAPACITY);
+                log_info("CSV output: rows=%llu, bytes=%llu in %llu writes (%llu failed), "
+                         "writer busy %.1fms, %.0f rows/s",
+                         stCSVStats.ullRows, stCSVStats.ullBytes, stCSVStats.ullWrites, stCSVStats.ullWriteFailures,
+                         stCSVStats.dBusyUs / 1000.0, stCSVStats.dRowsPerSecond);
+                if (stCSVStats.ullWriteFailures > 0) {
+                    log_error("CSV output: %llu short writes, capture files are truncated",
+                              stCSVStats.ullWriteFailures);
+                }
+                log_info("Telemetry output: %llu raw bytes -> %llu written (%.1fx)", stCSVStats.ullTelemetryRaw,
+                         stCSVStats.ullTelemetryBytes, stCSVStats.ullTelemetryBytes ?
+                         (double)stCSVStats.ullTelemetryRaw / (double)stCSVStats.ullTelemetryBytes : 0.0);
+                log_info("Flight recorder: %lld cycles recorded, keeps last %llu (%.0fs)", g_stRecorder.llSequence,
+                         g_stRecorder.ullSlotCount, g_stRecorder.ullSlotCount * SAMPLINGTIME);
+
+                stPlannerWorkerStats stPlanStats;
+                unsigned long long ullPlanDone;
+                PlannerWorkerGetStats(&stPlanStats);
+                ullPlanDone = stPlanStats.ullApplied + stPlanStats.ullFailed;
+                log_info("Planner: requested=%llu, applied=%llu, failed=%llu, rejected=%llu, feedback dropped=%llu",
+                         stPlanStats.ullRequested, stPlanStats.ullApplied, stPlanStats.ullFailed,
+                         stPlanStats.ullRejected, stQueueStats.ullFeedbackDropped);
+                log_info("Planner timing: plan mean=%.1fus max=%.1fus, request-to-apply mean=%.1fus max=%.1fus",
+                         ullPlanDone ? stPlanStats.dSumPlanUs / (double)ullPlanDone : 0.0, stPlanStats.dMaxPlanUs,
+                         ullPlanDone ? stPlanStats.dSumLatencyUs / (double)ullPlanDone : 0.0, stPlanStats.dMaxLatencyUs);
+
+                stPlannerCacheStats stCacheStats;
+                PlannerCacheGetStats(&stCacheStats);
+                log_info("Planner cache: hits=%llu, misses=%llu, entries=%d/%d (loaded %d), evictions=%llu",
+                         stCacheStats.ullHits, stCacheStats.ullMisses, stCacheStats.iEntries,
+                         PLANNER_CACHE_CAPACITY, stCacheStats.iLoaded, stCacheStats.ullEvictions);
+
+                stPlannerPoolStats stPoolStats;
+                PlannerPoolGetStats(&stPoolStats);
+                log_info("Planner pool: in use=%ld/%ld (max %ld), exhausted=%ld; control loop heap ops=%ld%s",
+                         stPoolStats.lInUse, stPoolStats.lCapacity, stPoolStats.lMaxInUse, stPoolStats.lExhausted,
+                         AllocGuardGetCount(), AllocGuardIsActive() ? "" : " (guard inactive in release build)");
+
+                stMotionQueueStats stMotionStats;
+                MotionQueueGetStats(targetAxis, &stMotionStats);
+                log_info("Motion queue: %s, targets=%llu, segments=%llu, ready=%ld, underruns=%llu, plan failures=%ld",
+                         stMotionStats.bActive ? "active" : "idle", stMotionStats.ullTargets, stMotionStats.ullSegments,
+                         stMotionStats.lReady, stMotionStats.ullUnderruns, stMotionStats.lPlanFailures);
+
+                const stFeedOverride* pFeed = GetAxisFeed(targetAxis);
+                log_info("Feed override: %.1f%% (command %.1f%%), rate %.3f/s (max %.3f/s, accel %.3f/s^2), "
+                         "group 0x%llX, time base %s",
+                         pFeed->dRatio * 100.0, pFeed->dTarget * 100.0, pFeed->dRate, pFeed->dRateMax,
+                         pFeed->dAccelMax, (unsigned long long)g_aullFeedMask[g_aiFeedGroup[targetAxis]],
+                         g_controlState.pContext[targetAxis]->bTimeWarped ? "warped" : "sample grid");
+
+                if (PathOwnsAxis(targetAxis)) {
+                    log_info("Path: %s %s, mask 0x%llX, L=%.6f, s=%.6f, path VMax=%.6f",
+                             (g_stPath.iType == PATH_TYPE_LINE) ? "line" : "arc",
+                             (g_iPathState == PATH_STATE_ARMED) ? "armed" : "running",
+                             (unsigned long long)g_ullPathMask, g_stPath.dLength, g_stPath.stPathPoint.dPos,
+                             g_stPath.stPathLimits.dVMax);
+                }
+
+                if (ReplayOwnsAxis(targetAxis)) {
+                    log_info("Trajectory file replay: %s, mask 0x%llX, frame %llu / %llu",
+                             (g_iReplayState == REPLAY_STATE_LOADING) ? "loading" :
+                             (g_iReplayState == REPLAY_STATE_ARMED) ? "armed" : "running",
+                             (unsigned long long)g_controlState.stReplay.ullAxisMask,
+                             (unsigned long long)g_controlState.stReplay.ullFrame,
+                             (unsigned long long)g_controlState.stReplay.ullFrameCount);
+                }
+
+                if (g_aiOnlineState[targetAxis] != ONLINE_STATE_OFF) {
+                    const stOnlineTrajectory* pOnline = &g_astOnline[targetAxis];
+                    log_info("Online trajectory: %s, target=%.6f, retargets=%llu, step mean=%.3fus max=%.2fus over %lld cycles",
+                             OnlineTrajectoryIsSettled(pOnline) ? "settled" : "moving",
+                             pOnline->dTarget, pOnline->ullRetargets,
+                             pOnline->llSampleIndex ? pOnline->dSumStepUs / (double)pOnline->llSampleIndex : 0.0,
+                             pOnline->dMaxStepUs, pOnline->llSampleIndex);
+                }
+
+                stPlannerDiagnostics stDiag;
+                if (FourthOrderPlannerGetDiagnostics(g_controlState.pContext[targetAxis], &stDiag) == 0) {
+                    log_info("Trajectory: T=%.4fs (Td=%.4f Tj=%.4f Ta=%.4f Tv=%.4f), alpha=%.4f%s, exit=%d",
+                             stDiag.dTotalTime, stDiag.dTd, stDiag.dTj, stDiag.dTa, stDiag.dTv,
+                             stDiag.dAlphaScaleFactor, stDiag.bIsTimeScaled ? " (time scaled)" : "", stDiag.iExitFlag);
+                    log_info("Trajectory peaks: v=%.6f/%.6f a=%.6f/%.6f j=%.6f/%.6f (peak/effective limit)",
+                             stDiag.dVPeak, stDiag.dVMaxEffective, stDiag.dAPeak, stDiag.dAMaxEffective,
+                             stDiag.dJPeak, stDiag.dJMaxEffective);
+                    log_info("Trajectory planning cost: %.1fus, %d solver iterations",
+                             stDiag.dInitUs, stDiag.iSolverIterations);
+                }
                 log_debug("Target position: %.12f", g_controlState.ctrl_data.dTargetPosition[targetAxis]);
                 log_debug("Actual position: %.15f", g_controlState.ctrl_data.dActualPosition[targetAxis]);
                 log_debug("Error: %.13f", g_controlState.ctrl_data.dError[targetAxis]);
@@ -404,9 +1076,13 @@ void ProcessCommand(struct RxData* pRxData) {
                 log_debug("Output position: %.12f", g_controlState.ctrl_data.dOutputPosition[targetAxis]);
                 
                 // 显示控制器参数
-                log_debug("Controller Kp: %.6f", g_controlState.controller[targetAxis].pid.kp);
-                log_debug("Controller Ki: %.6f", g_controlState.controller[targetAxis].pid.ki);
-                log_debug("Controller Kd: %.6f", g_controlState.controller[targetAxis].pid.kd);
+                log_debug("Controller Kp: %.6f", g_controlState.controller.astAxis[targetAxis].kp);
+                log_debug("Controller Ki: %.6f", g_controlState.controller.astAxis[targetAxis].ki);
+                log_debug("Controller Kd: %.6f", g_controlState.controller.astAxis[targetAxis].kd);
+                log_debug("Controller sections: %d (notches: %d), bank stages %d",
+                          g_controlState.controller.astAxis[targetAxis].stCascade.iSectionCount,
+                          g_controlState.controller.astAxis[targetAxis].iNotchCount,
+                          g_controlState.controller.iStageCount);
                 
                 // 显示轨迹参数
                 if (g_controlState.pContext[targetAxis] != NULL) {
@@ -420,7 +1096,7 @@ void ProcessCommand(struct RxData* pRxData) {
         case 8: // 同时控制所有轴
             {
                 // 控制所有轴 (使用全1掩码)
-                int axisMask = (1 << AXIS_COUNT) - 1;
+                uint64_t axisMask = AxisConfigAllMask();
                 log_info("Controlling all axes");
                 
                 // 执行单步控制
@@ -433,7 +1109,7 @@ void ProcessCommand(struct RxData* pRxData) {
         case 9: // 执行所有轴的多步控制
             {
                 // 控制所有轴 (使用全1掩码)
-                int axisMask = (1 << AXIS_COUNT) - 1;
+                uint64_t axisMask = AxisConfigAllMask();
                 int stepsToExecute = (int)pRxData->dParamData[0];
                 log_info("Executing %d control steps on all axes", stepsToExecute);
                 for(int i = 0; i < stepsToExecute && g_controlState.iControlStep < TOTALSTEPS; i++) {
@@ -445,6 +1121,551 @@ void ProcessCommand(struct RxData* pRxData) {
             }
             break;
             
+        case 10: // 启动周期控制模式
+            {
+                // axis 按位表示参与控制的轴 (1: 轴0, 2: 轴1, 3: 轴0和轴1, iReserved[0] 为高32位)
+                uint64_t axisMask = 0;
+                if (GetCommandAxisMask(pRxData, &axisMask) != 0) {
+                    log_error("Invalid axis value %d for CMD 10", pRxData->axis);
+                    return;
+                }
+                g_controlState.ullCyclicAxisMask = axisMask;
+                g_controlState.bCyclicMode = 1;
+                CycleStatsReset(&g_controlState.stCycleStats);
+                log_info("Cyclic mode started: axis mask 0x%llX, period %.3f ms", (unsigned long long)axisMask, SAMPLINGTIME * 1000.0);
+            }
+            break;
+
+        case 11: // 停止周期控制模式
+            if (g_controlState.bCyclicMode) {
+                g_controlState.bCyclicMode = 0;
+                log_info("Cyclic mode stopped after %llu cycles: overruns=%llu, jitter mean=%.1fus max=%.1fus, exec max=%.1fus",
+                         g_controlState.stCycleStats.ullCycles,
+                         g_controlState.stCycleStats.ullOverruns,
+                         CycleStatsMeanJitterUs(&g_controlState.stCycleStats),
+                         g_controlState.stCycleStats.dMaxJitterUs,
+                         g_controlState.stCycleStats.dMaxExecUs);
+            }
+            break;
+
+        case 12: // 多轴同步规划 (共同结束时间)
+            {
+                // iReserved[1]: 0 暂存 axis 轴的运动参数 (同 CMD 5, 但位移可为 0), 不规划;
+                //               1 同步规划并切换掩码中的轴 (axis 为低32位掩码, iReserved[0] 为高32位),
+                //                 dParamData[0] > 0 时作为共同时间下限 [s]
+                if (pRxData->iReserved[1] == 0) {
+                    int targetAxis = pRxData->axis;
+                    if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
+                        log_error("Invalid axis number %d", targetAxis);
+                        SendAsyncFeedback(12, targetAxis, CMD_STATUS_ERROR, 3, "Invalid axis %d", targetAxis);
+                        return;
+                    }
+                    GetWarpPlannerInput(pRxData, &g_astStagedInput[targetAxis]);
+                    // 位移不取默认值: 0 表示该轴不动 (以零速停留到共同结束时间)
+                    g_astStagedInput[targetAxis].dDistance = pRxData->dParamData[0];
+                    g_ullStagedMask |= 1ULL << targetAxis;
+                    SendAsyncFeedback(12, targetAxis, CMD_STATUS_COMPLETED, 0, "Axis %d staged: S=%.6f",
+                                      targetAxis, g_astStagedInput[targetAxis].dDistance);
+                    break;
+                }
+
+                uint64_t axisMask = 0;
+                if (GetCommandAxisMask(pRxData, &axisMask) != 0 || (axisMask & ~g_ullStagedMask) != 0) {
+                    log_error("CMD 12: axis mask 0x%llX invalid or not fully staged (staged 0x%llX)",
+                              (unsigned long long)axisMask, (unsigned long long)g_ullStagedMask);
+                    SendAsyncFeedback(12, pRxData->axis, CMD_STATUS_ERROR, 3,
+                                      "Axis mask 0x%llX not staged", (unsigned long long)axisMask);
+                    return;
+                }
+                for (int axis = 0; axis < g_iAxisCount; axis++) {
+                    if ((axisMask & (1ULL << axis)) &&
+                        (MotionQueueIsActive(axis) || g_aiOnlineState[axis] != ONLINE_STATE_OFF || PathOwnsAxis(axis) ||
+                         ReplayOwnsAxis(axis))) {
+                        log_error("Synchronized planning rejected: motion queue, online trajectory, path or replay active on axis %d", axis);
+                        SendAsyncFeedback(12, pRxData->axis, CMD_STATUS_ERROR, 1,
+                                          "Synchronized replan rejected: axis %d busy", axis);
+                        return;
+                    }
+                }
+                for (int axis = 0; axis < g_iAxisCount; axis++) {
+                    g_astStagedInput[axis].dTimeLimit = (pRxData->dParamData[0] > 0.0) ? pRxData->dParamData[0] : 0.0;
+                }
+                if (PlannerWorkerRequestGroup(axisMask, g_iCommandSequence, g_astStagedInput) != 0) {
+                    log_error("Synchronized planning request rejected: planner busy");
+                    SendAsyncFeedback(12, pRxData->axis, CMD_STATUS_ERROR, 1,
+                                      "Synchronized replan rejected: planner busy");
+                    return;
+                }
+                g_ullStagedMask &= ~axisMask;
+                log_info("Synchronized replan requested for axis mask 0x%llX", (unsigned long long)axisMask);
+            }
+            break;
+
+        case 13: // 配置控制器滤波链路
+            {
+                // iReserved[1]: 0 清除PID后的所有滤波器, 1 追加低通 (频率, 阻尼),
+                //               2 追加陷波 (零点频率, 极点频率, 零点阻尼, 极点阻尼),
+                //               3 追加超前/滞后 (零点频率, 极点频率), 4 恢复默认滤波器 (保留当前PID增益)
+                // 频率须低于奈奎斯特频率 0.5/SAMPLINGTIME (达到奈奎斯特频率的双线性离散化已不在所设频率上);
+                // 频率 > 0、低通阻尼与陷波极点阻尼 > 0、陷波零点阻尼 >= 0 由 ControllerAdd* 检查
+                int targetAxis = pRxData->axis;
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
+                    log_error("Invalid axis number %d", targetAxis);
+                    return;
+                }
+                Controller* pCtrl = &g_controlState.controller.astAxis[targetAxis];
+                Controller stBackup = *pCtrl;
+                const double* p = pRxData->dParamData;
+                const double dNyquist = 0.5 / SAMPLINGTIME;
+                int iResult = 0;
+
+                switch (pRxData->iReserved[1]) {
+                    case 0:
+                        ControllerClearFilters(pCtrl);
+                        break;
+                    case 1:
+                        if (p[0] >= dNyquist) {
+                            iResult = -1;
+                            break;
+                        }
+                        iResult = ControllerAddLowPass(pCtrl, p[0], p[1]);
+                        break;
+                    case 2:
+                        if (p[0] >= dNyquist || p[1] >= dNyquist) {
+                            iResult = -1;
+                            break;
+                        }
+                        iResult = ControllerAddNotch(pCtrl, p[0], p[1], p[2], p[3]);
+                        break;
+                    case 3:
+                        if (p[0] >= dNyquist || p[1] >= dNyquist) {
+                            iResult = -1;
+                            break;
+                        }
+                        iResult = ControllerAddLeadLag(pCtrl, p[0], p[1]);
+                        break;
+                    case 4:
+                        ControllerRestoreDefaultFilters(pCtrl);
+                        break;
+                    default:
+                        iResult = -1;
+                        break;
+                }
+                if (iResult == 0) {
+                    iResult = ControllerBankCompileAxis(&g_controlState.controller, targetAxis);
+                }
+
+                if (iResult != 0) {
+                    *pCtrl = stBackup;
+                    log_error("Filter configuration %d rejected for axis %d (params %g/%g/%g/%g, Nyquist %g Hz, "
+                              "sections %d/%d, notches %d/%d)",
+                              pRxData->iReserved[1], targetAxis, p[0], p[1], p[2], p[3], dNyquist,
+                              pCtrl->stCascade.iSectionCount, SOS_MAX_SECTIONS,
+                              pCtrl->iNotchCount, CONTROLLER_MAX_NOTCHES);
+                } else {
+                    log_info("Axis %d controller: %d sections, %d notches (bank stages %d)",
+                             targetAxis, pCtrl->stCascade.iSectionCount, pCtrl->iNotchCount,
+                             g_controlState.controller.iStageCount);
+                }
+            }
+            break;
+
+        case 14: // 前瞻运动队列
+            {
+                // iReserved[1]: 0 开始程序 (起点为当前轨迹终点, 当前轨迹执行完后开始),
+                //               1 追加目标点 (dParamData[0] 为绝对目标位置, [1]~[4] 为本段 VMax, AMax, JMax, DMax,
+                //                 为 0 时取默认值; 每个目标点只反馈一次最终状态), 2 结束程序 (在最后一个目标点停止)
+                int targetAxis = pRxData->axis;
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
+                    log_error("Invalid axis number %d", targetAxis);
+                    SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 3, "Invalid axis %d", targetAxis);
+                    return;
+                }
+
+                switch (pRxData->iReserved[1]) {
+                    case 0:
+                        {
+                            stTrajectoryPoint stEnd;
+                            if (PlannerWorkerIsPending(1ULL << targetAxis) || g_aiOnlineState[targetAxis] != ONLINE_STATE_OFF ||
+                                PathOwnsAxis(targetAxis) || ReplayOwnsAxis(targetAxis) ||
+                                FourthOrderPlannerGetPointAt(g_controlState.pContext[targetAxis],
+                                                             g_controlState.pContext[targetAxis]->dTotalTime, &stEnd) != 0 ||
+                                MotionQueueBegin(targetAxis, stEnd.dPos) != 0) {
+                                log_error("Motion queue start rejected for axis %d: replan pending, queue or online trajectory active", targetAxis);
+                                SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 1,
+                                                  "Axis %d motion queue busy", targetAxis);
+                                return;
+                            }
+                            log_info("Motion queue started for axis %d at %.6f", targetAxis, stEnd.dPos);
+                            SendAsyncFeedback(14, targetAxis, CMD_STATUS_COMPLETED, 0,
+                                              "Axis %d motion queue started at %.6f", targetAxis, stEnd.dPos);
+                        }
+                        break;
+                    case 1:
+                        {
+                            stPlannerInput stLimits;
+                            GetWarpPlannerInput(pRxData, &stLimits);
+                            stLimits.dDistance = 0.0;
+                            if (!MotionQueueIsActive(targetAxis)) {
+                                SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 3,
+                                                  "Axis %d motion queue not started", targetAxis);
+                                return;
+                            }
+                            if (MotionQueuePushTarget(targetAxis, pRxData->dParamData[0], &stLimits) != 0) {
+                                SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 1,
+                                                  "Axis %d motion queue full or ended", targetAxis);
+                                return;
+                            }
+                            SendAsyncFeedback(14, targetAxis, CMD_STATUS_COMPLETED, 0,
+                                              "Axis %d target %.6f queued", targetAxis, pRxData->dParamData[0]);
+                        }
+                        break;
+                    case 2:
+                        if (MotionQueueEnd(targetAxis) != 0) {
+                            SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 1,
+                                              "Axis %d motion queue not started, ended or full", targetAxis);
+                            return;
+                        }
+                        log_info("Motion queue program ended for axis %d", targetAxis);
+                        SendAsyncFeedback(14, targetAxis, CMD_STATUS_COMPLETED, 0,
+                                          "Axis %d motion queue ending", targetAxis);
+                        break;
+                    default:
+                        SendAsyncFeedback(14, targetAxis, CMD_STATUS_ERROR, 3,
+                                          "Unknown motion queue operation %d", pRxData->iReserved[1]);
+                        break;
+                }
+            }
+            break;
+
+        case 15: // 在线轨迹生成 (运动中随时修改目标)
+            {
+                // iReserved[1]: 0 开始 (从当前参考的位置、速度、加速度立即接管, 运动中的 CMD 5 轨迹或运动队列程序
+                //                 就此中止, 未改目标时平稳停止; dParamData[1]~[4] 为 VMax, AMax, JMax, DMax,
+                //                 为 0 时取默认值), 1 修改目标 (dParamData[0] 为绝对目标位置,
+                //                 dParamData[1] > 0 时同时修改速度上限), 2 以最大减速度停止,
+                //               3 退出 (须已到位, 之后停在到位点)
+                int targetAxis = pRxData->axis;
+                if (targetAxis < 0 || targetAxis >= g_iAxisCount) {
+                    log_error("Invalid axis number %d", targetAxis);
+                    SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 3, "Invalid axis %d", targetAxis);
+                    return;
+                }
+                stOnlineTrajectory* pOnline = &g_astOnline[targetAxis];
+                int iState = g_aiOnlineState[targetAxis];
+
+                if (pRxData->iReserved[1] != 0 && iState == ONLINE_STATE_OFF) {
+                    SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 3,
+                                      "Axis %d online trajectory not started", targetAxis);
+                    return;
+                }
+                switch (pRxData->iReserved[1]) {
+                    case 0:
+                        {
+                            stPlannerInput stLimits;
+                            stPlannerInputEx stHold;
+                            stTrajectoryPoint stStart;
+                            if (iState != ONLINE_STATE_OFF || PathOwnsAxis(targetAxis) || ReplayOwnsAxis(targetAxis) ||
+                                PlannerWorkerIsPending(1ULL << targetAxis)) {
+                                log_error("Online trajectory start rejected for axis %d: axis busy", targetAxis);
+                                SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 1, "Axis %d busy", targetAxis);
+                                return;
+                            }
+                            GetCommandPlannerInput(pRxData, &stLimits);
+                            GetLiveReference(targetAxis, &stStart);
+                            if (OnlineTrajectoryInitFrom(pOnline, &stStart, &stLimits) != 0) {
+                                log_error("Online trajectory limits rejected for axis %d (v=%.6f a=%.6f)",
+                                          targetAxis, stStart.dVel, stStart.dAcc);
+                                SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 3,
+                                                  "Axis %d limits invalid, window over %d samples or v/a above limits",
+                                                  targetAxis, ONLINE_TRAJ_MAX_WINDOW);
+                                return;
+                            }
+                            // 运动队列程序: 中止后由控制周期的 MotionQueueSelect 丢弃其余段
+                            if (MotionQueueAbort(targetAxis) != 0) {
+                                log_error("Online trajectory start rejected for axis %d: queue abort failed",
+                                          targetAxis);
+                                SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 1,
+                                                  "Axis %d motion queue busy, retry", targetAxis);
+                                return;
+                            }
+                            // 原轨迹不再执行, 换为停在接管点的零位移轨迹 (队列段随之归还)
+                            memset(&stHold, 0, sizeof(stHold));
+                            stHold.stLimits = stLimits;
+                            stHold.dStartPos = stStart.dPos;
+                            FourthOrderPlannerInitEx(&stHold, &g_astHoldContext[targetAxis]);
+                            g_controlState.pContext[targetAxis] = &g_astHoldContext[targetAxis];
+                            g_aiOnlineState[targetAxis] = ONLINE_STATE_RUNNING;
+                            log_info("Online trajectory started for axis %d at %.6f (v=%.6f a=%.6f, windows %d/%d)",
+                                     targetAxis, stStart.dPos, stStart.dVel, stStart.dAcc,
+                                     pOnline->iLen1, pOnline->iLen2);
+                            SendAsyncFeedback(15, targetAxis, CMD_STATUS_COMPLETED, 0,
+                                              "Axis %d online from %.6f v=%.4f a=%.4f, lag %.3fs", targetAxis,
+                                              stStart.dPos, stStart.dVel, stStart.dAcc,
+                                              (pOnline->iLen1 + pOnline->iLen2) * SAMPLINGTIME);
+                        }
+                        break;
+                    case 1:
+                        if (OnlineTrajectorySetTarget(pOnline, pRxData->dParamData[0], pRxData->dParamData[1]) != 0) {
+                            SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 3, "Axis %d target invalid", targetAxis);
+                            return;
+                        }
+                        SendAsyncFeedback(15, targetAxis, CMD_STATUS_COMPLETED, 0, "Axis %d target %.6f",
+                                          targetAxis, pOnline->dTarget);
+                        break;
+                    case 2:
+                        OnlineTrajectoryStop(pOnline);
+                        SendAsyncFeedback(15, targetAxis, CMD_STATUS_COMPLETED, 0, "Axis %d stopping at %.6f",
+                                          targetAxis, pOnline->dTarget);
+                        break;
+                    case 3:
+                        {
+                            stPlannerInputEx stHold;
+                            if (!OnlineTrajectoryIsSettled(pOnline)) {
+                                SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 1,
+                                                  "Axis %d not settled", targetAxis);
+                                return;
+                            }
+                            memset(&stHold, 0, sizeof(stHold));
+                            stHold.stLimits = pOnline->stLimits;
+                            stHold.dStartPos = pOnline->dTarget;
+                            FourthOrderPlannerInitEx(&stHold, &g_astHoldContext[targetAxis]);
+                            g_controlState.pContext[targetAxis] = &g_astHoldContext[targetAxis];
+                            g_aiOnlineState[targetAxis] = ONLINE_STATE_OFF;
+                            log_info("Online trajectory released for axis %d: %lld cycles, step mean %.3fus max %.2fus",
+                                     targetAxis, pOnline->llSampleIndex,
+                                     pOnline->llSampleIndex ? pOnline->dSumStepUs / (double)pOnline->llSampleIndex : 0.0,
+                                     pOnline->dMaxStepUs);
+                            SendAsyncFeedback(15, targetAxis, CMD_STATUS_COMPLETED, 0,
+                                              "Axis %d released at %.6f, step max %.2fus", targetAxis,
+                                              pOnline->dTarget, pOnline->dMaxStepUs);
+                        }
+                        break;
+                    default:
+                        SendAsyncFeedback(15, targetAxis, CMD_STATUS_ERROR, 3,
+                                          "Unknown online trajectory operation %d", pRxData->iReserved[1]);
+                        break;
+                }
+            }
+            break;
+
+        case 16: // 进给倍率 (不重新规划)
+            {
+                // axis 按位表示轴 (iReserved[0] 为高32位), 这些轴组成一个倍率组 (同步规划的轴须在同一组);
+                // dParamData[0] 为倍率 [%] (0 ~ 200, 0 即进给保持), 运动中按组内最严的轴限制变化速率;
+                // 附加加速度/Jerk 比例固定为 FEED_OVERRIDE_SHARE (规划约束已按此预留), dParamData[1] 须为 0.
+                // 组内有轴正在执行在线轨迹/文件回放时, 倍率在其回到规划轨迹后才作用于该轴, 以 EXECUTING (2) 反馈
+                uint64_t axisMask = 0;
+                double dRatio = pRxData->dParamData[0] / 100.0;
+                if (GetCommandAxisMask(pRxData, &axisMask) != 0 || !(dRatio >= 0.0) || dRatio > FEED_OVERRIDE_MAX ||
+                    pRxData->dParamData[1] != 0.0) {
+                    log_error("Feed override rejected: axis mask 0x%X, %.1f%%, share %.3f",
+                              pRxData->axis, pRxData->dParamData[0], pRxData->dParamData[1]);
+                    SendAsyncFeedback(16, pRxData->axis, CMD_STATUS_ERROR, 3,
+                                      "Feed override rejected: mask 0x%X/0x%X, %.1f%% (0~%.0f), "
+                                      "share %.3f (fixed %.2f)",
+                                      pRxData->iReserved[0], pRxData->axis, pRxData->dParamData[0],
+                                      FEED_OVERRIDE_MAX * 100.0, pRxData->dParamData[1], FEED_OVERRIDE_SHARE);
+                    return;
+                }
+                int iGroup = GetMaskFeedbackAxis(axisMask);
+                if (SetFeedGroup(axisMask) != 0) {
+                    log_error("Feed override rejected for axis mask 0x%llX: axes moving at different ratios",
+                              (unsigned long long)axisMask);
+                    SendAsyncFeedback(16, iGroup, CMD_STATUS_ERROR, 1,
+                                      "Mask 0x%llX axes moving at different feed ratios, group them at rest",
+                                      (unsigned long long)axisMask);
+                    return;
+                }
+                stFeedOverride* pFeed = &g_astFeed[iGroup];
+                FeedOverrideSet(pFeed, dRatio);
+                uint64_t ullDeferred = 0;
+                for (int axis = iGroup; axis < g_iAxisCount; axis++) {
+                    if (((axisMask >> axis) & 1ULL) && !FeedAxisWarped(axis)) {
+                        ullDeferred |= 1ULL << axis;
+                    }
+                }
+                log_info("Feed override %.1f%% -> %.1f%% (max rate %.3f/s) for axis mask 0x%llX, deferred 0x%llX",
+                         pFeed->dRatio * 100.0, pFeed->dTarget * 100.0, pFeed->dRateMax,
+                         (unsigned long long)axisMask, (unsigned long long)ullDeferred);
+                if (ullDeferred != 0) {
+                    SendAsyncFeedback(16, iGroup, CMD_STATUS_EXECUTING, 2,
+                                      "Feed override %.1f%% set, axes 0x%llX on online/replay motion apply it later",
+                                      pFeed->dTarget * 100.0, (unsigned long long)ullDeferred);
+                } else {
+                    SendAsyncFeedback(16, iGroup, CMD_STATUS_COMPLETED, 0,
+                                      "Feed override %.1f%% -> %.1f%% for mask 0x%llX", pFeed->dRatio * 100.0,
+                                      pFeed->dTarget * 100.0, (unsigned long long)axisMask);
+                }
+            }
+            break;
+
+        case 17: // 多轴路径插补 (直线 / 圆弧)
+            {
+                // iReserved[1]: 0 设置路径合成约束 (dParamData[1]~[4] 为 VMax, AMax, JMax, DMax, 为 0 时取默认值),
+                //               1 暂存 axis 轴的直线终点 (dParamData[0] 为绝对位置),
+                //               2 开始直线 (axis 为低32位掩码, iReserved[0] 为高32位, 各轴须已暂存终点),
+                //               3 开始圆弧 (axis 为 X 轴号, iReserved[0] 为 Y 轴号; dParamData[0]~[1] 终点 X/Y,
+                //                 [2]~[3] 圆心 X/Y, [4] >= 0 逆时针, < 0 顺时针; 终点与起点重合时为整圆),
+                //               4 取消尚未接管的路径
+                // 路径起点为各参与轴当前轨迹的终点, 当前轨迹全部执行完后接管; 完成时经反馈队列报告
+                // (反馈 axis 为参与轴中最低的轴号, 消息中含完整掩码)
+                int iOperation = pRxData->iReserved[1];
+                uint64_t axisMask = 0;
+                double adStart[MAX_AXIS_COUNT];
+                int iResult;
+
+                switch (iOperation) {
+                    case 0:
+                        GetWarpPlannerInput(pRxData, &g_stPathLimits);
+                        g_stPathLimits.dDistance = 0.0;
+                        SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_COMPLETED, 0,
+                                          "Path planning limits V=%.6f A=%.6f J=%.6f D=%.6f", g_stPathLimits.dVMax,
+                                          g_stPathLimits.dAMax, g_stPathLimits.dJMax, g_stPathLimits.dDMax);
+                        return;
+                    case 1:
+                        if (pRxData->axis < 0 || pRxData->axis >= g_iAxisCount || !isfinite(pRxData->dParamData[0])) {
+                            SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 3, "Invalid axis %d", pRxData->axis);
+                            return;
+                        }
+                        g_adPathTarget[pRxData->axis] = pRxData->dParamData[0];
+                        g_ullPathStagedMask |= 1ULL << pRxData->axis;
+                        SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_COMPLETED, 0, "Axis %d line end %.6f staged",
+                                          pRxData->axis, pRxData->dParamData[0]);
+                        return;
+                    case 2:
+                        if (GetCommandAxisMask(pRxData, &axisMask) != 0 || (axisMask & ~g_ullPathStagedMask) != 0) {
+                            SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 3,
+                                              "Axis mask 0x%llX invalid or not fully staged", (unsigned long long)axisMask);
+                            return;
+                        }
+                        break;
+                    case 3:
+                        if (pRxData->axis < 0 || pRxData->axis >= g_iAxisCount || pRxData->iReserved[0] < 0 ||
+                            pRxData->iReserved[0] >= g_iAxisCount || pRxData->axis == pRxData->iReserved[0]) {
+                            SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 3, "Invalid arc axes %d/%d",
+                                              pRxData->axis, pRxData->iReserved[0]);
+                            return;
+                        }
+                        axisMask = (1ULL << pRxData->axis) | (1ULL << pRxData->iReserved[0]);
+                        break;
+                    case 4:
+                        if (g_iPathState != PATH_STATE_ARMED) {
+                            SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 1, "No armed path to cancel");
+                            return;
+                        }
+                        g_iPathState = PATH_STATE_OFF;
+                        SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_COMPLETED, 0, "Armed path cancelled");
+                        return;
+                    default:
+                        SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 3, "Unknown path operation %d", iOperation);
+                        return;
+                }
+
+                if (g_iPathState != PATH_STATE_OFF || PlannerWorkerIsPending(axisMask)) {
+                    SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 1, "Path rejected: path or replan pending");
+                    return;
+                }
+                for (int axis = 0; axis < g_iAxisCount; axis++) {
+                    if (!(axisMask & (1ULL << axis))) {
+                        continue;
+                    }
+                    if (MotionQueueIsActive(axis) || g_aiOnlineState[axis] != ONLINE_STATE_OFF || ReplayOwnsAxis(axis)) {
+                        SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 1, "Path rejected: axis %d busy", axis);
+                        return;
+                    }
+                    stTrajectoryPoint stEnd;
+                    FourthOrderPlannerGetPointAt(g_controlState.pContext[axis], g_controlState.pContext[axis]->dTotalTime, &stEnd);
+                    adStart[axis] = stEnd.dPos;
+                }
+
+                if (iOperation == 2) {
+                    iResult = PathInterpInitLine(&g_stPath, axisMask, adStart, g_adPathTarget, &g_stPathLimits);
+                } else {
+                    const double* p = pRxData->dParamData;
+                    iResult = PathInterpInitArc(&g_stPath, pRxData->axis, pRxData->iReserved[0], adStart,
+                                                p[0], p[1], p[2], p[3], (p[4] < 0.0) ? -1 : 1, &g_stPathLimits);
+                }
+                if (iResult != 0) {
+                    log_error("Path rejected: invalid geometry or limits");
+                    SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_ERROR, 3, "Path geometry or limits invalid");
+                    return;
+                }
+                for (int k = 0; k < g_stPath.iAxisCount; k++) {
+                    g_aiPathSlot[g_stPath.aiAxis[k]] = k;
+                }
+                if (iOperation == 2) {
+                    g_ullPathStagedMask &= ~axisMask;
+                }
+                g_ullPathMask = axisMask;
+                g_iPathSequence = g_iCommandSequence;
+                g_iPathState = PATH_STATE_ARMED;
+                log_info("%s path armed for mask 0x%llX: L=%.6f, T=%.4fs, path VMax=%.6f",
+                         (iOperation == 2) ? "Line" : "Arc", (unsigned long long)axisMask, g_stPath.dLength,
+                         g_stPath.stContext.dTotalTime, g_stPath.stPathLimits.dVMax);
+                SendAsyncFeedback(17, pRxData->axis, CMD_STATUS_EXECUTING, 0, "%s path armed: L=%.6f, T=%.4fs",
+                                  (iOperation == 2) ? "Line" : "Arc", g_stPath.dLength, g_stPath.stContext.dTotalTime);
+            }
+            break;
+
+        case 18: // 离线轨迹文件回放
+            {
+                // iReserved[1]: 0 开始回放 (文件为 TRAJ_FILE_NAME_FORMAT, 编号为 dParamData[0];
+                //                 axis 为低32位掩码, iReserved[0] 为高32位, 文件轴依次对应掩码中由低到高的各轴),
+                //               1 取消尚未接管的回放
+                // 文件由规划线程打开并映射 (控制线程不做文件系统调用), 映射完成后检查 (见 ArmReplay):
+                // 已通过约束检查, 帧间隔等于控制周期, 文件约束不超过各轴约束, 首末帧静止, 首帧位置等于各轴当前轨迹终点;
+                // 检查结果 (armed / rejected) 与完成均经反馈队列报告 (反馈 axis 为最低的参与轴号, 消息中含完整掩码);
+                // 当前轨迹全部执行完后接管
+                stTrajectoryFile* pReplay = &g_controlState.stReplay;
+                uint64_t axisMask = 0;
+                char szPath[TRAJ_FILE_PATH_CHARS];
+
+                if (pRxData->iReserved[1] == 1) {
+                    if (g_iReplayState == REPLAY_STATE_LOADING) {
+                        g_bReplayCancelled = 1;
+                    } else if (g_iReplayState == REPLAY_STATE_ARMED) {
+                        TrajectoryFileRequestClose(pReplay);
+                        memset(pReplay, 0, sizeof(*pReplay));
+                        g_iReplayState = REPLAY_STATE_OFF;
+                    } else {
+                        SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_ERROR, 1, "No armed replay to cancel");
+                        return;
+                    }
+                    SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_COMPLETED, 0, "Armed replay cancelled");
+                    return;
+                }
+                if (pRxData->iReserved[1] != 0 || GetCommandAxisMask(pRxData, &axisMask) != 0) {
+                    SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_ERROR, 3, "Invalid replay operation or axis mask");
+                    return;
+                }
+                if (g_iReplayState != REPLAY_STATE_OFF || PlannerWorkerIsPending(axisMask)) {
+                    SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_ERROR, 1, "Replay rejected: replay or replan pending");
+                    return;
+                }
+                for (int axis = 0; axis < g_iAxisCount; axis++) {
+                    if ((axisMask & (1ULL << axis)) &&
+                        (MotionQueueIsActive(axis) || g_aiOnlineState[axis] != ONLINE_STATE_OFF || PathOwnsAxis(axis))) {
+                        SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_ERROR, 1, "Replay rejected: axis %d busy", axis);
+                        return;
+                    }
+                }
+
+                sprintf_s(szPath, sizeof(szPath), TRAJ_FILE_NAME_FORMAT, (int)pRxData->dParamData[0]);
+                if (TrajectoryFileRequestOpen(szPath) != 0) {
+                    SendAsyncFeedback(18, pRxData->axis, CMD_STATUS_ERROR, 1, "Replay rejected: file loader busy");
+                    return;
+                }
+                memset(pReplay, 0, sizeof(*pReplay));
+                pReplay->ullAxisMask = axisMask;
+                strcpy_s(g_szReplayPath, sizeof(g_szReplayPath), szPath);
+                g_iReplaySequence = g_iCommandSequence;
+                g_bReplayCancelled = 0;
+                g_iReplayState = REPLAY_STATE_LOADING;
+                log_debug("Trajectory file %s loading for mask 0x%llX", szPath, (unsigned long long)axisMask);
+            }
+            break;
+
         case 999: // 断开连接
             log_info("Received disconnect command");
             g_controlState.bControlRunning = 0;
@@ -457,21 +1678,99 @@ void ProcessCommand(struct RxData* pRxData) {
 }
 
 
-// 在 ExecuteSocketCommand 函数中添加对轴参数的支持
+// 取出本周期内到达的所有Socket指令并依次处理 (每周期最多处理 COMMAND_DRAIN_MAX_PER_CYCLE 条)
 void ExecuteSocketCommand(void)
 {
-    if(g_bDataReceived)
+    stCommandEntry stEntry;
+    int iDrained = 0;
+
+    while(iDrained < COMMAND_DRAIN_MAX_PER_CYCLE && CommandQueuePop(&stEntry) == 0)
     {
         // 使用新的指令解析函数处理命令
-        ProcessCommand(&g_rxData);
-        
-        g_bDataReceived = 0;
+        g_iCommandSequence = stEntry.iSequence;
+        ProcessCommand(&stEntry.stRx);
+        iDrained++;
+    }
+}
+
+// 在周期边界应用规划线程已完成的轨迹, 并经反馈队列报告完成状态与规划耗时
+static void ApplyPlannerResults(void)
+{
+    stPlanResult stResult;
+
+    while (PlannerWorkerApply(&stResult) == 0)
+    {
+        CommandFeedback stFeedback = {0};
+        if (stResult.iAxis == PLANNER_GROUP_REQUEST) {
+            stFeedback.iCMD = 12;
+            stFeedback.axis = GetMaskFeedbackAxis(stResult.ullAxisMask);
+            stFeedback.sequenceNumber = stResult.iSequence;
+            if (stResult.iStatus == 0) {
+                for (int axis = 0; axis < g_iAxisCount; axis++) {
+                    if (stResult.ullAxisMask & (1ULL << axis)) {
+                        g_controlState.pContext[axis] = PlannerWorkerGetContext(axis);
+                    }
+                }
+                stFeedback.status = CMD_STATUS_COMPLETED;
+                sprintf_s(stFeedback.message, sizeof(stFeedback.message),
+                          "Mask 0x%llX replanned: T=%.4fs (slowest axis %d, %d scaled), plan %.1fus, applied after %.1fus",
+                          (unsigned long long)stResult.ullAxisMask, stResult.stGroup.dCommonTime,
+                          stResult.stGroup.iSlowestAxis, stResult.stGroup.iScaledAxes,
+                          stResult.dPlanUs, stResult.dLatencyUs);
+            } else {
+                stFeedback.status = CMD_STATUS_ERROR;
+                stFeedback.errorCode = 2;
+                if (stResult.stGroup.bPoolTimeout) {
+                    sprintf_s(stFeedback.message, sizeof(stFeedback.message),
+                              "Mask 0x%llX replan failed: planner thread pool timed out, previous trajectories kept",
+                              (unsigned long long)stResult.ullAxisMask);
+                } else {
+                    sprintf_s(stFeedback.message, sizeof(stFeedback.message),
+                                  "Mask 0x%llX replan failed at axis %d, previous trajectories kept",
+                              (unsigned long long)stResult.ullAxisMask, stResult.stGroup.iFailedAxis);
+                }
+            }
+            CommandFeedbackPush(&stFeedback);
+            continue;
+        }
+        stFeedback.iCMD = 5;
+        stFeedback.axis = stResult.iAxis;
+        stFeedback.sequenceNumber = stResult.iSequence;
+        if (stResult.iStatus == 0) {
+            g_controlState.pContext[stResult.iAxis] = PlannerWorkerGetContext(stResult.iAxis);
+            stFeedback.status = CMD_STATUS_COMPLETED;
+            sprintf_s(stFeedback.message, sizeof(stFeedback.message),
+                      "Axis %d replanned: plan %.1fus%s, applied after %.1fus, T=%.4fs",
+                      stResult.iAxis, stResult.dPlanUs, stResult.bCacheHit ? " (cached)" : "", stResult.dLatencyUs,
+                      g_controlState.pContext[stResult.iAxis]->dTotalTime);
+        } else {
+            stFeedback.status = CMD_STATUS_ERROR;
+            stFeedback.errorCode = 2;
+            sprintf_s(stFeedback.message, sizeof(stFeedback.message),
+                      "Axis %d replan failed after %.1fus, previous trajectory kept",
+                      stResult.iAxis, stResult.dPlanUs);
+        }
+        CommandFeedbackPush(&stFeedback);
     }
 }
 
 // 清理控制资源
 void CleanupControlSystem(void)
 {
+    PlannerWorkerStop();
+    ThreadPoolDestroy();
+    // 规划线程已停止: 关闭仍映射的轨迹文件
+    TrajectoryFileLoaderCleanup();
+    TrajectoryFileClose(&g_controlState.stReplay);
+    // 规划线程已停止, 保存缓存供下次启动使用
+    int iSaved = PlannerCacheSave(PLANNER_CACHE_FILE);
+    if (iSaved >= 0) {
+        log_info("Planner cache saved: %d entries", iSaved);
+    }
+    // 等待CSV写入线程取完队列后再关闭文件
+    CSVWriterStop();
+    // 黑匣子标记为正常关闭 (未执行到此处的进程, 下次启动时保留其记录)
+    FlightRecorderClose(&g_stRecorder);
     if(g_controlState.pFile != NULL)
     {
         fclose(g_controlState.pFile);
@@ -484,7 +1783,7 @@ void CleanupControlSystem(void)
 // Socket回调函数
 void SocketDataCallback(struct RxData* pData)
 {
-    // 数据已经在全局变量g_rxData中，这里可以添加额外处理
+    // 数据已经放入指令队列，这里可以添加额外处理
     if(pData != NULL)
     {
         log_debug("Socket data received in callback: CMD=%d", pData->iCMD);
@@ -503,16 +1802,72 @@ void* ControlThreadFunction(void* param)
         log_error("Failed to initialize control system");
         return NULL;
     }
-    
+
+    // 控制线程以 SAMPLINGTIME 为周期运行, Socket 指令在每个周期开始时异步处理
+    stCycleTimer stTimer;
+    if (CycleTimerInit(&stTimer, SAMPLINGTIME) != 0)
+    {
+        log_error("Failed to initialize cycle timer");
+        CleanupControlSystem();
+        return NULL;
+    }
+    if (stTimer.hTimer == NULL)
+    {
+        log_warn("High resolution waitable timer unavailable, falling back to busy wait");
+    }
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+    // 初始化完成, 此后控制线程的任何堆操作都是缺陷 (Debug 构建计数, 定义 ALLOC_GUARD_BREAK 时中断)
+    AllocGuardArm();
+
+    int iReportCounter = 0;
+    const int iReportInterval = (int)(1.0 / SAMPLINGTIME);  // 每秒最多报告一次超限
+
     // 控制线程的主循环
     while(g_controlState.bControlRunning)
     {
-        // 检查并处理Socket命令
+        // 等待下一周期的绝对截止时刻
+        CycleTimerWait(&stTimer, &g_controlState.stCycleStats);
+
+        // 应用已完成的重新规划 (周期边界切换轨迹), 再处理Socket命令
+        ApplyPlannerResults();
         ExecuteSocketCommand();
-        
-        // 短暂延时避免CPU占用过高
-        Sleep(10);
+
+        // 周期模式下每个周期执行一次控制步骤
+        if (g_controlState.bCyclicMode && g_controlState.bControlRunning)
+        {
+            if (ExecuteControlStep(g_controlState.ullCyclicAxisMask) != 0)
+            {
+                log_error("Control step execution failed, leaving cyclic mode");
+                g_controlState.bCyclicMode = 0;
+            }
+        }
+
+        CycleTimerEndCycle(&stTimer, &g_controlState.stCycleStats);
+
+        // 超限报告 (限频, 避免日志本身造成超限)
+        if (++iReportCounter >= iReportInterval)
+        {
+            iReportCounter = 0;
+            if (g_controlState.stCycleStats.ullOverruns > g_controlState.stCycleStats.ullOverrunsReported)
+            {
+                log_warn("Cycle overruns: %llu (+%llu), last exec %.1fus, max exec %.1fus, max jitter %.1fus",
+                         g_controlState.stCycleStats.ullOverruns,
+                         g_controlState.stCycleStats.ullOverruns - g_controlState.stCycleStats.ullOverrunsReported,
+                         g_controlState.stCycleStats.dLastExecUs,
+                         g_controlState.stCycleStats.dMaxExecUs,
+                         g_controlState.stCycleStats.dMaxJitterUs);
+                g_controlState.stCycleStats.ullOverrunsReported = g_controlState.stCycleStats.ullOverruns;
+            }
+        }
+    }
+
+    AllocGuardDisarm();
+    if (AllocGuardGetCount() != 0)
+    {
+        log_warn("Control loop performed %ld heap operations", AllocGuardGetCount());
     }
+    CycleTimerClose(&stTimer);
     
     // 清理资源
     CleanupControlSystem();
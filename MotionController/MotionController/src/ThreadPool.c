@@ -0,0 +1,144 @@
+#include "ThreadPool.h"
+#include "log.h"
+#include <process.h>
+
+static HANDLE g_ahThread[THREAD_POOL_MAX_THREADS];
+static int g_iThreadCount = 0;
+static HANDLE g_hStartSemaphore = NULL;     // 每释放一次唤醒一个工作线程参与当前任务
+static HANDLE g_hDoneEvent = NULL;          // 最后一个参与的工作线程完成时置位 (自动复位)
+static volatile LONG g_lStopRequested = 0;
+
+// 当前任务 (由 ParallelFor 在唤醒工作线程前写入)
+static ThreadPoolTaskFn g_pfnTask = NULL;
+static void* g_pTaskParam = NULL;
+static volatile LONG g_lTaskCount = 0;
+static volatile LONG g_lNextTask = 0;       // 下一个待领取的任务序号
+static volatile LONG g_lPendingWorkers = 0; // 已唤醒但尚未退出当前任务的工作线程数
+
+// 领取并执行任务直到全部被领取
+static void ThreadPoolRunTasks(void) {
+    for (;;) {
+        LONG lIndex = InterlockedIncrement(&g_lNextTask) - 1;
+        if (lIndex >= g_lTaskCount) {
+            break;
+        }
+        g_pfnTask((int)lIndex, g_pTaskParam);
+    }
+}
+
+static unsigned __stdcall ThreadPoolWorker(void* pParam) {
+    (void)pParam;
+    for (;;) {
+        WaitForSingleObject(g_hStartSemaphore, INFINITE);
+        if (ReadAcquire(&g_lStopRequested)) {
+            break;
+        }
+        ThreadPoolRunTasks();
+        if (InterlockedDecrement(&g_lPendingWorkers) == 0) {
+            SetEvent(g_hDoneEvent);
+        }
+    }
+    return 0;
+}
+
+// 创建工作线程, iThreads <= 0 时取 CPU 数 - 1 (调用线程也参与计算); 失败返回 -1
+int ThreadPoolInit(int iThreads) {
+    if (g_iThreadCount > 0) {
+        return 0;
+    }
+    if (iThreads <= 0) {
+        SYSTEM_INFO stInfo;
+        GetSystemInfo(&stInfo);
+        iThreads = (int)stInfo.dwNumberOfProcessors - 1;
+    }
+    if (iThreads > THREAD_POOL_MAX_THREADS) {
+        iThreads = THREAD_POOL_MAX_THREADS;
+    }
+
+    g_lStopRequested = 0;
+    g_hStartSemaphore = CreateSemaphore(NULL, 0, THREAD_POOL_MAX_THREADS, NULL);
+    g_hDoneEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (g_hStartSemaphore == NULL || g_hDoneEvent == NULL) {
+        ThreadPoolDestroy();
+        return -1;
+    }
+    for (int i = 0; i < iThreads; i++) {
+        g_ahThread[i] = (HANDLE)_beginthreadex(NULL, 0, ThreadPoolWorker, NULL, 0, NULL);
+        if (g_ahThread[i] == NULL) {
+            ThreadPoolDestroy();
+            return -1;
+        }
+        g_iThreadCount++;
+    }
+    return 0;
+}
+
+// 停止并回收全部工作线程
+void ThreadPoolDestroy(void) {
+    if (g_iThreadCount > 0) {
+        InterlockedExchange(&g_lStopRequested, 1);
+        ReleaseSemaphore(g_hStartSemaphore, g_iThreadCount, NULL);
+        WaitForMultipleObjects((DWORD)g_iThreadCount, g_ahThread, TRUE, INFINITE);
+        for (int i = 0; i < g_iThreadCount; i++) {
+            CloseHandle(g_ahThread[i]);
+            g_ahThread[i] = NULL;
+        }
+        g_iThreadCount = 0;
+    }
+    if (g_hStartSemaphore != NULL) {
+        CloseHandle(g_hStartSemaphore);
+        g_hStartSemaphore = NULL;
+    }
+    if (g_hDoneEvent != NULL) {
+        CloseHandle(g_hDoneEvent);
+        g_hDoneEvent = NULL;
+    }
+}
+
+// 并行执行 pfnTask(0..iCount-1, pParam), 全部完成后返回 0
+// 每个参与线程至少分到 iMinTasksPerThread 个任务, 任务很轻时少唤醒线程以免唤醒开销超过计算本身
+// 工作线程在 THREAD_POOL_WAIT_MS 内未做完已领取的任务时记录错误并返回 -1 (本次结果作废)
+int ThreadPoolParallelFor(int iCount, int iMinTasksPerThread, ThreadPoolTaskFn pfnTask, void* pParam) {
+    if (iCount <= 0) {
+        return 0;
+    }
+    // 上次超时的工作线程尚未退出: 不修改当前任务, 也不唤醒工作线程, 由调用线程顺序执行
+    if (ReadAcquire(&g_lPendingWorkers) != 0) {
+        for (int i = 0; i < iCount; i++) {
+            pfnTask(i, pParam);
+        }
+        return 0;
+    }
+    if (iMinTasksPerThread < 1) {
+        iMinTasksPerThread = 1;
+    }
+    int iWake = (iCount + iMinTasksPerThread - 1) / iMinTasksPerThread - 1;
+    if (iWake > g_iThreadCount) {
+        iWake = g_iThreadCount;
+    }
+
+    g_pfnTask = pfnTask;
+    g_pTaskParam = pParam;
+    g_lTaskCount = iCount;
+    g_lNextTask = 0;
+    WriteRelease(&g_lPendingWorkers, iWake);
+    if (iWake > 0) {
+        ResetEvent(g_hDoneEvent);   // 丢弃超时的工作线程事后置位的完成事件
+        ReleaseSemaphore(g_hStartSemaphore, iWake, NULL);
+    }
+
+    ThreadPoolRunTasks();
+
+    // 等待已唤醒的工作线程退出当前任务 (它们至多还在执行各自已领取的一个任务)
+    if (iWake > 0 && WaitForSingleObject(g_hDoneEvent, THREAD_POOL_WAIT_MS) != WAIT_OBJECT_0) {
+        log_error("Thread pool: %ld of %d workers did not finish within %d ms",
+                  ReadAcquire(&g_lPendingWorkers), iWake, THREAD_POOL_WAIT_MS);
+        return -1;
+    }
+    return 0;
+}
+
+// 工作线程数 (不含调用线程)
+int ThreadPoolGetThreadCount(void) {
+    return g_iThreadCount;
+}
@@ -0,0 +1,263 @@
+#include "TrajectoryFile.h"
+#include <math.h>
+#include <string.h>
+#include <xmmintrin.h>
+
+// 后台加载器 (控制线程 <-> 规划工作线程, 经 lState 交接, 同一时刻只有一方访问 stFile / szPath)
+typedef struct {
+    volatile LONG lState;               // TRAJ_LOADER_*
+    char szPath[TRAJ_FILE_PATH_CHARS];  // 待打开的文件
+    stTrajectoryFile stFile;            // 已打开 (READY) 或待关闭 (CLOSING) 的文件
+    void (*pfnWake)(void);              // 唤醒工作线程
+} stTrajLoader;
+
+static stTrajLoader g_stLoader;
+
+// 打开并映射轨迹文件, 检查头部与文件大小; bWritable 为 1 时以读写方式映射 (生成工具写入检查标记用)
+// 失败返回 -1 (文件不存在、格式不符或大小与头部不一致)
+int TrajectoryFileOpen(stTrajectoryFile* pFile, const char* pszPath, int bWritable) {
+    LARGE_INTEGER liSize;
+
+    memset(pFile, 0, sizeof(*pFile));
+    pFile->hFile = CreateFileA(pszPath, bWritable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ,
+                               NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (pFile->hFile == INVALID_HANDLE_VALUE) {
+        pFile->hFile = NULL;
+        return -1;
+    }
+    if (!GetFileSizeEx(pFile->hFile, &liSize) || liSize.QuadPart < TRAJ_FILE_HEADER_SIZE) {
+        TrajectoryFileClose(pFile);
+        return -1;
+    }
+    pFile->hMapping = CreateFileMappingA(pFile->hFile, NULL, bWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+    if (pFile->hMapping == NULL) {
+        TrajectoryFileClose(pFile);
+        return -1;
+    }
+    pFile->pucView = (const unsigned char*)MapViewOfFile(pFile->hMapping, bWritable ? FILE_MAP_WRITE : FILE_MAP_READ,
+                                                         0, 0, 0);
+    if (pFile->pucView == NULL) {
+        TrajectoryFileClose(pFile);
+        return -1;
+    }
+
+    const stTrajFileHeader* pHeader = (const stTrajFileHeader*)pFile->pucView;
+    if (pHeader->uMagic != TRAJ_FILE_MAGIC || pHeader->uVersion != TRAJ_FILE_VERSION || pHeader->uAxisCount < 1 ||
+        pHeader->uAxisCount > MAX_AXIS_COUNT || !(pHeader->dSampleTime > 0.0) || pHeader->ullFrameCount == 0 ||
+        (uint64_t)(liSize.QuadPart - TRAJ_FILE_HEADER_SIZE) / pHeader->uAxisCount / sizeof(stTrajRecord) <
+            pHeader->ullFrameCount) {
+        TrajectoryFileClose(pFile);
+        return -1;
+    }
+    pFile->pHeader = pHeader;
+    pFile->pRecords = (const stTrajRecord*)(pFile->pucView + TRAJ_FILE_HEADER_SIZE);
+    pFile->iAxisCount = (int)pHeader->uAxisCount;
+    pFile->ullFrameCount = pHeader->ullFrameCount;
+
+    // 提示系统预读整个映射 (异步, 不可用时忽略), 回放时只剩缓存预取
+    WIN32_MEMORY_RANGE_ENTRY stRange;
+    stRange.VirtualAddress = (PVOID)pFile->pucView;
+    stRange.NumberOfBytes = (SIZE_T)liSize.QuadPart;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &stRange, 0);
+    return 0;
+}
+
+// 解除映射并关闭文件 (可重复调用)
+void TrajectoryFileClose(stTrajectoryFile* pFile) {
+    if (pFile->pucView != NULL) {
+        UnmapViewOfFile(pFile->pucView);
+    }
+    if (pFile->hMapping != NULL) {
+        CloseHandle(pFile->hMapping);
+    }
+    if (pFile->hFile != NULL) {
+        CloseHandle(pFile->hFile);
+    }
+    memset(pFile, 0, sizeof(*pFile));
+}
+
+// 将文件轴依次绑定到掩码中由低到高的各轴并把游标置于首帧; 掩码轴数与文件轴数不一致返回 -1
+int TrajectoryFileBind(stTrajectoryFile* pFile, uint64_t ullAxisMask) {
+    int iCount = 0;
+    for (int axis = 0; axis < MAX_AXIS_COUNT; axis++) {
+        if (ullAxisMask & (1ULL << axis)) {
+            if (iCount >= pFile->iAxisCount) {
+                return -1;
+            }
+            pFile->aiAxis[iCount++] = axis;
+        }
+    }
+    if (iCount != pFile->iAxisCount) {
+        return -1;
+    }
+    pFile->ullAxisMask = ullAxisMask;
+    pFile->ullFrame = 0;
+    return 0;
+}
+
+// 取下一帧 (各文件轴的记录连续存放) 并预取前方帧; 已输出最后一帧后返回 NULL (每周期调用一次)
+const stTrajRecord* TrajectoryFileNextFrame(stTrajectoryFile* pFile) {
+    if (pFile->ullFrame >= pFile->ullFrameCount) {
+        return NULL;
+    }
+    const size_t uFrameRecords = (size_t)pFile->iAxisCount;
+    const stTrajRecord* pFrame = pFile->pRecords + pFile->ullFrame * uFrameRecords;
+    uint64_t ullAhead = pFile->ullFrame + TRAJ_FILE_PREFETCH_FRAMES;
+    if (ullAhead < pFile->ullFrameCount) {
+        // 前方一帧可能跨两个缓存行
+        const char* pcAhead = (const char*)(pFile->pRecords + ullAhead * uFrameRecords);
+        _mm_prefetch(pcAhead, _MM_HINT_T0);
+        _mm_prefetch(pcAhead + uFrameRecords * sizeof(stTrajRecord) - 1, _MM_HINT_T0);
+    }
+    pFile->ullFrame++;
+    return pFrame;
+}
+
+// 是否已输出最后一帧
+int TrajectoryFileIsFinished(const stTrajectoryFile* pFile) {
+    return pFile->ullFrame >= pFile->ullFrameCount;
+}
+
+// 随机访问第 ullFrame 帧 (超出范围返回 NULL), 不移动游标
+const stTrajRecord* TrajectoryFileGetFrame(const stTrajectoryFile* pFile, uint64_t ullFrame) {
+    if (pFile->pRecords == NULL || ullFrame >= pFile->ullFrameCount) {
+        return NULL;
+    }
+    return pFile->pRecords + ullFrame * (size_t)pFile->iAxisCount;
+}
+
+// 逐帧检查约束 (离线使用, 需以可写方式打开), 通过后在头部写入约束并置 TRAJ_FILE_FLAG_VALIDATED, 不通过时清除该标记
+// 检查: 数值有限, |v| <= VMax, |a| <= AMax; 相邻帧 |Δa| <= JMax*Ts, |Δv| <= AMax*Ts,
+//       位置增量与速度梯形积分之差 <= JMax*Ts^3/12 (梯形公式截断误差, 速度三阶导数即 Jerk);
+//       首帧与末帧静止 (TrajectoryFileIsAtRest)
+// 返回 0 通过; -1 不通过, *pullBadFrame 为首个不满足的帧
+int TrajectoryFileValidate(stTrajectoryFile* pFile, double dVMax, double dAMax, double dJMax, uint64_t* pullBadFrame) {
+    const int n = pFile->iAxisCount;
+    const double dTs = pFile->pHeader->dSampleTime;
+    const double dTol = 1.0 + TRAJ_FILE_CHECK_TOL;
+    const double dChainMax = dJMax * dTs * dTs * dTs / 12.0 * dTol + 1e-12;
+    stTrajFileHeader* pHeader = (stTrajFileHeader*)pFile->pucView;
+
+    *pullBadFrame = 0;
+    for (uint64_t ullFrame = 0; ullFrame < pFile->ullFrameCount; ullFrame++) {
+        const stTrajRecord* pFrame = TrajectoryFileGetFrame(pFile, ullFrame);
+        const stTrajRecord* pLast = (ullFrame > 0) ? pFrame - n : NULL;
+        for (int k = 0; k < n; k++) {
+            const stTrajRecord* r = &pFrame[k];
+            int bBad = !isfinite(r->dPos) || !isfinite(r->dVel) || !isfinite(r->dAcc) ||
+                       fabs(r->dVel) > dVMax * dTol || fabs(r->dAcc) > dAMax * dTol;
+            if (!bBad && (ullFrame == 0 || ullFrame + 1 == pFile->ullFrameCount)) {
+                bBad = fabs(r->dVel) > TRAJ_FILE_REST_TOL || fabs(r->dAcc) > TRAJ_FILE_REST_TOL;
+            }
+            if (!bBad && pLast != NULL) {
+                const stTrajRecord* q = &pLast[k];
+                bBad = fabs(r->dAcc - q->dAcc) > dJMax * dTs * dTol + 1e-12 ||
+                       fabs(r->dVel - q->dVel) > dAMax * dTs * dTol + 1e-12 ||
+                       fabs((r->dPos - q->dPos) - 0.5 * (r->dVel + q->dVel) * dTs) > dChainMax;
+            }
+            if (bBad) {
+                *pullBadFrame = ullFrame;
+                pHeader->uFlags &= ~TRAJ_FILE_FLAG_VALIDATED;
+                FlushViewOfFile(pFile->pucView, TRAJ_FILE_HEADER_SIZE);
+                return -1;
+            }
+        }
+    }
+
+    pHeader->dVMax = dVMax;
+    pHeader->dAMax = dAMax;
+    pHeader->dJMax = dJMax;
+    pHeader->uFlags |= TRAJ_FILE_FLAG_VALIDATED;
+    FlushViewOfFile(pFile->pucView, TRAJ_FILE_HEADER_SIZE);
+    return 0;
+}
+
+// 第 ullFrame 帧各文件轴是否静止 (|v|、|a| <= TRAJ_FILE_REST_TOL), 帧不存在返回 0
+int TrajectoryFileIsAtRest(const stTrajectoryFile* pFile, uint64_t ullFrame) {
+    const stTrajRecord* pFrame = TrajectoryFileGetFrame(pFile, ullFrame);
+    if (pFrame == NULL) {
+        return 0;
+    }
+    for (int k = 0; k < pFile->iAxisCount; k++) {
+        if (fabs(pFrame[k].dVel) > TRAJ_FILE_REST_TOL || fabs(pFrame[k].dAcc) > TRAJ_FILE_REST_TOL) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 初始化后台加载器 (工作线程启动前调用), pfnWake 在提交请求后唤醒工作线程
+void TrajectoryFileLoaderInit(void (*pfnWake)(void)) {
+    memset(&g_stLoader, 0, sizeof(g_stLoader));
+    g_stLoader.pfnWake = pfnWake;
+}
+
+// 提交打开请求 (仅控制线程调用, 不阻塞); 加载器忙或路径过长返回 -1
+int TrajectoryFileRequestOpen(const char* pszPath) {
+    if (ReadAcquire(&g_stLoader.lState) != TRAJ_LOADER_IDLE || strlen(pszPath) >= sizeof(g_stLoader.szPath)) {
+        return -1;
+    }
+    strcpy_s(g_stLoader.szPath, sizeof(g_stLoader.szPath), pszPath);
+    WriteRelease(&g_stLoader.lState, TRAJ_LOADER_OPENING);
+    if (g_stLoader.pfnWake != NULL) {
+        g_stLoader.pfnWake();
+    }
+    return 0;
+}
+
+// 查询打开结果 (仅控制线程调用, 每周期至多一次): 已打开返回 1 并把文件交给调用者 (只复制描述);
+// 仍在打开返回 0; 打开失败返回 -1. 返回非 0 后加载器回到空闲
+int TrajectoryFilePollOpen(stTrajectoryFile* pFile) {
+    LONG lState = ReadAcquire(&g_stLoader.lState);
+    if (lState == TRAJ_LOADER_READY) {
+        *pFile = g_stLoader.stFile;
+        memset(&g_stLoader.stFile, 0, sizeof(g_stLoader.stFile));
+        WriteRelease(&g_stLoader.lState, TRAJ_LOADER_IDLE);
+        return 1;
+    }
+    if (lState == TRAJ_LOADER_FAILED) {
+        WriteRelease(&g_stLoader.lState, TRAJ_LOADER_IDLE);
+        return -1;
+    }
+    return 0;
+}
+
+// 交还已取走的文件由工作线程解除映射并关闭 (仅控制线程调用, 不阻塞), 调用后 *pFile 清零.
+// 加载器不空闲时 (调用方未按一次一个文件使用) 退回为当场关闭
+void TrajectoryFileRequestClose(stTrajectoryFile* pFile) {
+    if (pFile->hFile == NULL) {
+        return;
+    }
+    if (ReadAcquire(&g_stLoader.lState) != TRAJ_LOADER_IDLE) {
+        TrajectoryFileClose(pFile);
+        return;
+    }
+    g_stLoader.stFile = *pFile;
+    memset(pFile, 0, sizeof(*pFile));
+    WriteRelease(&g_stLoader.lState, TRAJ_LOADER_CLOSING);
+    if (g_stLoader.pfnWake != NULL) {
+        g_stLoader.pfnWake();
+    }
+}
+
+// 处理一条打开或关闭请求 (仅工作线程调用), 有处理时返回 1
+int TrajectoryFileService(void) {
+    LONG lState = ReadAcquire(&g_stLoader.lState);
+    if (lState == TRAJ_LOADER_OPENING) {
+        int iResult = TrajectoryFileOpen(&g_stLoader.stFile, g_stLoader.szPath, 0);
+        WriteRelease(&g_stLoader.lState, (iResult == 0) ? TRAJ_LOADER_READY : TRAJ_LOADER_FAILED);
+        return 1;
+    }
+    if (lState == TRAJ_LOADER_CLOSING) {
+        TrajectoryFileClose(&g_stLoader.stFile);
+        WriteRelease(&g_stLoader.lState, TRAJ_LOADER_IDLE);
+        return 1;
+    }
+    return 0;
+}
+
+// 关闭加载器中仍持有的文件 (工作线程停止后调用)
+void TrajectoryFileLoaderCleanup(void) {
+    TrajectoryFileClose(&g_stLoader.stFile);
+    WriteRelease(&g_stLoader.lState, TRAJ_LOADER_IDLE);
+}
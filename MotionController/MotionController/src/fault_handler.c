@@ -2,7 +2,7 @@
 
 // ================== 全局变量定义 ==================
 // 必须在 .c 文件中定义，与头文件中的 extern 声明对应
-tAxisFaultCtx g_atAxisFaults[8];      // 8 个轴的故障上下文
+tAxisFaultCtx g_atAxisFaults[MAX_AXIS_COUNT];      // 每个轴的故障上下文
 tSystemFaultCtx g_tSystemFault;       // 系统级故障上下文
 
 // ================== 函数实现 ==================
@@ -14,7 +14,7 @@ void vFault_Init(void) {
     uint8_t u8AxisIdx, u8FaultIdx;
 
     // 初始化所有轴
-    for (u8AxisIdx = 0; u8AxisIdx < 8; u8AxisIdx++) {
+    for (u8AxisIdx = 0; u8AxisIdx < MAX_AXIS_COUNT; u8AxisIdx++) {
         tAxisFaultCtx* ptCtx = &g_atAxisFaults[u8AxisIdx];
 
         for (u8FaultIdx = 0; u8FaultIdx < FAULT_MAX; u8FaultIdx++) {
@@ -40,7 +40,7 @@ void vFault_Init(void) {
  */
 void vFault_UpdateAxis(uint8_t u8AxisId) {
     // 参数检查
-    if (u8AxisId >= 8) {
+    if (u8AxisId >= MAX_AXIS_COUNT) {
         return; // 轴ID无效
     }
 
@@ -78,7 +78,7 @@ void vFault_UpdateSystem(void) {
     uint8_t u8AxisIdx;
 
     // 检查是否有任意轴故障 (OR)
-    for (u8AxisIdx = 0; u8AxisIdx < 8; u8AxisIdx++) {
+    for (u8AxisIdx = 0; u8AxisIdx < g_iAxisCount; u8AxisIdx++) {
         if (g_atAxisFaults[u8AxisIdx].m_bAxisFault) {
             bAnyAxisFault = true;
             break;
@@ -106,7 +106,7 @@ void vFault_UpdateSystem(void) {
  * @return true 表示轴故障
  */
 bool bFault_GetAxisFault(uint8_t u8AxisId) {
-    if (u8AxisId >= 8) {
+    if (u8AxisId >= MAX_AXIS_COUNT) {
         return false; // 无效轴ID，返回无故障
     }
     return g_atAxisFaults[u8AxisId].m_bAxisFault;
@@ -118,4 +118,23 @@ bool bFault_GetAxisFault(uint8_t u8AxisId) {
  */
 bool bFault_GetSystemFault(void) {
     return g_tSystemFault.m_bSFault;
+}
+
+/**
+ * @brief 获取指定轴的故障位 (记录用)
+ * @param u8AxisId 轴ID
+ * @return 各故障类型一位, 另含轴综合故障位; 无效轴ID返回 0
+ */
+uint32_t u32Fault_GetAxisFaultBits(uint8_t u8AxisId) {
+    if (u8AxisId >= MAX_AXIS_COUNT) {
+        return 0;
+    }
+    const tAxisFaultCtx* ptAxis = &g_atAxisFaults[u8AxisId];
+    uint32_t u32Bits = ptAxis->m_bAxisFault ? FAULT_AXIS_FAULT_BIT : 0;
+    for (int i = 0; i < FAULT_MAX; i++) {
+        if (ptAxis->m_bFault[i]) {
+            u32Bits |= 1U << i;
+        }
+    }
+    return u32Bits;
 }
\ No newline at end of file
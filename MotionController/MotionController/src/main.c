@@ -3,13 +3,16 @@
 #endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <windows.h>
 #include <process.h>
 #include "ThreadControl.h"
 #include "Socket.h"
+#include "CommandQueue.h"
+#include "CSVWriter.h"
 #include "log.h"  // 添加日志头文件
 
-int main()
+int main(int argc, char* argv[])
 {
     // 初始化日志系统
     log_init();
@@ -24,11 +27,38 @@ int main()
     log_info("Starting multi-threaded application");
     log_info("==================================="); 
 
+    // 运行轴数: 第一个命令行参数, 缺省为 DEFAULT_AXIS_COUNT
+    if (argc > 1) {
+        if (AxisConfigSetCount(atoi(argv[1])) != 0) {
+            log_error("Invalid axis count '%s' (valid range 1~%d), using %d",
+                      argv[1], MAX_AXIS_COUNT, g_iAxisCount);
+        }
+    }
+    log_info("Axis count: %d", g_iAxisCount);
+
+    // 记录格式: 第二个命令行参数 csv (缺省) / tlm (二进制) / tlmz (二进制, 分组压缩)
+    if (argc > 2) {
+        int iFormat = -1;
+        if (strcmp(argv[2], "csv") == 0) {
+            iFormat = CSV_CAPTURE_TEXT;
+        } else if (strcmp(argv[2], "tlm") == 0) {
+            iFormat = CSV_CAPTURE_BINARY;
+        } else if (strcmp(argv[2], "tlmz") == 0) {
+            iFormat = CSV_CAPTURE_COMPRESSED;
+        }
+        if (CSVWriterSetCaptureFormat(iFormat) != 0) {
+            log_error("Invalid capture format '%s' (csv, tlm or tlmz), using csv", argv[2]);
+        }
+    }
+
     HANDLE hControlThread = NULL, hSocketThread = NULL, hCSVWriterThread = NULL;
     unsigned short port = 8081;
     
     //初始化CSV缓冲区
     InitCSVBuffer();
+
+    // 初始化Socket线程到控制线程的指令队列
+    CommandQueueInit();
     
     // 创建Socket线程
     hSocketThread = (HANDLE)_beginthreadex(
@@ -92,6 +122,7 @@ int main()
         }
         if(hCSVWriterThread != NULL)
         {
+            CSVWriterStop();
             WaitForSingleObject(hCSVWriterThread, INFINITE);
             CloseHandle(hCSVWriterThread);
         }
@@ -130,6 +161,7 @@ int main()
     // 等待CSV写入线程结束
     if(hCSVWriterThread != NULL)
     {
+        CSVWriterStop();
         WaitForSingleObject(hCSVWriterThread, INFINITE);
         CloseHandle(hCSVWriterThread);
         hCSVWriterThread = NULL;
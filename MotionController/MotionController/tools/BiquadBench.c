@@ -0,0 +1,249 @@
+// 滤波器组内核与控制器链路的基准测试及一致性检查
+// 1. 各 BiquadBankProcess 内核 (标量/AVX2/AVX-512) 与标量内核逐位比较, 并测量耗时
+// 2. 二阶节级联控制器 (ControllerUpdate) 和按级编译的控制器组 (ControllerBankUpdate, 各级为 BiquadBank)
+//    与原 PID -> 低通 -> 陷波 逐级递推的结果对比及耗时
+// 3. 含 6 个陷波 (25Hz ~ 300Hz) 与超前滞后的长链路: 控制器组与二阶节级联对比 (编译不得失败)
+// 耗时均以 ns/轴/周期 表示
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc BiquadBench.c ..\src\BiquadBank.c ..\src\Controler.c ..\src\PIDController.c
+//      ..\src\LowPassFilter.c ..\src\Notch_TF.c ..\src\LeadLag.c ..\src\SosCascade.c
+//      ..\src\AxisConfig.c ..\src\log.c
+// 用法: BiquadBench [轴数(默认64)] [周期数(默认200000)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <windows.h>
+#include "AxisConfig.h"
+#include "BiquadBank.h"
+#include "Controler.h"
+#include "log.h"
+
+#define CHECK_STEPS 2000
+#define CHECK_TOLERANCE 1e-9    // 相对于参考输出峰值的允许误差
+
+// 原控制器链路 (逐级递推, 每级除以 a0)
+typedef struct {
+    PIDController pid;
+    LowPassFilter lpf;
+    SNotchTF notch;
+} LegacyController;
+
+static ControllerBank s_stBank;
+static Controller s_astCascade[MAX_AXIS_COUNT];
+static LegacyController s_astLegacy[MAX_AXIS_COUNT];
+static stBiquadBank s_stBiquad;
+
+static void LegacyInit(LegacyController* pCtrl) {
+    PIDControllerInit(&pCtrl->pid, 500000.0, 10.0, 20.0, 0.001);
+    LowPassFilterInit(&pCtrl->lpf, 500.0, 0.8, 0.001);
+    NotchTFInit(&pCtrl->notch, 100.0, 100.0, 0.01, 0.05, 0.001);
+}
+
+static double LegacyUpdate(LegacyController* pCtrl, double dError) {
+    double dOut = PIDControllerUpdate(&pCtrl->pid, dError);
+    dOut = LowPassFilterUpdate(&pCtrl->lpf, dOut);
+    return NotchTFUpdate(&pCtrl->notch, dOut);
+}
+
+static double ElapsedNs(LARGE_INTEGER stStart, LARGE_INTEGER stEnd, LARGE_INTEGER stFreq) {
+    return (double)(stEnd.QuadPart - stStart.QuadPart) * 1e9 / (double)stFreq.QuadPart;
+}
+
+// 二阶节级联与状态空间组分别与原链路对比, 输出最大误差与参考输出峰值之比
+static void CheckController(int iAxisCount, double* pdCascadeErr, double* pdKernelErr) {
+    double adError[MAX_AXIS_COUNT], adOut[MAX_AXIS_COUNT];
+    double dCascadeDiff = 0.0, dKernelDiff = 0.0, dMaxRef = 0.0;
+
+    ControllerBankInit(&s_stBank, iAxisCount);
+    for (int i = 0; i < iAxisCount; i++) {
+        LegacyInit(&s_astLegacy[i]);
+        ControllerInit(&s_astCascade[i]);
+    }
+
+    for (int k = 0; k < CHECK_STEPS; k++) {
+        for (int i = 0; i < iAxisCount; i++) {
+            adError[i] = 1e-6 * sin(0.01 * k * (i + 1));
+        }
+        ControllerBankUpdate(&s_stBank, adError, adOut, NULL, iAxisCount);
+        for (int i = 0; i < iAxisCount; i++) {
+            double dRef = LegacyUpdate(&s_astLegacy[i], adError[i]);
+            double dCascade = ControllerUpdate(&s_astCascade[i], adError[i]);
+            if (fabs(dCascade - dRef) > dCascadeDiff) {
+                dCascadeDiff = fabs(dCascade - dRef);
+            }
+            if (fabs(adOut[i] - dRef) > dKernelDiff) {
+                dKernelDiff = fabs(adOut[i] - dRef);
+            }
+            if (fabs(dRef) > dMaxRef) {
+                dMaxRef = fabs(dRef);
+            }
+        }
+    }
+    if (dMaxRef <= 0.0) {
+        dMaxRef = 1.0;
+    }
+    *pdCascadeErr = dCascadeDiff / dMaxRef;
+    *pdKernelErr = dKernelDiff / dMaxRef;
+}
+
+// 长链路: 默认链路后追加 6 个陷波 (各轴频率错开) 与一个超前滞后, 控制器组与二阶节级联对比
+// 返回最大误差与参考输出峰值之比; 任一轴编译失败返回 -1
+static double CheckLongChain(int iAxisCount, int* piSections) {
+    static const double adNotchHz[CONTROLLER_MAX_NOTCHES] = { 25.0, 30.0, 60.0, 150.0, 220.0, 300.0 };
+    double adError[MAX_AXIS_COUNT], adOut[MAX_AXIS_COUNT];
+    double dDiff = 0.0, dMaxRef = 0.0;
+
+    ControllerBankInit(&s_stBank, iAxisCount);
+    for (int i = 0; i < iAxisCount; i++) {
+        Controller* pCtrl = &s_stBank.astAxis[i];
+        ControllerClearFilters(pCtrl);
+        ControllerAddLowPass(pCtrl, 500.0, 0.8);
+        for (int n = 0; n < CONTROLLER_MAX_NOTCHES; n++) {
+            double dHz = adNotchHz[n] * (1.0 + 0.01 * i);
+            if (ControllerAddNotch(pCtrl, dHz, dHz, 0.01, 0.05) != 0) {
+                return -1.0;
+            }
+        }
+        if (ControllerAddLeadLag(pCtrl, 40.0, 120.0) != 0 || ControllerBankCompileAxis(&s_stBank, i) != 0) {
+            return -1.0;
+        }
+        s_astCascade[i] = *pCtrl;
+        ControllerReset(&s_astCascade[i]);
+    }
+    *piSections = s_stBank.iStageCount;
+
+    for (int k = 0; k < CHECK_STEPS; k++) {
+        for (int i = 0; i < iAxisCount; i++) {
+            adError[i] = 1e-6 * sin(0.01 * k * (i + 1)) + ((k == 0) ? 1e-6 : 0.0);
+        }
+        ControllerBankUpdate(&s_stBank, adError, adOut, NULL, iAxisCount);
+        for (int i = 0; i < iAxisCount; i++) {
+            double dRef = ControllerUpdate(&s_astCascade[i], adError[i]);
+            if (fabs(adOut[i] - dRef) > dDiff) {
+                dDiff = fabs(adOut[i] - dRef);
+            }
+            if (fabs(dRef) > dMaxRef) {
+                dMaxRef = fabs(dRef);
+            }
+        }
+    }
+    return dDiff / ((dMaxRef > 0.0) ? dMaxRef : 1.0);
+}
+
+int main(int argc, char* argv[]) {
+    int iAxisCount = (argc > 1) ? atoi(argv[1]) : MAX_AXIS_COUNT;
+    int iCycles = (argc > 2) ? atoi(argv[2]) : 200000;
+    const eBiquadKernel aeKernels[] = { BIQUAD_KERNEL_SCALAR, BIQUAD_KERNEL_AVX2, BIQUAD_KERNEL_AVX512 };
+    double adIn[MAX_AXIS_COUNT], adOut[MAX_AXIS_COUNT];
+    stSosSection stNotch;
+    LARGE_INTEGER stFreq, stStart, stEnd;
+    int iRet = 0;
+
+    if (AxisConfigSetCount(iAxisCount) != 0 || iCycles <= 0) {
+        fprintf(stderr, "usage: BiquadBench [axes 1~%d] [cycles]\n", MAX_AXIS_COUNT);
+        return 1;
+    }
+    log_set_quiet(true);
+    QueryPerformanceFrequency(&stFreq);
+    printf("axes=%d cycles=%d\n", iAxisCount, iCycles);
+
+    // 1. 滤波器组内核 (陷波滤波器系数)
+    NotchTFDesignSos(100.0, 100.0, 0.01, 0.05, 0.001, &stNotch);
+    printf("%-10s %10s %16s\n", "kernel", "selftest", "biquad ns/axis");
+    for (int k = 0; k < (int)(sizeof(aeKernels) / sizeof(aeKernels[0])); k++) {
+        eBiquadKernel eKernel = aeKernels[k];
+        if (!BiquadBankKernelSupported(eKernel)) {
+            printf("%-10s %10s\n", BiquadBankKernelName(eKernel), "n/a");
+            continue;
+        }
+        if (BiquadBankSelectKernel(eKernel) != 0) {
+            printf("%-10s %10s\n", BiquadBankKernelName(eKernel), "MISMATCH");
+            iRet = 1;
+            continue;
+        }
+
+        BiquadBankInit(&s_stBiquad);
+        for (int i = 0; i < iAxisCount; i++) {
+            BiquadBankSetCoeffs(&s_stBiquad, i, stNotch.dB0, stNotch.dB1, stNotch.dB2, 1.0, stNotch.dA1, stNotch.dA2);
+            adIn[i] = 1e-3 * (i + 1);
+        }
+        QueryPerformanceCounter(&stStart);
+        for (int c = 0; c < iCycles; c++) {
+            BiquadBankProcess(&s_stBiquad, adIn, adOut, NULL, iAxisCount);
+        }
+        QueryPerformanceCounter(&stEnd);
+        printf("%-10s %10s %16.3f\n", BiquadBankKernelName(eKernel), "bit-exact",
+               ElapsedNs(stStart, stEnd, stFreq) / ((double)iCycles * iAxisCount));
+    }
+
+    // 2. 控制器链路
+    double dCascadeErr, dKernelErr;
+    CheckController(iAxisCount, &dCascadeErr, &dKernelErr);
+
+    ControllerBankInit(&s_stBank, iAxisCount);
+    QueryPerformanceCounter(&stStart);
+    for (int c = 0; c < iCycles; c++) {
+        ControllerBankUpdate(&s_stBank, adIn, adOut, NULL, iAxisCount);
+    }
+    QueryPerformanceCounter(&stEnd);
+    double dKernelNs = ElapsedNs(stStart, stEnd, stFreq) / ((double)iCycles * iAxisCount);
+
+    for (int i = 0; i < iAxisCount; i++) {
+        ControllerInit(&s_astCascade[i]);
+    }
+    QueryPerformanceCounter(&stStart);
+    for (int c = 0; c < iCycles; c++) {
+        for (int i = 0; i < iAxisCount; i++) {
+            adOut[i] = ControllerUpdate(&s_astCascade[i], adIn[i]);
+        }
+    }
+    QueryPerformanceCounter(&stEnd);
+    double dCascadeNs = ElapsedNs(stStart, stEnd, stFreq) / ((double)iCycles * iAxisCount);
+
+    for (int i = 0; i < iAxisCount; i++) {
+        LegacyInit(&s_astLegacy[i]);
+    }
+    QueryPerformanceCounter(&stStart);
+    for (int c = 0; c < iCycles; c++) {
+        for (int i = 0; i < iAxisCount; i++) {
+            adOut[i] = LegacyUpdate(&s_astLegacy[i], adIn[i]);
+        }
+    }
+    QueryPerformanceCounter(&stEnd);
+    double dLegacyNs = ElapsedNs(stStart, stEnd, stFreq) / ((double)iCycles * iAxisCount);
+
+    printf("\n%-10s %14s %16s\n", "controller", "rel err", "ns/axis");
+    printf("%-10s %14s %16.3f\n", "legacy", "-", dLegacyNs);
+    printf("%-10s %14.3e %16.3f\n", "sos", dCascadeErr, dCascadeNs);
+    printf("%-10s %14.3e %16.3f  (%d stages, %s)\n", "bank", dKernelErr, dKernelNs, s_stBank.iStageCount,
+           BiquadBankKernelName(BiquadBankGetKernel()));
+    if (dCascadeErr > CHECK_TOLERANCE || dKernelErr > CHECK_TOLERANCE) {
+        printf("controller mismatch exceeds tolerance %.1e\n", CHECK_TOLERANCE);
+        iRet = 1;
+    }
+
+    // 3. 长链路 (6 个陷波)
+    int iSections = 0;
+    double dLongErr = CheckLongChain(iAxisCount, &iSections);
+    if (dLongErr < 0.0) {
+        printf("long chain: compile failed\n");
+        return 1;
+    }
+    QueryPerformanceCounter(&stStart);
+    for (int c = 0; c < iCycles; c++) {
+        ControllerBankUpdate(&s_stBank, adIn, adOut, NULL, iAxisCount);
+    }
+    QueryPerformanceCounter(&stEnd);
+    printf("%-10s %14.3e %16.3f  (%d stages, vs sos cascade)\n", "bank-long", dLongErr,
+           ElapsedNs(stStart, stEnd, stFreq) / ((double)iCycles * iAxisCount), iSections);
+    if (dLongErr > CHECK_TOLERANCE) {
+        printf("long chain mismatch exceeds tolerance %.1e\n", CHECK_TOLERANCE);
+        iRet = 1;
+    }
+    return iRet;
+}
@@ -0,0 +1,183 @@
+// 浮点数快速转文本 (DoubleFormat) 与批量 CSV 格式化 (CSVWriterFormatBatch) 的检查与基准
+// 1. 往返检查: N 个随机 double (一半为任意位模式, 一半为 [-500, 500) 内的控制量), 输出经 strtod 必须还原为原值;
+//    与 "%.{1..17}e" 求得的最短位数比较, 统计非最短的个数
+// 2. 单值耗时: DoubleFormatShortest 与 snprintf("%.17g") 比较
+// 3. 批量格式化: 64 条记录 × 轴数, 新格式化 (CSVWriterFormatBatch) 与原 fprintf 格式 ("%.12f" 等, 此处为 snprintf
+//    到内存, 不含文件 I/O) 的 行/秒 与 字节/行
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc CSVFormatBench.c ..\src\DoubleFormat.c ..\src\CSVWriter.c ..\src\SpscRing.c ..\src\AxisConfig.c
+//      ..\src\TelemetryFile.c ..\src\TelemetryCompress.c
+// 用法: CSVFormatBench [随机值个数(默认1000000)] [轴数(默认64)] [重复次数(默认200)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <windows.h>
+#include "DoubleFormat.h"
+#include "CSVWriter.h"
+#include "AxisConfig.h"
+
+#define BENCH_RECORDS CSV_DRAIN_BATCH
+
+static double s_dTicksToUs = 0.0;
+static uint64_t s_ullSeed = 20261016ULL;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static uint64_t Random64(void) {
+    s_ullSeed ^= s_ullSeed << 13;
+    s_ullSeed ^= s_ullSeed >> 7;
+    s_ullSeed ^= s_ullSeed << 17;
+    return s_ullSeed;
+}
+
+static double RandomValue(int bAnyBits) {
+    uint64_t ullBits = Random64();
+    double dValue;
+    if (bAnyBits) {
+        memcpy(&dValue, &ullBits, sizeof(dValue));
+        return dValue;
+    }
+    return (double)(ullBits >> 11) / 9007199254740992.0 * 1000.0 - 500.0;
+}
+
+// 输出中的有效数字位数 (不含前导零与定点格式末尾补齐的零)
+static int SignificantDigits(const char* pcText) {
+    int iDigits = 0, iZeros = 0;
+    while (*pcText && (*pcText < '1' || *pcText > '9')) {
+        pcText++;
+    }
+    for (; *pcText && *pcText != 'e'; pcText++) {
+        if (*pcText == '0') {
+            iZeros++;
+        } else if (*pcText >= '1' && *pcText <= '9') {
+            iDigits += iZeros + 1;
+            iZeros = 0;
+        }
+    }
+    return iDigits;
+}
+
+// 原写入线程的格式 (每轴一行)
+static size_t FormatBatchPrintf(const CSVData* pstData, LONG lCount, char* pcText) {
+    char* p = pcText;
+    for (LONG i = 0; i < lCount; i++) {
+        const CSVData* data = &pstData[i];
+        for (int axis = 0; axis < g_iAxisCount; axis++) {
+            p += sprintf(p, "\n%d,%.3f", data->step, data->time);
+            p += sprintf(p, ",%.12f,%.15f,%.13f,%.9f,%d", data->targetPosition[axis], data->actualPosition[axis],
+                         data->error[axis], data->controlForce[axis], data->controlMode[axis]);
+        }
+    }
+    return (size_t)(p - pcText);
+}
+
+int main(int argc, char* argv[]) {
+    static CSVData s_astData[BENCH_RECORDS];
+    static char s_acText[CSV_BATCH_TEXT_MAX];
+    char acText[DOUBLE_FORMAT_MAX_CHARS], acRef[DOUBLE_FORMAT_MAX_CHARS];
+    int iValues = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int iAxes = (argc > 2) ? atoi(argv[2]) : 64;
+    int iRepeat = (argc > 3) ? atoi(argv[3]) : 200;
+    LARGE_INTEGER liFreq;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iValues < 1 || iRepeat < 1 || AxisConfigSetCount(iAxes) != 0) {
+        printf("usage: CSVFormatBench [values] [axes 1..%d] [repeat]\n", MAX_AXIS_COUNT);
+        return 1;
+    }
+
+    // 1. 往返与最短位数
+    int iBad = 0, iNotShortest = 0, iChecked = 0;
+    for (int i = 0; i < iValues; i++) {
+        double dValue = RandomValue(i & 1);
+        if (dValue != dValue) {
+            continue;
+        }
+        DoubleFormatShortest(dValue, acText);
+        double dBack = strtod(acText, NULL);
+        if (memcmp(&dBack, &dValue, sizeof(double)) != 0) {
+            if (iBad++ < 5) {
+                printf("round trip failed: %.17g -> %s\n", dValue, acText);
+            }
+        }
+        int iShortest = 1;
+        for (; iShortest < 17; iShortest++) {
+            snprintf(acRef, sizeof(acRef), "%.*e", iShortest - 1, dValue);
+            if (strtod(acRef, NULL) == dValue) {
+                break;
+            }
+        }
+        iNotShortest += SignificantDigits(acText) > iShortest;
+        iChecked++;
+    }
+    printf("round trip: %d values, %d failed, %d not shortest (%.3f%%)\n", iChecked, iBad, iNotShortest,
+           100.0 * iNotShortest / iChecked);
+
+    // 2. 单值耗时
+    double adValues[1024];
+    for (int i = 0; i < 1024; i++) {
+        adValues[i] = RandomValue(0);
+    }
+    size_t uSink = 0;
+    double dStart = NowUs();
+    for (int r = 0; r < iRepeat; r++) {
+        for (int i = 0; i < 1024; i++) {
+            uSink += (size_t)DoubleFormatShortest(adValues[i], acText);
+        }
+    }
+    double dShortestNs = (NowUs() - dStart) * 1000.0 / (1024.0 * iRepeat);
+    dStart = NowUs();
+    for (int r = 0; r < iRepeat; r++) {
+        for (int i = 0; i < 1024; i++) {
+            uSink += (size_t)snprintf(acRef, sizeof(acRef), "%.17g", adValues[i]);
+        }
+    }
+    double dPrintfNs = (NowUs() - dStart) * 1000.0 / (1024.0 * iRepeat);
+    printf("single value: DoubleFormatShortest %.1fns, snprintf %%.17g %.1fns (%.1fx)\n", dShortestNs, dPrintfNs,
+           dPrintfNs / dShortestNs);
+
+    // 3. 批量格式化 (类似控制数据: 位置 1e-3 步进, 误差 1e-7 量级)
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        s_astData[i].step = 100000 + i;
+        s_astData[i].time = (100000 + i) * 1e-3;
+        for (int axis = 0; axis < g_iAxisCount; axis++) {
+            s_astData[i].targetPosition[axis] = 0.1 * axis + (100000 + i) * 1e-6;
+            s_astData[i].actualPosition[axis] = s_astData[i].targetPosition[axis] - 1e-7 * RandomValue(0) / 500.0;
+            s_astData[i].error[axis] = s_astData[i].targetPosition[axis] - s_astData[i].actualPosition[axis];
+            s_astData[i].controlForce[axis] = RandomValue(0) / 50.0;
+            s_astData[i].controlMode[axis] = (axis % 7) == 0;
+        }
+    }
+    double dRows = (double)BENCH_RECORDS * g_iAxisCount * iRepeat;
+    size_t uFastBytes = 0, uPrintfBytes = 0;
+    dStart = NowUs();
+    for (int r = 0; r < iRepeat; r++) {
+        uFastBytes = CSVWriterFormatBatch(s_astData, BENCH_RECORDS, s_acText);
+    }
+    double dFastUs = NowUs() - dStart;
+    dStart = NowUs();
+    for (int r = 0; r < iRepeat; r++) {
+        uPrintfBytes = FormatBatchPrintf(s_astData, BENCH_RECORDS, s_acText);
+    }
+    double dPrintfUs = NowUs() - dStart;
+    double dRowsPerBatch = (double)BENCH_RECORDS * g_iAxisCount;
+    printf("batch of %d records x %d axes:\n", BENCH_RECORDS, g_iAxisCount);
+    printf("  %-22s %12.0f rows/s %8.1f bytes/row\n", "CSVWriterFormatBatch", dRows * 1.0e6 / dFastUs,
+           uFastBytes / dRowsPerBatch);
+    printf("  %-22s %12.0f rows/s %8.1f bytes/row\n", "printf (old format)", dRows * 1.0e6 / dPrintfUs,
+           uPrintfBytes / dRowsPerBatch);
+    printf("  speedup %.1fx, 1kHz x %d axes needs %d rows/s%s\n", dPrintfUs / dFastUs, g_iAxisCount,
+           1000 * g_iAxisCount, uSink ? "" : " ");
+
+    return (iBad == 0) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// 逐周期数据记录 (CSVWriter + SpscRing) 的基准与检查
+// 1. 写入线程未启动时连续写入 容量 + 100 条记录, 检查恰好丢弃 100 条且写入调用不阻塞
+// 2. 启动写入线程, 以固定周期 (默认 100us, 即 10 倍于 1ms 控制周期) 写入 N 条记录,
+//    统计每次 WriteCSVDataToBuffer 的耗时 (均值/最大值)、队列最大深度与写入线程的写出次数、行/秒
+// 3. CSVWriterStop 后检查 写出数 == 写入数, 文件行数 == 记录数 × 轴数, 且各记录步号递增 (周期为 0 时测试丢弃)
+// 格式 tlm: 写二进制记录文件 (SetTelemetryFile) 代替 CSV, 用 TelemetryReader 读回检查记录数与步号,
+//           采集过程中可用 TelemetryConvert stats csv_ring_bench.tlm -f 跟随读取; tlmz: 同 tlm, 分组压缩
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc CSVRingBench.c ..\src\CSVWriter.c ..\src\DoubleFormat.c ..\src\TelemetryFile.c ..\src\SpscRing.c
+//      ..\src\TelemetryCompress.c ..\src\AxisConfig.c
+// 用法: CSVRingBench [记录数(默认20000)] [写入周期 us(默认100)] [轴数(默认3)] [格式 csv|tlm|tlmz (默认csv)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include <process.h>
+#include <share.h>
+#include "CSVWriter.h"
+#include "AxisConfig.h"
+
+#define BENCH_CSV_FILE "csv_ring_bench.csv"
+#define BENCH_TLM_FILE "csv_ring_bench.tlm"
+#define BENCH_STALL_EXTRA 100
+
+static double s_dTicksToUs = 0.0;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+// 按步号填充一条记录 (可由文件内容反推步号)
+static void FillData(ControlData* pData, int iStep) {
+    for (int axis = 0; axis < g_iAxisCount; axis++) {
+        pData->dTargetPosition[axis] = iStep * 1e-3 + axis;
+        pData->dActualPosition[axis] = iStep * 1e-3 + axis - 1e-6;
+        pData->dError[axis] = 1e-6;
+        pData->dControlForce[axis] = 0.25 * axis;
+    }
+}
+
+// 检查文件: 行数与步号顺序, 返回不一致的行数
+static int CheckFile(unsigned long long ullRecords, int* piLines) {
+    char acLine[512];
+    int iBad = 0;
+    int iLines = 0;
+    int iLastStep = -1;
+    FILE* pFile = NULL;
+    if (fopen_s(&pFile, BENCH_CSV_FILE, "r") != 0 || pFile == NULL) {
+        *piLines = -1;
+        return 1;
+    }
+    while (fgets(acLine, sizeof(acLine), pFile) != NULL) {
+        if (acLine[0] == '\n' || acLine[0] == '\0') {
+            continue;
+        }
+        // 每条记录占 g_iAxisCount 行且步号相同; 记录间步号递增 (有丢弃时可不连续)
+        int iStep = atoi(acLine);
+        if ((iLines % g_iAxisCount == 0) ? (iStep <= iLastStep) : (iStep != iLastStep)) {
+            iBad++;
+        }
+        iLastStep = iStep;
+        iLines++;
+    }
+    fclose(pFile);
+    *piLines = iLines;
+    return iBad + ((unsigned long long)iLines != ullRecords * (unsigned long long)g_iAxisCount);
+}
+
+// 检查二进制文件: 记录数与步号递增, 返回不一致的记录数
+static int CheckTelemetryFile(unsigned long long ullRecords, int* piLines) {
+    static unsigned char s_aucRecord[TELEMETRY_RECORD_MAX];
+    stTelemetryReader stReader;
+    int iBad = 0;
+    int iLastStep = -1;
+    if (TelemetryReaderOpen(&stReader, BENCH_TLM_FILE) != 0 || stReader.stHeader.uAxisCount != (uint32_t)g_iAxisCount) {
+        *piLines = -1;
+        return 1;
+    }
+    while (TelemetryReaderNext(&stReader, s_aucRecord)) {
+        int iStep = (int)TelemetryGetValue(&stReader.stHeader, s_aucRecord, TELEMETRY_COL_STEP, 0);
+        iBad += (iStep <= iLastStep);
+        iLastStep = iStep;
+    }
+    *piLines = (int)stReader.ullRecords;
+    TelemetryReaderClose(&stReader);
+    return iBad + (stReader.ullRecords != ullRecords);
+}
+
+int main(int argc, char* argv[]) {
+    static ControlData s_stData;
+    int aiMode[MAX_AXIS_COUNT] = { 0 };
+    int iRecords = (argc > 1) ? atoi(argv[1]) : 20000;
+    int iPeriodUs = (argc > 2) ? atoi(argv[2]) : 100;
+    int iAxes = (argc > 3) ? atoi(argv[3]) : 3;
+    int bCompress = (argc > 4) && strcmp(argv[4], "tlmz") == 0;
+    int bBinary = bCompress || ((argc > 4) && strcmp(argv[4], "tlm") == 0);
+    stCSVWriterStats stStats;
+    LARGE_INTEGER liFreq;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iRecords < 1 || iPeriodUs < 0 || AxisConfigSetCount(iAxes) != 0) {
+        printf("usage: CSVRingBench [records] [period us] [axes 1..%d]\n", MAX_AXIS_COUNT);
+        return 1;
+    }
+
+    // 1. 写入线程未启动: 队列写满后丢弃
+    InitCSVBuffer();
+    double dStallMaxUs = 0.0;
+    for (int i = 0; i < CSV_RING_CAPACITY + BENCH_STALL_EXTRA; i++) {
+        double dStart = NowUs();
+        FillData(&s_stData, i);
+        WriteCSVDataToBuffer(i, i * 1e-3, &s_stData, aiMode);
+        double dElapsed = NowUs() - dStart;
+        if (dElapsed > dStallMaxUs) {
+            dStallMaxUs = dElapsed;
+        }
+    }
+    CSVWriterGetStats(&stStats);
+    int bStallPass = stStats.ullDropped == BENCH_STALL_EXTRA && stStats.ullCaptured == CSV_RING_CAPACITY;
+    printf("stalled writer: captured=%llu, dropped=%llu, max call %.2fus -> %s\n",
+           stStats.ullCaptured, stStats.ullDropped, dStallMaxUs, bStallPass ? "PASS" : "FAIL");
+    CleanupCSVBuffer();
+
+    // 2. 写入线程运行: 固定周期写入
+    const char* pszFile = bBinary ? BENCH_TLM_FILE : BENCH_CSV_FILE;
+    FILE* pFile = _fsopen(pszFile, bBinary ? "wb" : "w", _SH_DENYWR);
+    if (pFile == NULL || (bBinary ? SetTelemetryFile(pFile, 1e-3, bCompress) : (SetCSVFile(pFile), 0)) != 0) {
+        printf("cannot create %s\n", pszFile);
+        return 1;
+    }
+    InitCSVBuffer();
+    HANDLE hWriter = (HANDLE)_beginthreadex(NULL, 0, (unsigned int (__stdcall *)(void *))CSVWriterThreadFunction,
+                                            NULL, 0, NULL);
+    if (hWriter == NULL) {
+        printf("cannot start writer thread\n");
+        return 1;
+    }
+
+    double dSumUs = 0.0, dMaxUs = 0.0;
+    double dBeginUs = NowUs();
+    double dNextUs = dBeginUs;
+    for (int i = 0; i < iRecords; i++) {
+        while (NowUs() < dNextUs) {
+        }
+        dNextUs += iPeriodUs;
+        FillData(&s_stData, i);
+        double dStart = NowUs();
+        WriteCSVDataToBuffer(i, i * 1e-3, &s_stData, aiMode);
+        double dElapsed = NowUs() - dStart;
+        dSumUs += dElapsed;
+        if (dElapsed > dMaxUs) {
+            dMaxUs = dElapsed;
+        }
+    }
+    double dProduceUs = NowUs() - dBeginUs;
+
+    // 3. 停止并检查文件
+    double dStopStart = NowUs();
+    CSVWriterStop();
+    double dStopUs = NowUs() - dStopStart;
+    WaitForSingleObject(hWriter, INFINITE);
+    CloseHandle(hWriter);
+    CSVWriterGetStats(&stStats);
+    fclose(pFile);
+    SetCSVFile(NULL);
+    SetTelemetryFile(NULL, 1e-3, 0);
+
+    int iLines = 0;
+    int iBad = bBinary ? CheckTelemetryFile(stStats.ullCaptured, &iLines) : CheckFile(stStats.ullCaptured, &iLines);
+    int bPass = bStallPass && stStats.ullWritten == stStats.ullCaptured && iBad == 0 &&
+                (stStats.ullDropped > 0 || stStats.ullCaptured == (unsigned long long)iRecords);
+    printf("%d records x %d axes, period %dus (%.0f records/s offered)\n", iRecords, g_iAxisCount, iPeriodUs,
+           (double)iRecords * 1.0e6 / dProduceUs);
+    printf("capture call: mean %.3fus, max %.2fus\n", dSumUs / iRecords, dMaxUs);
+    printf("captured=%llu, dropped=%llu, written=%llu in %llu batches (%.1f/batch), max depth %ld/%d\n",
+           stStats.ullCaptured, stStats.ullDropped, stStats.ullWritten, stStats.ullBatches,
+           stStats.ullBatches ? (double)stStats.ullWritten / (double)stStats.ullBatches : 0.0,
+           stStats.lMaxDepth, CSV_RING_CAPACITY);
+    printf("output: %llu rows, %llu bytes in %llu writes (%llu failed), writer busy %.1fms -> %.0f rows/s\n",
+           stStats.ullRows, stStats.ullBytes, stStats.ullWrites, stStats.ullWriteFailures, stStats.dBusyUs / 1000.0,
+           stStats.dRowsPerSecond);
+    if (bBinary) {
+        printf("binary: %llu raw bytes -> %llu written (%.1fx)\n", stStats.ullTelemetryRaw, stStats.ullTelemetryBytes,
+               stStats.ullTelemetryBytes ? (double)stStats.ullTelemetryRaw / (double)stStats.ullTelemetryBytes : 0.0);
+    }
+    printf("stop drained in %.1fms, file %s %d, bad %d -> %s\n", dStopUs / 1000.0, bBinary ? "records" : "lines",
+           iLines, iBad, bPass ? "PASS" : "FAIL");
+    return bPass ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+// 进给倍率 (时间扭曲) 的基准测试及约束检查
+// 按 FeedOverridePlanningLimits 降低后的约束规划轨迹, 再按控制线程的方式逐周期调用
+// (轨迹静止时 FeedOverrideSettle) + FeedOverrideStep + FourthOrderPlannerSetTimeScale + GetNextPoint:
+// 1. slider:  S = 3 的单轴轨迹, 每 0.5~3s 随机改变一次指令倍率 (0 ~ 200%)
+// 2. group:   两轴以 dTimeLimit 同步规划 (约束不同), 共用一个倍率状态 (约束比值取较严的轴), 同上
+// 3. hold:    运动中 100% -> 0 (进给保持), 倍率到 0 后停 500ms -> 100%, 检查保持期间位置不变
+// 4. queue:   两段衔接轨迹 (段间速度不为 0), 150% 倍率下在 IsAtEnd 时切换并继承时间扭曲
+// 检查: 各轴输出的速度、加速度、Jerk 不超过该轴的约束 V / A / J (降低前), 并统计达到的比例,
+//       输出速度与位置差分一致 (链式法则), 位置不后退, 终点精确到达; 统计每周期耗时与一次重新规划的耗时
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc FeedOverrideBench.c ..\src\FeedOverride.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: FeedOverrideBench [重复次数(默认20)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "FeedOverride.h"
+
+#define CHECK_TOLERANCE 1e-9        // 约束检查的相对容差
+#define MAX_CYCLES 200000           // 单次运行的最大周期数
+
+#define GROUP_AXES 2                // group 的轴数
+
+static const stPlannerInput s_stLimits = { 3.0, 0.8, 2.0, 10.0, 200.0, 1e-3, 0.0 };
+// 轴约束 (规划时按倍率上限降低); group 的第二轴: 各约束比值都比 s_stLimits (第一轴) 严,
+// 倍率状态须取第二轴的比值, 否则第二轴 Jerk 超限
+static const stPlannerInput s_stGroupLimits = { 1.2, 0.5, 0.5, 1.2, 200.0, 1e-3, 0.0 };
+
+static double s_dTicksToUs = 0.0;
+static unsigned int s_uSeed = 20261016u;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+typedef struct {
+    long long llCycles;
+    double dMaxExcess[3];       // 速度、加速度、Jerk 超出各自允许值的最大量 (<= 0 为通过)
+    double dMaxUse[3];          // 速度、加速度、Jerk 与轴约束之比的最大值
+    double dMaxChainError;      // 位置差分与相邻速度均值之差的最大值
+    double dSumUs;
+    double dMaxUs;
+    int bPass;
+} stRunResult;
+
+// 检查一个输出点是否在轴约束之内
+static void CheckPoint(const stTrajectoryPoint* pPoint, const stTrajectoryPoint* pLast, const stPlannerInput* L,
+                       int bFinal, stRunResult* pResult) {
+    double adAllowed[3] = { L->dVMax, L->dAMax, L->dJMax };
+    double adValue[3] = { fabs(pPoint->dVel), fabs(pPoint->dAcc), fabs(pPoint->dJerk) };
+    for (int i = 0; i < 3; i++) {
+        double dExcess = adValue[i] - adAllowed[i] * (1.0 + CHECK_TOLERANCE) - 1e-12;
+        pResult->dMaxExcess[i] = fmax(pResult->dMaxExcess[i], dExcess);
+        pResult->dMaxUse[i] = fmax(pResult->dMaxUse[i], adValue[i] / adAllowed[i]);
+    }
+    if (pPoint->dPos < pLast->dPos - 1e-12) {
+        pResult->bPass = 0;
+    }
+    // 梯形积分: 位置增量 ~= (v_k + v_{k-1}) / 2 * Ts, 误差为 O(Ts^3 * Jerk);
+    // 终点取在总时长处而非最后一个扭曲时刻, 不参与比较
+    if (bFinal) {
+        return;
+    }
+    double dChain = fabs((pPoint->dPos - pLast->dPos) - 0.5 * (pPoint->dVel + pLast->dVel) * L->dSampleTime);
+    pResult->dMaxChainError = fmax(pResult->dMaxChainError, dChain);
+}
+
+// 轨迹是否静止 (尚未开始且起点静止, 或已结束), 与控制线程的判断相同
+static int IsAtRest(const stPlannerContext* pContext) {
+    return pContext->bIsFinished || (pContext->llSampleIndex == 0 && pContext->dStartVel == 0.0);
+}
+
+// iKind: 0 slider, 1 group, 2 hold
+static void RunSingle(int iKind, stRunResult* pResult) {
+    static stPlannerContext s_astContext[GROUP_AXES];
+    const stPlannerInput* apLimits[GROUP_AXES] = { &s_stLimits, &s_stGroupLimits };
+    int iAxes = (iKind == 1) ? GROUP_AXES : 1;
+    stFeedOverride stFeed;
+    stTrajectoryPoint astPoint[GROUP_AXES], astLast[GROUP_AXES];
+    long long llNextChange = 0;
+    double dHoldPos = 0.0;
+    long long llHoldStart = 0;
+
+    stPlannerInput astPlan[GROUP_AXES];
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->bPass = 1;
+    for (int i = 0; i < GROUP_AXES; i++) {
+        FeedOverridePlanningLimits(apLimits[i], &astPlan[i]);
+    }
+    FeedOverrideInit(&stFeed, s_stLimits.dSampleTime);
+    FeedOverrideSetLimits(&stFeed, &astPlan[0]);
+    FourthOrderPlannerInitInto(&astPlan[0], &s_astContext[0]);
+    if (iKind == 1) {
+        // 同步: 两轴取较长的最优时长规划, 倍率状态的约束比值取两轴中较严者
+        FourthOrderPlannerInitInto(&astPlan[1], &s_astContext[1]);
+        astPlan[1].dTimeLimit = fmax(s_astContext[0].dTotalTime, s_astContext[1].dTotalTime);
+        FourthOrderPlannerInitInto(&astPlan[1], &s_astContext[1]);
+        astPlan[0].dTimeLimit = s_astContext[1].dTotalTime;
+        FourthOrderPlannerInitInto(&astPlan[0], &s_astContext[0]);
+        FeedOverrideAddLimits(&stFeed, &astPlan[1]);
+    }
+    memset(astLast, 0, sizeof(astLast));
+
+    int bFinished = 0;
+    for (long long k = 0; k < MAX_CYCLES && !bFinished; k++) {
+        if (iKind == 2) {
+            if (k == 300) FeedOverrideSet(&stFeed, 0.0);
+            if (llHoldStart > 0 && k == llHoldStart + 500) FeedOverrideSet(&stFeed, 1.0);
+        } else if (k >= llNextChange) {
+            FeedOverrideSet(&stFeed, FEED_OVERRIDE_MAX * Random01());
+            llNextChange = k + 500 + (long long)(2500.0 * Random01());
+        }
+
+        double dStartUs = NowUs();
+        int bAtRest = 1;
+        for (int i = 0; i < iAxes; i++) {
+            bAtRest &= IsAtRest(&s_astContext[i]);
+        }
+        if (bAtRest) {
+            FeedOverrideSettle(&stFeed);
+        }
+        FeedOverrideStep(&stFeed);
+        for (int i = 0; i < iAxes; i++) {
+            FourthOrderPlannerSetTimeScale(&s_astContext[i], stFeed.dRatio, stFeed.dRate, stFeed.dAccel);
+            FourthOrderPlannerGetNextPoint(&s_astContext[i], &astPoint[i]);
+        }
+        double dUs = NowUs() - dStartUs;
+        pResult->dSumUs += dUs;
+        pResult->dMaxUs = fmax(pResult->dMaxUs, dUs);
+
+        bFinished = 1;
+        for (int i = 0; i < iAxes; i++) {
+            CheckPoint(&astPoint[i], &astLast[i], apLimits[i], s_astContext[i].bIsFinished, pResult);
+            astLast[i] = astPoint[i];
+            bFinished &= s_astContext[i].bIsFinished;
+        }
+        // 进给保持: 倍率到 0 之后位置不再变化
+        if (iKind == 2 && k > 300 && stFeed.dRatio == 0.0 && stFeed.dRate == 0.0) {
+            if (llHoldStart == 0) {
+                llHoldStart = k;
+                dHoldPos = astPoint[0].dPos;
+            } else if (astPoint[0].dPos != dHoldPos) {
+                pResult->bPass = 0;
+            }
+        }
+        pResult->llCycles = k + 1;
+    }
+    for (int i = 0; i < iAxes; i++) {
+        if (!s_astContext[i].bIsFinished || astLast[i].dPos != apLimits[i]->dDistance) {
+            pResult->bPass = 0;
+        }
+    }
+    if (iKind == 2 && llHoldStart == 0) {
+        pResult->bPass = 0;
+    }
+}
+
+// 两段衔接: 0 -> 0.4 (终点速度 0.25) -> 1.0, 150% 倍率
+static void RunQueue(stRunResult* pResult) {
+    static stPlannerContext s_astSegment[2];
+    stPlannerInputEx stEx;
+    stFeedOverride stFeed;
+    stTrajectoryPoint stPoint, stLast;
+    int iSegment = 0;
+
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->bPass = 1;
+    memset(&stEx, 0, sizeof(stEx));
+    FeedOverridePlanningLimits(&s_stLimits, &stEx.stLimits);
+    stEx.stLimits.dDistance = 0.4;
+    stEx.dEndVel = 0.25;
+    FourthOrderPlannerInitEx(&stEx, &s_astSegment[0]);
+    stEx.stLimits.dDistance = 0.6;
+    stEx.dStartPos = 0.4;
+    stEx.dStartVel = 0.25;
+    stEx.dEndVel = 0.0;
+    stEx.dTimeOffset = FourthOrderPlannerGetEndOffset(&s_astSegment[0]);
+    FourthOrderPlannerInitEx(&stEx, &s_astSegment[1]);
+
+    FeedOverrideInit(&stFeed, s_stLimits.dSampleTime);
+    FeedOverrideSetLimits(&stFeed, &stEx.stLimits);
+    FeedOverrideSet(&stFeed, 1.5);
+    memset(&stLast, 0, sizeof(stLast));
+
+    for (long long k = 0; k < MAX_CYCLES && !s_astSegment[1].bIsFinished; k++) {
+        stPlannerContext* pContext = &s_astSegment[iSegment];
+        double dStartUs = NowUs();
+        if (IsAtRest(pContext)) {
+            FeedOverrideSettle(&stFeed);
+        }
+        FeedOverrideStep(&stFeed);
+        FourthOrderPlannerSetTimeScale(pContext, stFeed.dRatio, stFeed.dRate, stFeed.dAccel);
+        if (iSegment == 0 && FourthOrderPlannerIsAtEnd(pContext)) {
+            FourthOrderPlannerInheritTimeWarp(&s_astSegment[1], pContext);
+            pContext = &s_astSegment[++iSegment];
+        }
+        FourthOrderPlannerGetNextPoint(pContext, &stPoint);
+        double dUs = NowUs() - dStartUs;
+        pResult->dSumUs += dUs;
+        pResult->dMaxUs = fmax(pResult->dMaxUs, dUs);
+        CheckPoint(&stPoint, &stLast, &s_stLimits, pContext->bIsFinished, pResult);
+        stLast = stPoint;
+        pResult->llCycles = k + 1;
+    }
+    if (!s_astSegment[1].bIsFinished || fabs(stLast.dPos - 1.0) > 1e-12) {
+        pResult->bPass = 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    static const char* s_apszName[4] = { "slider", "group", "hold", "queue" };
+    static stPlannerContext s_stReplan;
+    int iRepeat = (argc > 1) ? atoi(argv[1]) : 20;
+    int bAllPass = 1;
+    LARGE_INTEGER liFreq;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iRepeat < 1) {
+        iRepeat = 1;
+    }
+
+    stFeedOverride stProbe;
+    stPlannerInput stPlan;
+    FeedOverrideInit(&stProbe, s_stLimits.dSampleTime);
+    FeedOverridePlanningLimits(&s_stLimits, &stPlan);
+    FeedOverrideSetLimits(&stProbe, &stPlan);
+    printf("limits V=%.3f A=%.3f J=%.1f D=%.1f, Ts=%.4fs, planned V=%.3f A=%.3f J=%.3f (r <= %.0f%%, share %.2f)\n",
+           s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax, s_stLimits.dDMax, s_stLimits.dSampleTime,
+           stPlan.dVMax, stPlan.dAMax, stPlan.dJMax, FEED_OVERRIDE_MAX * 100.0, FEED_OVERRIDE_SHARE);
+    printf("r' <= %.4f/s, r'' <= %.4f/s^2", stProbe.dRateMax, stProbe.dAccelMax);
+    FeedOverridePlanningLimits(&s_stGroupLimits, &stPlan);
+    FeedOverrideAddLimits(&stProbe, &stPlan);
+    printf("; with group second axis V=%.3f A=%.3f J=%.1f: r' <= %.4f/s, r'' <= %.4f/s^2\n",
+           s_stGroupLimits.dVMax, s_stGroupLimits.dAMax, s_stGroupLimits.dJMax, stProbe.dRateMax, stProbe.dAccelMax);
+    printf("%-7s %9s %8s %8s %8s %11s %10s %10s %7s\n", "input", "cycles", "v/V", "a/A",
+           "j/J", "chain err", "step mean", "step max", "result");
+
+    for (int i = 0; i < 4; i++) {
+        stRunResult stTotal;
+        memset(&stTotal, 0, sizeof(stTotal));
+        stTotal.bPass = 1;
+        for (int n = 0; n < iRepeat; n++) {
+            stRunResult stRun;
+            if (i < 3) {
+                RunSingle(i, &stRun);
+            } else {
+                RunQueue(&stRun);
+            }
+            stTotal.llCycles += stRun.llCycles;
+            for (int j = 0; j < 3; j++) {
+                stTotal.dMaxExcess[j] = (n == 0) ? stRun.dMaxExcess[j] : fmax(stTotal.dMaxExcess[j], stRun.dMaxExcess[j]);
+                stTotal.dMaxUse[j] = fmax(stTotal.dMaxUse[j], stRun.dMaxUse[j]);
+            }
+            stTotal.dMaxChainError = fmax(stTotal.dMaxChainError, stRun.dMaxChainError);
+            stTotal.dSumUs += stRun.dSumUs;
+            stTotal.dMaxUs = fmax(stTotal.dMaxUs, stRun.dMaxUs);
+            stTotal.bPass &= stRun.bPass;
+        }
+        for (int j = 0; j < 3; j++) {
+            if (stTotal.dMaxExcess[j] > 0.0) {
+                stTotal.bPass = 0;
+            }
+        }
+        if (stTotal.dMaxChainError > 1e-8) {
+            stTotal.bPass = 0;
+        }
+        printf("%-7s %9lld %8.4f %8.4f %8.4f %11.2e %8.3fus %8.2fus %7s\n",
+               s_apszName[i], stTotal.llCycles, stTotal.dMaxUse[0], stTotal.dMaxUse[1], stTotal.dMaxUse[2],
+               stTotal.dMaxChainError, stTotal.dSumUs / (double)stTotal.llCycles,
+               stTotal.dMaxUs, stTotal.bPass ? "PASS" : "FAIL");
+        bAllPass &= stTotal.bPass;
+    }
+
+    // 对照: 每次改变倍率都以新的 dTimeLimit 重新规划的耗时
+    stPlannerInput stReplan;
+    FeedOverridePlanningLimits(&s_stLimits, &stReplan);
+    double dStartUs = NowUs();
+    for (int n = 0; n < 1000; n++) {
+        stReplan.dTimeLimit = 2.0 + 0.001 * n;
+        FourthOrderPlannerInitInto(&stReplan, &s_stReplan);
+    }
+    printf("replan with dTimeLimit for comparison: %.3fus per Init\n", (NowUs() - dStartUs) / 1000.0);
+    return bAllPass ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// 飞行记录仪 (FlightRecorder, 默认 flight_recorder.fdr / 崩溃后保留的 flight_recorder_crash.fdr) 的时间线重建
+// 按序号从最早保留的周期读到最后一个完整周期, 只输出首尾序号一致的槽; 可在控制进程运行时读取
+// summary: 头部信息、关闭状态、保留的周期范围与时间跨度、不完整/缺失的槽、步号间断 (控制重新开始等),
+//          各轴 |误差| 与 |控制力| 最大值及其时刻、开环周期数、首次故障 (时刻与故障位名称), 以及最后一个周期的各轴状态
+// csv:     每周期每轴一行: sequence,step,time,axis,target,actual,error,force,mode,faults (故障位十六进制),
+//          数值为最短往返文本
+// 秒数参数只取最后若干秒 (默认全部保留的周期)
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc FlightRecorderDump.c ..\src\FlightRecorder.c ..\src\DoubleFormat.c
+// 用法: FlightRecorderDump summary <记录.fdr> [最后秒数]
+//       FlightRecorderDump csv     <记录.fdr> [最后秒数] [输出.csv (默认标准输出)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <windows.h>
+#include "FlightRecorder.h"
+#include "fault_handler.h"
+#include "DoubleFormat.h"
+
+// 故障位名称 (与 tFaultType 顺序一致)
+static const char* s_apszFaultName[FAULT_MAX] = {
+    "HW_RIGHT_LIMIT", "HW_LEFT_LIMIT", "NETWORK", "MOTOR_OVERHEAT", "SW_RIGHT_LIMIT", "SW_LEFT_LIMIT",
+    "ENC1_NOT_CONNECTED", "ENC2_NOT_CONNECTED", "DRIVE", "ENC1_ERROR", "ENC2_ERROR", "NON_CRITICAL_POS_ERR",
+    "CRITICAL_POS_ERR", "VELOCITY_LIMIT", "ACCELERATION_LIMIT", "OVERCURRENT", "SERVO_ALARM", "SAFE_TORQUE_OFF",
+    "HSSI_NOT_CONNECTED", "EMERGENCY_STOP"
+};
+
+// 各轴统计量
+typedef struct {
+    double dMaxError;
+    double dMaxErrorTime;
+    double dMaxForce;
+    double dMaxForceTime;
+    unsigned long long ullOpenLoop;     // 控制模式非闭环 (CONTROL_MODE_CLOSED_LOOP = 0) 的周期数
+    int bFaultSeen;
+    int iFaultStep;
+    double dFaultTime;
+    uint32_t uFaultBits;
+} stAxisSummary;
+
+static void PrintFileTime(const char* pszLabel, uint64_t ullFileTime) {
+    FILETIME stUtc, stLocal;
+    SYSTEMTIME stTime;
+    if (ullFileTime == 0) {
+        printf("%s: -\n", pszLabel);
+        return;
+    }
+    stUtc.dwLowDateTime = (DWORD)(ullFileTime & 0xFFFFFFFFULL);
+    stUtc.dwHighDateTime = (DWORD)(ullFileTime >> 32);
+    FileTimeToLocalFileTime(&stUtc, &stLocal);
+    FileTimeToSystemTime(&stLocal, &stTime);
+    printf("%s: %04u-%02u-%02u %02u:%02u:%02u.%03u\n", pszLabel, stTime.wYear, stTime.wMonth, stTime.wDay,
+           stTime.wHour, stTime.wMinute, stTime.wSecond, stTime.wMilliseconds);
+}
+
+static void PrintFaultBits(uint32_t uBits) {
+    if (uBits & FAULT_AXIS_FAULT_BIT) {
+        printf(" AXIS_FAULT");
+    }
+    for (int i = 0; i < FAULT_MAX; i++) {
+        if (uBits & (1U << i)) {
+            printf(" %s", s_apszFaultName[i]);
+        }
+    }
+}
+
+// 输出范围: 最早保留的周期 (或最后 dSeconds 秒) 至最后一个完整周期
+static int64_t FirstSequence(const stFlightRecorder* pRecorder, int64_t llLast, double dSeconds) {
+    int64_t llFirst = llLast - (int64_t)pRecorder->ullSlotCount + 1;
+    if (dSeconds > 0.0) {
+        int64_t llWanted = llLast - (int64_t)(dSeconds / pRecorder->pHeader->dSampleTime + 0.5) + 1;
+        if (llWanted > llFirst) {
+            llFirst = llWanted;
+        }
+    }
+    return llFirst < 1 ? 1 : llFirst;
+}
+
+static int Summary(const stFlightRecorder* pRecorder, double dSeconds) {
+    const stFlightRecorderHeader* pHeader = pRecorder->pHeader;
+    const int iAxes = pRecorder->iAxisCount;
+    stFlightSlot* pSlot = (stFlightSlot*)malloc(pRecorder->uSlotSize);
+    stFlightSlot* pLastSlot = (stFlightSlot*)malloc(pRecorder->uSlotSize);
+    stAxisSummary* pAxis = (stAxisSummary*)calloc((size_t)iAxes, sizeof(stAxisSummary));
+    if (pSlot == NULL || pLastSlot == NULL || pAxis == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("Axes: %d, sample time: %.6gs, slots: %llu (%.1fs), slot size: %u bytes\n", iAxes, pHeader->dSampleTime,
+           (unsigned long long)pRecorder->ullSlotCount, pRecorder->ullSlotCount * pHeader->dSampleTime,
+           pHeader->uSlotSize);
+    PrintFileTime("Opened", pHeader->ullStartTime);
+    if (pHeader->uState == FLIGHT_RECORDER_STATE_CLOSED) {
+        PrintFileTime("Closed", pHeader->ullCloseTime);
+    } else {
+        printf("Closed: no (process still running or terminated abnormally)\n");
+    }
+
+    const int64_t llLast = FlightRecorderLastSequence(pRecorder);
+    if (llLast == 0) {
+        printf("No complete cycle recorded\n");
+        return 0;
+    }
+    const int64_t llFirst = FirstSequence(pRecorder, llLast, dSeconds);
+
+    unsigned long long ullComplete = 0, ullTorn = 0, ullMissing = 0, ullGaps = 0, ullSystemFault = 0;
+    int bHavePrev = 0, iPrevStep = 0, iFirstStep = 0;
+    double dFirstTime = 0.0;
+    for (int64_t llSeq = llFirst; llSeq <= llLast; llSeq++) {
+        int iState = FlightRecorderReadSlot(pRecorder, llSeq, pSlot);
+        if (iState != 1) {
+            // 正在被覆盖的最早槽 (运行中读取) 或写到一半的槽
+            if (iState < 0) {
+                ullTorn++;
+            } else {
+                ullMissing++;
+            }
+            bHavePrev = 0;
+            continue;
+        }
+        if (ullComplete == 0) {
+            iFirstStep = pSlot->iStep;
+            dFirstTime = pSlot->dTime;
+        } else if (bHavePrev && pSlot->iStep != iPrevStep + 1) {
+            ullGaps++;
+        }
+        ullComplete++;
+        bHavePrev = 1;
+        iPrevStep = pSlot->iStep;
+        if (pSlot->uFlags & FLIGHT_RECORDER_FLAG_SYSTEM_FAULT) {
+            ullSystemFault++;
+        }
+        for (int axis = 0; axis < iAxes; axis++) {
+            const stFlightAxisRecord* r = &pSlot->astAxis[axis];
+            stAxisSummary* s = &pAxis[axis];
+            if (!(fabs(r->dError) <= s->dMaxError)) {
+                s->dMaxError = fabs(r->dError);     // NaN 同样保留 (控制步骤因数值异常退出时)
+                s->dMaxErrorTime = pSlot->dTime;
+            }
+            if (!(fabs(r->dForce) <= s->dMaxForce)) {
+                s->dMaxForce = fabs(r->dForce);
+                s->dMaxForceTime = pSlot->dTime;
+            }
+            if (r->iMode != 0) {
+                s->ullOpenLoop++;
+            }
+            if (r->uFaults != 0 && !s->bFaultSeen) {
+                s->bFaultSeen = 1;
+                s->iFaultStep = pSlot->iStep;
+                s->dFaultTime = pSlot->dTime;
+                s->uFaultBits = r->uFaults;
+            }
+        }
+        memcpy(pLastSlot, pSlot, pRecorder->uSlotSize);
+    }
+
+    printf("Sequences: %lld .. %lld, complete: %llu, torn: %llu, missing: %llu, step gaps: %llu\n",
+           (long long)llFirst, (long long)llLast, ullComplete, ullTorn, ullMissing, ullGaps);
+    if (ullComplete == 0) {
+        return 0;
+    }
+    printf("Steps: %d .. %d, time: %.3fs .. %.3fs (%.3fs)\n", iFirstStep, pLastSlot->iStep, dFirstTime,
+           pLastSlot->dTime, pLastSlot->dTime - dFirstTime);
+    if (FlightRecorderReadSlot(pRecorder, llLast + 1, pSlot) < 0) {
+        printf("Cycle %lld was being written when recording stopped (incomplete)\n", (long long)(llLast + 1));
+    }
+    printf("System fault cycles: %llu\n", ullSystemFault);
+    for (int axis = 0; axis < iAxes; axis++) {
+        const stAxisSummary* s = &pAxis[axis];
+        printf("Axis %d: max |error| %.6g at %.3fs, max |force| %.6g at %.3fs, open loop %llu cycles", axis,
+               s->dMaxError, s->dMaxErrorTime, s->dMaxForce, s->dMaxForceTime, s->ullOpenLoop);
+        if (s->bFaultSeen) {
+            printf(", first fault at step %d (%.3fs):", s->iFaultStep, s->dFaultTime);
+            PrintFaultBits(s->uFaultBits);
+        }
+        printf("\n");
+    }
+
+    // 最后一个完整周期的状态 (崩溃前的最后时刻)
+    printf("Last cycle: step %d, time %.3fs%s\n", pLastSlot->iStep, pLastSlot->dTime,
+           (pLastSlot->uFlags & FLIGHT_RECORDER_FLAG_SYSTEM_FAULT) ? ", system fault" : "");
+    for (int axis = 0; axis < iAxes; axis++) {
+        const stFlightAxisRecord* r = &pLastSlot->astAxis[axis];
+        printf("  axis %d: target %.9g, actual %.9g, error %.6g, force %.6g, mode %d, faults 0x%08X", axis,
+               r->dTarget, r->dActual, r->dError, r->dForce, r->iMode, r->uFaults);
+        PrintFaultBits(r->uFaults);
+        printf("\n");
+    }
+    free(pAxis);
+    free(pLastSlot);
+    free(pSlot);
+    return 0;
+}
+
+static int ConvertToCsv(const stFlightRecorder* pRecorder, double dSeconds, FILE* pOut) {
+    const int iAxes = pRecorder->iAxisCount;
+    stFlightSlot* pSlot = (stFlightSlot*)malloc(pRecorder->uSlotSize);
+    // 一轴一行: 10 列各至多 DOUBLE_FORMAT_MAX_CHARS 字符
+    char* pcLine = (char*)malloc((size_t)iAxes * 10 * DOUBLE_FORMAT_MAX_CHARS);
+    if (pSlot == NULL || pcLine == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    fprintf(pOut, "sequence,step,time,axis,target,actual,error,force,mode,faults\n");
+    const int64_t llLast = FlightRecorderLastSequence(pRecorder);
+    unsigned long long ullSkipped = 0;
+    for (int64_t llSeq = (llLast > 0) ? FirstSequence(pRecorder, llLast, dSeconds) : 1; llSeq <= llLast; llSeq++) {
+        if (FlightRecorderReadSlot(pRecorder, llSeq, pSlot) != 1) {
+            ullSkipped++;
+            continue;
+        }
+        char* p = pcLine;
+        for (int axis = 0; axis < iAxes; axis++) {
+            const stFlightAxisRecord* r = &pSlot->astAxis[axis];
+            p += sprintf(p, "%lld,", (long long)llSeq);
+            p += DoubleFormatInt(pSlot->iStep, p);
+            *p++ = ',';
+            p += DoubleFormatShortest(pSlot->dTime, p);
+            *p++ = ',';
+            p += DoubleFormatInt(axis, p);
+            *p++ = ',';
+            p += DoubleFormatShortest(r->dTarget, p);
+            *p++ = ',';
+            p += DoubleFormatShortest(r->dActual, p);
+            *p++ = ',';
+            p += DoubleFormatShortest(r->dError, p);
+            *p++ = ',';
+            p += DoubleFormatShortest(r->dForce, p);
+            *p++ = ',';
+            p += DoubleFormatInt(r->iMode, p);
+            p += sprintf(p, ",0x%08X\n", r->uFaults);
+        }
+        fwrite(pcLine, 1, (size_t)(p - pcLine), pOut);
+    }
+    if (ullSkipped != 0) {
+        fprintf(stderr, "%llu incomplete cycles skipped\n", ullSkipped);
+    }
+    free(pcLine);
+    free(pSlot);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    stFlightRecorder stRecorder;
+    int iResult;
+
+    if (argc < 3 || (strcmp(argv[1], "summary") != 0 && strcmp(argv[1], "csv") != 0)) {
+        fprintf(stderr, "usage: %s summary <file.fdr> [last seconds]\n"
+                        "       %s csv     <file.fdr> [last seconds] [out.csv]\n", argv[0], argv[0]);
+        return 2;
+    }
+    if (FlightRecorderOpenRead(&stRecorder, argv[2]) != 0) {
+        fprintf(stderr, "cannot open flight record %s\n", argv[2]);
+        return 1;
+    }
+    double dSeconds = (argc > 3) ? atof(argv[3]) : 0.0;
+
+    if (strcmp(argv[1], "summary") == 0) {
+        iResult = Summary(&stRecorder, dSeconds);
+    } else {
+        FILE* pOut = stdout;
+        if (argc > 4 && fopen_s(&pOut, argv[4], "w") != 0) {
+            fprintf(stderr, "cannot create %s\n", argv[4]);
+            FlightRecorderClose(&stRecorder);
+            return 1;
+        }
+        iResult = ConvertToCsv(&stRecorder, dSeconds, pOut);
+        if (pOut != stdout) {
+            fclose(pOut);
+        }
+    }
+    FlightRecorderClose(&stRecorder);
+    return iResult;
+}
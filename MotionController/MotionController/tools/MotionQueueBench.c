@@ -0,0 +1,234 @@
+// 前瞻运动队列的基准测试及衔接检查
+// 对一条由 N 个目标点组成的单轴路径 (默认 10000 点: 正弦轮廓上的不等距进给 + 随机插入的反向点),
+// 1. 逐段静止到静止规划 (FourthOrderPlannerInitInto), 统计总周期数 (每段的全部采样点依次执行)
+// 2. 前瞻衔接规划 (Lookahead, 窗口 LOOKAHEAD_WINDOW), 按控制线程的方式逐周期取点:
+//    当前段即将输出终点 (FourthOrderPlannerIsAtEnd) 时切换到下一段, 统计总周期数
+// 3. 检查衔接轨迹: 相邻采样的位置增量不超过 VMax*Ts、速度增量不超过 AMax*Ts, 峰值不超过约束,
+//    终点到达最后一个目标点且速度为 0
+// 4. 统计两种方式单段规划的平均/最大耗时 (衔接方式计入追加目标点时的反向传播)
+// 5. 首段规划失败时的退路: 匀速途中以 LookaheadCommitStop 减速停止, 检查速度连续且停在下一目标点之前
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc MotionQueueBench.c ..\src\Lookahead.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: MotionQueueBench [目标点数(默认10000)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "Lookahead.h"
+
+#define CHECK_TOLERANCE 1e-9    // 约束检查的相对容差
+#define REVERSAL_PERIOD 97      // 约每隔多少个点插入一次反向回退
+
+static const stPlannerInput s_stLimits = { 0.0, 0.2, 2.0, 50.0, 2000.0, 1e-3, 0.0 };
+
+static double s_dTicksToUs = 0.0;
+static unsigned int s_uSeed = 12345u;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+// 生成路径: 正弦轮廓上 0.2~5 mm 不等距的点, 周期性插入一次反向回退
+static void BuildPath(double* adTarget, int iCount) {
+    double dS = 0.0;
+    for (int i = 0; i < iCount; i++) {
+        if (i % REVERSAL_PERIOD == REVERSAL_PERIOD - 1) {
+            adTarget[i] = adTarget[i - 1] - 0.002;
+            continue;
+        }
+        dS += 0.0002 + 0.0048 * Random01();
+        adTarget[i] = 0.05 * sin(dS * 20.0) + 0.5 * dS;
+        if (i > 0 && adTarget[i] == adTarget[i - 1]) {
+            adTarget[i] += 1e-6;
+        }
+    }
+}
+
+// 统计采样点数 (包括终点)
+static long long CountSamples(stPlannerContext* pContext) {
+    stTrajectoryPoint stPoint;
+    long long llCount = 0;
+    while (FourthOrderPlannerGetNextPoint(pContext, &stPoint) == 0) {
+        llCount++;
+    }
+    return llCount;
+}
+
+// 匀速途中 (若干衔接段之后) 改为减速停止段, 按控制线程的方式取点检查衔接
+static int CheckStopFallback(void) {
+    stPlannerContext astSegment[8];
+    stLookahead stLookahead;
+    int iSegments = 0;
+    LookaheadReset(&stLookahead, 0.0);
+    for (int i = 1; i <= LOOKAHEAD_WINDOW; i++) {
+        LookaheadPush(&stLookahead, 0.1 * i, &s_stLimits);
+    }
+    while (iSegments < 6) {
+        if (LookaheadCommit(&stLookahead, &astSegment[iSegments]) != 0) {
+            printf("stop fallback: blended planning failed\n");
+            return 0;
+        }
+        iSegments++;
+    }
+    double dEndVel = stLookahead.dVel;
+    double dNextTarget = 0.1 * (iSegments + 1);
+    if (LookaheadCommitStop(&stLookahead, &astSegment[iSegments]) != 0) {
+        printf("stop fallback: stop segment planning failed\n");
+        return 0;
+    }
+    iSegments++;
+
+    const double dMaxDv = s_stLimits.dAMax * s_stLimits.dSampleTime * (1.0 + CHECK_TOLERANCE);
+    stTrajectoryPoint stPoint, stPrev = { 0 };
+    double dMaxVelStep = 0.0;
+    long long llSamples = 0;
+    int iCurrent = 0;
+    for (;;) {
+        while (iCurrent < iSegments - 1 && FourthOrderPlannerIsAtEnd(&astSegment[iCurrent])) {
+            iCurrent++;
+        }
+        if (FourthOrderPlannerGetNextPoint(&astSegment[iCurrent], &stPoint) != 0) {
+            break;
+        }
+        if (llSamples > 0) {
+            dMaxVelStep = fmax(dMaxVelStep, fabs(stPoint.dVel - stPrev.dVel));
+        }
+        stPrev = stPoint;
+        llSamples++;
+    }
+    int bPass = dMaxVelStep <= dMaxDv && stPrev.dVel == 0.0 && stPrev.dPos <= dNextTarget &&
+                fabs(stPrev.dPos - stLookahead.dPos) < 1e-9;
+    printf("stop fallback: v=%.4f at %.4f, stopped at %.6f (next target %.4f), max |dv|=%.3e (limit %.3e) -> %s\n",
+           dEndVel, 0.1 * (iSegments - 1), stPrev.dPos, dNextTarget, dMaxVelStep, dMaxDv, bPass ? "PASS" : "FAIL");
+    return bPass;
+}
+
+int main(int argc, char* argv[]) {
+    int iCount = (argc > 1) ? atoi(argv[1]) : 10000;
+    LARGE_INTEGER liFreq;
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iCount < 2) {
+        iCount = 2;
+    }
+
+    double* adTarget = (double*)malloc(sizeof(double) * iCount);
+    stPlannerContext* astSegment = (stPlannerContext*)malloc(sizeof(stPlannerContext) * iCount);
+    if (adTarget == NULL || astSegment == NULL) {
+        printf("out of memory\n");
+        return 1;
+    }
+    BuildPath(adTarget, iCount);
+
+    // 1. 静止到静止
+    long long llRestSamples = 0;
+    double dRestTime = 0.0, dRestSumUs = 0.0, dRestMaxUs = 0.0;
+    double dPos = 0.0;
+    for (int i = 0; i < iCount; i++) {
+        stPlannerInput stInput = s_stLimits;
+        stInput.dDistance = fabs(adTarget[i] - dPos);
+        double dStart = NowUs();
+        if (FourthOrderPlannerInitInto(&stInput, &astSegment[0]) != 0) {
+            printf("rest-to-rest planning failed at point %d\n", i);
+            return 1;
+        }
+        double dUs = NowUs() - dStart;
+        dRestSumUs += dUs;
+        dRestMaxUs = fmax(dRestMaxUs, dUs);
+        dRestTime += astSegment[0].dTotalTime;
+        llRestSamples += CountSamples(&astSegment[0]);
+        dPos = adTarget[i];
+    }
+
+    // 2. 前瞻衔接: 窗口满时提交首段, 最后一个点追加后提交剩余段
+    stLookahead stLookahead;
+    int iSegments = 0, iFailed = 0;
+    double dBlendSumUs = 0.0, dBlendMaxUs = 0.0;
+    LookaheadReset(&stLookahead, 0.0);
+    for (int i = 0; i <= iCount; i++) {
+        while (LookaheadCount(&stLookahead) == LOOKAHEAD_WINDOW || (i == iCount && LookaheadCount(&stLookahead) > 0)) {
+            double dStart = NowUs();
+            int iResult = LookaheadCommit(&stLookahead, &astSegment[iSegments]);
+            double dUs = NowUs() - dStart;
+            if (iResult != 0) {
+                iFailed++;
+                break;
+            }
+            dBlendSumUs += dUs;
+            dBlendMaxUs = fmax(dBlendMaxUs, dUs);
+            iSegments++;
+        }
+        if (i < iCount) {
+            double dStart = NowUs();
+            if (LookaheadPush(&stLookahead, adTarget[i], &s_stLimits) < 0) {
+                iFailed++;
+            }
+            dBlendSumUs += NowUs() - dStart;
+        }
+        if (iFailed > 0) {
+            break;
+        }
+    }
+    if (iFailed > 0) {
+        printf("blended planning failed after %d segments\n", iSegments);
+        return 1;
+    }
+
+    // 3. 逐周期取点 (与控制线程的切换方式相同) 并检查衔接
+    const double dTs = s_stLimits.dSampleTime;
+    const double dMaxStep = s_stLimits.dVMax * dTs * (1.0 + CHECK_TOLERANCE);
+    const double dMaxDv = s_stLimits.dAMax * dTs * (1.0 + CHECK_TOLERANCE);
+    stTrajectoryPoint stPoint, stPrev = { 0 };
+    long long llBlendSamples = 0;
+    double dMaxPosStep = 0.0, dMaxVelStep = 0.0, dPeakVel = 0.0, dPeakAcc = 0.0;
+    int iCurrent = 0;
+    for (;;) {
+        while (iCurrent < iSegments - 1 && FourthOrderPlannerIsAtEnd(&astSegment[iCurrent])) {
+            iCurrent++;
+        }
+        if (FourthOrderPlannerGetNextPoint(&astSegment[iCurrent], &stPoint) != 0) {
+            break;
+        }
+        if (llBlendSamples > 0) {
+            dMaxPosStep = fmax(dMaxPosStep, fabs(stPoint.dPos - stPrev.dPos));
+            dMaxVelStep = fmax(dMaxVelStep, fabs(stPoint.dVel - stPrev.dVel));
+        }
+        dPeakVel = fmax(dPeakVel, fabs(stPoint.dVel));
+        dPeakAcc = fmax(dPeakAcc, fabs(stPoint.dAcc));
+        stPrev = stPoint;
+        llBlendSamples++;
+    }
+    double dBlendTime = stLookahead.dCommittedTime;
+    int bPass = dMaxPosStep <= dMaxStep && dMaxVelStep <= dMaxDv &&
+                dPeakVel <= s_stLimits.dVMax * (1.0 + CHECK_TOLERANCE) &&
+                dPeakAcc <= s_stLimits.dAMax * (1.0 + CHECK_TOLERANCE) &&
+                fabs(stPrev.dPos - adTarget[iCount - 1]) < 1e-9 && stPrev.dVel == 0.0;
+
+    printf("path: %d points, limits V=%.3f A=%.3f J=%.1f D=%.1f, Ts=%.4fs, look-ahead window %d\n",
+           iCount, s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax, s_stLimits.dDMax, dTs, LOOKAHEAD_WINDOW);
+    printf("%-14s %12s %12s %14s %14s\n", "mode", "time [s]", "cycles", "plan mean[us]", "plan max[us]");
+    printf("%-14s %12.3f %12lld %14.2f %14.2f\n", "rest-to-rest", dRestTime, llRestSamples,
+           dRestSumUs / iCount, dRestMaxUs);
+    printf("%-14s %12.3f %12lld %14.2f %14.2f\n", "blended", dBlendTime, llBlendSamples,
+           dBlendSumUs / iSegments, dBlendMaxUs);
+    printf("cycle reduction: %.1f%%\n", 100.0 * (1.0 - (double)llBlendSamples / (double)llRestSamples));
+    printf("continuity: max |dx|=%.3e (limit %.3e), max |dv|=%.3e (limit %.3e), peak v=%.4f a=%.4f -> %s\n",
+           dMaxPosStep, dMaxStep, dMaxVelStep, dMaxDv, dPeakVel, dPeakAcc, bPass ? "PASS" : "FAIL");
+    bPass &= CheckStopFallback();
+
+    free(astSegment);
+    free(adTarget);
+    return bPass ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// 在线轨迹生成的基准测试及约束检查
+// 三种目标输入, 每种逐周期调用 OnlineTrajectoryStep:
+// 1. step:     每 150~400ms 随机改变一次目标位置 (运动中改目标)
+// 2. jog:      摇杆点动, 每 50~500ms 随机改变方向与速度 (目标取远处, 速度上限为摇杆速度, 含松开停止)
+// 3. servo:    视觉伺服, 每周期更新目标 (正弦轨迹 + 随机噪声)
+// 另: takeover: 在 CMD 5 点到点轨迹的随机时刻以 InitFrom 从其位置/速度/加速度接管并停止,
+//     检查接管后的约束 (接管采样处的 Jerk 跳变除外) 及衔接处的速度、加速度偏差
+// 检查: 输出速度、加速度、Jerk、Snap (采样差分) 不超过约束 (容差含位置舍入经差分放大的部分),
+//       最后停止时精确到达目标; 统计每周期 Step 耗时 (平均 / 99.9% / 最大),
+//       以及若以 CMD 5 从零状态重新规划, 改目标时参考速度的跳变量
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc OnlineTrajectoryBench.c ..\src\OnlineTrajectory.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: OnlineTrajectoryBench [每种输入的周期数(默认200000)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <windows.h>
+#include "OnlineTrajectory.h"
+
+#define CHECK_TOLERANCE 1e-9        // 约束检查的相对容差
+#define HISTOGRAM_BIN_US 0.01       // 耗时直方图分辨率
+#define HISTOGRAM_BINS 10000        // 直方图范围 0 ~ 100us (更长的计入最后一格)
+#define SETTLE_LIMIT_STEPS 100000   // 停止后等待到位的最大周期数
+#define TAKEOVER_TRIALS 2000        // 接管测试次数
+
+static const stPlannerInput s_stLimits = { 0.0, 0.8, 2.0, 10.0, 200.0, 1e-3, 0.0 };
+
+static unsigned int s_uSeed = 20261016u;
+static long long s_allHistogram[HISTOGRAM_BINS];
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+typedef struct {
+    const char* pszName;
+    long long llSteps;
+    long long llRetargets;
+    double adPeak[4];           // 速度、加速度、Jerk、Snap 的峰值
+    double dMaxRestartJump;     // 以 CMD 5 重新规划时的最大速度跳变
+    double dSumStepUs;
+    double dMaxStepUs;
+    long long llSettleSteps;    // 停止到到位的周期数 (-1: 未到位)
+    int bPass;
+} stScenarioResult;
+
+// 第 k 阶差分允许值: 约束 + 位置舍入 (2^k 个量级为 |pos|*eps 的误差) 经 1/Ts^k 放大
+static double AllowedDerivative(double dLimit, int iOrder, double dMaxPos) {
+    double dNoise = ldexp(4.0 * DBL_EPSILON * (dMaxPos + 1.0), iOrder) / pow(s_stLimits.dSampleTime, iOrder);
+    return dLimit * (1.0 + CHECK_TOLERANCE) + dNoise;
+}
+
+static void RunScenario(int iKind, long long llSteps, stScenarioResult* pResult) {
+    static stOnlineTrajectory s_stOnline;
+    static const char* s_apszName[3] = { "step", "jog", "servo" };
+    const double adLimit[4] = { s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax, s_stLimits.dDMax };
+    stTrajectoryPoint stPoint;
+    long long llNextChange = 0;
+    double dMaxPos = 0.0;
+
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->pszName = s_apszName[iKind];
+    OnlineTrajectoryInit(&s_stOnline, 0.0, &s_stLimits);
+
+    for (long long k = 0; k < llSteps + SETTLE_LIMIT_STEPS; k++) {
+        int bSettling = (k >= llSteps);
+        if (k == llSteps) {
+            OnlineTrajectoryStop(&s_stOnline);
+        } else if (!bSettling && k >= llNextChange) {
+            double dTarget, dVMax = 0.0;
+            if (iKind == 0) {
+                dTarget = (Random01() - 0.5) * 2.0;
+                llNextChange = k + 150 + (long long)(250.0 * Random01());
+            } else if (iKind == 1) {
+                double dCommand = Random01();
+                dVMax = s_stLimits.dVMax * Random01();
+                dTarget = (dCommand < 0.2) ? s_stOnline.dPos0 : ((dCommand < 0.6) ? -1000.0 : 1000.0);
+                llNextChange = k + 50 + (long long)(450.0 * Random01());
+            } else {
+                double dTime = (double)k * s_stLimits.dSampleTime;
+                dTarget = 0.3 * sin(2.0 * dTime) + 0.1 * sin(7.0 * dTime) + 0.002 * (Random01() - 0.5);
+                llNextChange = k + 1;
+            }
+            // CMD 5 从零状态重新规划时, 参考速度由当前速度跳到 0
+            pResult->dMaxRestartJump = fmax(pResult->dMaxRestartJump, fabs(s_stOnline.stLast.dVel));
+            OnlineTrajectorySetTarget(&s_stOnline, dTarget, dVMax);
+            pResult->llRetargets++;
+        }
+
+        OnlineTrajectoryStep(&s_stOnline, &stPoint);
+        int iBin = (int)(s_stOnline.dLastStepUs / HISTOGRAM_BIN_US);
+        s_allHistogram[(iBin < HISTOGRAM_BINS) ? iBin : HISTOGRAM_BINS - 1]++;
+        dMaxPos = fmax(dMaxPos, fabs(stPoint.dPos));
+        if (k >= 4) {       // 前 4 个采样的高阶差分含起点的零初值
+            pResult->adPeak[0] = fmax(pResult->adPeak[0], fabs(stPoint.dVel));
+            pResult->adPeak[1] = fmax(pResult->adPeak[1], fabs(stPoint.dAcc));
+            pResult->adPeak[2] = fmax(pResult->adPeak[2], fabs(stPoint.dJerk));
+            pResult->adPeak[3] = fmax(pResult->adPeak[3], fabs(stPoint.dSnap));
+        }
+        if (bSettling && OnlineTrajectoryIsSettled(&s_stOnline)) {
+            pResult->llSettleSteps = k - llSteps;
+            break;
+        }
+        pResult->llSettleSteps = -1;
+    }
+
+    pResult->llSteps = (long long)(s_stOnline.llSampleIndex);
+    pResult->dSumStepUs = s_stOnline.dSumStepUs;
+    pResult->dMaxStepUs = s_stOnline.dMaxStepUs;
+    // 到位后的下一个采样应精确静止在目标 (到位采样本身的差分含上一采样的舍入)
+    OnlineTrajectoryStep(&s_stOnline, &stPoint);
+    pResult->bPass = (pResult->llSettleSteps >= 0) && (stPoint.dPos == s_stOnline.dTarget) && (stPoint.dVel == 0.0);
+    for (int i = 0; i < 4; i++) {
+        if (pResult->adPeak[i] > AllowedDerivative(adLimit[i], i + 1, dMaxPos)) {
+            pResult->bPass = 0;
+        }
+    }
+}
+
+// 在 CMD 5 轨迹运动中接管: 返回是否通过, 输出接管后的峰值及衔接处速度/加速度的最大偏差
+static int RunTakeover(int iTrials, double adPeak[4], double* pdVelJump, double* pdAccJump) {
+    static stOnlineTrajectory s_stOnline;
+    const double adLimit[4] = { s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax, s_stLimits.dDMax };
+    stPlannerContext stPlanner;
+    stTrajectoryPoint stPoint, stFirst = { 0 };
+    int bPass = 1;
+
+    memset(adPeak, 0, 4 * sizeof(double));
+    *pdVelJump = 0.0;
+    *pdAccJump = 0.0;
+    for (int iTrial = 0; iTrial < iTrials; iTrial++) {
+        stPlannerInput stInput = s_stLimits;
+        stInput.dDistance = 0.01 + 2.0 * Random01();
+        if (FourthOrderPlannerInitInto(&stInput, &stPlanner) != 0) {
+            continue;
+        }
+        // 在轨迹前 95% 的随机时刻接管 (GetNextPoint 即控制周期的参考输出)
+        long long llTakeover = (long long)(Random01() * 0.95 * stPlanner.dTotalTime / s_stLimits.dSampleTime);
+        stPoint.dPos = 0.0;
+        stPoint.dVel = stPoint.dAcc = stPoint.dJerk = 0.0;
+        for (long long k = 0; k < llTakeover; k++) {
+            FourthOrderPlannerGetNextPoint(&stPlanner, &stPoint);
+        }
+        if (Random01() < 0.5) {     // Init 只规划正向, 反向运动取镜像
+            stPoint.dPos = -stPoint.dPos;
+            stPoint.dVel = -stPoint.dVel;
+            stPoint.dAcc = -stPoint.dAcc;
+            stPoint.dJerk = -stPoint.dJerk;
+        }
+        stPoint.dTime = 0.0;
+        if (OnlineTrajectoryInitFrom(&s_stOnline, &stPoint, &s_stLimits) != 0) {
+            bPass = 0;
+            continue;
+        }
+        double dMaxPos = fabs(stPoint.dPos);
+        for (long long k = 0; k == 0 || (k < SETTLE_LIMIT_STEPS && !OnlineTrajectoryIsSettled(&s_stOnline)); k++) {
+            stTrajectoryPoint stOut;
+            OnlineTrajectoryStep(&s_stOnline, &stOut);
+            dMaxPos = fmax(dMaxPos, fabs(stOut.dPos));
+            double adValue[4] = { stOut.dVel, stOut.dAcc, stOut.dJerk, stOut.dSnap };
+            for (int i = 0; i < 4; i++) {
+                if (k >= i - 1) {   // 接管采样的 Jerk 由规划值跳到生成器的值, 其 Snap 不计
+                    adPeak[i] = fmax(adPeak[i], fabs(adValue[i]));
+                }
+            }
+            if (k == 0) {
+                stFirst = stOut;
+            }
+        }
+        if (!OnlineTrajectoryIsSettled(&s_stOnline)) {
+            bPass = 0;
+        }
+        // 衔接偏差: 首个输出的速度/加速度相对接管点按规划 Jerk 外推一步的值
+        *pdVelJump = fmax(*pdVelJump, fabs(stFirst.dVel - (stPoint.dVel + stPoint.dAcc * s_stLimits.dSampleTime)));
+        *pdAccJump = fmax(*pdAccJump, fabs(stFirst.dAcc - stPoint.dAcc));
+        for (int i = 0; i < 4; i++) {
+            if (adPeak[i] > AllowedDerivative(adLimit[i], i + 1, dMaxPos)) {
+                bPass = 0;
+            }
+        }
+    }
+    return bPass;
+}
+
+int main(int argc, char* argv[]) {
+    long long llSteps = (argc > 1) ? atoll(argv[1]) : 200000;
+    stScenarioResult astResult[3];
+    stOnlineTrajectory stProbe;
+    int bAllPass = 1;
+
+    if (llSteps < 1) {
+        llSteps = 1;
+    }
+    OnlineTrajectoryInit(&stProbe, 0.0, &s_stLimits);
+    printf("limits V=%.3f A=%.3f J=%.1f D=%.1f, Ts=%.4fs, moving-average windows n1=%d n2=%d (lag %.3fs)\n",
+           s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax, s_stLimits.dDMax, s_stLimits.dSampleTime,
+           stProbe.iLen1, stProbe.iLen2, (stProbe.iLen1 + stProbe.iLen2) * s_stLimits.dSampleTime);
+    printf("%-7s %10s %9s %9s %9s %9s %9s %11s %10s %10s %7s\n", "input", "cycles", "retargets",
+           "peak v", "peak a", "peak j", "peak s", "CMD5 jump", "step mean", "step max", "result");
+
+    for (int i = 0; i < 3; i++) {
+        RunScenario(i, llSteps, &astResult[i]);
+        stScenarioResult* p = &astResult[i];
+        printf("%-7s %10lld %9lld %9.4f %9.4f %9.3f %9.2f %9.4fm/s %8.3fus %8.2fus %7s\n",
+               p->pszName, p->llSteps, p->llRetargets, p->adPeak[0], p->adPeak[1], p->adPeak[2], p->adPeak[3],
+               p->dMaxRestartJump, p->dSumStepUs / (double)p->llSteps, p->dMaxStepUs, p->bPass ? "PASS" : "FAIL");
+        bAllPass &= p->bPass;
+    }
+
+    double adPeak[4], dVelJump, dAccJump;
+    int bTakeover = RunTakeover(TAKEOVER_TRIALS, adPeak, &dVelJump, &dAccJump);
+    printf("takeover %d trials: peak v=%.4f a=%.4f j=%.3f s=%.2f, junction |dv|<=%.2e m/s |da|<=%.2e m/s^2 %s\n",
+           TAKEOVER_TRIALS, adPeak[0], adPeak[1], adPeak[2], adPeak[3], dVelJump, dAccJump,
+           bTakeover ? "PASS" : "FAIL");
+    bAllPass &= bTakeover;
+
+    long long llTotal = 0, llCount = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        llTotal += s_allHistogram[i];
+    }
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        llCount += s_allHistogram[i];
+        if (llCount * 1000 >= llTotal * 999) {
+            printf("step time 99.9%%: <= %.2fus over %lld cycles\n", (i + 1) * HISTOGRAM_BIN_US, llTotal);
+            break;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        printf("%s: settled exactly on target %lld cycles after stop\n", astResult[i].pszName, astResult[i].llSettleSteps);
+    }
+    return bAllPass ? 0 : 1;
+}
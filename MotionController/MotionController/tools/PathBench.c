@@ -0,0 +1,200 @@
+// 多轴路径插补 (PathInterpolation) 的基准测试及约束检查
+// 1. line3:  三轴直线 (0, 0, 0) -> (0.6, -0.3, 0.2)
+// 2. arc:    XY 平面内 R = 0.1 的 3/4 圆弧 (逆时针)
+// 3. circle: R = 0.05 的整圆 (顺时针, 终点 = 起点)
+// 4. small:  R = 0.005 的半圆 (路径速度受 sqrt(share*A*R) 限制)
+// 检查: 直线上各点到直线的距离 / 圆弧上各点到圆心的距离与半径之差 (轮廓误差), 终点精确到达,
+//       由位置二次 / 三次差分得到的合成加速度 <= A、合成 Jerk <= J (圆弧见 PathInterpolation.h 的 Jerk 上界),
+//       合成速度 <= V; 统计每周期 PathInterpStep 的耗时,
+//       并与逐点流式发送 (每轴每周期一条 struct RxData 指令) 的网络数据量比较
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc PathBench.c ..\src\PathInterpolation.c ..\src\FourthOrderTrajectoryPlanning.c ws2_32.lib
+// 用法: PathBench [重复次数(默认20)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <windows.h>
+#include "Socket.h"
+#include "PathInterpolation.h"
+
+#define CHECK_TOLERANCE 1e-6        // 差分检查的相对容差 (差分含 O(Ts) 截断误差)
+#define MAX_CYCLES 200000           // 单次运行的最大周期数
+
+static const stPlannerInput s_stLimits = { 1.0, 0.8, 2.0, 10.0, 200.0, 1e-3, 0.0 };
+
+static double s_dTicksToUs = 0.0;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+typedef struct {
+    long long llCycles;
+    double dContourError;       // 最大轮廓误差
+    double dEndError;           // 终点误差
+    double dMaxVel;             // 最大合成速度 (一次差分)
+    double dMaxAcc;             // 最大合成加速度 (二次差分)
+    double dMaxJerk;            // 最大合成 Jerk (三次差分)
+    double dSumUs;
+    double dMaxUs;
+    int bPass;
+} stRunResult;
+
+// iKind: 0 line3, 1 arc, 2 circle, 3 small
+static void RunPath(int iKind, stRunResult* pResult) {
+    static stPathInterp s_stPath;
+    double adStart[MAX_AXIS_COUNT] = { 0.0 };
+    double adEnd[MAX_AXIS_COUNT] = { 0.0 };
+    double adHist[3][MAX_AXIS_COUNT];       // 最近三个周期的位置 (用于差分)
+    const double dTs = s_stLimits.dSampleTime;
+    double dJerkBound = s_stLimits.dJMax;
+    int iResult;
+
+    memset(pResult, 0, sizeof(*pResult));
+    pResult->bPass = 1;
+    switch (iKind) {
+        case 0:
+            adEnd[0] = 0.6; adEnd[1] = -0.3; adEnd[2] = 0.2;
+            iResult = PathInterpInitLine(&s_stPath, 0x7ULL, adStart, adEnd, &s_stLimits);
+            break;
+        case 1:
+            adStart[0] = 0.1;
+            iResult = PathInterpInitArc(&s_stPath, 0, 1, adStart, 0.0, -0.1, 0.0, 0.0, 1, &s_stLimits);
+            break;
+        case 2:
+            adStart[0] = 0.05;
+            iResult = PathInterpInitArc(&s_stPath, 0, 1, adStart, 0.05, 0.0, 0.0, 0.0, -1, &s_stLimits);
+            break;
+        default:
+            adStart[0] = 0.005;
+            iResult = PathInterpInitArc(&s_stPath, 0, 1, adStart, -0.005, 0.0, 0.0, 0.0, 1, &s_stLimits);
+            break;
+    }
+    if (iResult != 0) {
+        pResult->bPass = 0;
+        return;
+    }
+    if (iKind != 0) {
+        const double dShare = PATH_ARC_NORMAL_SHARE;
+        dJerkBound = ((1.0 - dShare) + dShare + dShare * dShare / (3.0 * (1.0 - dShare))) * s_stLimits.dJMax;
+    }
+
+    const int n = s_stPath.iAxisCount;
+    for (int k = 0; k < n; k++) {
+        adHist[0][k] = adHist[1][k] = adHist[2][k] = s_stPath.adOrigin[k];
+    }
+
+    for (long long c = 0; c < MAX_CYCLES; c++) {
+        double dStartUs = NowUs();
+        int bEnd = PathInterpStep(&s_stPath);
+        double dUs = NowUs() - dStartUs;
+        pResult->dSumUs += dUs;
+        pResult->dMaxUs = fmax(pResult->dMaxUs, dUs);
+        pResult->llCycles = c + 1;
+
+        // 轮廓误差
+        const double* p = s_stPath.adPos;
+        if (iKind == 0) {
+            double dDot = 0.0, dDist2 = 0.0;
+            for (int k = 0; k < n; k++) {
+                dDot += (p[k] - s_stPath.adOrigin[k]) * s_stPath.adDir[k];
+            }
+            for (int k = 0; k < n; k++) {
+                double d = p[k] - s_stPath.adOrigin[k] - dDot * s_stPath.adDir[k];
+                dDist2 += d * d;
+            }
+            pResult->dContourError = fmax(pResult->dContourError, sqrt(dDist2));
+        } else {
+            double dR = hypot(p[0] - s_stPath.dCenterX, p[1] - s_stPath.dCenterY);
+            pResult->dContourError = fmax(pResult->dContourError, fabs(dR - s_stPath.dRadius));
+        }
+
+        // 合成速度 / 加速度 / Jerk 的差分估计
+        double dV2 = 0.0, dA2 = 0.0, dJ2 = 0.0;
+        for (int k = 0; k < n; k++) {
+            double dV = (p[k] - adHist[0][k]) / dTs;
+            double dA = (p[k] - 2.0 * adHist[0][k] + adHist[1][k]) / (dTs * dTs);
+            double dJ = (p[k] - 3.0 * adHist[0][k] + 3.0 * adHist[1][k] - adHist[2][k]) / (dTs * dTs * dTs);
+            dV2 += dV * dV;
+            dA2 += dA * dA;
+            dJ2 += dJ * dJ;
+        }
+        if (c >= 3) {
+            pResult->dMaxVel = fmax(pResult->dMaxVel, sqrt(dV2));
+            pResult->dMaxAcc = fmax(pResult->dMaxAcc, sqrt(dA2));
+            pResult->dMaxJerk = fmax(pResult->dMaxJerk, sqrt(dJ2));
+        }
+        for (int k = 0; k < n; k++) {
+            adHist[2][k] = adHist[1][k];
+            adHist[1][k] = adHist[0][k];
+            adHist[0][k] = p[k];
+        }
+        if (bEnd) {
+            break;
+        }
+    }
+
+    for (int k = 0; k < n; k++) {
+        pResult->dEndError = fmax(pResult->dEndError, fabs(s_stPath.adPos[k] - s_stPath.adEnd[k]));
+    }
+    if (!PathInterpIsFinished(&s_stPath) || pResult->dEndError != 0.0 || pResult->dContourError > 1e-12 ||
+        pResult->dMaxVel > s_stLimits.dVMax * (1.0 + CHECK_TOLERANCE) ||
+        pResult->dMaxAcc > s_stLimits.dAMax * (1.0 + CHECK_TOLERANCE) + 1e-6 ||
+        pResult->dMaxJerk > dJerkBound * (1.0 + CHECK_TOLERANCE) + 1e-3) {
+        pResult->bPass = 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    static const char* s_apszName[4] = { "line3", "arc", "circle", "small" };
+    static const int s_aiAxes[4] = { 3, 2, 2, 2 };
+    int iRepeat = (argc > 1) ? atoi(argv[1]) : 20;
+    int bAllPass = 1;
+    LARGE_INTEGER liFreq;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iRepeat < 1) {
+        iRepeat = 1;
+    }
+
+    printf("limits V=%.3f A=%.3f J=%.1f, Ts=%.4fs, arc normal share %.2f\n", s_stLimits.dVMax, s_stLimits.dAMax,
+           s_stLimits.dJMax, s_stLimits.dSampleTime, PATH_ARC_NORMAL_SHARE);
+    printf("%-7s %8s %11s %10s %8s %8s %8s %10s %10s %11s %7s\n", "path", "cycles", "contour", "end err",
+           "v max", "a max", "j max", "step mean", "step max", "stream/cmd", "result");
+
+    for (int iKind = 0; iKind < 4; iKind++) {
+        stRunResult stResult, stSum;
+        memset(&stSum, 0, sizeof(stSum));
+        stSum.bPass = 1;
+        for (int r = 0; r < iRepeat; r++) {
+            RunPath(iKind, &stResult);
+            stSum.llCycles = stResult.llCycles;
+            stSum.dContourError = fmax(stSum.dContourError, stResult.dContourError);
+            stSum.dEndError = fmax(stSum.dEndError, stResult.dEndError);
+            stSum.dMaxVel = fmax(stSum.dMaxVel, stResult.dMaxVel);
+            stSum.dMaxAcc = fmax(stSum.dMaxAcc, stResult.dMaxAcc);
+            stSum.dMaxJerk = fmax(stSum.dMaxJerk, stResult.dMaxJerk);
+            stSum.dSumUs += stResult.dSumUs;
+            stSum.dMaxUs = fmax(stSum.dMaxUs, stResult.dMaxUs);
+            stSum.bPass &= stResult.bPass;
+        }
+        // 逐点流式: 每周期每轴一条指令; 路径指令: 直线为每轴一条暂存 + 一条开始, 圆弧为一条
+        long long llStreamBytes = stSum.llCycles * s_aiAxes[iKind] * (long long)sizeof(struct RxData);
+        long long llPathBytes = (long long)((iKind == 0) ? s_aiAxes[iKind] + 1 : 1) * (long long)sizeof(struct RxData);
+        printf("%-7s %8lld %11.3e %10.3e %8.4f %8.4f %8.3f %8.3fus %8.3fus %5lld/%-5lld %7s\n", s_apszName[iKind],
+               stSum.llCycles, stSum.dContourError, stSum.dEndError, stSum.dMaxVel, stSum.dMaxAcc, stSum.dMaxJerk,
+               stSum.dSumUs / (double)(stSum.llCycles * iRepeat), stSum.dMaxUs, llStreamBytes / 1024, llPathBytes,
+               stSum.bPass ? "PASS" : "FAIL");
+        bAllPass &= stSum.bPass;
+    }
+    printf("stream/cmd: KiB sent when streaming one RxData per axis per cycle / bytes sent as path commands\n");
+    return bAllPass ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// 批量规划引擎 (PlannerBatch) 的命令行工具: 节拍估算吞吐量及与逐个 InitInto 的一致性检查
+// 生成 N 个随机点到点运动 (位移 1e-5 ~ 2, 约 20% 带时间限制, 约 1% 零位移, 约 0.1% 约束无效),
+// 输入与输出各一次性分配为连续数组, 然后:
+// 1. 逐个 FourthOrderPlannerInitInto (完整规划, 含边界状态与多项式表), 记录总时长与匀速时间作为基准
+// 2. PlannerBatchPlan 单线程 (线程池未启动)
+// 3. PlannerBatchPlan 多线程 (ThreadPoolInit, 全部核)
+// 检查: 批量结果的总时长与 InitInto 逐位相同, Td/Tj/Ta/Tv 与上下文一致, 失败数等于无效输入数;
+// 输出每种方式的吞吐量 (moves/s) 与节拍估算 (总时长之和)
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc PlannerBatchBench.c ..\src\PlannerBatch.c ..\src\ThreadPool.c ..\src\FourthOrderTrajectoryPlanning.c
+//      ..\src\log.c
+// 用法: PlannerBatchBench [运动数(默认50000)] [工作线程数(默认0: CPU 数 - 1)] [重复次数(默认5)] 2>nul
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "PlannerBatch.h"
+#include "ThreadPool.h"
+
+#define OUTPUT_ARRAYS 6         // 总时长, Td, Tj, Ta, Tv, alpha
+
+static double s_dTicksToUs = 0.0;
+static unsigned int s_uSeed = 20261016u;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+// 对数均匀分布
+static double RandomLog(double dMin, double dMax) {
+    return dMin * pow(dMax / dMin, Random01());
+}
+
+// 多次运行取最快一次
+static int RunBatch(const stPlannerBatch* pBatch, int iRepeat, stPlannerBatchResult* pBest) {
+    int iStatus = 0;
+    for (int r = 0; r < iRepeat; r++) {
+        stPlannerBatchResult stResult;
+        iStatus = PlannerBatchPlan(pBatch, &stResult);
+        if (r == 0 || stResult.dElapsedUs < pBest->dElapsedUs) {
+            *pBest = stResult;
+        }
+    }
+    return iStatus;
+}
+
+// 与 InitInto 的结果比较, 返回不一致的运动数
+static int CompareBatch(const stPlannerBatch* pBatch, const double* pdRefTime, const double* pdRefTv) {
+    int iMismatch = 0;
+    for (int i = 0; i < pBatch->iCount; i++) {
+        if (pBatch->pdTotalTime[i] != pdRefTime[i] ||
+            (pdRefTime[i] >= 0.0 && fabs(pBatch->pdTv[i] - pdRefTv[i]) > 1e-12 * fmax(1.0, pdRefTime[i]))) {
+            iMismatch++;
+        }
+    }
+    return iMismatch;
+}
+
+int main(int argc, char* argv[]) {
+    static stPlannerContext s_stContext;
+    int iCount = (argc > 1) ? atoi(argv[1]) : 50000;
+    int iThreads = (argc > 2) ? atoi(argv[2]) : 0;
+    int iRepeat = (argc > 3) ? atoi(argv[3]) : 5;
+    int iInvalid = 0;
+    LARGE_INTEGER liFreq;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (iCount < 1 || iRepeat < 1) {
+        printf("usage: PlannerBatchBench [moves] [threads] [repeat]\n");
+        return 1;
+    }
+
+    // 输入与输出各一次分配 (输出为 OUTPUT_ARRAYS 个连续数组 + 基准的总时长与匀速时间)
+    stPlannerInput* pstInput = (stPlannerInput*)malloc(sizeof(stPlannerInput) * (size_t)iCount);
+    double* pdOutput = (double*)malloc(sizeof(double) * (size_t)iCount * (OUTPUT_ARRAYS + 2));
+    if (pstInput == NULL || pdOutput == NULL) {
+        printf("out of memory\n");
+        return 1;
+    }
+    stPlannerBatch stBatch;
+    stBatch.iCount = iCount;
+    stBatch.pstInput = pstInput;
+    stBatch.pdTotalTime = pdOutput;
+    stBatch.pdTd = pdOutput + (size_t)iCount;
+    stBatch.pdTj = pdOutput + (size_t)iCount * 2;
+    stBatch.pdTa = pdOutput + (size_t)iCount * 3;
+    stBatch.pdTv = pdOutput + (size_t)iCount * 4;
+    stBatch.pdAlpha = pdOutput + (size_t)iCount * 5;
+    double* pdRefTime = pdOutput + (size_t)iCount * OUTPUT_ARRAYS;
+    double* pdRefTv = pdRefTime + (size_t)iCount;
+
+    for (int i = 0; i < iCount; i++) {
+        stPlannerInput* p = &pstInput[i];
+        double dKind = Random01();
+        p->dDistance = (dKind < 0.01) ? 0.0 : RandomLog(1e-5, 2.0);
+        p->dVMax = RandomLog(0.05, 2.0);
+        p->dAMax = RandomLog(0.5, 10.0);
+        p->dJMax = RandomLog(10.0, 200.0);
+        p->dDMax = RandomLog(200.0, 5000.0);
+        p->dSampleTime = 1e-3;
+        p->dTimeLimit = 0.0;
+        if (dKind > 0.999) {
+            p->dVMax = 0.0;
+            iInvalid++;
+        }
+    }
+
+    // 1. 逐个 InitInto (基准), 带时间限制的用例取最优时间的 0.5 ~ 3 倍
+    double dStartUs = NowUs();
+    for (int i = 0; i < iCount; i++) {
+        if (FourthOrderPlannerInitInto(&pstInput[i], &s_stContext) != 0) {
+            pdRefTime[i] = -1.0;
+            continue;
+        }
+        if (Random01() < 0.2 && s_stContext.dTotalTime > 0.0) {
+            pstInput[i].dTimeLimit = s_stContext.dTotalTime * (0.5 + 2.5 * Random01());
+        }
+    }
+    double dFirstPassUs = NowUs() - dStartUs;
+    double dRefSum = 0.0;
+    dStartUs = NowUs();
+    for (int i = 0; i < iCount; i++) {
+        if (FourthOrderPlannerInitInto(&pstInput[i], &s_stContext) != 0) {
+            pdRefTime[i] = -1.0;
+            continue;
+        }
+        pdRefTime[i] = s_stContext.dTotalTime;
+        pdRefTv[i] = s_stContext.dTv;
+        dRefSum += s_stContext.dTotalTime;
+    }
+    double dInitUs = fmin(dFirstPassUs, NowUs() - dStartUs);
+
+    // 2. 单线程批量
+    stPlannerBatchResult stSingle, stMulti;
+    RunBatch(&stBatch, iRepeat, &stSingle);
+    int iSingleMismatch = CompareBatch(&stBatch, pdRefTime, pdRefTv);
+
+    // 3. 多线程批量
+    memset(pdOutput, 0, sizeof(double) * (size_t)iCount * OUTPUT_ARRAYS);
+    if (ThreadPoolInit(iThreads) != 0) {
+        printf("ThreadPoolInit failed\n");
+        return 1;
+    }
+    RunBatch(&stBatch, iRepeat, &stMulti);
+    int iMultiMismatch = CompareBatch(&stBatch, pdRefTime, pdRefTv);
+
+    int bPass = iSingleMismatch == 0 && iMultiMismatch == 0 && stMulti.iFailed == iInvalid &&
+                stSingle.iFailed == iInvalid && stMulti.dSumTime == dRefSum;
+    printf("%d moves (%d with invalid limits), %d worker threads + caller, chunk %d\n", iCount, iInvalid,
+           ThreadPoolGetThreadCount(), PLANNER_BATCH_CHUNK);
+    printf("%-22s %12s %12s %16s %10s\n", "method", "elapsed", "moves/s", "cycle time sum", "mismatch");
+    printf("%-22s %10.1fms %12.0f %14.3fs %10s\n", "InitInto one by one", dInitUs / 1000.0,
+           (double)iCount * 1.0e6 / dInitUs, dRefSum, "-");
+    printf("%-22s %10.1fms %12.0f %14.3fs %10d\n", "batch, 1 thread", stSingle.dElapsedUs / 1000.0,
+           stSingle.dMovesPerSecond, stSingle.dSumTime, iSingleMismatch);
+    printf("%-22s %10.1fms %12.0f %14.3fs %10d\n", "batch, thread pool", stMulti.dElapsedUs / 1000.0,
+           stMulti.dMovesPerSecond, stMulti.dSumTime, iMultiMismatch);
+    printf("failed moves: %d (first %d), speedup vs InitInto %.1fx, pool vs 1 thread %.2fx -> %s\n", stMulti.iFailed,
+           stMulti.iFirstFailed, dInitUs / stMulti.dElapsedUs, stSingle.dElapsedUs / stMulti.dElapsedUs,
+           bPass ? "PASS" : "FAIL");
+
+    ThreadPoolDestroy();
+    free(pdOutput);
+    free(pstInput);
+    return bPass ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// 四阶轨迹规划器逐点取点的基准测试及一致性检查
+// 对几组典型行程 (长行程/短行程/时间缩放/极短行程), 分别用参考实现 (v1.10.1,
+// 逐点线性查找段 + pow 积分, 见 PlannerReference.c) 和当前实现 (段游标 + Horner)
+// 生成整条轨迹, 比较各点差异与点数, 并测量每秒取点数;
+// 再将成批生成 (GenerateBlock, 全部输出/仅位置) 与逐点输出比较并测量每秒点数
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc PlannerBench.c PlannerReference.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: PlannerBench [重复次数(默认20)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "PlannerReference.h"
+
+#define CHECK_TOLERANCE 1e-9    // 相对于各量峰值的允许误差
+#define BLOCK_TOLERANCE 1e-12   // 成批输出相对逐点输出的允许误差 (见 GenerateBlock 说明)
+#define BLOCK_SIZE 256
+#define MAX_POINTS 200000
+
+typedef struct {
+    const char* pszName;
+    stPlannerInput stInput;
+} stBenchCase;
+
+static const stBenchCase s_astCases[] = {
+    { "long",   { 2.0,   0.8, 2.0, 10.0, 200.0, 1e-4, 0.0 } },
+    { "short",  { 0.02,  0.8, 2.0, 10.0, 200.0, 1e-4, 0.0 } },
+    { "scaled", { 1.0,   0.8, 2.0, 10.0, 200.0, 1e-4, 4.0 } },
+    { "tiny",   { 1e-5,  0.8, 2.0, 10.0, 200.0, 1e-4, 0.0 } },
+};
+
+static double ElapsedNs(LARGE_INTEGER stStart, LARGE_INTEGER stEnd, LARGE_INTEGER stFreq) {
+    return (double)(stEnd.QuadPart - stStart.QuadPart) * 1e9 / (double)stFreq.QuadPart;
+}
+
+static void UpdatePeak(double* pdPeak, double dValue) {
+    if (fabs(dValue) > *pdPeak) *pdPeak = fabs(dValue);
+}
+
+// 逐点比较两种实现, 返回 pos/vel/acc/jerk 中最大的相对误差, 点数写入 piRefCount/piNewCount
+static double CheckCase(const stPlannerInput* pstInput, int* piRefCount, int* piNewCount) {
+    stRefPlannerContext* pRef = RefPlannerInit(pstInput);
+    stPlannerContext* pNew = FourthOrderPlannerInit(pstInput);
+    stTrajectoryPoint stRef, stNew;
+    double adDiff[4] = { 0 }, adPeak[4] = { 0 };
+    int bRefDone = 0, bNewDone = 0;
+
+    *piRefCount = 0; *piNewCount = 0;
+    if (!pRef || !pNew) {
+        RefPlannerFree(pRef); FourthOrderPlannerFree(pNew);
+        return INFINITY;
+    }
+    while (!bRefDone || !bNewDone) {
+        bRefDone = bRefDone || RefPlannerGetNextPoint(pRef, &stRef) != 0;
+        bNewDone = bNewDone || FourthOrderPlannerGetNextPoint(pNew, &stNew) != 0;
+        if (!bRefDone) (*piRefCount)++;
+        if (!bNewDone) (*piNewCount)++;
+        if (bRefDone || bNewDone) continue;
+
+        double adRef[4] = { stRef.dPos, stRef.dVel, stRef.dAcc, stRef.dJerk };
+        double adNew[4] = { stNew.dPos, stNew.dVel, stNew.dAcc, stNew.dJerk };
+        for (int i = 0; i < 4; i++) {
+            UpdatePeak(&adPeak[i], adRef[i]);
+            UpdatePeak(&adDiff[i], adNew[i] - adRef[i]);
+        }
+    }
+    RefPlannerFree(pRef);
+    FourthOrderPlannerFree(pNew);
+
+    double dMaxRel = 0.0;
+    for (int i = 0; i < 4; i++) {
+        if (adPeak[i] > 0.0 && adDiff[i] / adPeak[i] > dMaxRel) dMaxRel = adDiff[i] / adPeak[i];
+    }
+    return dMaxRel;
+}
+
+static double s_adPoint[4][MAX_POINTS];
+static double s_adBlock[4][MAX_POINTS];
+
+// 成批生成与逐点生成比较, 返回 pos/vel/acc/jerk 中最大的相对误差 (点数不同返回 INFINITY)
+static double CheckBlock(const stPlannerInput* pstInput) {
+    stPlannerContext* pPoint = FourthOrderPlannerInit(pstInput);
+    stPlannerContext* pBlock = FourthOrderPlannerInit(pstInput);
+    stTrajectoryPoint stPoint;
+    int iPointCount = 0, iBlockCount = 0, n;
+
+    if (!pPoint || !pBlock) {
+        FourthOrderPlannerFree(pPoint); FourthOrderPlannerFree(pBlock);
+        return INFINITY;
+    }
+    while (iPointCount < MAX_POINTS && FourthOrderPlannerGetNextPoint(pPoint, &stPoint) == 0) {
+        s_adPoint[0][iPointCount] = stPoint.dPos;  s_adPoint[1][iPointCount] = stPoint.dVel;
+        s_adPoint[2][iPointCount] = stPoint.dAcc;  s_adPoint[3][iPointCount] = stPoint.dJerk;
+        iPointCount++;
+    }
+    // 块大小取质数, 使块边界与段边界错开
+    while ((n = FourthOrderPlannerGenerateBlock(pBlock, (MAX_POINTS - iBlockCount < 97) ? MAX_POINTS - iBlockCount : 97,
+                                                s_adBlock[0] + iBlockCount, s_adBlock[1] + iBlockCount,
+                                                s_adBlock[2] + iBlockCount, s_adBlock[3] + iBlockCount)) > 0) {
+        iBlockCount += n;
+    }
+    FourthOrderPlannerFree(pPoint);
+    FourthOrderPlannerFree(pBlock);
+    if (iPointCount != iBlockCount) return INFINITY;
+
+    double dMaxRel = 0.0;
+    for (int q = 0; q < 4; q++) {
+        double dPeak = 0.0, dDiff = 0.0;
+        for (int i = 0; i < iPointCount; i++) {
+            UpdatePeak(&dPeak, s_adPoint[q][i]);
+            UpdatePeak(&dDiff, s_adBlock[q][i] - s_adPoint[q][i]);
+        }
+        if (dPeak > 0.0 && dDiff / dPeak > dMaxRel) dMaxRel = dDiff / dPeak;
+    }
+    return dMaxRel;
+}
+
+// 成批生成整条轨迹的耗时 [ns], bPosOnly 时只输出位置
+static double TimeBlock(const stPlannerInput* pstInput, int bPosOnly, long long* pllPoints) {
+    static double adPos[BLOCK_SIZE], adVel[BLOCK_SIZE], adAcc[BLOCK_SIZE], adJerk[BLOCK_SIZE];
+    LARGE_INTEGER stFreq, stStart, stEnd;
+    stPlannerContext* pContext = FourthOrderPlannerInit(pstInput);
+    int n;
+
+    if (!pContext) return 0.0;
+    QueryPerformanceFrequency(&stFreq);
+    QueryPerformanceCounter(&stStart);
+    while ((n = FourthOrderPlannerGenerateBlock(pContext, BLOCK_SIZE, adPos, bPosOnly ? NULL : adVel,
+                                                bPosOnly ? NULL : adAcc, bPosOnly ? NULL : adJerk)) > 0) {
+        *pllPoints += n;
+    }
+    QueryPerformanceCounter(&stEnd);
+    FourthOrderPlannerFree(pContext);
+    return ElapsedNs(stStart, stEnd, stFreq);
+}
+
+int main(int argc, char* argv[]) {
+    int iRepeat = (argc > 1) ? atoi(argv[1]) : 20;
+    LARGE_INTEGER stFreq, stStart, stEnd;
+    stTrajectoryPoint stPoint;
+    volatile double dSink = 0.0;
+    int iRet = 0;
+
+    if (iRepeat <= 0) {
+        fprintf(stderr, "usage: PlannerBench [repeat]\n");
+        return 1;
+    }
+    QueryPerformanceFrequency(&stFreq);
+    printf("%-8s %8s %8s %12s %14s %14s %8s\n", "case", "ref pts", "new pts", "rel err", "ref Mpts/s", "new Mpts/s", "speedup");
+
+    for (int c = 0; c < (int)(sizeof(s_astCases) / sizeof(s_astCases[0])); c++) {
+        const stPlannerInput* pstInput = &s_astCases[c].stInput;
+        int iRefCount, iNewCount;
+        double dErr = CheckCase(pstInput, &iRefCount, &iNewCount);
+
+        // 只计取点时间, Init 在计时区间外
+        double dRefNs = 0.0, dNewNs = 0.0;
+        long long llPoints = 0;
+        for (int r = 0; r < iRepeat; r++) {
+            stRefPlannerContext* pRef = RefPlannerInit(pstInput);
+            stPlannerContext* pNew = FourthOrderPlannerInit(pstInput);
+            if (!pRef || !pNew) { RefPlannerFree(pRef); FourthOrderPlannerFree(pNew); break; }
+
+            QueryPerformanceCounter(&stStart);
+            while (RefPlannerGetNextPoint(pRef, &stPoint) == 0) dSink += stPoint.dPos;
+            QueryPerformanceCounter(&stEnd);
+            dRefNs += ElapsedNs(stStart, stEnd, stFreq);
+
+            QueryPerformanceCounter(&stStart);
+            while (FourthOrderPlannerGetNextPoint(pNew, &stPoint) == 0) dSink += stPoint.dPos;
+            QueryPerformanceCounter(&stEnd);
+            dNewNs += ElapsedNs(stStart, stEnd, stFreq);
+
+            llPoints += iNewCount;
+            RefPlannerFree(pRef);
+            FourthOrderPlannerFree(pNew);
+        }
+
+        double dRefRate = (dRefNs > 0.0) ? llPoints * 1e3 / dRefNs : 0.0;
+        double dNewRate = (dNewNs > 0.0) ? llPoints * 1e3 / dNewNs : 0.0;
+        printf("%-8s %8d %8d %12.3e %14.2f %14.2f %7.2fx\n", s_astCases[c].pszName, iRefCount, iNewCount,
+               dErr, dRefRate, dNewRate, (dRefRate > 0.0) ? dNewRate / dRefRate : 0.0);
+        if (dErr > CHECK_TOLERANCE || abs(iRefCount - iNewCount) > 1) {
+            printf("%s: mismatch exceeds tolerance %.1e\n", s_astCases[c].pszName, CHECK_TOLERANCE);
+            iRet = 1;
+        }
+    }
+
+    // 成批生成
+    printf("\n%-8s %12s %14s %14s %14s\n", "case", "block err", "point Mpts/s", "block Mpts/s", "pos Mpts/s");
+    for (int c = 0; c < (int)(sizeof(s_astCases) / sizeof(s_astCases[0])); c++) {
+        const stPlannerInput* pstInput = &s_astCases[c].stInput;
+        double dErr = CheckBlock(pstInput);
+        double dPointNs = 0.0, dBlockNs = 0.0, dPosNs = 0.0;
+        long long llPoints = 0, llBlockPoints = 0, llPosPoints = 0;
+
+        for (int r = 0; r < iRepeat; r++) {
+            stPlannerContext* pContext = FourthOrderPlannerInit(pstInput);
+            if (!pContext) break;
+            QueryPerformanceCounter(&stStart);
+            while (FourthOrderPlannerGetNextPoint(pContext, &stPoint) == 0) { dSink += stPoint.dPos; llPoints++; }
+            QueryPerformanceCounter(&stEnd);
+            dPointNs += ElapsedNs(stStart, stEnd, stFreq);
+            FourthOrderPlannerFree(pContext);
+
+            dBlockNs += TimeBlock(pstInput, 0, &llBlockPoints);
+            dPosNs += TimeBlock(pstInput, 1, &llPosPoints);
+        }
+        printf("%-8s %12.3e %14.2f %14.2f %14.2f\n", s_astCases[c].pszName, dErr,
+               (dPointNs > 0.0) ? llPoints * 1e3 / dPointNs : 0.0,
+               (dBlockNs > 0.0) ? llBlockPoints * 1e3 / dBlockNs : 0.0,
+               (dPosNs > 0.0) ? llPosPoints * 1e3 / dPosNs : 0.0);
+        if (dErr > BLOCK_TOLERANCE) {
+            printf("%s: block output exceeds tolerance %.1e\n", s_astCases[c].pszName, BLOCK_TOLERANCE);
+            iRet = 1;
+        }
+    }
+    (void)dSink;
+    return iRet;
+}
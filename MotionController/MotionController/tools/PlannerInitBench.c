@@ -0,0 +1,146 @@
+// 四阶轨迹规划器 Init 的基准测试及回归比较
+// 在位移/速度/加速度/Jerk/Snap 约束与时间限制组成的网格上, 分别调用参考实现
+// (v1.10.1, alpha 与峰值加速度两层二分搜索, 见 PlannerReference.c) 和当前实现 (解析解),
+// 1. 两者都成功时比较 Td/Tj/Ta/Tv/总时长 (以总时长归一化), 超出 CHECK_TOLERANCE 判为不一致
+// 2. 统计参考实现失败而当前实现成功 (原实现无解的情形) 及当前实现失败而参考实现成功 (回归) 的用例数;
+//    参考实现短行程搜索不检查速度约束, 其峰值速度超过 (缩放后) VMax 的用例单独统计, 不参与比较;
+//    当前实现峰值速度超限判为回归;
+//    参考实现终点位置的相对误差超过 REF_DIST_TOLERANCE 时 (极短行程下二分搜索的绝对容差 1e-9 相对过大),
+//    其分段本身不准, 单独统计为 "ref imprecise", 不参与比较
+// 3. 统计两者单次 Init 的平均/最大耗时
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc PlannerInitBench.c PlannerReference.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: PlannerInitBench 2>nul   (参考实现对无解用例会向 stderr 打印大量错误信息)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "PlannerReference.h"
+
+#define CHECK_TOLERANCE 1e-6    // 分段时长差异 / 总时长 的允许值 (参考实现的二分搜索精度约 1e-7~1e-9)
+#define REF_DIST_TOLERANCE 1e-6 // 参考实现终点位置相对误差超过此值时不参与比较
+
+static const double s_adDistance[] = { 1e-6, 1e-4, 1e-3, 0.005, 0.02, 0.1, 0.3, 0.5, 1.0, 2.0, 5.0, 10.0 };
+static const double s_adVMax[] = { 0.05, 0.2, 0.8, 2.0 };
+static const double s_adAMax[] = { 0.5, 2.0, 10.0 };
+static const double s_adJMax[] = { 10.0, 100.0 };
+static const double s_adDMax[] = { 200.0, 5000.0 };
+static const double s_adLimitRatio[] = { 0.0, 0.5, 0.9, 1.5, 3.0 };  // 时间限制 = 最优时间 * 比例 (0 表示不限)
+
+#define COUNT_OF(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+typedef struct {
+    double dTotalNs;
+    double dMaxNs;
+    int iCalls;
+} stInitTiming;
+
+static double ElapsedNs(LARGE_INTEGER stStart, LARGE_INTEGER stEnd, LARGE_INTEGER stFreq) {
+    return (double)(stEnd.QuadPart - stStart.QuadPart) * 1e9 / (double)stFreq.QuadPart;
+}
+
+static void AddTiming(stInitTiming* pTiming, double dNs) {
+    pTiming->dTotalNs += dNs;
+    if (dNs > pTiming->dMaxNs) pTiming->dMaxNs = dNs;
+    pTiming->iCalls++;
+}
+
+// 加速段末 (即峰值) 速度是否超过缩放后的速度约束
+static int ExceedsVMax(double dPeakVel, double dAlpha, const stPlannerInput* pstInput) {
+    return dPeakVel > dAlpha * pstInput->dVMax * (1.0 + 1e-9);
+}
+
+// 两种实现的分段时长最大差异 (以参考实现总时长归一化)
+static double SegmentDiff(const stRefPlannerContext* pRef, const stPlannerContext* pNew) {
+    double adRef[5] = { pRef->dTd, pRef->dTj, pRef->dTa, pRef->dTv, pRef->dTotalTime };
+    double adNew[5] = { pNew->dTd, pNew->dTj, pNew->dTa, pNew->dTv, pNew->dTotalTime };
+    double dScale = (pRef->dTotalTime > 1e-12) ? pRef->dTotalTime : 1.0;
+    double dMax = 0.0;
+    for (int i = 0; i < 5; i++) {
+        double dDiff = fabs(adNew[i] - adRef[i]) / dScale;
+        if (dDiff > dMax) dMax = dDiff;
+    }
+    return dMax;
+}
+
+int main(void) {
+    LARGE_INTEGER stFreq, stStart, stEnd;
+    stInitTiming stRefTiming = { 0 }, stNewTiming = { 0 };
+    int iBothOk = 0, iFixed = 0, iRegressed = 0, iBothFail = 0, iMismatch = 0, iRefOverspeed = 0, iRefImprecise = 0;
+    double dMaxDiff = 0.0;
+    stPlannerInput stWorst = { 0 };
+
+    QueryPerformanceFrequency(&stFreq);
+
+    for (int s = 0; s < COUNT_OF(s_adDistance); s++)
+    for (int v = 0; v < COUNT_OF(s_adVMax); v++)
+    for (int a = 0; a < COUNT_OF(s_adAMax); a++)
+    for (int j = 0; j < COUNT_OF(s_adJMax); j++)
+    for (int d = 0; d < COUNT_OF(s_adDMax); d++)
+    for (int l = 0; l < COUNT_OF(s_adLimitRatio); l++) {
+        stPlannerInput stInput = { s_adDistance[s], s_adVMax[v], s_adAMax[a], s_adJMax[j], s_adDMax[d], 1e-3, 0.0 };
+
+        // 时间限制按最优时间的比例给出 (最优时间取参考实现, 参考实现失败时取当前实现)
+        if (s_adLimitRatio[l] > 0.0) {
+            stRefPlannerContext* pOpt = RefPlannerInit(&stInput);
+            stPlannerContext* pOptNew = pOpt ? NULL : FourthOrderPlannerInit(&stInput);
+            double dOptimal = pOpt ? pOpt->dTotalTime : (pOptNew ? pOptNew->dTotalTime : 0.0);
+            RefPlannerFree(pOpt);
+            FourthOrderPlannerFree(pOptNew);
+            if (dOptimal <= 0.0) continue;
+            stInput.dTimeLimit = dOptimal * s_adLimitRatio[l];
+        }
+
+        QueryPerformanceCounter(&stStart);
+        stRefPlannerContext* pRef = RefPlannerInit(&stInput);
+        QueryPerformanceCounter(&stEnd);
+        AddTiming(&stRefTiming, ElapsedNs(stStart, stEnd, stFreq));
+
+        QueryPerformanceCounter(&stStart);
+        stPlannerContext* pNew = FourthOrderPlannerInit(&stInput);
+        QueryPerformanceCounter(&stEnd);
+        AddTiming(&stNewTiming, ElapsedNs(stStart, stEnd, stFreq));
+
+        if (pNew && ExceedsVMax(pNew->stAccStateAtBorder[7].dVel, pNew->dAlphaScaleFactor, &stInput)) {
+            iRegressed++;
+            printf("overspeed: S=%g V=%g A=%g J=%g D=%g T=%g\n", stInput.dDistance, stInput.dVMax,
+                   stInput.dAMax, stInput.dJMax, stInput.dDMax, stInput.dTimeLimit);
+        } else if (pRef && pNew && ExceedsVMax(pRef->stAccStateAtBorder[7].dVel, pRef->dAlphaScaleFactor, &stInput)) {
+            iRefOverspeed++;
+        } else if (pRef && pNew &&
+                   fabs(pRef->stDecStateAtBorder[7].dPos - stInput.dDistance) > REF_DIST_TOLERANCE * stInput.dDistance) {
+            iRefImprecise++;
+        } else if (pRef && pNew) {
+            double dDiff = SegmentDiff(pRef, pNew);
+            iBothOk++;
+            if (dDiff > dMaxDiff) { dMaxDiff = dDiff; stWorst = stInput; }
+            if (dDiff > CHECK_TOLERANCE) iMismatch++;
+        } else if (pNew) {
+            iFixed++;
+        } else if (pRef) {
+            iRegressed++;
+            printf("regression: S=%g V=%g A=%g J=%g D=%g T=%g\n", stInput.dDistance, stInput.dVMax,
+                   stInput.dAMax, stInput.dJMax, stInput.dDMax, stInput.dTimeLimit);
+        } else {
+            iBothFail++;
+        }
+        RefPlannerFree(pRef);
+        FourthOrderPlannerFree(pNew);
+    }
+
+    printf("cases=%d  both ok=%d  fixed (ref failed)=%d  ref overspeed=%d  ref imprecise=%d  regressed=%d  both failed=%d\n",
+           stNewTiming.iCalls, iBothOk, iFixed, iRefOverspeed, iRefImprecise, iRegressed, iBothFail);
+    printf("max segment diff / total time = %.3e (tolerance %.1e, %d over)\n", dMaxDiff, CHECK_TOLERANCE, iMismatch);
+    printf("  worst: S=%g V=%g A=%g J=%g D=%g T=%g\n", stWorst.dDistance, stWorst.dVMax, stWorst.dAMax,
+           stWorst.dJMax, stWorst.dDMax, stWorst.dTimeLimit);
+    printf("\n%-10s %14s %14s\n", "init", "mean us", "max us");
+    printf("%-10s %14.3f %14.3f\n", "ref", stRefTiming.dTotalNs / stRefTiming.iCalls * 1e-3, stRefTiming.dMaxNs * 1e-3);
+    printf("%-10s %14.3f %14.3f\n", "new", stNewTiming.dTotalNs / stNewTiming.iCalls * 1e-3, stNewTiming.dMaxNs * 1e-3);
+
+    return (iMismatch > 0 || iRegressed > 0) ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+// 参考实现: 四阶轨迹规划器 v1.10.1 (见 PlannerReference.c)
+#ifndef PLANNER_REFERENCE_H
+#define PLANNER_REFERENCE_H
+
+#include "FourthOrderTrajectoryPlanning.h"
+
+// 参考实现的上下文 (与 v1.10.1 的 stPlannerContext 字段一致)
+typedef struct {
+    stPlannerInput stInput;
+    double dTd, dTj, dTa, dTv, dTotalTime;
+    int bIsTimeScaled;
+    double dAlphaScaleFactor;
+    double adAccSegBorders[8];
+    double adDecSegBorders[8];
+    double dConstVelStartTime;
+    double dDecelStartTime;
+    stSegmentBoundaryState stAccStateAtBorder[8];
+    stSegmentBoundaryState stDecStateAtBorder[8];
+    stSegmentBoundaryState stConstVelEndState;
+    double dCurrentTime;
+    int    bIsFinished;
+} stRefPlannerContext;
+
+stRefPlannerContext* RefPlannerInit(const stPlannerInput *pstInput);
+int RefPlannerGetNextPoint(stRefPlannerContext *pContext, stTrajectoryPoint *pPointOutput);
+void RefPlannerFree(stRefPlannerContext *pContext);
+
+#endif
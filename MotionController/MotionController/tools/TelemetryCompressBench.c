@@ -0,0 +1,305 @@
+// 逐周期记录分组压缩 (TelemetryCompress) 的检查与基准
+// 数据: 与控制线程相同的闭环 (四阶轨迹 -> ControllerBank -> 刚体被控对象 BiquadBank, 1ms 周期), 各运动轴执行随机
+//       点到点运动, 运动之间停留随机时长 (按运动占空比), 另有若干轴始终静止; 按 TelemetryFile 标准列编码为定长记录
+// 1. 逐组压缩并解压, 与原记录逐位比较; 每组再逐通道单独解码 (TelemetryDecodeChannel) 比较
+// 2. 压缩比: 总体, 以及各列 (各轴合计) 的 位/值 与编码方式 (XOR/DOD) 的选择次数
+// 3. 压缩/解压速度, 单通道解码与整组解压的耗时比较
+// 可选输出文件: 写出压缩的 .tlm 与组索引 (可用 TelemetryConvert csv/stats/channel 读取), 再经 TelemetryReader
+//   在随机位置读取单个通道, 给出经索引定位的耗时
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc TelemetryCompressBench.c ..\src\TelemetryCompress.c ..\src\TelemetryFile.c
+//      ..\src\FourthOrderTrajectoryPlanning.c ..\src\BiquadBank.c ..\src\Controlled_Device.c ..\src\Controler.c
+//      ..\src\PIDController.c ..\src\LowPassFilter.c ..\src\Notch_TF.c ..\src\LeadLag.c ..\src\SosCascade.c
+//      ..\src\AxisConfig.c ..\src\log.c
+// 用法: TelemetryCompressBench [轴数(默认8)] [时长 s(默认600)] [运动占空比(默认0.2)] [静止轴数(默认2)] [输出.tlm]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include "AxisConfig.h"
+#include "BiquadBank.h"
+#include "Controler.h"
+#include "Controlled_Device.h"
+#include "FourthOrderTrajectoryPlanning.h"
+#include "TelemetryCompress.h"
+
+#define BENCH_SAMPLE_TIME 1e-3
+#define BENCH_PLANT_MASS 16.0       // 与 ThreadControl.h 的 PLANT_MASS 相同
+
+static const stPlannerInput s_stLimits = { 0.0, 0.8, 2.0, 10.0, 200.0, BENCH_SAMPLE_TIME, 0.0 };
+
+static double s_dTicksToUs = 0.0;
+static unsigned int s_uSeed = 20261016u;
+
+// 单轴的运动程序
+typedef struct {
+    stPlannerContext stContext;
+    double dTarget;                 // 当前目标位置
+    int iDwell;                     // 剩余停留周期数 (< 0: 运动中)
+    int bIdle;                      // 始终静止
+} stAxisProgram;
+
+static stAxisProgram s_astProgram[MAX_AXIS_COUNT];
+static stBiquadBank s_stPlant;
+static ControllerBank s_stController;
+static stTelemetryIndexBuilder s_stIndex;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+// 开始下一段随机运动 (位移 ±[0.02, 0.5]), 返回运动周期数
+static int NextMove(stAxisProgram* pProgram) {
+    stPlannerInputEx stEx;
+    memset(&stEx, 0, sizeof(stEx));
+    stEx.stLimits = s_stLimits;
+    stEx.stLimits.dVMax = s_stLimits.dVMax * (0.3 + 0.7 * Random01());
+    stEx.stLimits.dDistance = (0.02 + 0.48 * Random01()) * ((Random01() < 0.5) ? -1.0 : 1.0);
+    stEx.dStartPos = pProgram->dTarget;
+    FourthOrderPlannerInitEx(&stEx, &pProgram->stContext);
+    return (int)(pProgram->stContext.dTotalTime / BENCH_SAMPLE_TIME) + 1;
+}
+
+// 推进一个周期的目标位置; 运动结束后按占空比停留 (停留时长 = 运动时长 × (1 - 占空比) / 占空比 × [0.5, 1.5))
+static void StepTarget(stAxisProgram* pProgram, double dDuty) {
+    stTrajectoryPoint stPoint;
+    if (pProgram->bIdle) {
+        return;
+    }
+    if (pProgram->iDwell > 0) {
+        pProgram->iDwell--;
+        return;
+    }
+    if (pProgram->iDwell == 0) {
+        NextMove(pProgram);
+        pProgram->iDwell = -1;
+    }
+    if (FourthOrderPlannerGetNextPoint(&pProgram->stContext, &stPoint) == 0) {
+        pProgram->dTarget = stPoint.dPos;
+    }
+    if (pProgram->stContext.bIsFinished) {
+        double dMoveCycles = pProgram->stContext.dTotalTime / BENCH_SAMPLE_TIME;
+        pProgram->iDwell = 1 + (int)(dMoveCycles * (1.0 - dDuty) / dDuty * (0.5 + Random01()));
+    }
+}
+
+// 运行一个控制周期并按标准列编码为一条记录
+static void SimulateRecord(const stTelemetryHeader* pHeader, int iStep, double dDuty, unsigned char* pucRecord) {
+    const stTelemetryColumn* pColumn = pHeader->astColumn;
+    double adTarget[MAX_AXIS_COUNT], adActual[MAX_AXIS_COUNT], adError[MAX_AXIS_COUNT];
+    double adForce[MAX_AXIS_COUNT], adOut[MAX_AXIS_COUNT];
+    int32_t aiMode[MAX_AXIS_COUNT];
+    unsigned char aucEnable[MAX_AXIS_COUNT];
+    int iAxes = g_iAxisCount;
+    double dTime = iStep * BENCH_SAMPLE_TIME;
+    int32_t iStep32 = iStep;
+
+    for (int axis = 0; axis < iAxes; axis++) {
+        StepTarget(&s_astProgram[axis], dDuty);
+        adTarget[axis] = s_astProgram[axis].dTarget;
+        adActual[axis] = s_stPlant.adOut1[axis];
+        adError[axis] = adTarget[axis] - adActual[axis];
+        aiMode[axis] = 0;
+        aucEnable[axis] = 1;
+    }
+    ControllerBankUpdate(&s_stController, adError, adForce, aucEnable, iAxes);
+    BiquadBankProcess(&s_stPlant, adForce, adOut, aucEnable, iAxes);
+
+    size_t uAxisBytes = sizeof(double) * (size_t)iAxes;
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_TIME].uOffset, &dTime, sizeof(double));
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_TARGET].uOffset, adTarget, uAxisBytes);
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_ACTUAL].uOffset, adActual, uAxisBytes);
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_ERROR].uOffset, adError, uAxisBytes);
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_FORCE].uOffset, adForce, uAxisBytes);
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_STEP].uOffset, &iStep32, sizeof(int32_t));
+    memcpy(pucRecord + pColumn[TELEMETRY_COL_MODE].uOffset, aiMode, sizeof(int32_t) * (size_t)iAxes);
+}
+
+// 经 TelemetryReader (组索引) 在随机位置读取步号通道 (步号 = 记录序号), 返回不符的次数
+static unsigned long long RandomChannelReads(const char* pszPath, long long llRecords) {
+    static double s_adWindow[1000];
+    const int iReads = 1000;
+    stTelemetryReader stReader;
+    unsigned long long ullBad = 0;
+    if (TelemetryReaderOpen(&stReader, pszPath) != 0) {
+        printf("cannot open %s\n", pszPath);
+        return 1;
+    }
+    uint32_t uFileEntries = stReader.uIndexCount;
+    double dStart = NowUs();
+    for (int i = 0; i < iReads; i++) {
+        uint64_t ullFirst = (uint64_t)(Random01() * (double)llRecords);
+        uint32_t uCount = (uint32_t)(sizeof(s_adWindow) / sizeof(s_adWindow[0]));
+        uint32_t uExpected = (ullFirst + uCount > (uint64_t)llRecords) ? (uint32_t)(llRecords - ullFirst) : uCount;
+        int iRead = TelemetryReaderReadChannel(&stReader, TELEMETRY_COL_STEP, 0, ullFirst, uCount, s_adWindow);
+        int bMatch = (iRead == (int)uExpected);
+        for (int k = 0; bMatch && k < iRead; k++) {
+            bMatch = (s_adWindow[k] == (double)(ullFirst + (uint64_t)k));
+        }
+        if (!bMatch && ullBad++ < 5) {
+            printf("channel read at record %llu: %d values, mismatch\n", (unsigned long long)ullFirst, iRead);
+        }
+    }
+    double dUs = NowUs() - dStart;
+    if (stReader.ullDataEnd == 0) {
+        printf("%s: group index missing\n", pszPath);
+        ullBad++;
+    }
+    printf("file index: %u entries (stride %u groups); random channel read %.1f us per %u records\n", uFileEntries,
+           stReader.uIndexStride, dUs / iReads, (unsigned)(sizeof(s_adWindow) / sizeof(s_adWindow[0])));
+    TelemetryReaderClose(&stReader);
+    return ullBad;
+}
+
+int main(int argc, char* argv[]) {
+    static unsigned char s_aucRecords[TELEMETRY_GROUP_RECORDS * TELEMETRY_RECORD_MAX];
+    static unsigned char s_aucDecoded[TELEMETRY_GROUP_RECORDS * TELEMETRY_RECORD_MAX];
+    static unsigned char s_aucGroup[TELEMETRY_GROUP_MAX_BYTES(TELEMETRY_STD_CHANNELS_MAX, TELEMETRY_GROUP_RECORDS)];
+    static double s_adChannel[TELEMETRY_GROUP_RECORDS];
+    static unsigned long long s_aullColumnBytes[TELEMETRY_MAX_COLUMNS];
+    static unsigned long long s_aullCodec[TELEMETRY_MAX_COLUMNS][3];
+    int iAxes = (argc > 1) ? atoi(argv[1]) : 8;
+    double dSeconds = (argc > 2) ? atof(argv[2]) : 600.0;
+    double dDuty = (argc > 3) ? atof(argv[3]) : 0.2;
+    int iIdleAxes = (argc > 4) ? atoi(argv[4]) : 2;
+    const char* pszOut = (argc > 5) ? argv[5] : NULL;
+    stTelemetryHeader stHeader;
+    LARGE_INTEGER liFreq;
+    FILE* pOut = NULL;
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (AxisConfigSetCount(iAxes) != 0 || dSeconds <= 0.0 || !(dDuty > 0.0 && dDuty <= 1.0) || iIdleAxes < 0 ||
+        TelemetryHeaderInit(&stHeader, iAxes, BENCH_SAMPLE_TIME) != 0) {
+        printf("usage: TelemetryCompressBench [axes 1..%d] [seconds] [duty 0..1] [idle axes] [out.tlm]\n",
+               MAX_AXIS_COUNT);
+        return 1;
+    }
+    stHeader.uFlags |= TELEMETRY_FLAG_COMPRESSED;
+    if (pszOut != NULL) {
+        if (fopen_s(&pOut, pszOut, "wb") != 0 || pOut == NULL) {
+            printf("cannot create %s\n", pszOut);
+            return 1;
+        }
+        fwrite(&stHeader, 1, sizeof(stHeader), pOut);
+    }
+
+    BiquadBankInit(&s_stPlant);
+    for (int axis = 0; axis < iAxes; axis++) {
+        RigidBodyBankInitAxis(&s_stPlant, axis, BENCH_PLANT_MASS, BENCH_SAMPLE_TIME);
+        memset(&s_astProgram[axis], 0, sizeof(s_astProgram[axis]));
+        s_astProgram[axis].bIdle = axis >= iAxes - iIdleAxes;
+        s_astProgram[axis].iDwell = (int)(Random01() * 1000.0);     // 各轴错开开始
+    }
+    ControllerBankInit(&s_stController, iAxes);
+
+    // 通道 -> 列
+    int aiChannelColumn[TELEMETRY_CHANNEL_MAX];
+    int iChannels = TelemetryChannelCount(&stHeader);
+    for (int c = 0, k = 0; c < (int)stHeader.uColumnCount; c++) {
+        for (int e = 0; e < stHeader.astColumn[c].usCount; e++) {
+            aiChannelColumn[k++] = c;
+        }
+    }
+
+    uint32_t uRecordSize = stHeader.uRecordSize;
+    long long llRecords = (long long)(dSeconds / BENCH_SAMPLE_TIME);
+    unsigned long long ullRawBytes = 0, ullCompressedBytes = 0, ullGroups = 0, ullBad = 0;
+    TelemetryIndexInit(&s_stIndex);
+    double dCompressUs = 0.0, dDecompressUs = 0.0, dChannelUs = 0.0;
+    for (long long llFirst = 0; llFirst < llRecords; llFirst += TELEMETRY_GROUP_RECORDS) {
+        uint32_t uCount = (llRecords - llFirst < TELEMETRY_GROUP_RECORDS) ? (uint32_t)(llRecords - llFirst)
+                                                                           : TELEMETRY_GROUP_RECORDS;
+        for (uint32_t i = 0; i < uCount; i++) {
+            SimulateRecord(&stHeader, (int)(llFirst + i), dDuty, s_aucRecords + (size_t)i * uRecordSize);
+        }
+
+        double dStart = NowUs();
+        size_t uBytes = TelemetryCompressGroup(&stHeader, s_aucRecords, uCount, (uint64_t)llFirst, s_aucGroup);
+        dCompressUs += NowUs() - dStart;
+        dStart = NowUs();
+        int iDecoded = (TelemetryCheckGroup(&stHeader, s_aucGroup, uBytes) == 0)
+                           ? TelemetryDecompressGroup(&stHeader, s_aucGroup, s_aucDecoded) : -1;
+        dDecompressUs += NowUs() - dStart;
+        if (iDecoded != (int)uCount || memcmp(s_aucRecords, s_aucDecoded, (size_t)uCount * uRecordSize) != 0) {
+            if (ullBad++ < 5) {
+                printf("group at record %lld: decoded %d records, mismatch\n", llFirst, iDecoded);
+            }
+        }
+
+        // 逐通道单独解码, 并统计各列的块字节数与编码方式
+        for (int ch = 0; ch < iChannels; ch++) {
+            int c = aiChannelColumn[ch];
+            const stTelemetryColumn* pColumn = &stHeader.astColumn[c];
+            int iElement = ch - TelemetryChannelIndex(&stHeader, c, 0);
+            uint32_t uOffset, uEnd = (uint32_t)uBytes;
+            memcpy(&uOffset, s_aucGroup + sizeof(stTelemetryGroupHeader) + 4 * (size_t)ch, sizeof(uOffset));
+            if (ch + 1 < iChannels) {
+                memcpy(&uEnd, s_aucGroup + sizeof(stTelemetryGroupHeader) + 4 * (size_t)(ch + 1), sizeof(uEnd));
+            }
+            s_aullColumnBytes[c] += uEnd - uOffset + sizeof(uint32_t);
+            s_aullCodec[c][s_aucGroup[uOffset] % 3]++;
+
+            dStart = NowUs();
+            int iValues = TelemetryDecodeChannel(&stHeader, s_aucGroup, ch, s_adChannel);
+            dChannelUs += NowUs() - dStart;
+            for (int i = 0; i < iValues; i++) {
+                double dExpected = TelemetryGetValue(&stHeader, s_aucRecords + (size_t)i * uRecordSize, c, iElement);
+                if (memcmp(&s_adChannel[i], &dExpected, sizeof(double)) != 0) {
+                    iValues = -1;
+                    break;
+                }
+            }
+            if (iValues != (int)uCount && ullBad++ < 5) {
+                printf("group at record %lld: channel %d (%s[%d]) mismatch\n", llFirst, ch, pColumn->acName, iElement);
+            }
+        }
+
+        if (pOut != NULL) {
+            TelemetryIndexAdd(&s_stIndex, (uint64_t)llFirst, TELEMETRY_HEADER_SIZE + ullCompressedBytes);
+            fwrite(s_aucGroup, 1, uBytes, pOut);
+        }
+        ullRawBytes += (unsigned long long)uCount * uRecordSize;
+        ullCompressedBytes += uBytes;
+        ullGroups++;
+    }
+    if (pOut != NULL) {
+        TelemetryIndexWrite(&s_stIndex, TELEMETRY_HEADER_SIZE + ullCompressedBytes, pOut);
+        fclose(pOut);
+    }
+
+    double dRawMB = (double)ullRawBytes / 1.0e6;
+    printf("%lld records x %d axes (%d moving, duty %.2f, %d idle), %llu groups of <= %d records\n", llRecords, iAxes,
+           iAxes - iIdleAxes, dDuty, iIdleAxes, ullGroups, TELEMETRY_GROUP_RECORDS);
+    printf("%-8s %12s %10s %8s %8s\n", "column", "bytes", "bits/val", "xor", "dod");
+    for (int c = 0; c < (int)stHeader.uColumnCount; c++) {
+        const stTelemetryColumn* pColumn = &stHeader.astColumn[c];
+        double dValues = (double)llRecords * pColumn->usCount;
+        printf("%-8s %12llu %10.2f %8llu %8llu\n", pColumn->acName, s_aullColumnBytes[c],
+               8.0 * (double)s_aullColumnBytes[c] / dValues, s_aullCodec[c][TELEMETRY_CODEC_XOR],
+               s_aullCodec[c][TELEMETRY_CODEC_DOD]);
+    }
+    printf("raw %llu bytes (%u bytes/record) -> compressed %llu bytes (%.1f bytes/record): %.2fx\n", ullRawBytes,
+           uRecordSize, ullCompressedBytes, (double)ullCompressedBytes / (double)llRecords,
+           (double)ullRawBytes / (double)ullCompressedBytes);
+    printf("compress %.0f MB/s (%.2f us/record), decompress %.0f MB/s, one channel %.2f us/group vs whole group "
+           "%.1f us\n", dRawMB * 1.0e6 / dCompressUs, dCompressUs / (double)llRecords,
+           dRawMB * 1.0e6 / dDecompressUs, dChannelUs / (double)(ullGroups * (unsigned long long)iChannels),
+           dDecompressUs / (double)ullGroups);
+    if (pszOut != NULL) {
+        ullBad += RandomChannelReads(pszOut, llRecords);
+    }
+    printf("round trip: %llu mismatches -> %s\n", ullBad, ullBad == 0 ? "PASS" : "FAIL");
+    return ullBad == 0 ? 0 : 1;
+}
@@ -0,0 +1,336 @@
+// 二进制逐周期数据记录 (TelemetryFile, 默认 control_data.tlm; 控制程序以 tlm / tlmz 参数启动时生成) 的转换与统计
+// csv:   转为 CSV: 每条记录每轴一行, 列为 标量列..., axis, 每轴列... (列名取自文件头部), 数值为最短往返文本
+// stats: 输出头部信息、记录数、时间范围、步号间断 (写入队列满时丢弃的记录) 与各轴各列的
+//        最小/最大/均值/均方根 (整数列输出非零周期数, 如开环周期数)
+//        (压缩文件另输出组数与压缩比)
+// channel: 随机读取单个通道 (列名 + 元素号, 如 actual 2), 输出 记录号,值; 压缩文件只解码该通道的块
+// -f:    跟随正在写入的文件: 读到末尾后继续等待新记录, 连续 FOLLOW_IDLE_MS 无新数据后结束
+// 压缩文件 (TelemetryCompress) 由 TelemetryReader 透明解压, 各模式用法相同
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc TelemetryConvert.c ..\src\TelemetryFile.c ..\src\TelemetryCompress.c ..\src\DoubleFormat.c
+// 用法: TelemetryConvert csv     <输入.tlm> [输出.csv (默认标准输出)] [-f]
+//       TelemetryConvert stats   <输入.tlm> [-f]
+//       TelemetryConvert channel <输入.tlm> <列名> [元素号(默认0)] [起始记录(默认0)] [记录数(默认全部)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <windows.h>
+#include "TelemetryFile.h"
+#include "DoubleFormat.h"
+
+#define FOLLOW_POLL_MS 100          // 跟随模式下无新数据时的轮询间隔
+#define FOLLOW_IDLE_MS 3000         // 跟随模式下连续无新数据多久后结束
+#define CHANNEL_CHUNK 4096          // channel 模式每次读取的值个数
+
+// 每列每个元素的统计量
+typedef struct {
+    double dMin;
+    double dMax;
+    double dSum;
+    double dSumSq;
+    unsigned long long ullNonZero;
+} stColumnStats;
+
+static int s_bFollow = 0;
+
+// 读取下一条记录; 跟随模式下等待新数据, 超时或非跟随模式下读到末尾返回 0
+static int ReadNext(stTelemetryReader* pReader, unsigned char* pucRecord) {
+    int iIdleMs = 0;
+    for (;;) {
+        if (TelemetryReaderNext(pReader, pucRecord)) {
+            return 1;
+        }
+        if (!s_bFollow || iIdleMs >= FOLLOW_IDLE_MS) {
+            return 0;
+        }
+        Sleep(FOLLOW_POLL_MS);
+        iIdleMs += FOLLOW_POLL_MS;
+    }
+}
+
+// 打开文件; 跟随模式下等待文件创建及头部写完
+static int OpenReader(stTelemetryReader* pReader, const char* pszPath) {
+    int iIdleMs = 0;
+    while (TelemetryReaderOpen(pReader, pszPath) != 0) {
+        if (!s_bFollow || iIdleMs >= FOLLOW_IDLE_MS) {
+            return -1;
+        }
+        Sleep(FOLLOW_POLL_MS);
+        iIdleMs += FOLLOW_POLL_MS;
+    }
+    return 0;
+}
+
+static char* AppendValue(char* p, const stTelemetryHeader* pHeader, const unsigned char* pucRecord, int iColumn,
+                         int iIndex) {
+    double dValue = TelemetryGetValue(pHeader, pucRecord, iColumn, iIndex);
+    *p++ = ',';
+    if (pHeader->astColumn[iColumn].ucType == TELEMETRY_TYPE_I32) {
+        return p + DoubleFormatInt((int)dValue, p);
+    }
+    return p + DoubleFormatShortest(dValue, p);
+}
+
+static int ConvertToCsv(stTelemetryReader* pReader, FILE* pOut) {
+    const stTelemetryHeader* pHeader = &pReader->stHeader;
+    int iColumns = (int)pHeader->uColumnCount;
+    int iAxes = (int)pHeader->uAxisCount;
+    unsigned char* pucRecord = (unsigned char*)malloc(pHeader->uRecordSize);
+    // 一行: 每个标量元素与每轴元素各至多 DOUBLE_FORMAT_MAX_CHARS 字符
+    size_t uLineMax = (size_t)(pHeader->uRecordSize / 4 + 2) * DOUBLE_FORMAT_MAX_CHARS;
+    char* pcLine = (char*)malloc(uLineMax);
+    char* pcPrefix = (char*)malloc(uLineMax);
+    if (pucRecord == NULL || pcLine == NULL || pcPrefix == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // 表头: 标量列, axis, 每轴列 (标量数组列展开为 name[k])
+    char* p = pcLine;
+    for (int c = 0; c < iColumns; c++) {
+        const stTelemetryColumn* pColumn = &pHeader->astColumn[c];
+        if (pColumn->ucFlags & TELEMETRY_COLUMN_PER_AXIS) {
+            continue;
+        }
+        for (int k = 0; k < pColumn->usCount; k++) {
+            p += (pColumn->usCount == 1) ? sprintf(p, "%s,", pColumn->acName)
+                                         : sprintf(p, "%s[%d],", pColumn->acName, k);
+        }
+    }
+    p += sprintf(p, "axis");
+    for (int c = 0; c < iColumns; c++) {
+        if (pHeader->astColumn[c].ucFlags & TELEMETRY_COLUMN_PER_AXIS) {
+            p += sprintf(p, ",%s", pHeader->astColumn[c].acName);
+        }
+    }
+    *p++ = '\n';
+    fwrite(pcLine, 1, (size_t)(p - pcLine), pOut);
+
+    while (ReadNext(pReader, pucRecord)) {
+        // 标量部分每条记录格式化一次, 各轴行复用
+        char* q = pcPrefix;
+        for (int c = 0; c < iColumns; c++) {
+            const stTelemetryColumn* pColumn = &pHeader->astColumn[c];
+            if (pColumn->ucFlags & TELEMETRY_COLUMN_PER_AXIS) {
+                continue;
+            }
+            for (int k = 0; k < pColumn->usCount; k++) {
+                q = AppendValue(q, pHeader, pucRecord, c, k);
+            }
+        }
+        size_t uPrefix = (size_t)(q - pcPrefix) - 1;    // 去掉开头的逗号
+
+        p = pcLine;
+        for (int axis = 0; axis < iAxes; axis++) {
+            memcpy(p, pcPrefix + 1, uPrefix);
+            p += uPrefix;
+            *p++ = ',';
+            p += DoubleFormatInt(axis, p);
+            for (int c = 0; c < iColumns; c++) {
+                if (pHeader->astColumn[c].ucFlags & TELEMETRY_COLUMN_PER_AXIS) {
+                    p = AppendValue(p, pHeader, pucRecord, c, axis);
+                }
+            }
+            *p++ = '\n';
+            fwrite(pcLine, 1, (size_t)(p - pcLine), pOut);
+            p = pcLine;
+        }
+    }
+    fprintf(stderr, "%llu records converted\n", (unsigned long long)pReader->ullRecords);
+    free(pcPrefix);
+    free(pcLine);
+    free(pucRecord);
+    return 0;
+}
+
+static int PrintStats(stTelemetryReader* pReader) {
+    const stTelemetryHeader* pHeader = &pReader->stHeader;
+    int iColumns = (int)pHeader->uColumnCount;
+    int iAxes = (int)pHeader->uAxisCount;
+    int iTimeColumn = TelemetryFindColumn(pHeader, "time");
+    int iStepColumn = TelemetryFindColumn(pHeader, "step");
+    unsigned char* pucRecord = (unsigned char*)malloc(pHeader->uRecordSize);
+    stColumnStats* pStats = (stColumnStats*)calloc((size_t)iColumns * (size_t)iAxes, sizeof(stColumnStats));
+    if (pucRecord == NULL || pStats == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < iColumns * iAxes; i++) {
+        pStats[i].dMin = DBL_MAX;
+        pStats[i].dMax = -DBL_MAX;
+    }
+
+    // 头部
+    unsigned long long ullStart = pHeader->ullStartTime;
+    printf("axes %u, sample time %gs, record %u bytes, %u columns, started at FILETIME %llu\n", pHeader->uAxisCount,
+           pHeader->dSampleTime, pHeader->uRecordSize, pHeader->uColumnCount, ullStart);
+    for (int c = 0; c < iColumns; c++) {
+        const stTelemetryColumn* pColumn = &pHeader->astColumn[c];
+        printf("  %-16s %s x%-3u offset %u%s\n", pColumn->acName,
+               pColumn->ucType == TELEMETRY_TYPE_F64 ? "f64" : "i32", pColumn->usCount, pColumn->uOffset,
+               (pColumn->ucFlags & TELEMETRY_COLUMN_PER_AXIS) ? " (per axis)" : "");
+    }
+
+    double dFirstTime = 0.0, dLastTime = 0.0;
+    long long llLastStep = 0;
+    unsigned long long ullGaps = 0, ullMissing = 0;
+    while (ReadNext(pReader, pucRecord)) {
+        if (iTimeColumn >= 0) {
+            dLastTime = TelemetryGetValue(pHeader, pucRecord, iTimeColumn, 0);
+            if (pReader->ullRecords == 1) {
+                dFirstTime = dLastTime;
+            }
+        }
+        if (iStepColumn >= 0) {
+            long long llStep = (long long)TelemetryGetValue(pHeader, pucRecord, iStepColumn, 0);
+            if (pReader->ullRecords > 1 && llStep != llLastStep + 1) {
+                ullGaps++;
+                if (llStep > llLastStep) {
+                    ullMissing += (unsigned long long)(llStep - llLastStep - 1);
+                }
+            }
+            llLastStep = llStep;
+        }
+        for (int c = 0; c < iColumns; c++) {
+            if (!(pHeader->astColumn[c].ucFlags & TELEMETRY_COLUMN_PER_AXIS)) {
+                continue;
+            }
+            for (int axis = 0; axis < iAxes; axis++) {
+                stColumnStats* s = &pStats[c * iAxes + axis];
+                double dValue = TelemetryGetValue(pHeader, pucRecord, c, axis);
+                s->dMin = fmin(s->dMin, dValue);
+                s->dMax = fmax(s->dMax, dValue);
+                s->dSum += dValue;
+                s->dSumSq += dValue * dValue;
+                s->ullNonZero += (dValue != 0.0);
+            }
+        }
+    }
+
+    unsigned long long ullRecords = (unsigned long long)pReader->ullRecords;
+    printf("%llu records, time %.3fs .. %.3fs, step gaps %llu (%llu records missing)\n", ullRecords, dFirstTime,
+           dLastTime, ullGaps, ullMissing);
+    if ((pHeader->uFlags & TELEMETRY_FLAG_COMPRESSED) && ullRecords > 0) {
+        printf("compressed: %llu groups, %llu bytes, %.1f bytes/record (%.1fx)\n",
+               (unsigned long long)pReader->ullGroups, (unsigned long long)pReader->ullStoredBytes,
+               (double)pReader->ullStoredBytes / (double)ullRecords,
+               (double)ullRecords * pHeader->uRecordSize / (double)pReader->ullStoredBytes);
+        if (pReader->ullDataEnd != 0) {
+            printf("group index: %u entries, stride %u groups\n", pReader->uIndexCount, pReader->uIndexStride);
+        } else {
+            printf("group index: none (file still being written or not closed cleanly)\n");
+        }
+    }
+    if (ullRecords > 0) {
+        printf("%-16s %4s %16s %16s %16s %16s\n", "column", "axis", "min", "max", "mean", "rms");
+        for (int c = 0; c < iColumns; c++) {
+            const stTelemetryColumn* pColumn = &pHeader->astColumn[c];
+            if (!(pColumn->ucFlags & TELEMETRY_COLUMN_PER_AXIS)) {
+                continue;
+            }
+            for (int axis = 0; axis < iAxes; axis++) {
+                const stColumnStats* s = &pStats[c * iAxes + axis];
+                if (pColumn->ucType == TELEMETRY_TYPE_I32) {
+                    printf("%-16s %4d %16.0f %16.0f %16s nonzero %llu\n", pColumn->acName, axis, s->dMin, s->dMax, "",
+                           s->ullNonZero);
+                } else {
+                    printf("%-16s %4d %16.9g %16.9g %16.9g %16.9g\n", pColumn->acName, axis, s->dMin, s->dMax,
+                           s->dSum / (double)ullRecords, sqrt(s->dSumSq / (double)ullRecords));
+                }
+            }
+        }
+    }
+    free(pStats);
+    free(pucRecord);
+    return 0;
+}
+
+// 输出一个通道自 ullFirst 起的 ullCount 个值 (记录号,值)
+static int PrintChannel(stTelemetryReader* pReader, const char* pszColumn, int iIndex, uint64_t ullFirst,
+                        uint64_t ullCount) {
+    const stTelemetryHeader* pHeader = &pReader->stHeader;
+    static double s_adValues[CHANNEL_CHUNK];
+    char acLine[2 * DOUBLE_FORMAT_MAX_CHARS + 2];
+    int iColumn = TelemetryFindColumn(pHeader, pszColumn);
+    if (iColumn < 0 || iIndex < 0 || iIndex >= pHeader->astColumn[iColumn].usCount) {
+        fprintf(stderr, "no column %s element %d\n", pszColumn, iIndex);
+        return 1;
+    }
+    int bInteger = pHeader->astColumn[iColumn].ucType == TELEMETRY_TYPE_I32;
+    uint64_t ullDone = 0;
+    printf("record,%s\n", pszColumn);
+    while (ullDone < ullCount) {
+        uint32_t uChunk = (ullCount - ullDone < CHANNEL_CHUNK) ? (uint32_t)(ullCount - ullDone) : CHANNEL_CHUNK;
+        int iRead = TelemetryReaderReadChannel(pReader, iColumn, iIndex, ullFirst + ullDone, uChunk, s_adValues);
+        for (int i = 0; i < iRead; i++) {
+            char* p = acLine;
+            p += sprintf(p, "%llu,", (unsigned long long)(ullFirst + ullDone + (uint64_t)i));
+            p += bInteger ? DoubleFormatInt((int)s_adValues[i], p) : DoubleFormatShortest(s_adValues[i], p);
+            *p++ = '\n';
+            fwrite(acLine, 1, (size_t)(p - acLine), stdout);
+        }
+        ullDone += (uint64_t)(iRead > 0 ? iRead : 0);
+        if (iRead < (int)uChunk) {
+            break;
+        }
+    }
+    fprintf(stderr, "%llu values read\n", (unsigned long long)ullDone);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    stTelemetryReader stReader;
+    const char* pszOut = NULL;
+    int iArgs = 0;
+    const char* apszArg[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-f") == 0) {
+            s_bFollow = 1;
+        } else if (iArgs < 6) {
+            apszArg[iArgs++] = argv[i];
+        }
+    }
+    if (iArgs < 2 || (strcmp(apszArg[0], "csv") != 0 && strcmp(apszArg[0], "stats") != 0 &&
+                      (strcmp(apszArg[0], "channel") != 0 || iArgs < 3))) {
+        printf("usage: TelemetryConvert csv <in.tlm> [out.csv] [-f]\n");
+        printf("       TelemetryConvert stats <in.tlm> [-f]\n");
+        printf("       TelemetryConvert channel <in.tlm> <column> [element] [first] [count]\n");
+        return 1;
+    }
+    if (OpenReader(&stReader, apszArg[1]) != 0) {
+        fprintf(stderr, "cannot open %s or not a telemetry file\n", apszArg[1]);
+        return 1;
+    }
+
+    int iResult;
+    if (strcmp(apszArg[0], "csv") == 0) {
+        FILE* pOut = stdout;
+        pszOut = apszArg[2];
+        if (pszOut != NULL && (fopen_s(&pOut, pszOut, "wb") != 0 || pOut == NULL)) {
+            fprintf(stderr, "cannot create %s\n", pszOut);
+            TelemetryReaderClose(&stReader);
+            return 1;
+        }
+        setvbuf(pOut, NULL, _IOFBF, 1 << 20);
+        iResult = ConvertToCsv(&stReader, pOut);
+        if (pOut != stdout) {
+            fclose(pOut);
+        }
+    } else if (strcmp(apszArg[0], "channel") == 0) {
+        setvbuf(stdout, NULL, _IOFBF, 1 << 20);
+        iResult = PrintChannel(&stReader, apszArg[2], apszArg[3] ? atoi(apszArg[3]) : 0,
+                               apszArg[4] ? strtoull(apszArg[4], NULL, 10) : 0,
+                               apszArg[5] ? strtoull(apszArg[5], NULL, 10) : UINT64_MAX);
+    } else {
+        iResult = PrintStats(&stReader);
+    }
+    TelemetryReaderClose(&stReader);
+    return iResult;
+}
@@ -0,0 +1,262 @@
+// 离线轨迹文件 (TrajectoryFile) 的生成、约束检查与回放基准
+// gen:   为每轴生成一段由随机点到点运动组成的程序 (FourthOrderPlannerInitEx + GenerateBlock 分块生成),
+//        按帧交织写入 trajectory_NNN.trj (先结束的轴停在终点补齐), 随后映射文件做约束检查并写入检查标记
+// check: 以给定约束重新检查已有文件 (不通过时输出首个不满足的帧)
+// bench: 以控制线程的方式逐帧读取映射的文件 (TrajectoryFileNextFrame), 统计每帧耗时,
+//        并与逐轴调用 FourthOrderPlannerGetNextPoint 的在线求值比较
+//
+// 编译 (VS 开发者命令行, 在 tools 目录下):
+//   cl /O2 /I..\inc TrajectoryFileGen.c ..\src\TrajectoryFile.c ..\src\FourthOrderTrajectoryPlanning.c
+// 用法: TrajectoryFileGen gen   <编号> [轴数(默认3)] [每轴运动数(默认200)] [起点位置(默认0)]
+//       TrajectoryFileGen check <编号> [VMax] [AMax] [JMax]
+//       TrajectoryFileGen bench <编号> [重复次数(默认5)]
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <windows.h>
+#include "FourthOrderTrajectoryPlanning.h"
+#include "TrajectoryFile.h"
+
+#define GEN_BLOCK_FRAMES 4096       // 每次生成并写出的帧数
+
+static const stPlannerInput s_stLimits = { 0.0, 0.8, 2.0, 10.0, 200.0, 1e-3, 0.0 };
+
+static double s_dTicksToUs = 0.0;
+static unsigned int s_uSeed = 20261016u;
+
+static double NowUs(void) {
+    LARGE_INTEGER liNow;
+    QueryPerformanceCounter(&liNow);
+    return (double)liNow.QuadPart * s_dTicksToUs;
+}
+
+static double Random01(void) {
+    s_uSeed = s_uSeed * 1664525u + 1013904223u;
+    return (double)(s_uSeed >> 8) / 16777216.0;
+}
+
+// 单轴的程序生成状态
+typedef struct {
+    stPlannerContext stContext;     // 当前运动
+    int iMovesLeft;                 // 剩余运动数
+    double dPos;                    // 当前运动的终点 (下一运动的起点)
+    int bDone;                      // 全部运动已输出
+} stAxisProgram;
+
+static stAxisProgram s_astProgram[MAX_AXIS_COUNT];
+static double s_adPos[GEN_BLOCK_FRAMES], s_adVel[GEN_BLOCK_FRAMES], s_adAcc[GEN_BLOCK_FRAMES];
+static stTrajRecord s_astFrames[GEN_BLOCK_FRAMES * MAX_AXIS_COUNT];
+
+// 开始该轴的下一段随机运动 (位移 ±[0.02, 0.5], 速度上限随机取 30% ~ 100%)
+static void NextMove(stAxisProgram* pProgram) {
+    stPlannerInputEx stEx;
+    memset(&stEx, 0, sizeof(stEx));
+    stEx.stLimits = s_stLimits;
+    stEx.stLimits.dVMax = s_stLimits.dVMax * (0.3 + 0.7 * Random01());
+    stEx.stLimits.dDistance = (0.02 + 0.48 * Random01()) * ((Random01() < 0.5) ? -1.0 : 1.0);
+    stEx.dStartPos = pProgram->dPos;
+    FourthOrderPlannerInitEx(&stEx, &pProgram->stContext);
+    pProgram->dPos += stEx.stLimits.dDistance;
+    pProgram->iMovesLeft--;
+}
+
+// 为一个轴填充 iFrames 帧 (写入交织帧中的第 k 列); 全部运动结束后停在终点
+static void FillAxis(stAxisProgram* pProgram, int k, int iAxisCount, int iFrames) {
+    int iFilled = 0;
+    while (iFilled < iFrames) {
+        int iCount = 0;
+        if (!pProgram->bDone) {
+            if (pProgram->stContext.bIsFinished) {
+                if (pProgram->iMovesLeft == 0) {
+                    pProgram->bDone = 1;
+                    continue;
+                }
+                NextMove(pProgram);
+            }
+            iCount = FourthOrderPlannerGenerateBlock(&pProgram->stContext, iFrames - iFilled, s_adPos, s_adVel, s_adAcc, NULL);
+        }
+        if (iCount <= 0) {
+            // 停在终点
+            iCount = iFrames - iFilled;
+            for (int i = 0; i < iCount; i++) {
+                s_adPos[i] = pProgram->dPos;
+                s_adVel[i] = 0.0;
+                s_adAcc[i] = 0.0;
+            }
+        }
+        for (int i = 0; i < iCount; i++) {
+            stTrajRecord* r = &s_astFrames[(size_t)(iFilled + i) * iAxisCount + k];
+            r->dPos = s_adPos[i];
+            r->dVel = s_adVel[i];
+            r->dAcc = s_adAcc[i];
+        }
+        iFilled += iCount;
+    }
+}
+
+static int CheckFile(const char* pszPath, double dVMax, double dAMax, double dJMax) {
+    stTrajectoryFile stFile;
+    uint64_t ullBad = 0;
+
+    if (TrajectoryFileOpen(&stFile, pszPath, 1) != 0) {
+        printf("cannot map %s\n", pszPath);
+        return 1;
+    }
+    double dStartUs = NowUs();
+    int iResult = TrajectoryFileValidate(&stFile, dVMax, dAMax, dJMax, &ullBad);
+    double dUs = NowUs() - dStartUs;
+    if (iResult == 0) {
+        printf("check  %s: %llu frames x %d axes within V=%.3f A=%.3f J=%.1f (%.1f ms, %.1f Mframe/s) -> validated\n",
+               pszPath, (unsigned long long)stFile.ullFrameCount, stFile.iAxisCount, dVMax, dAMax, dJMax, dUs / 1000.0,
+               (double)stFile.ullFrameCount / dUs);
+    } else {
+        const stTrajRecord* pFrame = TrajectoryFileGetFrame(&stFile, ullBad);
+        printf("check  %s: FAIL at frame %llu (pos %.6f vel %.6f acc %.6f on file axis 0)\n", pszPath,
+               (unsigned long long)ullBad, pFrame[0].dPos, pFrame[0].dVel, pFrame[0].dAcc);
+    }
+    TrajectoryFileClose(&stFile);
+    return (iResult == 0) ? 0 : 1;
+}
+
+static int Generate(const char* pszPath, int iAxisCount, int iMoves, double dStartPos) {
+    stTrajFileHeader stHeader;
+    FILE* pFile = NULL;
+    uint64_t ullFrames = 0;
+
+    for (int k = 0; k < iAxisCount; k++) {
+        memset(&s_astProgram[k], 0, sizeof(s_astProgram[k]));
+        s_astProgram[k].iMovesLeft = iMoves;
+        s_astProgram[k].dPos = dStartPos;
+        NextMove(&s_astProgram[k]);
+    }
+    if (fopen_s(&pFile, pszPath, "wb") != 0 || pFile == NULL) {
+        printf("cannot create %s\n", pszPath);
+        return 1;
+    }
+    memset(&stHeader, 0, sizeof(stHeader));
+    fwrite(&stHeader, sizeof(stHeader), 1, pFile);
+
+    double dStartUs = NowUs();
+    for (;;) {
+        int bAllDone = 1;
+        for (int k = 0; k < iAxisCount; k++) {
+            const stAxisProgram* p = &s_astProgram[k];
+            bAllDone &= p->bDone || (p->iMovesLeft == 0 && p->stContext.bIsFinished);
+        }
+        if (bAllDone) {
+            break;
+        }
+        for (int k = 0; k < iAxisCount; k++) {
+            FillAxis(&s_astProgram[k], k, iAxisCount, GEN_BLOCK_FRAMES);
+        }
+        fwrite(s_astFrames, sizeof(stTrajRecord) * iAxisCount, GEN_BLOCK_FRAMES, pFile);
+        ullFrames += GEN_BLOCK_FRAMES;
+    }
+    double dUs = NowUs() - dStartUs;
+
+    stHeader.uMagic = TRAJ_FILE_MAGIC;
+    stHeader.uVersion = TRAJ_FILE_VERSION;
+    stHeader.uAxisCount = (uint32_t)iAxisCount;
+    stHeader.ullFrameCount = ullFrames;
+    stHeader.dSampleTime = s_stLimits.dSampleTime;
+    fseek(pFile, 0, SEEK_SET);
+    fwrite(&stHeader, sizeof(stHeader), 1, pFile);
+    fclose(pFile);
+    printf("gen    %s: %d axes x %d moves, %llu frames (%.1f s), %.1f MiB, generated in %.1f ms\n", pszPath,
+           iAxisCount, iMoves, (unsigned long long)ullFrames, (double)ullFrames * s_stLimits.dSampleTime,
+           (double)(TRAJ_FILE_HEADER_SIZE + ullFrames * iAxisCount * sizeof(stTrajRecord)) / (1024.0 * 1024.0),
+           dUs / 1000.0);
+    return CheckFile(pszPath, s_stLimits.dVMax, s_stLimits.dAMax, s_stLimits.dJMax);
+}
+
+static int Bench(const char* pszPath, int iRepeat) {
+    static stPlannerContext s_astContext[MAX_AXIS_COUNT];
+    stTrajectoryFile stFile;
+    double dSum = 0.0, dBestUs = 1e30, dBestPlanUs = 1e30, dMaxFrameUs = 0.0;
+
+    if (TrajectoryFileOpen(&stFile, pszPath, 0) != 0 ||
+        TrajectoryFileBind(&stFile, (1ULL << stFile.iAxisCount) - 1) != 0) {
+        printf("cannot map %s\n", pszPath);
+        return 1;
+    }
+    const int n = stFile.iAxisCount;
+    const uint64_t ullFrames = stFile.ullFrameCount;
+
+    for (int r = 0; r < iRepeat; r++) {
+        // 文件回放: 每帧取出各轴位置 (控制线程只读取位置)
+        TrajectoryFileBind(&stFile, stFile.ullAxisMask);
+        double dStartUs = NowUs();
+        const stTrajRecord* pFrame;
+        while ((pFrame = TrajectoryFileNextFrame(&stFile)) != NULL) {
+            double dFrameStartUs = (stFile.ullFrame % 1024 == 0) ? NowUs() : 0.0;
+            for (int k = 0; k < n; k++) {
+                dSum += pFrame[k].dPos;
+            }
+            if (dFrameStartUs > 0.0) {
+                dMaxFrameUs = fmax(dMaxFrameUs, NowUs() - dFrameStartUs);
+            }
+        }
+        dBestUs = fmin(dBestUs, NowUs() - dStartUs);
+
+        // 在线求值: 同样帧数的单段轨迹, 各轴每周期一次 GetNextPoint
+        stPlannerInput stInput = s_stLimits;
+        stInput.dDistance = 0.5 * s_stLimits.dVMax * (double)ullFrames * s_stLimits.dSampleTime;
+        for (int k = 0; k < n; k++) {
+            FourthOrderPlannerInitInto(&stInput, &s_astContext[k]);
+        }
+        dStartUs = NowUs();
+        for (uint64_t f = 0; f < ullFrames; f++) {
+            for (int k = 0; k < n; k++) {
+                stTrajectoryPoint stPoint;
+                FourthOrderPlannerGetNextPoint(&s_astContext[k], &stPoint);
+                dSum += stPoint.dPos;
+            }
+        }
+        dBestPlanUs = fmin(dBestPlanUs, NowUs() - dStartUs);
+    }
+    printf("bench  %s: %llu frames x %d axes\n", pszPath, (unsigned long long)ullFrames, n);
+    printf("  mapped replay : %7.2f ns/frame (%.1f Mframe/s, sampled frame max %.3f us)\n",
+           dBestUs * 1000.0 / (double)ullFrames, (double)ullFrames / dBestUs, dMaxFrameUs);
+    printf("  GetNextPoint  : %7.2f ns/frame (%d axes evaluated online)\n", dBestPlanUs * 1000.0 / (double)ullFrames, n);
+    printf("  (checksum %.3f)\n", dSum);
+    TrajectoryFileClose(&stFile);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    LARGE_INTEGER liFreq;
+    char szPath[64];
+
+    QueryPerformanceFrequency(&liFreq);
+    s_dTicksToUs = 1.0e6 / (double)liFreq.QuadPart;
+    if (argc < 3) {
+        printf("usage: TrajectoryFileGen gen|check|bench <number> [...]\n");
+        return 1;
+    }
+    sprintf_s(szPath, sizeof(szPath), TRAJ_FILE_NAME_FORMAT, atoi(argv[2]));
+
+    if (strcmp(argv[1], "gen") == 0) {
+        int iAxisCount = (argc > 3) ? atoi(argv[3]) : 3;
+        int iMoves = (argc > 4) ? atoi(argv[4]) : 200;
+        double dStartPos = (argc > 5) ? atof(argv[5]) : 0.0;
+        if (iAxisCount < 1 || iAxisCount > MAX_AXIS_COUNT || iMoves < 1) {
+            printf("invalid axis count or move count\n");
+            return 1;
+        }
+        return Generate(szPath, iAxisCount, iMoves, dStartPos);
+    }
+    if (strcmp(argv[1], "check") == 0) {
+        return CheckFile(szPath, (argc > 3) ? atof(argv[3]) : s_stLimits.dVMax,
+                         (argc > 4) ? atof(argv[4]) : s_stLimits.dAMax, (argc > 5) ? atof(argv[5]) : s_stLimits.dJMax);
+    }
+    if (strcmp(argv[1], "bench") == 0) {
+        int iRepeat = (argc > 3) ? atoi(argv[3]) : 5;
+        return Bench(szPath, (iRepeat < 1) ? 1 : iRepeat);
+    }
+    printf("unknown mode %s\n", argv[1]);
+    return 1;
+}